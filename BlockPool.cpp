@@ -0,0 +1,154 @@
+///============================================================================
+///@file	BlockPool.cpp
+///@brief	Fixed size block allocator implementation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "BlockPool.h"
+
+#include <string.h>
+
+///----------------------------------------------------------------------------
+///Default constructor, blocks have no size until Create
+///----------------------------------------------------------------------------
+BlockPool::BlockPool()
+{
+	m_Slabs = NULL;
+	m_Free = NULL;
+	m_BlockSize = 0;
+	m_BlocksPerSlab = DEFAULT_BLOCKS_PER_SLAB;
+	memset(&m_Stats, 0, sizeof(m_Stats));
+}
+
+///----------------------------------------------------------------------------
+///Default destructor
+///----------------------------------------------------------------------------
+BlockPool::~BlockPool()
+{
+	Release();
+}
+
+///----------------------------------------------------------------------------
+///Sets the block size, freeing any block of the previous one
+///@param	blockSize - bytes per block, rounded up to a multiple of a pointer
+///			(which is also the alignment of the blocks)
+///@param	blocksPerSlab - blocks taken from the heap at a time
+///----------------------------------------------------------------------------
+bool BlockPool::Create(size_t blockSize, unsigned int blocksPerSlab)
+{
+	Release();
+
+	if(!blockSize || !blocksPerSlab)
+		return false;
+
+	m_BlockSize = (blockSize + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+	m_BlocksPerSlab = blocksPerSlab;
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Takes a block off the free list, adding a slab if it is empty
+///@return	uninitialized block, NULL before Create or if the heap is exhausted
+///----------------------------------------------------------------------------
+void* BlockPool::Allocate()
+{
+	if(!m_Free && (!m_BlockSize || !AddSlab()))
+		return NULL;
+
+	void *block = m_Free;
+	m_Free = *(void**)block;
+	m_Stats.used += m_BlockSize;
+	if(m_Stats.used > m_Stats.highWater)
+		m_Stats.highWater = m_Stats.used;
+	return block;
+}
+
+///----------------------------------------------------------------------------
+///Puts a block of this pool back on the free list
+///----------------------------------------------------------------------------
+void BlockPool::Free(void *block)
+{
+	if(!block) return;
+
+	*(void**)block = m_Free;
+	m_Free = block;
+	m_Stats.used -= m_BlockSize;
+}
+
+///----------------------------------------------------------------------------
+///Grows the pool until at least blocks more are free, so the first
+///allocations do not reach the heap one slab at a time
+///----------------------------------------------------------------------------
+bool BlockPool::Reserve(unsigned int blocks)
+{
+	if(!m_BlockSize)
+		return false;
+
+	unsigned long long wanted = m_Stats.used + (unsigned long long)blocks * m_BlockSize;
+	while(m_Stats.capacity < wanted)
+	{
+		if(!AddSlab())
+			return false;
+	}
+
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Gives every slab back to the heap. Blocks still in use become invalid.
+///----------------------------------------------------------------------------
+void BlockPool::Release()
+{
+	while(m_Slabs)
+	{
+		void *slab = m_Slabs;
+		m_Slabs = *(void**)slab;
+		::operator delete(slab);
+	}
+
+	m_Free = NULL;
+	m_Stats.used = 0;
+	m_Stats.capacity = 0;
+}
+
+///----------------------------------------------------------------------------
+///Bytes per block, 0 before Create
+///----------------------------------------------------------------------------
+size_t BlockPool::GetBlockSize() const
+{
+	return m_BlockSize;
+}
+
+///----------------------------------------------------------------------------
+///Blocks in use and slabs taken, in bytes, and heap traffic
+///----------------------------------------------------------------------------
+const MemoryStats& BlockPool::GetStats() const
+{
+	return m_Stats;
+}
+
+///----------------------------------------------------------------------------
+///Takes a slab from the heap and threads its blocks onto the free list
+///----------------------------------------------------------------------------
+bool BlockPool::AddSlab()
+{
+	size_t bytes = m_BlockSize * m_BlocksPerSlab;
+	unsigned char *slab = (unsigned char*)::operator new(sizeof(void*) + bytes, std::nothrow);
+	if(!slab) return false;
+
+	*(void**)slab = m_Slabs;
+	m_Slabs = slab;
+
+	//first block on top of the free list
+	unsigned char *blocks = slab + sizeof(void*);
+	for(unsigned int i = m_BlocksPerSlab; i-- > 0;)
+	{
+		*(void**)(blocks + i * m_BlockSize) = m_Free;
+		m_Free = blocks + i * m_BlockSize;
+	}
+
+	m_Stats.capacity += bytes;
+	m_Stats.systemAllocations++;
+	return true;
+}
@@ -0,0 +1,134 @@
+///============================================================================
+///@file	BlockPool.h
+///@brief	Fixed size block allocator. Blocks are carved from slabs taken
+///			from the heap and go back to an intrusive free list when freed,
+///			so once a pool has grown to the most blocks a workload keeps at
+///			the same time, allocating and freeing never reach the global
+///			allocator again. Not thread safe, each pool has one owner.
+///			PoolAllocator puts the nodes of a standard container in a pool:
+///
+///			BlockPool nodes;
+///			std::list<int, PoolAllocator<int> > values(PoolAllocator<int>(&nodes));
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <new>
+#include "MemoryArena.h"
+
+class BlockPool
+{
+public:
+	//-------------------------------------------------------------------------
+	//Constructors and destructors
+	//-------------------------------------------------------------------------
+	BlockPool();
+	~BlockPool();
+
+	//-------------------------------------------------------------------------
+	//Public methods
+	//-------------------------------------------------------------------------
+	bool Create(size_t blockSize, unsigned int blocksPerSlab = DEFAULT_BLOCKS_PER_SLAB);
+	void* Allocate();
+	void Free(void *block);
+	bool Reserve(unsigned int blocks);
+	void Release();
+	size_t GetBlockSize() const;
+	const MemoryStats& GetStats() const;
+
+	//-------------------------------------------------------------------------
+	//Public members
+	//-------------------------------------------------------------------------
+	static const unsigned int DEFAULT_BLOCKS_PER_SLAB = 64;	///> Blocks taken from the heap at a time
+
+private:
+	//-------------------------------------------------------------------------
+	//Private methods
+	//-------------------------------------------------------------------------
+	bool AddSlab();
+
+	//-------------------------------------------------------------------------
+	//Non copyable
+	//-------------------------------------------------------------------------
+	BlockPool(const BlockPool&);
+	BlockPool& operator=(const BlockPool&);
+
+	//-------------------------------------------------------------------------
+	//Private members
+	//-------------------------------------------------------------------------
+	void*			m_Slabs;			///> Slabs linked through their first word, newest first
+	void*			m_Free;				///> Free blocks linked through their first word
+	size_t			m_BlockSize;		///> Bytes per block, 0 until Create
+	unsigned int	m_BlocksPerSlab;	///> Blocks per slab
+	MemoryStats		m_Stats;			///> Usage
+};
+
+//-------------------------------------------------------------------------
+//Standard allocator over a BlockPool. Single objects that fit a block come
+//from the pool, arrays (hash buckets) from the heap as usual. A pool that
+//was not created is sized by the first single object, the container node.
+//-------------------------------------------------------------------------
+template <typename T>
+class PoolAllocator
+{
+public:
+	typedef T value_type;
+
+	explicit PoolAllocator(BlockPool *pool) : m_Pool(pool)
+	{
+	}
+
+	template <typename U>
+	PoolAllocator(const PoolAllocator<U> &other) : m_Pool(other.GetPool())
+	{
+	}
+
+	T* allocate(size_t count)
+	{
+		if(count == 1 && !m_Pool->GetBlockSize())
+			m_Pool->Create(sizeof(T));
+		if(UsesPool(count))
+		{
+			void *block = m_Pool->Allocate();
+			if(!block) throw std::bad_alloc();
+			return (T*)block;
+		}
+		return (T*)::operator new(count * sizeof(T));
+	}
+
+	void deallocate(T *values, size_t count)
+	{
+		if(UsesPool(count))
+			m_Pool->Free(values);
+		else
+			::operator delete(values);
+	}
+
+	BlockPool* GetPool() const
+	{
+		return m_Pool;
+	}
+
+	template <typename U>
+	bool operator==(const PoolAllocator<U> &other) const
+	{
+		return m_Pool == other.GetPool();
+	}
+
+	template <typename U>
+	bool operator!=(const PoolAllocator<U> &other) const
+	{
+		return m_Pool != other.GetPool();
+	}
+
+private:
+	bool UsesPool(size_t count) const
+	{
+		return count == 1 && sizeof(T) <= m_Pool->GetBlockSize() && alignof(T) <= sizeof(void*);
+	}
+
+	BlockPool*	m_Pool;	///> Pool the nodes come from
+};
@@ -0,0 +1,28 @@
+///============================================================================
+///@file	BoundingBox.h
+///@brief	Defines an axis aligned bounding box.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+//-------------------------------------------------------------------------
+//Axis aligned bounding box in world space
+//-------------------------------------------------------------------------
+struct BoundingBox
+{
+	float minX, minY, minZ;
+	float maxX, maxY, maxZ;
+
+	///Grows this box so it also encloses b
+	void Merge(const BoundingBox &b)
+	{
+		if(b.minX < minX) minX = b.minX;
+		if(b.minY < minY) minY = b.minY;
+		if(b.minZ < minZ) minZ = b.minZ;
+		if(b.maxX > maxX) maxX = b.maxX;
+		if(b.maxY > maxY) maxY = b.maxY;
+		if(b.maxZ > maxZ) maxZ = b.maxZ;
+	}
+};
@@ -0,0 +1,99 @@
+///============================================================================
+///@file	CpuInfo.cpp
+///@brief	Runtime instruction set detection implementation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "CpuInfo.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define CPUINFO_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#ifdef CPUINFO_X86
+///----------------------------------------------------------------------------
+///Runs cpuid for a leaf/subleaf, regs receives eax, ebx, ecx, edx
+///----------------------------------------------------------------------------
+static void CpuId(unsigned int leaf, unsigned int subleaf, unsigned int *regs)
+{
+#if defined(_MSC_VER)
+	int r[4];
+	__cpuidex(r, (int)leaf, (int)subleaf);
+	for(int i = 0; i < 4; i++)
+		regs[i] = (unsigned int)r[i];
+#else
+	__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+///----------------------------------------------------------------------------
+///Returns the low word of XCR0, the register states the OS saves
+///----------------------------------------------------------------------------
+static unsigned int GetXCR0()
+{
+#if defined(_MSC_VER)
+	return (unsigned int)_xgetbv(0);
+#else
+	unsigned int eax, edx;
+	__asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	return eax;
+#endif
+}
+#endif
+
+///----------------------------------------------------------------------------
+///Returns true if the CPU supports SSE2
+///----------------------------------------------------------------------------
+bool CpuInfo::HasSSE2()
+{
+#ifdef CPUINFO_X86
+	unsigned int regs[4];
+	CpuId(1, 0, regs);
+	return (regs[3] & (1u << 26)) != 0;
+#else
+	return false;
+#endif
+}
+
+///----------------------------------------------------------------------------
+///Queries cpuid and XCR0 for AVX2, see HasAVX2
+///----------------------------------------------------------------------------
+static bool DetectAVX2()
+{
+#ifdef CPUINFO_X86
+	unsigned int regs[4];
+	CpuId(0, 0, regs);
+	bool avx2 = false;
+
+	if(regs[0] >= 7)
+	{
+		//OSXSAVE and AVX, then XMM|YMM state enabled, then AVX2
+		CpuId(1, 0, regs);
+		if((regs[2] & (1u << 27)) && (regs[2] & (1u << 28)) && (GetXCR0() & 6) == 6)
+		{
+			CpuId(7, 0, regs);
+			avx2 = (regs[1] & (1u << 5)) != 0;
+		}
+	}
+
+	return avx2;
+#else
+	return false;
+#endif
+}
+
+///----------------------------------------------------------------------------
+///Returns true if the CPU supports AVX2 and the OS saves the YMM registers
+///----------------------------------------------------------------------------
+bool CpuInfo::HasAVX2()
+{
+	//function statics are initialized once even when workers race here
+	static const bool cached = DetectAVX2();
+	return cached;
+}
@@ -0,0 +1,15 @@
+///============================================================================
+///@file	CpuInfo.h
+///@brief	Runtime detection of the instruction sets the SIMD kernels use,
+///			so one binary can pick the fastest path the machine supports.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+namespace CpuInfo
+{
+	bool HasSSE2();
+	bool HasAVX2();
+}
@@ -0,0 +1,294 @@
+///============================================================================
+///@file	D3D9Backend.cpp
+///@brief	Direct3D 9 render backend implementation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "D3D9Backend.h"
+#include "Profiler.h"
+
+#include <string.h>
+
+///----------------------------------------------------------------------------
+///Default constructor
+///----------------------------------------------------------------------------
+D3D9Backend::D3D9Backend()
+{
+	m_Device = NULL;
+	m_VertexBuffer = 0;
+	m_IndexBuffer = 0;
+	m_VertexCount = 0;
+}
+
+///----------------------------------------------------------------------------
+///Default destructor
+///----------------------------------------------------------------------------
+D3D9Backend::~D3D9Backend()
+{
+	Release();
+}
+
+///----------------------------------------------------------------------------
+///Draws with a device, set up for the terrain vertex format
+///@param	device - a created device, it must outlive the backend's buffers
+///----------------------------------------------------------------------------
+bool D3D9Backend::Create(LPDIRECT3DDEVICE9 device)
+{
+	Release();
+	if(!device)
+		return false;
+
+	m_Device = device;
+	m_Device->SetFVF(D3DFVF_XYZ | D3DFVF_DIFFUSE);
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Frees every buffer, the device is left alone
+///----------------------------------------------------------------------------
+void D3D9Backend::Release()
+{
+	for(size_t i = 0; i < m_Buffers.size(); i++)
+	{
+		if(m_Buffers[i].vertices) m_Buffers[i].vertices->Release();
+		if(m_Buffers[i].indices) m_Buffers[i].indices->Release();
+	}
+
+	std::vector<Buffer>().swap(m_Buffers);
+	std::vector<RenderBuffer>().swap(m_FreeBuffers);
+	m_Device = NULL;
+	m_VertexBuffer = 0;
+	m_IndexBuffer = 0;
+	m_VertexCount = 0;
+}
+
+///----------------------------------------------------------------------------
+///Creates a write only managed vertex buffer of Vertex3D
+///@param	vertexCount - vertices it holds
+///@return	the buffer, 0 on failure
+///----------------------------------------------------------------------------
+RenderBuffer D3D9Backend::CreateVertexBuffer(unsigned int vertexCount)
+{
+	Buffer buffer = { NULL, NULL, vertexCount, sizeof(Vertex3D) };
+	if(!m_Device || !vertexCount ||
+	   FAILED(m_Device->CreateVertexBuffer(sizeof(Vertex3D)*vertexCount, D3DUSAGE_WRITEONLY, D3DFVF_XYZ | D3DFVF_DIFFUSE,
+										   D3DPOOL_MANAGED, &buffer.vertices, NULL)))
+		return 0;
+
+	return Store(buffer);
+}
+
+///----------------------------------------------------------------------------
+///Creates a write only managed index buffer
+///@param	indexCount - indices it holds
+///@param	format - INDEX_16 or INDEX_32
+///@return	the buffer, 0 on failure
+///----------------------------------------------------------------------------
+RenderBuffer D3D9Backend::CreateIndexBuffer(unsigned int indexCount, IndexFormat format)
+{
+	Buffer buffer = { NULL, NULL, indexCount, (unsigned int)format };
+	if(!m_Device || !indexCount ||
+	   FAILED(m_Device->CreateIndexBuffer((unsigned int)format*indexCount, D3DUSAGE_WRITEONLY,
+										  format == INDEX_16 ? D3DFMT_INDEX16 : D3DFMT_INDEX32,
+										  D3DPOOL_MANAGED, &buffer.indices, NULL)))
+		return 0;
+
+	return Store(buffer);
+}
+
+///----------------------------------------------------------------------------
+///Copies vertices into a buffer
+///@param	buffer - vertex buffer
+///@param	first - first vertex written
+///@param	vertices - source
+///@param	count - vertices to write
+///@return	false if they do not fit or the lock failed
+///----------------------------------------------------------------------------
+bool D3D9Backend::UpdateVertices(RenderBuffer buffer, unsigned int first, const Vertex3D *vertices, unsigned int count)
+{
+	Buffer *target = Find(buffer);
+	if(!target || !target->vertices || !vertices || first > target->count || count > target->count - first)
+		return false;
+
+	void *data = NULL;
+	if(FAILED(target->vertices->Lock(first*sizeof(Vertex3D), count*sizeof(Vertex3D), &data, 0)))
+		return false;
+
+	memcpy(data, vertices, count*sizeof(Vertex3D));
+	target->vertices->Unlock();
+	m_Stats.uploadBytes += (unsigned long long)count * sizeof(Vertex3D);
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Copies indices into a buffer, in its format
+///@see		UpdateVertices
+///----------------------------------------------------------------------------
+bool D3D9Backend::UpdateIndices(RenderBuffer buffer, unsigned int first, const void *indices, unsigned int count)
+{
+	Buffer *target = Find(buffer);
+	if(!target || !target->indices || !indices || first > target->count || count > target->count - first)
+		return false;
+
+	void *data = NULL;
+	if(FAILED(target->indices->Lock(first*target->stride, count*target->stride, &data, 0)))
+		return false;
+
+	memcpy(data, indices, count*target->stride);
+	target->indices->Unlock();
+	m_Stats.uploadBytes += (unsigned long long)count * target->stride;
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Frees a buffer, unbinding it if bound
+///----------------------------------------------------------------------------
+void D3D9Backend::ReleaseBuffer(RenderBuffer buffer)
+{
+	Buffer *target = Find(buffer);
+	if(!target)
+		return;
+
+	if(m_VertexBuffer == buffer)
+	{
+		m_Device->SetStreamSource(0, NULL, 0, 0);
+		m_VertexBuffer = 0;
+	}
+	if(m_IndexBuffer == buffer)
+	{
+		m_Device->SetIndices(NULL);
+		m_IndexBuffer = 0;
+	}
+
+	if(target->vertices) target->vertices->Release();
+	if(target->indices) target->indices->Release();
+	target->vertices = NULL;
+	target->indices = NULL;
+	m_FreeBuffers.push_back(buffer);
+}
+
+///----------------------------------------------------------------------------
+///Clears the back buffer and depth, and begins the scene
+///@param	clearColor - D3DCOLOR
+///----------------------------------------------------------------------------
+bool D3D9Backend::BeginFrame(unsigned int clearColor)
+{
+	ResetStats();
+	if(!m_Device)
+		return false;
+
+	m_Device->Clear(0, NULL, D3DCLEAR_TARGET | D3DCLEAR_ZBUFFER, clearColor, 1.0f, 0);
+	return SUCCEEDED(m_Device->BeginScene());
+}
+
+///----------------------------------------------------------------------------
+///Ends the scene and presents it
+///----------------------------------------------------------------------------
+void D3D9Backend::EndFrame()
+{
+	if(!m_Device)
+		return;
+
+	PROFILE_ZONE("present");
+	m_Device->EndScene();
+	m_Device->Present(NULL, NULL, NULL, NULL);
+}
+
+///----------------------------------------------------------------------------
+///Sets D3DTS_WORLD, D3DTS_VIEW or D3DTS_PROJECTION
+///----------------------------------------------------------------------------
+void D3D9Backend::SetTransform(TransformType type, const float *matrix)
+{
+	static const D3DTRANSFORMSTATETYPE states[] = { D3DTS_WORLD, D3DTS_VIEW, D3DTS_PROJECTION };
+	if(!m_Device || (unsigned int)type > TRANSFORM_PROJECTION || !matrix)
+		return;
+
+	m_Device->SetTransform(states[type], (const D3DMATRIX*)matrix);
+	m_Stats.stateChanges++;
+}
+
+///----------------------------------------------------------------------------
+///Sets D3DRS_FILLMODE
+///----------------------------------------------------------------------------
+void D3D9Backend::SetFillMode(FillMode mode)
+{
+	if(!m_Device)
+		return;
+
+	m_Device->SetRenderState(D3DRS_FILLMODE, (DWORD)mode);
+	m_Stats.stateChanges++;
+}
+
+///----------------------------------------------------------------------------
+///Binds the vertex buffer of the next draws to stream 0
+///----------------------------------------------------------------------------
+void D3D9Backend::SetVertexBuffer(RenderBuffer buffer)
+{
+	if(buffer == m_VertexBuffer)
+		return;
+
+	Buffer *source = Find(buffer);
+	m_Device->SetStreamSource(0, source ? source->vertices : NULL, 0, sizeof(Vertex3D));
+	m_VertexBuffer = source ? buffer : 0;
+	m_VertexCount = source ? source->count : 0;
+	m_Stats.bufferBinds++;
+}
+
+///----------------------------------------------------------------------------
+///Binds the index buffer of the next draws
+///----------------------------------------------------------------------------
+void D3D9Backend::SetIndexBuffer(RenderBuffer buffer)
+{
+	if(buffer == m_IndexBuffer)
+		return;
+
+	Buffer *source = Find(buffer);
+	m_Device->SetIndices(source ? source->indices : NULL);
+	m_IndexBuffer = source ? buffer : 0;
+	m_Stats.bufferBinds++;
+}
+
+///----------------------------------------------------------------------------
+///Draws an indexed triangle list from the bound buffers
+///@param	firstIndex - first index drawn
+///@param	triangleCount - triangles drawn
+///----------------------------------------------------------------------------
+void D3D9Backend::DrawIndexed(unsigned int firstIndex, unsigned int triangleCount)
+{
+	if(!m_VertexBuffer || !m_IndexBuffer || !triangleCount)
+		return;
+
+	m_Device->DrawIndexedPrimitive(D3DPT_TRIANGLELIST, 0, 0, m_VertexCount, firstIndex, triangleCount);
+	m_Stats.drawCalls++;
+	m_Stats.triangles += triangleCount;
+}
+
+///----------------------------------------------------------------------------
+///Puts a buffer in a free slot, or a new one
+///----------------------------------------------------------------------------
+RenderBuffer D3D9Backend::Store(const Buffer &buffer)
+{
+	if(!m_FreeBuffers.empty())
+	{
+		RenderBuffer handle = m_FreeBuffers.back();
+		m_FreeBuffers.pop_back();
+		m_Buffers[handle - 1] = buffer;
+		return handle;
+	}
+
+	m_Buffers.push_back(buffer);
+	return (RenderBuffer)m_Buffers.size();
+}
+
+///----------------------------------------------------------------------------
+///Returns a live buffer, or NULL
+///----------------------------------------------------------------------------
+D3D9Backend::Buffer* D3D9Backend::Find(RenderBuffer buffer)
+{
+	if(!buffer || buffer > m_Buffers.size())
+		return NULL;
+
+	Buffer *slot = &m_Buffers[buffer - 1];
+	return (slot->vertices || slot->indices) ? slot : NULL;
+}
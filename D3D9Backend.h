@@ -0,0 +1,72 @@
+///============================================================================
+///@file	D3D9Backend.h
+///@brief	Render backend over a Direct3D 9 device (fixed function,
+///			D3DFVF_XYZ | D3DFVF_DIFFUSE vertices, managed pool buffers).
+///			Rebinding the bound buffers is filtered out.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+#include <d3d9.h>
+#include <vector>
+#include "RenderBackend.h"
+
+class D3D9Backend : public RenderBackend
+{
+public:
+	//-------------------------------------------------------------------------
+	//Constructors and destructors
+	//-------------------------------------------------------------------------
+	D3D9Backend();
+	virtual ~D3D9Backend();
+
+	//-------------------------------------------------------------------------
+	//Public methods
+	//-------------------------------------------------------------------------
+	bool Create(LPDIRECT3DDEVICE9 device);
+	void Release();
+
+	virtual RenderBuffer CreateVertexBuffer(unsigned int vertexCount);
+	virtual RenderBuffer CreateIndexBuffer(unsigned int indexCount, IndexFormat format);
+	virtual bool UpdateVertices(RenderBuffer buffer, unsigned int first, const Vertex3D *vertices, unsigned int count);
+	virtual bool UpdateIndices(RenderBuffer buffer, unsigned int first, const void *indices, unsigned int count);
+	virtual void ReleaseBuffer(RenderBuffer buffer);
+
+	virtual bool BeginFrame(unsigned int clearColor);
+	virtual void EndFrame();
+	virtual void SetTransform(TransformType type, const float *matrix);
+	virtual void SetFillMode(FillMode mode);
+	virtual void SetVertexBuffer(RenderBuffer buffer);
+	virtual void SetIndexBuffer(RenderBuffer buffer);
+	virtual void DrawIndexed(unsigned int firstIndex, unsigned int triangleCount);
+
+private:
+	//-------------------------------------------------------------------------
+	//Private types
+	//-------------------------------------------------------------------------
+	struct Buffer
+	{
+		LPDIRECT3DVERTEXBUFFER9	vertices;	///> Vertex buffer, or NULL
+		LPDIRECT3DINDEXBUFFER9	indices;	///> Index buffer, or NULL
+		unsigned int			count;		///> Vertices or indices
+		unsigned int			stride;		///> Bytes per element
+	};
+
+	//-------------------------------------------------------------------------
+	//Private methods
+	//-------------------------------------------------------------------------
+	RenderBuffer Store(const Buffer &buffer);
+	Buffer* Find(RenderBuffer buffer);
+
+	//-------------------------------------------------------------------------
+	//Private members
+	//-------------------------------------------------------------------------
+	LPDIRECT3DDEVICE9			m_Device;		///> Device drawn with, not owned
+	std::vector<Buffer>			m_Buffers;		///> Buffer slots, handle = slot + 1
+	std::vector<RenderBuffer>	m_FreeBuffers;	///> Released handles
+	RenderBuffer				m_VertexBuffer;	///> Bound vertex buffer
+	RenderBuffer				m_IndexBuffer;	///> Bound index buffer
+	unsigned int				m_VertexCount;	///> Vertices in the bound vertex buffer
+};
@@ -8,6 +8,8 @@
 
 #include "DXApp.h"
 
+static const float CAMERA_SMOOTHING = 0.25f;	///> Seconds the camera velocity is averaged over
+
 ///----------------------------------------------------------------------------
 ///Default constructor.
 ///----------------------------------------------------------------------------
@@ -21,6 +23,9 @@ DXApp::DXApp()
 	m_WindowTitle	= "DXApp";
 	m_Width			= 640;
 	m_Height		= 480;
+
+	m_CameraVelocity = D3DXVECTOR3(0.0f, 0.0f, 0.0f);
+	m_CameraTracked	= false;
 }
 
 ///----------------------------------------------------------------------------
@@ -245,7 +250,7 @@ void DXApp::InitGraphics()
 ///Draws some text in the scene (i.e. FPS, etc)
 ///Default call
 ///----------------------------------------------------------------------------
-void DXApp::RenderText(LPTSTR text)
+void DXApp::RenderText(LPCTSTR text)
 {
 	RECT rc = {5, 5, 0, 0};
 	RenderText(text, rc, D3DCOLOR_ARGB(200,255,255,255));
@@ -257,7 +262,7 @@ void DXApp::RenderText(LPTSTR text)
 ///@param	rc - rect where the text is being displayed
 ///@param	color - D3DCOLOR of the text
 ///----------------------------------------------------------------------------
-void DXApp::RenderText(LPTSTR text, RECT rc, D3DCOLOR color)
+void DXApp::RenderText(LPCTSTR text, RECT rc, D3DCOLOR color)
 {
 	m_D3DFont->DrawTextA(NULL, text, -1, &rc, DT_NOCLIP, color);
 }
@@ -331,3 +336,68 @@ D3DXVECTOR3 DXApp::GetCameraPos()
 {
 	return m_CameraPos;
 }
+
+///----------------------------------------------------------------------------
+///Tracks the camera in model space (the world matrix moves the scene, not
+///the camera) and its velocity across frames. Call once per frame.
+///@param	elapsed - seconds since the previous frame (Timer::GetTimeElapsed)
+///----------------------------------------------------------------------------
+void DXApp::UpdateCameraMotion(float elapsed)
+{
+	D3DXMATRIX invWorld;
+	D3DXVECTOR3 local;
+	D3DXMatrixInverse(&invWorld, NULL, &m_WorldMat);
+	D3DXVec3TransformCoord(&local, &m_CameraPos, &invWorld);
+
+	if(m_CameraTracked && elapsed > 0.0f)
+	{
+		//blend in the last frame so a single long or short frame does not
+		//swing the estimate
+		D3DXVECTOR3 velocity = (local - m_LocalCameraPos) / elapsed;
+		float blend = (elapsed < CAMERA_SMOOTHING) ? elapsed / CAMERA_SMOOTHING : 1.0f;
+		m_CameraVelocity += (velocity - m_CameraVelocity) * blend;
+	}
+
+	m_LocalCameraPos = local;
+	m_CameraTracked = true;
+}
+
+///----------------------------------------------------------------------------
+///Returns the camera position in model space, as of UpdateCameraMotion
+///----------------------------------------------------------------------------
+D3DXVECTOR3 DXApp::GetLocalCameraPos()
+{
+	return m_LocalCameraPos;
+}
+
+///----------------------------------------------------------------------------
+///Returns the camera velocity in model space units per second
+///----------------------------------------------------------------------------
+D3DXVECTOR3 DXApp::GetCameraVelocity()
+{
+	return m_CameraVelocity;
+}
+
+///----------------------------------------------------------------------------
+///Returns the camera view matrix
+///----------------------------------------------------------------------------
+const D3DXMATRIX& DXApp::GetViewMatrix()
+{
+	return m_CameraViewMat;
+}
+
+///----------------------------------------------------------------------------
+///Returns the camera projection matrix
+///----------------------------------------------------------------------------
+const D3DXMATRIX& DXApp::GetProjMatrix()
+{
+	return m_CameraProjMat;
+}
+
+///----------------------------------------------------------------------------
+///Returns the world matrix
+///----------------------------------------------------------------------------
+const D3DXMATRIX& DXApp::GetWorldMatrix()
+{
+	return m_WorldMat;
+}
\ No newline at end of file
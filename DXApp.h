@@ -25,8 +25,8 @@ public:
 	//Public methods
 	//-------------------------------------------------------------------------
 	virtual void InitGraphics();
-	virtual void RenderText(LPTSTR text);
-	virtual void RenderText(LPTSTR text, RECT rc, D3DCOLOR color);
+	virtual void RenderText(LPCTSTR text);
+	virtual void RenderText(LPCTSTR text, RECT rc, D3DCOLOR color);
 	virtual bool ShutDown();
 	virtual LRESULT DisplayWndProc(HWND hWnd, UINT Msg, WPARAM wParam, LPARAM lParam);
 	virtual void Reshape(int w,int h);
@@ -35,6 +35,12 @@ public:
 	void InitApp(LPSTR title, USHORT width, USHORT height);
 	void SetCameraPos(D3DXVECTOR3 &cam);
 	D3DXVECTOR3 GetCameraPos();
+	void UpdateCameraMotion(float elapsed);
+	D3DXVECTOR3 GetLocalCameraPos();
+	D3DXVECTOR3 GetCameraVelocity();
+	const D3DXMATRIX& GetViewMatrix();
+	const D3DXMATRIX& GetProjMatrix();
+	const D3DXMATRIX& GetWorldMatrix();
 	LPDIRECT3DDEVICE9 GetDevice();
 	LPD3DXFONT GetFont();
 	D3DADAPTER_IDENTIFIER9 GetAdapterIdentifier();
@@ -59,4 +65,7 @@ private:
 	D3DXMATRIX				m_CameraViewMat;	///> View matrix
 	D3DXMATRIX				m_WorldMat;			///> World matrix
 	D3DXVECTOR3				m_CameraPos;		///> Camera position
+	D3DXVECTOR3				m_LocalCameraPos;	///> Camera position in model space
+	D3DXVECTOR3				m_CameraVelocity;	///> Smoothed model space velocity, units per second
+	bool					m_CameraTracked;	///> m_LocalCameraPos holds a previous frame
 };
@@ -0,0 +1,157 @@
+///============================================================================
+///@file	FramePacer.cpp
+///@brief	Frame pacer implementation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "FramePacer.h"
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <thread>
+
+///----------------------------------------------------------------------------
+///Default constructor, unlocked
+///----------------------------------------------------------------------------
+FramePacer::FramePacer()
+{
+	m_Interval = 0;
+	m_Deadline = 0;
+	m_SpinWindow = MIN_SPIN * 4;
+	m_OvershootMean = (double)MIN_SPIN;
+	m_OvershootVariance = 0.0;
+	memset(&m_Stats, 0, sizeof(m_Stats));
+}
+
+///----------------------------------------------------------------------------
+///Default destructor
+///----------------------------------------------------------------------------
+FramePacer::~FramePacer()
+{
+}
+
+///----------------------------------------------------------------------------
+///Sets the rate Wait holds frames to
+///@param	framesPerSecond - target rate, 0 or less to stop pacing
+///----------------------------------------------------------------------------
+void FramePacer::SetTargetRate(double framesPerSecond)
+{
+	long long interval = (framesPerSecond > 0.0) ? (long long)(1e9 / framesPerSecond + 0.5) : 0;
+	if(interval != m_Interval)
+	{
+		m_Interval = interval;
+		m_Deadline = 0;
+	}
+}
+
+///----------------------------------------------------------------------------
+///Target rate in frames per second, 0 when unlocked
+///----------------------------------------------------------------------------
+double FramePacer::GetTargetRate() const
+{
+	return m_Interval ? 1e9 / (double)m_Interval : 0.0;
+}
+
+///----------------------------------------------------------------------------
+///Frame length in nanoseconds, 0 when unlocked
+///----------------------------------------------------------------------------
+long long FramePacer::GetInterval() const
+{
+	return m_Interval;
+}
+
+///----------------------------------------------------------------------------
+///Starts counting frames from the next Wait, after a pause for instance
+///----------------------------------------------------------------------------
+void FramePacer::Restart()
+{
+	m_Deadline = 0;
+}
+
+///----------------------------------------------------------------------------
+///Blocks until the current frame has lasted its interval. The first call
+///only starts the first frame.
+///@return	nanoseconds waited
+///----------------------------------------------------------------------------
+long long FramePacer::Wait()
+{
+	long long start = Now();
+	if(!m_Interval)
+		return 0;
+
+	if(!m_Deadline)
+	{
+		m_Deadline = start + m_Interval;
+		return 0;
+	}
+
+	m_Stats.frames++;
+	if(start >= m_Deadline)
+	{
+		//late: no waiting, and no burst of short frames to catch up either
+		m_Stats.missed++;
+		m_Stats.lastError = start - m_Deadline;
+		m_Deadline = (start - m_Deadline < m_Interval) ? m_Deadline + m_Interval : start + m_Interval;
+		return 0;
+	}
+
+	//sleep up to the spin window and learn how far the scheduler overshoots
+	long long sleep = m_Deadline - start - m_SpinWindow;
+	long long now = start;
+	if(sleep > 0)
+	{
+		std::this_thread::sleep_for(std::chrono::nanoseconds(sleep));
+		now = Now();
+		m_Stats.slept += now - start;
+
+		//running mean and deviation of the overshoot, the window is two
+		//deviations above the mean; outliers are clipped so a rare long
+		//wake up costs one late frame instead of making every frame spin
+		double overshoot = std::min((double)(now - (start + sleep)), m_OvershootMean * 4.0 + (double)MIN_SPIN);
+		double delta = overshoot - m_OvershootMean;
+		m_OvershootMean += delta / 16.0;
+		m_OvershootVariance += (delta * (overshoot - m_OvershootMean) - m_OvershootVariance) / 16.0;
+		m_SpinWindow = (long long)(m_OvershootMean + 2.0 * sqrt(m_OvershootVariance));
+		m_SpinWindow = std::max(MIN_SPIN, std::min(m_SpinWindow, MAX_SPIN));
+	}
+
+	long long spinStart = now;
+	while(now < m_Deadline)
+	{
+		std::this_thread::yield();
+		now = Now();
+	}
+	m_Stats.spun += std::max(now - spinStart, 0LL);
+
+	long long error = now - m_Deadline;
+	m_Stats.lastError = error;
+	m_Stats.maxError = std::max(m_Stats.maxError, error);
+	m_Deadline += m_Interval;
+	return now - start;
+}
+
+///----------------------------------------------------------------------------
+///Time before a deadline spent spinning rather than sleeping, in ns
+///----------------------------------------------------------------------------
+long long FramePacer::GetSpinWindow() const
+{
+	return m_SpinWindow;
+}
+
+///----------------------------------------------------------------------------
+///Accuracy and cost of the waits so far
+///----------------------------------------------------------------------------
+const FramePacerStats& FramePacer::GetStats() const
+{
+	return m_Stats;
+}
+
+///----------------------------------------------------------------------------
+///Steady clock in integer nanoseconds
+///----------------------------------------------------------------------------
+long long FramePacer::Now()
+{
+	return (long long)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,75 @@
+///============================================================================
+///@file	FramePacer.h
+///@brief	Holds frames to a target rate without burning a core. Wait sleeps
+///			for the bulk of what is left of the frame and spins only for the
+///			last stretch, sized from how much sleeps have overshot lately
+///			(tens of microseconds on Linux, about a millisecond on Windows).
+///			Deadlines advance by whole intervals from the first frame, so
+///			the rate does not drift, and the pacer resynchronizes instead of
+///			bursting after a long stall.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+#include <chrono>
+
+//-------------------------------------------------------------------------
+//How well the pacer has kept time, in nanoseconds
+//-------------------------------------------------------------------------
+struct FramePacerStats
+{
+	unsigned long long	frames;		///> Waits so far
+	unsigned long long	missed;		///> Frames that were already late
+	long long			lastError;	///> Wake up minus deadline of the last wait
+	long long			maxError;	///> Largest wake up error of frames on time
+	long long			slept;		///> Time spent sleeping
+	long long			spun;		///> Time spent spinning
+};
+
+class FramePacer
+{
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	static const long long MIN_SPIN = 50000;		///> Spin window floor, ns
+	static const long long MAX_SPIN = 4000000;		///> Spin window ceiling, ns
+
+	//-------------------------------------------------------------------------
+	//Constructors and destructors
+	//-------------------------------------------------------------------------
+	FramePacer();
+	~FramePacer();
+
+	//-------------------------------------------------------------------------
+	//Public methods
+	//-------------------------------------------------------------------------
+	void SetTargetRate(double framesPerSecond);
+	double GetTargetRate() const;
+	long long GetInterval() const;
+	void Restart();
+	long long Wait();
+
+	long long GetSpinWindow() const;
+	const FramePacerStats& GetStats() const;
+
+	static long long Now();
+
+private:
+	//-------------------------------------------------------------------------
+	//Non copyable
+	//-------------------------------------------------------------------------
+	FramePacer(const FramePacer&);
+	FramePacer& operator=(const FramePacer&);
+
+	//-------------------------------------------------------------------------
+	//Private members
+	//-------------------------------------------------------------------------
+	long long		m_Interval;		///> Frame length, ns, 0 when unlocked
+	long long		m_Deadline;		///> End of the current frame, ns, 0 until the first wait
+	long long		m_SpinWindow;	///> Time before the deadline spent spinning
+	double			m_OvershootMean;		///> Average sleep overshoot, ns
+	double			m_OvershootVariance;	///> Its variance
+	FramePacerStats	m_Stats;		///> Accuracy and cost so far
+};
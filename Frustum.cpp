@@ -0,0 +1,211 @@
+///============================================================================
+///@file	Frustum.cpp
+///@brief	View frustum implementation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "Frustum.h"
+
+#include <math.h>
+#include <string.h>
+
+///----------------------------------------------------------------------------
+///Default constructor, an identity view projection
+///----------------------------------------------------------------------------
+Frustum::Frustum()
+{
+	static const float identity[16] = { 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1 };
+	Extract(identity);
+}
+
+///----------------------------------------------------------------------------
+///Multiplies two row major 4x4 matrices (result = a * b)
+///----------------------------------------------------------------------------
+void Frustum::Multiply(const float *a, const float *b, float *result)
+{
+	float r[16];
+
+	for(int i = 0; i < 4; i++)
+		for(int j = 0; j < 4; j++)
+			r[i*4 + j] = a[i*4 + 0] * b[0*4 + j] + a[i*4 + 1] * b[1*4 + j] +
+						 a[i*4 + 2] * b[2*4 + j] + a[i*4 + 3] * b[3*4 + j];
+
+	memcpy(result, r, sizeof(r));
+}
+
+///----------------------------------------------------------------------------
+///Builds a left handed look at view matrix (row vectors), as
+///D3DXMatrixLookAtLH with +y up
+///@return	false if the eye is the target or straight above or below it
+///----------------------------------------------------------------------------
+bool Frustum::LookAtLH(const float *eye, const float *target, float *view)
+{
+	float z[3] = { target[0] - eye[0], target[1] - eye[1], target[2] - eye[2] };
+	float len = sqrtf(z[0] * z[0] + z[1] * z[1] + z[2] * z[2]);
+	if(len <= 0.0f) return false;
+	z[0] /= len; z[1] /= len; z[2] /= len;
+
+	//x = normalize(up x z), y = z x x
+	float x[3] = { z[2], 0.0f, -z[0] };
+	len = sqrtf(x[0] * x[0] + x[2] * x[2]);
+	if(len <= 0.0f) return false;
+	x[0] /= len; x[2] /= len;
+	float y[3] = { z[1] * x[2] - z[2] * x[1], z[2] * x[0] - z[0] * x[2], z[0] * x[1] - z[1] * x[0] };
+
+	float m[16] = {
+		x[0], y[0], z[0], 0.0f,
+		x[1], y[1], z[1], 0.0f,
+		x[2], y[2], z[2], 0.0f,
+		-(x[0] * eye[0] + x[1] * eye[1] + x[2] * eye[2]),
+		-(y[0] * eye[0] + y[1] * eye[1] + y[2] * eye[2]),
+		-(z[0] * eye[0] + z[1] * eye[1] + z[2] * eye[2]), 1.0f };
+	memcpy(view, m, sizeof(m));
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Builds a left handed perspective projection, as D3DXMatrixPerspectiveFovLH
+///----------------------------------------------------------------------------
+void Frustum::PerspectiveFovLH(float fovY, float aspect, float zn, float zf, float *proj)
+{
+	float yScale = 1.0f / tanf(fovY * 0.5f);
+	float m[16] = {
+		yScale / aspect, 0.0f, 0.0f, 0.0f,
+		0.0f, yScale, 0.0f, 0.0f,
+		0.0f, 0.0f, zf / (zf - zn), 1.0f,
+		0.0f, 0.0f, -zn * zf / (zf - zn), 0.0f };
+	memcpy(proj, m, sizeof(m));
+}
+
+///----------------------------------------------------------------------------
+///Extracts the planes from a combined view * projection matrix
+///(Gribb/Hartmann). Boxes tested afterwards must be in the space the
+///matrix transforms from.
+///@param	viewProj - row major 4x4 matrix, e.g. a D3DXMATRIX
+///----------------------------------------------------------------------------
+void Frustum::Extract(const float *viewProj)
+{
+	const float *m = viewProj;
+	memcpy(m_ViewProj, viewProj, sizeof(m_ViewProj));
+
+	//column i of the matrix is m[i], m[4+i], m[8+i], m[12+i]
+	for(int p = 0; p < PLANE_COUNT; p++)
+	{
+		int col = p / 2;
+		float sign = (p & 1) ? -1.0f : 1.0f;
+		Plane &plane = m_Planes[p];
+
+		if(p == NEAR_PLANE)
+		{
+			//D3D clip space z >= 0
+			plane.a = m[2];
+			plane.b = m[6];
+			plane.c = m[10];
+			plane.d = m[14];
+		}
+		else
+		{
+			plane.a = m[3]  + sign * m[col];
+			plane.b = m[7]  + sign * m[4 + col];
+			plane.c = m[11] + sign * m[8 + col];
+			plane.d = m[15] + sign * m[12 + col];
+		}
+
+		float length = sqrtf(plane.a * plane.a + plane.b * plane.b + plane.c * plane.c);
+		if(length > 0.0f)
+		{
+			plane.a /= length;
+			plane.b /= length;
+			plane.c /= length;
+			plane.d /= length;
+		}
+	}
+}
+
+///----------------------------------------------------------------------------
+///Extracts the planes from separate view and projection matrices
+///----------------------------------------------------------------------------
+void Frustum::Extract(const float *view, const float *proj)
+{
+	float viewProj[16];
+	Multiply(view, proj, viewProj);
+	Extract(viewProj);
+}
+
+///----------------------------------------------------------------------------
+///Extracts the planes in object space of the given world matrix
+///----------------------------------------------------------------------------
+void Frustum::Extract(const float *world, const float *view, const float *proj)
+{
+	float worldView[16];
+	Multiply(world, view, worldView);
+	Extract(worldView, proj);
+}
+
+///----------------------------------------------------------------------------
+///Returns false if the box lies completely outside one of the planes
+///----------------------------------------------------------------------------
+bool Frustum::TestBox(const BoundingBox &box) const
+{
+	for(int p = 0; p < PLANE_COUNT; p++)
+	{
+		const Plane &plane = m_Planes[p];
+
+		//corner furthest along the plane normal
+		float x = plane.a >= 0.0f ? box.maxX : box.minX;
+		float y = plane.b >= 0.0f ? box.maxY : box.minY;
+		float z = plane.c >= 0.0f ? box.maxZ : box.minZ;
+
+		if(plane.a * x + plane.b * y + plane.c * z + plane.d < 0.0f)
+			return false;
+	}
+
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Projects a point to normalized device coordinates
+///@param	sx, sy - receive the NDC position, y pointing up
+///@return	false if the point is behind the eye
+///----------------------------------------------------------------------------
+bool Frustum::Project(float x, float y, float z, float &sx, float &sy) const
+{
+	const float *m = m_ViewProj;
+	float w = x * m[3] + y * m[7] + z * m[11] + m[15];
+	if(w <= 1e-6f)
+		return false;
+
+	sx = (x * m[0] + y * m[4] + z * m[8]  + m[12]) / w;
+	sy = (x * m[1] + y * m[5] + z * m[9]  + m[13]) / w;
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Transforms a point to homogeneous clip space
+///@param	clip - receives x, y, z, w
+///----------------------------------------------------------------------------
+void Frustum::Transform(float x, float y, float z, float *clip) const
+{
+	const float *m = m_ViewProj;
+	clip[0] = x * m[0] + y * m[4] + z * m[8]  + m[12];
+	clip[1] = x * m[1] + y * m[5] + z * m[9]  + m[13];
+	clip[2] = x * m[2] + y * m[6] + z * m[10] + m[14];
+	clip[3] = x * m[3] + y * m[7] + z * m[11] + m[15];
+}
+
+///----------------------------------------------------------------------------
+///Returns one of the six clipping planes
+///----------------------------------------------------------------------------
+const Plane& Frustum::GetPlane(unsigned int i) const
+{
+	return m_Planes[i];
+}
+
+///----------------------------------------------------------------------------
+///Returns the matrix the planes were extracted from
+///----------------------------------------------------------------------------
+const float* Frustum::GetViewProj() const
+{
+	return m_ViewProj;
+}
@@ -0,0 +1,56 @@
+///============================================================================
+///@file	Frustum.h
+///@brief	Defines a view frustum extracted from D3D style matrices
+///			(row vectors, clip space z in [0,1]).
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+#include "BoundingBox.h"
+
+//-------------------------------------------------------------------------
+//Plane ax + by + cz + d = 0, normal pointing inside the frustum
+//-------------------------------------------------------------------------
+struct Plane
+{
+	float a, b, c, d;
+};
+
+class Frustum
+{
+public:
+	//-------------------------------------------------------------------------
+	//Constructors and destructors
+	//-------------------------------------------------------------------------
+	Frustum();
+
+	//-------------------------------------------------------------------------
+	//Public methods
+	//-------------------------------------------------------------------------
+	void Extract(const float *viewProj);
+	void Extract(const float *view, const float *proj);
+	void Extract(const float *world, const float *view, const float *proj);
+	bool TestBox(const BoundingBox &box) const;
+	bool Project(float x, float y, float z, float &sx, float &sy) const;
+	void Transform(float x, float y, float z, float *clip) const;
+	const Plane& GetPlane(unsigned int i) const;
+	const float* GetViewProj() const;
+
+	static void Multiply(const float *a, const float *b, float *result);
+	static bool LookAtLH(const float *eye, const float *target, float *view);
+	static void PerspectiveFovLH(float fovY, float aspect, float zn, float zf, float *proj);
+
+	//-------------------------------------------------------------------------
+	//Public members
+	//-------------------------------------------------------------------------
+	enum { LEFT, RIGHT, BOTTOM, TOP, NEAR_PLANE, FAR_PLANE, PLANE_COUNT };
+
+private:
+	//-------------------------------------------------------------------------
+	//Private members
+	//-------------------------------------------------------------------------
+	Plane	m_Planes[PLANE_COUNT];	///> Normalized clipping planes
+	float	m_ViewProj[16];			///> Matrix the planes came from (row major)
+};
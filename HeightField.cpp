@@ -0,0 +1,478 @@
+///============================================================================
+///@file	HeightField.cpp
+///@brief	Runtime sized height field implementation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "HeightField.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+
+const float HeightField::DEFAULT_VERTICAL_SCALE = 0.1f;
+
+///----------------------------------------------------------------------------
+///Returns the integer square root of n if n is a perfect square, 0 otherwise
+///----------------------------------------------------------------------------
+static unsigned int PerfectSquareRoot(unsigned long long n)
+{
+	unsigned long long r = 0;
+	unsigned long long bit = 1ULL << 62;
+
+	while(bit > n)
+		bit >>= 2;
+
+	for(unsigned long long v = n; bit; bit >>= 2)
+	{
+		if(v >= r + bit)
+		{
+			v -= r + bit;
+			r = (r >> 1) + bit;
+		}
+		else
+		{
+			r >>= 1;
+		}
+	}
+
+	return (r * r == n) ? (unsigned int)r : 0;
+}
+
+///----------------------------------------------------------------------------
+///Returns the size of a file in bytes, 0 if it cannot be opened
+///----------------------------------------------------------------------------
+static unsigned long long FileSize(const char* filename)
+{
+	FILE *f = fopen(filename, "rb");
+	if(!f) return 0;
+
+#ifdef _WIN32
+	_fseeki64(f, 0, SEEK_END);
+	unsigned long long size = (unsigned long long)_ftelli64(f);
+#else
+	fseeko(f, 0, SEEK_END);
+	unsigned long long size = (unsigned long long)ftello(f);
+#endif
+
+	fclose(f);
+	return size;
+}
+
+///----------------------------------------------------------------------------
+///Default constructor
+///----------------------------------------------------------------------------
+HeightField::HeightField()
+{
+	m_Width = 0;
+	m_Height = 0;
+	m_Format = HEIGHT_UINT8;
+	m_Data = NULL;
+	m_Owned = NULL;
+	m_Capacity = 0;
+	m_Scale = DEFAULT_VERTICAL_SCALE;
+	m_Offset = 0.0f;
+	ResetSampleRange();
+}
+
+///----------------------------------------------------------------------------
+///Default destructor
+///----------------------------------------------------------------------------
+HeightField::~HeightField()
+{
+	Release();
+}
+
+///----------------------------------------------------------------------------
+///Frees the samples and unmaps the source file
+///----------------------------------------------------------------------------
+void HeightField::Release()
+{
+	Clear();
+
+	if(m_Owned)
+	{
+		delete[] m_Owned;
+		m_Owned = NULL;
+		m_Capacity = 0;
+	}
+}
+
+///----------------------------------------------------------------------------
+///Allocates a zero filled height field. The heap buffer of a previous
+///Create is reused when it is large enough, so refilling a field (a
+///recycled tile) does not go back to the heap.
+///@param	width - number of samples along x
+///@param	height - number of samples along z
+///@param	format - sample format
+///----------------------------------------------------------------------------
+bool HeightField::Create(unsigned int width, unsigned int height, HeightFormat format)
+{
+	Clear();
+
+	if(width < 2 || height < 2)
+		return false;
+
+	m_Width = width;
+	m_Height = height;
+	m_Format = format;
+	ResetSampleRange();
+
+	size_t bytes = (size_t)GetSizeInBytes();
+	if(bytes > m_Capacity)
+	{
+		delete[] m_Owned;
+		m_Owned = new unsigned char[bytes];
+		m_Capacity = bytes;
+	}
+	memset(m_Owned, 0, bytes);
+	m_Data = m_Owned;
+
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Uses samples stored elsewhere (a tile of a mapped TerrainPackage) without
+///copying them. They must stay valid until the field is released.
+///@param	data - first sample, rows z-major, native byte order
+///@param	width - number of samples along x
+///@param	height - number of samples along z
+///@param	format - sample format
+///----------------------------------------------------------------------------
+bool HeightField::Wrap(const void *data, unsigned int width, unsigned int height, HeightFormat format)
+{
+	Release();
+
+	if(!data || width < 2 || height < 2)
+		return false;
+
+	m_Width = width;
+	m_Height = height;
+	m_Format = format;
+	m_Data = (const unsigned char*)data;
+	ResetSampleRange();
+
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Loads the heightmap from file.
+///The layout is taken from "<filename>.hdr" when present, a text file with
+///one "key value" pair per line:
+///		width 4097
+///		height 4097
+///		bits 16
+///		endian little
+///		scale 0.05
+///		offset -120
+///bits is 8, 16 or 32 (float); scale and offset map samples to world
+///heights; min and max give the sample range vertex colors span, the type
+///range for integer maps unless given, found by scanning float maps.
+///Otherwise the map is assumed square, 8-bit if the file size is a perfect
+///square and 16-bit little endian if half of it is.
+///@param	filename - name of the map to load (.raw)
+///----------------------------------------------------------------------------
+bool HeightField::Load(const char* filename)
+{
+	Release();
+
+	//map the file, the OS pages it in at disk bandwidth
+	bool mapped = m_File.Open(filename);
+	unsigned long long fileSize = mapped ? m_File.GetSize() : FileSize(filename);
+	if(!fileSize)
+		return false;
+
+	HeightLayout layout;
+	if(!ReadLayout(filename, fileSize, layout))
+	{
+		Release();
+		return false;
+	}
+
+	m_Width = layout.width;
+	m_Height = layout.height;
+	m_Format = layout.format;
+	m_Scale = layout.scale;
+	m_Offset = layout.offset;
+
+	//zero-copy when the samples can be used as they are stored
+	if(mapped && (!layout.bigEndian || m_Format == HEIGHT_UINT8))
+	{
+		m_Data = m_File.GetData();
+	}
+	else
+	{
+		m_File.Close();
+		if(!ReadFile(filename, layout.bigEndian))
+		{
+			Release();
+			return false;
+		}
+	}
+
+	if(layout.low < layout.high)
+		SetSampleRange(layout.low, layout.high);
+	else
+		UpdateSampleRange();
+
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Reads the layout of a .raw map (see Load) without loading any sample,
+///used by readers that only ever bring parts of the map in
+///@param	filename - name of the .raw file
+///@param	fileSize - size of the .raw file in bytes, 0 to query it
+///@param	layout - receives the dimensions, format, byte order and scale
+///@return	false if the layout is unknown or the file is too small
+///----------------------------------------------------------------------------
+bool HeightField::ReadLayout(const char* filename, unsigned long long fileSize, HeightLayout &layout)
+{
+	if(!fileSize)
+		fileSize = FileSize(filename);
+
+	std::string header = std::string(filename) + ".hdr";
+	FILE *f = fopen(header.c_str(), "r");
+
+	layout.bigEndian = false;
+	layout.scale = DEFAULT_VERTICAL_SCALE;
+	layout.offset = 0.0f;
+	layout.low = 0.0f;
+	layout.high = 0.0f;
+
+	if(f)
+	{
+		unsigned int bits = 8;
+		char key[32], value[32];
+
+		layout.width = 0;
+		layout.height = 0;
+		while(fscanf(f, "%31s %31s", key, value) == 2)
+		{
+			if(!strcmp(key, "width"))			layout.width = (unsigned int)strtoul(value, NULL, 10);
+			else if(!strcmp(key, "height"))		layout.height = (unsigned int)strtoul(value, NULL, 10);
+			else if(!strcmp(key, "bits"))		bits = (unsigned int)strtoul(value, NULL, 10);
+			else if(!strcmp(key, "endian"))		layout.bigEndian = !strcmp(value, "big");
+			else if(!strcmp(key, "scale"))		layout.scale = (float)atof(value);
+			else if(!strcmp(key, "offset"))		layout.offset = (float)atof(value);
+			else if(!strcmp(key, "min"))		layout.low = (float)atof(value);
+			else if(!strcmp(key, "max"))		layout.high = (float)atof(value);
+		}
+		fclose(f);
+
+		if(bits != 8 && bits != 16 && bits != 32)
+			return false;
+
+		layout.format = (HeightFormat)(bits / 8);
+	}
+	else
+	{
+		//no sidecar, assume a square map
+		unsigned int side = PerfectSquareRoot(fileSize);
+		layout.format = HEIGHT_UINT8;
+
+		if(!side && (fileSize & 1) == 0)
+		{
+			side = PerfectSquareRoot(fileSize / 2);
+			layout.format = HEIGHT_UINT16;
+		}
+
+		layout.width = side;
+		layout.height = side;
+	}
+
+	if(layout.width < 2 || layout.height < 2)
+		return false;
+
+	return fileSize >= (unsigned long long)layout.width * layout.height * (unsigned int)layout.format;
+}
+
+///----------------------------------------------------------------------------
+///Reads the samples into a heap buffer with a single bulk read
+///@param	filename - name of the .raw file
+///@param	bigEndian - swap multi-byte samples to host order
+///----------------------------------------------------------------------------
+bool HeightField::ReadFile(const char* filename, bool bigEndian)
+{
+	FILE *f = fopen(filename, "rb");
+	if(!f) return false;
+
+	size_t bytes = (size_t)GetSizeInBytes();
+	m_Owned = new unsigned char[bytes];
+	m_Capacity = bytes;
+	size_t read = fread(m_Owned, 1, bytes, f);
+	fclose(f);
+
+	if(read != bytes)
+		return false;
+
+	unsigned int sampleSize = GetSampleSize();
+	if(bigEndian && sampleSize > 1)
+	{
+		for(size_t i = 0; i < bytes; i += sampleSize)
+			std::reverse(m_Owned + i, m_Owned + i + sampleSize);
+	}
+
+	m_Data = m_Owned;
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Sets how samples map to world heights
+///@param	scale - world height per sample unit
+///@param	offset - world height of a zero sample
+///----------------------------------------------------------------------------
+void HeightField::SetVerticalScale(float scale, float offset)
+{
+	m_Scale = scale;
+	m_Offset = offset;
+}
+
+///----------------------------------------------------------------------------
+///Sets the sample range used to shade float maps, e.g. the range of the
+///whole map for one of its tiles
+///----------------------------------------------------------------------------
+void HeightField::SetSampleRange(float low, float high)
+{
+	m_Low = low;
+	m_High = high;
+}
+
+///----------------------------------------------------------------------------
+///Scans float samples for their range, integer maps use the range of
+///their type
+///----------------------------------------------------------------------------
+void HeightField::UpdateSampleRange()
+{
+	ResetSampleRange();
+	if(m_Format != HEIGHT_FLOAT32 || !m_Data)
+		return;
+
+	const float *samples = (const float*)m_Data;
+	unsigned long long count = (unsigned long long)m_Width * m_Height;
+	float low = samples[0], high = samples[0];
+	for(unsigned long long i = 1; i < count; i++)
+	{
+		low = std::min(low, samples[i]);
+		high = std::max(high, samples[i]);
+	}
+
+	SetSampleRange(low, high);
+}
+
+///----------------------------------------------------------------------------
+///Returns the lowest and highest sample value, the type range for integer
+///maps
+///----------------------------------------------------------------------------
+void HeightField::GetSampleRange(float &low, float &high) const
+{
+	low = m_Low;
+	high = m_High;
+}
+
+///----------------------------------------------------------------------------
+///Sets the type range for integer maps, an empty range for float ones
+///----------------------------------------------------------------------------
+void HeightField::ResetSampleRange()
+{
+	m_Low = 0.0f;
+	m_High = (m_Format == HEIGHT_UINT16) ? 65535.0f : (m_Format == HEIGHT_UINT8 ? 255.0f : 0.0f);
+}
+
+///----------------------------------------------------------------------------
+///Empties the field and unmaps the source file, keeping the heap buffer
+///----------------------------------------------------------------------------
+void HeightField::Clear()
+{
+	m_File.Close();
+	m_Data = NULL;
+	m_Width = 0;
+	m_Height = 0;
+}
+
+///----------------------------------------------------------------------------
+///Returns the number of samples along x
+///----------------------------------------------------------------------------
+unsigned int HeightField::GetWidth() const
+{
+	return m_Width;
+}
+
+///----------------------------------------------------------------------------
+///Returns the number of samples along z
+///----------------------------------------------------------------------------
+unsigned int HeightField::GetHeight() const
+{
+	return m_Height;
+}
+
+///----------------------------------------------------------------------------
+///Returns the sample format
+///----------------------------------------------------------------------------
+HeightFormat HeightField::GetFormat() const
+{
+	return m_Format;
+}
+
+///----------------------------------------------------------------------------
+///Returns the size of one sample in bytes
+///----------------------------------------------------------------------------
+unsigned int HeightField::GetSampleSize() const
+{
+	return (unsigned int)m_Format;
+}
+
+///----------------------------------------------------------------------------
+///Returns the size of all the samples in bytes
+///----------------------------------------------------------------------------
+unsigned long long HeightField::GetSizeInBytes() const
+{
+	return (unsigned long long)m_Width * m_Height * GetSampleSize();
+}
+
+///----------------------------------------------------------------------------
+///Returns true if the samples live in a read-only mapping (of the file, or
+///wrapped)
+///----------------------------------------------------------------------------
+bool HeightField::IsMapped() const
+{
+	return m_Data != NULL && m_Data != m_Owned;
+}
+
+///----------------------------------------------------------------------------
+///Returns a pointer to the first sample
+///----------------------------------------------------------------------------
+const void* HeightField::GetData() const
+{
+	return m_Data;
+}
+
+///----------------------------------------------------------------------------
+///Returns a writable pointer to the first sample, copying mapped or
+///wrapped samples into the heap buffer the first time it is called
+///@return	NULL if no samples are loaded
+///----------------------------------------------------------------------------
+void* HeightField::GetWritableData()
+{
+	if(!m_Data)
+		return NULL;
+
+	if(IsMapped())
+	{
+		size_t bytes = (size_t)GetSizeInBytes();
+		if(bytes > m_Capacity)
+		{
+			delete[] m_Owned;
+			m_Owned = new unsigned char[bytes];
+			m_Capacity = bytes;
+		}
+		memcpy(m_Owned, m_Data, bytes);
+		m_Data = m_Owned;
+		m_File.Close();
+	}
+
+	return m_Owned;
+}
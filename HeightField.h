@@ -0,0 +1,184 @@
+///============================================================================
+///@file	HeightField.h
+///@brief	Defines a runtime sized height field.
+///			Dimensions and sample format come from the data itself (a .hdr
+///			sidecar next to the .raw file, or inferred from the file size
+///			for square maps) instead of being fixed at compile time.
+///			Samples are 8-bit, 16-bit or float and map to world heights
+///			through a per-map scale and offset.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+#include "MappedFile.h"
+
+//-------------------------------------------------------------------------
+//Supported height sample formats
+//-------------------------------------------------------------------------
+enum HeightFormat
+{
+	HEIGHT_UINT8   = 1,	///> 8-bit unsigned samples
+	HEIGHT_UINT16  = 2,	///> 16-bit unsigned samples
+	HEIGHT_FLOAT32 = 4	///> 32-bit float samples
+};
+
+//-------------------------------------------------------------------------
+//What a .raw map holds, from its .hdr sidecar or its size
+//-------------------------------------------------------------------------
+struct HeightLayout
+{
+	unsigned int	width;		///> Samples along x
+	unsigned int	height;		///> Samples along z
+	HeightFormat	format;		///> Sample format
+	bool			bigEndian;	///> Multi-byte samples are stored big endian
+	float			scale;		///> World height per sample unit
+	float			offset;		///> World height of a zero sample
+	float			low;		///> Lowest sample value, low == high if unknown (float maps)
+	float			high;		///> Highest sample value
+};
+
+class HeightField
+{
+public:
+	//-------------------------------------------------------------------------
+	//Constructors and destructors
+	//-------------------------------------------------------------------------
+	HeightField();
+	~HeightField();
+
+	//-------------------------------------------------------------------------
+	//Public methods
+	//-------------------------------------------------------------------------
+	bool Load(const char* filename);
+	bool Create(unsigned int width, unsigned int height, HeightFormat format);
+	bool Wrap(const void *data, unsigned int width, unsigned int height, HeightFormat format);
+	void Release();
+	void SetVerticalScale(float scale, float offset = 0.0f);
+	void SetSampleRange(float low, float high);
+	void UpdateSampleRange();
+	void GetSampleRange(float &low, float &high) const;
+
+	unsigned int GetWidth() const;
+	unsigned int GetHeight() const;
+	HeightFormat GetFormat() const;
+	unsigned int GetSampleSize() const;
+	unsigned long long GetSizeInBytes() const;
+	bool IsMapped() const;
+	const void* GetData() const;
+	void* GetWritableData();
+
+	static bool ReadLayout(const char* filename, unsigned long long fileSize, HeightLayout &layout);
+
+	///Returns the raw sample at (x,z) of an integer map; rows are stored
+	///z-major, x-minor. Float samples are truncated, see GetValue.
+	unsigned int GetSample(unsigned int x, unsigned int z) const
+	{
+		unsigned long long i = (unsigned long long)z * m_Width + x;
+		if(m_Format == HEIGHT_UINT16)
+			return ((const unsigned short*)m_Data)[i];
+		if(m_Format == HEIGHT_FLOAT32)
+			return (unsigned int)((const float*)m_Data)[i];
+		return m_Data[i];
+	}
+
+	///Returns the sample at (x,z) in any format
+	float GetValue(unsigned int x, unsigned int z) const
+	{
+		unsigned long long i = (unsigned long long)z * m_Width + x;
+		if(m_Format == HEIGHT_UINT16)
+			return (float)((const unsigned short*)m_Data)[i];
+		if(m_Format == HEIGHT_FLOAT32)
+			return ((const float*)m_Data)[i];
+		return (float)m_Data[i];
+	}
+
+	///Returns the world space height at (x,z)
+	float GetElevation(unsigned int x, unsigned int z) const
+	{
+		return GetValue(x, z) * m_Scale + m_Offset;
+	}
+
+	///Stores a world space height at (x,z), rounded and clamped to the
+	///sample format; the samples must be writable (see GetWritableData)
+	void SetElevation(unsigned int x, unsigned int z, float elevation)
+	{
+		unsigned long long i = (unsigned long long)z * m_Width + x;
+		float v = (elevation - m_Offset) / m_Scale;
+		if(m_Format == HEIGHT_FLOAT32)
+		{
+			((float*)m_Owned)[i] = v;
+			return;
+		}
+
+		float top = (m_Format == HEIGHT_UINT16) ? 65535.0f : 255.0f;
+		unsigned int s = (unsigned int)((v < 0.0f ? 0.0f : (v > top ? top : v)) + 0.5f);
+		if(m_Format == HEIGHT_UINT16)
+			((unsigned short*)m_Owned)[i] = (unsigned short)s;
+		else
+			m_Owned[i] = (unsigned char)s;
+	}
+
+	///Returns the world units per height sample step
+	float GetVerticalScale() const
+	{
+		return m_Scale;
+	}
+
+	///Returns the world height of a zero sample
+	float GetVerticalOffset() const
+	{
+		return m_Offset;
+	}
+
+	///Returns the factor that takes a sample above the low end of its range
+	///to 0..256 (vertex colors): over the type range 1 for 8-bit maps and
+	///1/256 for 16-bit ones
+	float GetShadeScale() const
+	{
+		float levels = m_High - m_Low + (m_Format == HEIGHT_FLOAT32 ? 0.0f : 1.0f);
+		return (levels > 0.0f) ? 256.0f / levels : 0.0f;
+	}
+
+	///Returns the sample at (x,z) reduced to 8 bits (used for vertex colors)
+	unsigned char GetSample8(unsigned int x, unsigned int z) const
+	{
+		float shade = (GetValue(x, z) - m_Low) * GetShadeScale();
+		return (unsigned char)(shade < 0.0f ? 0.0f : (shade > 255.0f ? 255.0f : shade));
+	}
+
+	//-------------------------------------------------------------------------
+	//Public members
+	//-------------------------------------------------------------------------
+	static const float DEFAULT_VERTICAL_SCALE;	///> World height per sample unit unless the map says
+
+private:
+	//-------------------------------------------------------------------------
+	//Private methods
+	//-------------------------------------------------------------------------
+	void ResetSampleRange();
+	void Clear();
+	bool ReadFile(const char* filename, bool bigEndian);
+
+	//-------------------------------------------------------------------------
+	//Non copyable
+	//-------------------------------------------------------------------------
+	HeightField(const HeightField&);
+	HeightField& operator=(const HeightField&);
+
+	//-------------------------------------------------------------------------
+	//Private members
+	//-------------------------------------------------------------------------
+	unsigned int			m_Width;	///> Number of samples along x
+	unsigned int			m_Height;	///> Number of samples along z
+	HeightFormat			m_Format;	///> Sample format
+	const unsigned char*	m_Data;		///> Samples (m_Owned, inside m_File or wrapped)
+	unsigned char*			m_Owned;	///> Heap copy of the samples, if any
+	unsigned long long		m_Capacity;	///> Bytes allocated for m_Owned
+	MappedFile				m_File;		///> Mapped .raw file, if zero-copy
+	float					m_Scale;	///> World height per sample unit
+	float					m_Offset;	///> World height of a zero sample
+	float					m_Low;		///> Lowest sample value (type range for integer maps)
+	float					m_High;		///> Highest sample value
+};
@@ -0,0 +1,419 @@
+///============================================================================
+///@file	ImageFile.cpp
+///@brief	PPM and PNG image files implementation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "ImageFile.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef TERRAIN_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+static const unsigned char PNG_SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+///----------------------------------------------------------------------------
+///Returns the CRC-32 (as used by PNG chunks) of a buffer
+///----------------------------------------------------------------------------
+static unsigned int Crc32(const unsigned char *data, size_t size, unsigned int crc = 0)
+{
+	struct Table
+	{
+		unsigned int entries[256];
+		Table()
+		{
+			for(unsigned int n = 0; n < 256; n++)
+			{
+				unsigned int c = n;
+				for(unsigned int k = 0; k < 8; k++)
+					c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+				entries[n] = c;
+			}
+		}
+	};
+	static const Table table;
+
+	crc = ~crc;
+	for(size_t i = 0; i < size; i++)
+		crc = table.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	return ~crc;
+}
+
+///----------------------------------------------------------------------------
+///Returns the Adler-32 checksum closing a zlib stream
+///----------------------------------------------------------------------------
+static unsigned int Adler32(const unsigned char *data, size_t size)
+{
+	unsigned int a = 1, b = 0;
+	for(size_t i = 0; i < size; i++)
+	{
+		a = (a + data[i]) % 65521u;
+		b = (b + a) % 65521u;
+	}
+	return (b << 16) | a;
+}
+
+///----------------------------------------------------------------------------
+///Appends a big endian 32-bit value
+///----------------------------------------------------------------------------
+static void Put32(std::vector<unsigned char> &out, unsigned int value)
+{
+	out.push_back((unsigned char)(value >> 24));
+	out.push_back((unsigned char)(value >> 16));
+	out.push_back((unsigned char)(value >> 8));
+	out.push_back((unsigned char)value);
+}
+
+///----------------------------------------------------------------------------
+///Reads a big endian 32-bit value
+///----------------------------------------------------------------------------
+static unsigned int Get32(const unsigned char *data)
+{
+	return ((unsigned int)data[0] << 24) | ((unsigned int)data[1] << 16) | ((unsigned int)data[2] << 8) | data[3];
+}
+
+///----------------------------------------------------------------------------
+///Writes one PNG chunk: length, type, data and CRC of type and data
+///----------------------------------------------------------------------------
+static bool WriteChunk(FILE *file, const char *type, const unsigned char *data, size_t size)
+{
+	std::vector<unsigned char> chunk;
+	chunk.reserve(size + 12);
+	Put32(chunk, (unsigned int)size);
+	chunk.insert(chunk.end(), type, type + 4);
+	if(size)
+		chunk.insert(chunk.end(), data, data + size);
+	Put32(chunk, Crc32(&chunk[4], size + 4));
+	return fwrite(&chunk[0], 1, chunk.size(), file) == chunk.size();
+}
+
+///----------------------------------------------------------------------------
+///Wraps data in a zlib stream: deflated with zlib, stored blocks without
+///----------------------------------------------------------------------------
+static void Deflate(const std::vector<unsigned char> &data, std::vector<unsigned char> &out)
+{
+#ifdef TERRAIN_HAVE_ZLIB
+	uLongf size = compressBound((uLong)data.size());
+	out.resize(size);
+	if(compress2(&out[0], &size, &data[0], (uLong)data.size(), Z_DEFAULT_COMPRESSION) == Z_OK)
+	{
+		out.resize(size);
+		return;
+	}
+#endif
+
+	out.clear();
+	out.push_back(0x78);
+	out.push_back(0x01);
+	size_t offset = 0;
+	do
+	{
+		size_t block = data.size() - offset;
+		if(block > 65535) block = 65535;
+		out.push_back((offset + block == data.size()) ? 1 : 0);
+		out.push_back((unsigned char)block);
+		out.push_back((unsigned char)(block >> 8));
+		out.push_back((unsigned char)~block);
+		out.push_back((unsigned char)(~block >> 8));
+		out.insert(out.end(), data.begin() + offset, data.begin() + offset + block);
+		offset += block;
+	}
+	while(offset < data.size());
+	Put32(out, Adler32(&data[0], data.size()));
+}
+
+///----------------------------------------------------------------------------
+///Unwraps a zlib stream of a known size, stored blocks only without zlib
+///----------------------------------------------------------------------------
+static bool Inflate(const std::vector<unsigned char> &data, std::vector<unsigned char> &out)
+{
+#ifdef TERRAIN_HAVE_ZLIB
+	uLongf size = (uLongf)out.size();
+	return uncompress(&out[0], &size, &data[0], (uLong)data.size()) == Z_OK && size == out.size();
+#else
+	size_t offset = 2, written = 0;
+	if(data.size() < 2 || (data[0] & 0x0F) != 8)
+		return false;
+
+	for(bool last = false; !last; )
+	{
+		if(offset + 5 > data.size() || (data[offset] & 0x06) != 0)
+			return false;
+
+		last = (data[offset] & 1) != 0;
+		size_t block = data[offset + 1] | (data[offset + 2] << 8);
+		offset += 5;
+		if(offset + block > data.size() || written + block > out.size())
+			return false;
+
+		memcpy(&out[written], &data[offset], block);
+		offset += block;
+		written += block;
+	}
+	return written == out.size();
+#endif
+}
+
+///----------------------------------------------------------------------------
+///Paeth predictor of the PNG filters
+///----------------------------------------------------------------------------
+static unsigned char Paeth(int a, int b, int c)
+{
+	int p = a + b - c;
+	int pa = p > a ? p - a : a - p, pb = p > b ? p - b : b - p, pc = p > c ? p - c : c - p;
+	if(pa <= pb && pa <= pc) return (unsigned char)a;
+	return (unsigned char)((pb <= pc) ? b : c);
+}
+
+///----------------------------------------------------------------------------
+///Reads a binary PPM (P6, 8-bit)
+///----------------------------------------------------------------------------
+static bool ReadPPM(FILE *file, std::vector<unsigned int> &pixels, unsigned int &width, unsigned int &height)
+{
+	unsigned int fields[3];
+	for(unsigned int i = 0; i < 3; i++)
+	{
+		int c = fgetc(file);
+		while(c == '#' || c == ' ' || c == '\t' || c == '\r' || c == '\n')
+		{
+			if(c == '#')
+				while(c != '\n' && c != EOF) c = fgetc(file);
+			c = fgetc(file);
+		}
+		if(c < '0' || c > '9')
+			return false;
+
+		fields[i] = 0;
+		for(; c >= '0' && c <= '9'; c = fgetc(file))
+			fields[i] = fields[i] * 10 + (unsigned int)(c - '0');
+	}
+	if(fields[2] != 255 || !fields[0] || !fields[1])
+		return false;
+
+	width = fields[0];
+	height = fields[1];
+	std::vector<unsigned char> rgb((size_t)width * height * 3);
+	if(fread(&rgb[0], 1, rgb.size(), file) != rgb.size())
+		return false;
+
+	pixels.resize((size_t)width * height);
+	for(size_t i = 0; i < pixels.size(); i++)
+		pixels[i] = 0xFF000000u | (rgb[i * 3] << 16) | (rgb[i * 3 + 1] << 8) | rgb[i * 3 + 2];
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Reads an 8-bit RGB or RGBA, non interlaced PNG
+///----------------------------------------------------------------------------
+static bool ReadPNG(FILE *file, std::vector<unsigned int> &pixels, unsigned int &width, unsigned int &height)
+{
+	std::vector<unsigned char> compressed;
+	unsigned int channels = 0;
+	width = height = 0;
+
+	for(;;)
+	{
+		unsigned char header[8];
+		if(fread(header, 1, 8, file) != 8)
+			return false;
+
+		unsigned int size = Get32(header);
+		std::vector<unsigned char> data(size + 4);
+		if(fread(&data[0], 1, data.size(), file) != data.size() ||
+		   Crc32(&data[0], size, Crc32(header + 4, 4)) != Get32(&data[size]))
+			return false;
+
+		if(!memcmp(header + 4, "IHDR", 4))
+		{
+			if(size < 13 || data[8] != 8 || (data[9] != 2 && data[9] != 6) || data[12] != 0)
+				return false;
+			width = Get32(&data[0]);
+			height = Get32(&data[4]);
+			channels = (data[9] == 6) ? 4 : 3;
+		}
+		else if(!memcmp(header + 4, "IDAT", 4))
+			compressed.insert(compressed.end(), data.begin(), data.begin() + size);
+		else if(!memcmp(header + 4, "IEND", 4))
+			break;
+	}
+	if(!width || !height || compressed.empty())
+		return false;
+
+	size_t pitch = (size_t)width * channels;
+	std::vector<unsigned char> raw((pitch + 1) * height);
+	if(!Inflate(compressed, raw))
+		return false;
+
+	//undo the row filters in place, the previous row is already plain
+	pixels.resize((size_t)width * height);
+	for(unsigned int y = 0; y < height; y++)
+	{
+		unsigned char *row = &raw[y * (pitch + 1) + 1];
+		const unsigned char *above = y ? row - (pitch + 1) : NULL;
+		unsigned char filter = row[-1];
+		if(filter > 4)
+			return false;
+
+		for(size_t i = 0; i < pitch; i++)
+		{
+			int a = (i >= channels) ? row[i - channels] : 0;
+			int b = above ? above[i] : 0;
+			int c = (above && i >= channels) ? above[i - channels] : 0;
+			if(filter == 1) row[i] = (unsigned char)(row[i] + a);
+			else if(filter == 2) row[i] = (unsigned char)(row[i] + b);
+			else if(filter == 3) row[i] = (unsigned char)(row[i] + ((a + b) >> 1));
+			else if(filter == 4) row[i] = (unsigned char)(row[i] + Paeth(a, b, c));
+		}
+
+		for(unsigned int x = 0; x < width; x++)
+		{
+			const unsigned char *p = row + x * channels;
+			pixels[(size_t)y * width + x] = 0xFF000000u | (p[0] << 16) | (p[1] << 8) | p[2];
+		}
+	}
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Writes a binary PPM (P6)
+///@param	filename - file to write
+///@param	pixels - width * height pixels, rows top to bottom
+///@param	width, height - image size
+///----------------------------------------------------------------------------
+bool ImageFile::WritePPM(const char *filename, const unsigned int *pixels, unsigned int width, unsigned int height)
+{
+	FILE *file = fopen(filename, "wb");
+	if(!file)
+		return false;
+
+	bool ok = fprintf(file, "P6\n%u %u\n255\n", width, height) > 0;
+	std::vector<unsigned char> row((size_t)width * 3);
+	for(unsigned int y = 0; y < height && ok; y++)
+	{
+		const unsigned int *p = pixels + (size_t)y * width;
+		for(unsigned int x = 0; x < width; x++)
+		{
+			row[x * 3] = (unsigned char)(p[x] >> 16);
+			row[x * 3 + 1] = (unsigned char)(p[x] >> 8);
+			row[x * 3 + 2] = (unsigned char)p[x];
+		}
+		ok = fwrite(&row[0], 1, row.size(), file) == row.size();
+	}
+
+	return (fclose(file) == 0) && ok;
+}
+
+///----------------------------------------------------------------------------
+///Writes an 8-bit RGB PNG
+///@param	filename - file to write
+///@param	pixels - width * height pixels, rows top to bottom
+///@param	width, height - image size
+///----------------------------------------------------------------------------
+bool ImageFile::WritePNG(const char *filename, const unsigned int *pixels, unsigned int width, unsigned int height)
+{
+	//rows with filter 0 (none)
+	size_t pitch = (size_t)width * 3 + 1;
+	std::vector<unsigned char> raw(pitch * height), compressed;
+	for(unsigned int y = 0; y < height; y++)
+	{
+		unsigned char *row = &raw[y * pitch];
+		const unsigned int *p = pixels + (size_t)y * width;
+		row[0] = 0;
+		for(unsigned int x = 0; x < width; x++)
+		{
+			row[1 + x * 3] = (unsigned char)(p[x] >> 16);
+			row[2 + x * 3] = (unsigned char)(p[x] >> 8);
+			row[3 + x * 3] = (unsigned char)p[x];
+		}
+	}
+	Deflate(raw, compressed);
+
+	std::vector<unsigned char> header;
+	Put32(header, width);
+	Put32(header, height);
+	unsigned char format[5] = { 8, 2, 0, 0, 0 };	//8 bits, RGB, deflate, no filter set, no interlace
+	header.insert(header.end(), format, format + 5);
+
+	FILE *file = fopen(filename, "wb");
+	if(!file)
+		return false;
+
+	bool ok = fwrite(PNG_SIGNATURE, 1, 8, file) == 8 &&
+			  WriteChunk(file, "IHDR", &header[0], header.size()) &&
+			  WriteChunk(file, "IDAT", &compressed[0], compressed.size()) &&
+			  WriteChunk(file, "IEND", NULL, 0);
+
+	return (fclose(file) == 0) && ok;
+}
+
+///----------------------------------------------------------------------------
+///Writes a PNG if the name ends in .png, a PPM otherwise
+///----------------------------------------------------------------------------
+bool ImageFile::Write(const char *filename, const unsigned int *pixels, unsigned int width, unsigned int height)
+{
+	size_t length = strlen(filename);
+	if(length > 4 && (!strcmp(filename + length - 4, ".png") || !strcmp(filename + length - 4, ".PNG")))
+		return WritePNG(filename, pixels, width, height);
+
+	return WritePPM(filename, pixels, width, height);
+}
+
+///----------------------------------------------------------------------------
+///Reads a PPM or PNG, told apart by their signature
+///@param	filename - file to read
+///@param	pixels - receives width * height pixels, alpha set to 255
+///@param	width, height - receive the image size
+///----------------------------------------------------------------------------
+bool ImageFile::Read(const char *filename, std::vector<unsigned int> &pixels, unsigned int &width, unsigned int &height)
+{
+	FILE *file = fopen(filename, "rb");
+	if(!file)
+		return false;
+
+	unsigned char signature[8];
+	bool ok = false;
+	if(fread(signature, 1, 2, file) == 2)
+	{
+		if(signature[0] == 'P' && signature[1] == '6')
+			ok = ReadPPM(file, pixels, width, height);
+		else if(fread(signature + 2, 1, 6, file) == 6 && !memcmp(signature, PNG_SIGNATURE, 8))
+			ok = ReadPNG(file, pixels, width, height);
+	}
+
+	fclose(file);
+	return ok;
+}
+
+///----------------------------------------------------------------------------
+///Counts the pixels that differ by more than tolerance in any channel
+///@param	a, b - the two images, count pixels each
+///@param	tolerance - largest channel difference still counted as equal
+///@param	maxDifference - receives the largest channel difference, or NULL
+///@return	number of differing pixels
+///----------------------------------------------------------------------------
+unsigned int ImageFile::Compare(const unsigned int *a, const unsigned int *b, unsigned int count,
+								unsigned int tolerance, unsigned int *maxDifference)
+{
+	unsigned int differing = 0, largest = 0;
+	for(unsigned int i = 0; i < count; i++)
+	{
+		unsigned int difference = 0;
+		for(unsigned int shift = 0; shift < 24; shift += 8)
+		{
+			int ca = (a[i] >> shift) & 0xFF, cb = (b[i] >> shift) & 0xFF;
+			unsigned int d = (unsigned int)(ca > cb ? ca - cb : cb - ca);
+			if(d > difference) difference = d;
+		}
+
+		if(difference > tolerance) differing++;
+		if(difference > largest) largest = difference;
+	}
+
+	if(maxDifference)
+		*maxDifference = largest;
+	return differing;
+}
@@ -0,0 +1,26 @@
+///============================================================================
+///@file	ImageFile.h
+///@brief	Reads and writes 8-bit RGB images as binary PPM or PNG, and
+///			compares frames against reference images. Pixels are packed
+///			like D3DCOLOR (0xAARRGGBB); alpha is not stored. PNG is deflated
+///			with zlib when it is found, otherwise written with stored blocks,
+///			and only those can be read back without it.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+
+namespace ImageFile
+{
+	bool WritePPM(const char *filename, const unsigned int *pixels, unsigned int width, unsigned int height);
+	bool WritePNG(const char *filename, const unsigned int *pixels, unsigned int width, unsigned int height);
+	bool Write(const char *filename, const unsigned int *pixels, unsigned int width, unsigned int height);
+	bool Read(const char *filename, std::vector<unsigned int> &pixels, unsigned int &width, unsigned int &height);
+
+	unsigned int Compare(const unsigned int *a, const unsigned int *b, unsigned int count,
+						 unsigned int tolerance, unsigned int *maxDifference = NULL);
+}
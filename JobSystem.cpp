@@ -0,0 +1,216 @@
+///============================================================================
+///@file	JobSystem.cpp
+///@brief	Work stealing worker pool implementation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "JobSystem.h"
+
+static thread_local const JobSystem *s_Owner = NULL;	///> System the current thread works for
+static thread_local unsigned int s_WorkerIndex = 0;		///> Its worker index there
+
+///----------------------------------------------------------------------------
+///Default constructor
+///----------------------------------------------------------------------------
+JobSystem::JobSystem()
+{
+	m_Pending = 0;
+	m_Queued = 0;
+	m_NextWorker = 0;
+	m_Steals = 0;
+	m_Quit = false;
+}
+
+///----------------------------------------------------------------------------
+///Default destructor
+///----------------------------------------------------------------------------
+JobSystem::~JobSystem()
+{
+	Stop();
+}
+
+///----------------------------------------------------------------------------
+///Starts the workers
+///@param	threads - worker count, 0 for one per hardware thread but the one
+///			rendering (at least one)
+///----------------------------------------------------------------------------
+bool JobSystem::Start(unsigned int threads)
+{
+	Stop();
+
+	if(!threads)
+	{
+		unsigned int hardware = std::thread::hardware_concurrency();
+		threads = (hardware > 1) ? hardware - 1 : 1;
+	}
+
+	m_Quit = false;
+	for(unsigned int i = 0; i < threads; i++)
+		m_Workers.push_back(new Worker);
+	for(unsigned int i = 0; i < threads; i++)
+		m_Workers[i]->thread = std::thread(&JobSystem::RunWorker, this, i);
+
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Runs every job still queued, then stops and joins the workers
+///----------------------------------------------------------------------------
+void JobSystem::Stop()
+{
+	if(m_Workers.empty()) return;
+
+	{
+		std::lock_guard<std::mutex> guard(m_SleepLock);
+		m_Quit = true;
+	}
+	m_Wake.notify_all();
+
+	for(size_t i = 0; i < m_Workers.size(); i++)
+	{
+		m_Workers[i]->thread.join();
+		delete m_Workers[i];
+	}
+	m_Workers.clear();
+}
+
+///----------------------------------------------------------------------------
+///Returns true between Start and Stop
+///----------------------------------------------------------------------------
+bool JobSystem::IsRunning() const
+{
+	return !m_Workers.empty();
+}
+
+///----------------------------------------------------------------------------
+///Queues a job. Jobs submitted from a job go to the worker running it,
+///others are dealt round robin. Runs inline if the system is not running.
+///@param	function - called on a worker with data
+///@param	data - argument, must stay valid until the job runs
+///----------------------------------------------------------------------------
+void JobSystem::Submit(JobFunction function, void *data)
+{
+	if(m_Workers.empty())
+	{
+		function(data);
+		return;
+	}
+
+	Job job = { function, data };
+	unsigned int worker = (s_Owner == this) ? s_WorkerIndex : m_NextWorker++ % (unsigned int)m_Workers.size();
+
+	m_Pending++;
+	{
+		std::lock_guard<std::mutex> guard(m_Workers[worker]->lock);
+		m_Workers[worker]->jobs.push_back(job);
+		m_Queued++;
+	}
+
+	//taking the lock orders this against a worker about to sleep
+	{
+		std::lock_guard<std::mutex> guard(m_SleepLock);
+	}
+	m_Wake.notify_one();
+}
+
+///----------------------------------------------------------------------------
+///Blocks until every submitted job has finished. Must not be called from a
+///job.
+///----------------------------------------------------------------------------
+void JobSystem::Wait()
+{
+	std::unique_lock<std::mutex> lock(m_SleepLock);
+	m_Idle.wait(lock, [this]() { return m_Pending == 0; });
+}
+
+///----------------------------------------------------------------------------
+///Takes the newest job of a worker's own deque, or else the oldest job of
+///another worker
+///----------------------------------------------------------------------------
+bool JobSystem::PopJob(unsigned int worker, Job &job)
+{
+	{
+		Worker &self = *m_Workers[worker];
+		std::lock_guard<std::mutex> guard(self.lock);
+		if(!self.jobs.empty())
+		{
+			job = self.jobs.back();
+			self.jobs.pop_back();
+			m_Queued--;
+			return true;
+		}
+	}
+
+	unsigned int count = (unsigned int)m_Workers.size();
+	for(unsigned int i = 1; i < count; i++)
+	{
+		Worker &victim = *m_Workers[(worker + i) % count];
+		std::lock_guard<std::mutex> guard(victim.lock);
+		if(!victim.jobs.empty())
+		{
+			job = victim.jobs.front();
+			victim.jobs.pop_front();
+			m_Queued--;
+			m_Steals++;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+///----------------------------------------------------------------------------
+///Worker loop: run jobs while there are any, sleep otherwise
+///----------------------------------------------------------------------------
+void JobSystem::RunWorker(unsigned int worker)
+{
+	s_Owner = this;
+	s_WorkerIndex = worker;
+
+	for(;;)
+	{
+		Job job;
+		if(PopJob(worker, job))
+		{
+			job.function(job.data);
+			if(--m_Pending == 0)
+			{
+				std::lock_guard<std::mutex> guard(m_SleepLock);
+				m_Idle.notify_all();
+			}
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_SleepLock);
+		m_Wake.wait(lock, [this]() { return m_Queued > 0 || m_Quit; });
+		if(m_Quit && m_Queued == 0)
+			break;
+	}
+
+	s_Owner = NULL;
+}
+
+///----------------------------------------------------------------------------
+///Returns the number of workers
+///----------------------------------------------------------------------------
+unsigned int JobSystem::GetThreadCount() const
+{
+	return (unsigned int)m_Workers.size();
+}
+
+///----------------------------------------------------------------------------
+///Returns the number of jobs submitted but not finished
+///----------------------------------------------------------------------------
+unsigned int JobSystem::GetPendingCount() const
+{
+	return m_Pending;
+}
+
+///----------------------------------------------------------------------------
+///Returns how many jobs were stolen from another worker's deque
+///----------------------------------------------------------------------------
+unsigned long long JobSystem::GetStealCount() const
+{
+	return m_Steals;
+}
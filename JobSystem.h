@@ -0,0 +1,90 @@
+///============================================================================
+///@file	JobSystem.h
+///@brief	Background worker pool for streaming work (tile decoding, patch
+///			building). Every worker owns a deque: it runs its own jobs newest
+///			first and, once empty, steals the oldest job of another worker,
+///			so bursts of jobs spread across the pool without a shared queue.
+///			Unlike Parallel::For the submitting thread never waits for the
+///			workers.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+typedef void (*JobFunction)(void *data);
+
+class JobSystem
+{
+public:
+	//-------------------------------------------------------------------------
+	//Constructors and destructors
+	//-------------------------------------------------------------------------
+	JobSystem();
+	~JobSystem();
+
+	//-------------------------------------------------------------------------
+	//Public methods
+	//-------------------------------------------------------------------------
+	bool Start(unsigned int threads = 0);
+	void Stop();
+	bool IsRunning() const;
+	void Submit(JobFunction function, void *data);
+	void Wait();
+
+	unsigned int GetThreadCount() const;
+	unsigned int GetPendingCount() const;
+	unsigned long long GetStealCount() const;
+
+private:
+	//-------------------------------------------------------------------------
+	//A queued job
+	//-------------------------------------------------------------------------
+	struct Job
+	{
+		JobFunction		function;	///> What to run
+		void*			data;		///> Its argument
+	};
+
+	//-------------------------------------------------------------------------
+	//A worker thread and its deque
+	//-------------------------------------------------------------------------
+	struct Worker
+	{
+		std::mutex			lock;		///> Guards jobs
+		std::deque<Job>		jobs;		///> Owner pops the back, thieves the front
+		std::thread			thread;		///> The worker
+	};
+
+	//-------------------------------------------------------------------------
+	//Private methods
+	//-------------------------------------------------------------------------
+	bool PopJob(unsigned int worker, Job &job);
+	void RunWorker(unsigned int worker);
+
+	//-------------------------------------------------------------------------
+	//Non copyable
+	//-------------------------------------------------------------------------
+	JobSystem(const JobSystem&);
+	JobSystem& operator=(const JobSystem&);
+
+	//-------------------------------------------------------------------------
+	//Private members
+	//-------------------------------------------------------------------------
+	std::vector<Worker*>				m_Workers;		///> One per thread
+	std::atomic<unsigned int>			m_Pending;		///> Jobs submitted but not finished
+	std::atomic<unsigned int>			m_Queued;		///> Jobs submitted but not started
+	std::atomic<unsigned int>			m_NextWorker;	///> Round robin target of outside submissions
+	std::atomic<unsigned long long>		m_Steals;		///> Jobs run by a worker that did not own them
+	std::atomic<bool>					m_Quit;			///> Workers exit once their deques are empty
+	std::mutex							m_SleepLock;	///> Guards the sleep/wake handshake
+	std::condition_variable				m_Wake;			///> Signaled when jobs are queued
+	std::condition_variable				m_Idle;			///> Signaled when m_Pending drops to zero
+};
@@ -0,0 +1,149 @@
+///============================================================================
+///@file	LockFreeQueue.h
+///@brief	Bounded multi-producer multi-consumer queue without locks (Dmitry
+///			Vyukov's ring of sequenced cells). Producers and consumers only
+///			contend on one atomic counter each, so a worker finishing a job
+///			never blocks the render thread and vice versa.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <atomic>
+
+template <typename T>
+class LockFreeQueue
+{
+public:
+	//-------------------------------------------------------------------------
+	//Constructors and destructors
+	//-------------------------------------------------------------------------
+
+	///------------------------------------------------------------------------
+	///Creates an empty queue
+	///@param	capacity - maximum number of queued values, rounded up to a
+	///			power of two
+	///------------------------------------------------------------------------
+	explicit LockFreeQueue(size_t capacity = 256)
+	{
+		size_t size = 2;
+		while(size < capacity)
+			size <<= 1;
+
+		m_Cells = new Cell[size];
+		m_Mask = size - 1;
+		for(size_t i = 0; i < size; i++)
+			m_Cells[i].sequence.store(i, std::memory_order_relaxed);
+		m_Tail.store(0, std::memory_order_relaxed);
+		m_Head.store(0, std::memory_order_relaxed);
+	}
+
+	~LockFreeQueue()
+	{
+		delete[] m_Cells;
+	}
+
+	//-------------------------------------------------------------------------
+	//Public methods
+	//-------------------------------------------------------------------------
+
+	///------------------------------------------------------------------------
+	///Appends a value
+	///@return	false if the queue is full
+	///------------------------------------------------------------------------
+	bool Push(const T &value)
+	{
+		size_t position = m_Tail.load(std::memory_order_relaxed);
+		for(;;)
+		{
+			Cell &cell = m_Cells[position & m_Mask];
+			size_t sequence = cell.sequence.load(std::memory_order_acquire);
+			ptrdiff_t diff = (ptrdiff_t)sequence - (ptrdiff_t)position;
+
+			if(diff == 0)
+			{
+				if(m_Tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					cell.value = value;
+					cell.sequence.store(position + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if(diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				position = m_Tail.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	///------------------------------------------------------------------------
+	///Removes the oldest value
+	///@return	false if the queue is empty
+	///------------------------------------------------------------------------
+	bool Pop(T &value)
+	{
+		size_t position = m_Head.load(std::memory_order_relaxed);
+		for(;;)
+		{
+			Cell &cell = m_Cells[position & m_Mask];
+			size_t sequence = cell.sequence.load(std::memory_order_acquire);
+			ptrdiff_t diff = (ptrdiff_t)sequence - (ptrdiff_t)(position + 1);
+
+			if(diff == 0)
+			{
+				if(m_Head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					value = cell.value;
+					cell.sequence.store(position + m_Mask + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if(diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				position = m_Head.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	///Returns the maximum number of queued values
+	size_t GetCapacity() const
+	{
+		return m_Mask + 1;
+	}
+
+private:
+	//-------------------------------------------------------------------------
+	//One slot, its sequence tells whose turn it is
+	//-------------------------------------------------------------------------
+	struct Cell
+	{
+		std::atomic<size_t>	sequence;	///> Position the cell is ready for
+		T					value;		///> Queued value
+	};
+
+	//-------------------------------------------------------------------------
+	//Non copyable
+	//-------------------------------------------------------------------------
+	LockFreeQueue(const LockFreeQueue&);
+	LockFreeQueue& operator=(const LockFreeQueue&);
+
+	//-------------------------------------------------------------------------
+	//Private members
+	//-------------------------------------------------------------------------
+	Cell*				m_Cells;		///> Ring of cells
+	size_t				m_Mask;			///> Cell count - 1
+	char				m_Pad0[64];		///> Keeps producers and consumers on separate cache lines
+	std::atomic<size_t>	m_Tail;			///> Next position to push
+	char				m_Pad1[64];
+	std::atomic<size_t>	m_Head;			///> Next position to pop
+};
@@ -0,0 +1,161 @@
+///============================================================================
+///@file	MappedFile.cpp
+///@brief	Read-only memory mapped file implementation (Win32 and POSIX).
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+///----------------------------------------------------------------------------
+///Default constructor
+///----------------------------------------------------------------------------
+MappedFile::MappedFile()
+{
+	m_Data = 0;
+	m_Size = 0;
+#ifdef _WIN32
+	m_File = INVALID_HANDLE_VALUE;
+	m_Mapping = NULL;
+#else
+	m_File = -1;
+#endif
+}
+
+///----------------------------------------------------------------------------
+///Default destructor
+///----------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+///----------------------------------------------------------------------------
+///Maps the whole file read-only
+///@param	filename - name of the file to map
+///@return	false if the file does not exist, is empty or cannot be mapped
+///----------------------------------------------------------------------------
+bool MappedFile::Open(const char* filename)
+{
+	Close();
+
+#ifdef _WIN32
+	m_File = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+						 FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if(m_File == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if(!GetFileSizeEx(m_File, &size) || size.QuadPart == 0)
+	{
+		Close();
+		return false;
+	}
+	m_Size = (unsigned long long)size.QuadPart;
+
+	m_Mapping = CreateFileMappingA(m_File, NULL, PAGE_READONLY, 0, 0, NULL);
+	if(!m_Mapping)
+	{
+		Close();
+		return false;
+	}
+
+	m_Data = (const unsigned char*)MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+	m_File = open(filename, O_RDONLY);
+	if(m_File < 0)
+		return false;
+
+	struct stat st;
+	if(fstat(m_File, &st) != 0 || st.st_size == 0)
+	{
+		Close();
+		return false;
+	}
+	m_Size = (unsigned long long)st.st_size;
+
+	void *view = mmap(0, (size_t)m_Size, PROT_READ, MAP_SHARED, m_File, 0);
+	if(view != MAP_FAILED)
+	{
+		//we usually walk the whole file front to back
+		madvise(view, (size_t)m_Size, MADV_SEQUENTIAL);
+		m_Data = (const unsigned char*)view;
+	}
+#endif
+
+	if(!m_Data)
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Unmaps the view and closes the file
+///----------------------------------------------------------------------------
+void MappedFile::Close()
+{
+#ifdef _WIN32
+	if(m_Data)
+		UnmapViewOfFile(m_Data);
+
+	if(m_Mapping)
+	{
+		CloseHandle(m_Mapping);
+		m_Mapping = NULL;
+	}
+
+	if(m_File != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_File);
+		m_File = INVALID_HANDLE_VALUE;
+	}
+#else
+	if(m_Data)
+		munmap((void*)m_Data, (size_t)m_Size);
+
+	if(m_File >= 0)
+	{
+		close(m_File);
+		m_File = -1;
+	}
+#endif
+
+	m_Data = 0;
+	m_Size = 0;
+}
+
+///----------------------------------------------------------------------------
+///Returns true if a file is currently mapped
+///----------------------------------------------------------------------------
+bool MappedFile::IsOpen() const
+{
+	return m_Data != 0;
+}
+
+///----------------------------------------------------------------------------
+///Returns a pointer to the first byte of the mapped file
+///----------------------------------------------------------------------------
+const unsigned char* MappedFile::GetData() const
+{
+	return m_Data;
+}
+
+///----------------------------------------------------------------------------
+///Returns the size of the mapped file in bytes
+///----------------------------------------------------------------------------
+unsigned long long MappedFile::GetSize() const
+{
+	return m_Size;
+}
@@ -0,0 +1,49 @@
+///============================================================================
+///@file	MappedFile.h
+///@brief	Defines a read-only memory mapped file.
+///			Used to bring large height maps into memory at disk bandwidth,
+///			letting the OS page the data in instead of copying it through
+///			stream buffers.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+class MappedFile
+{
+public:
+	//-------------------------------------------------------------------------
+	//Constructors and destructors
+	//-------------------------------------------------------------------------
+	MappedFile();
+	~MappedFile();
+
+	//-------------------------------------------------------------------------
+	//Public methods
+	//-------------------------------------------------------------------------
+	bool Open(const char* filename);
+	void Close();
+	bool IsOpen() const;
+	const unsigned char* GetData() const;
+	unsigned long long GetSize() const;
+
+private:
+	//-------------------------------------------------------------------------
+	//Non copyable
+	//-------------------------------------------------------------------------
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+
+	//-------------------------------------------------------------------------
+	//Private members
+	//-------------------------------------------------------------------------
+	const unsigned char*	m_Data;		///> Start of the mapped view
+	unsigned long long		m_Size;		///> Size of the mapped view in bytes
+#ifdef _WIN32
+	void*					m_File;		///> Win32 file handle
+	void*					m_Mapping;	///> Win32 file mapping handle
+#else
+	int						m_File;		///> POSIX file descriptor
+#endif
+};
@@ -0,0 +1,132 @@
+///============================================================================
+///@file	MemoryArena.cpp
+///@brief	Linear allocator implementation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "MemoryArena.h"
+
+#include <string.h>
+#include <algorithm>
+
+//chunk headers keep the data after them aligned like the heap does
+static const size_t HEADER_SIZE = (sizeof(void*) * 2 + MemoryArena::DEFAULT_ALIGNMENT - 1) & ~(MemoryArena::DEFAULT_ALIGNMENT - 1);
+
+///----------------------------------------------------------------------------
+///Default constructor, no memory is taken until the first allocation
+///@param	chunkSize - smallest chunk taken from the heap
+///----------------------------------------------------------------------------
+MemoryArena::MemoryArena(size_t chunkSize)
+{
+	m_Chunks = NULL;
+	m_Cursor = NULL;
+	m_End = NULL;
+	m_ChunkSize = std::max(chunkSize, (size_t)DEFAULT_ALIGNMENT);
+	memset(&m_Stats, 0, sizeof(m_Stats));
+}
+
+///----------------------------------------------------------------------------
+///Default destructor
+///----------------------------------------------------------------------------
+MemoryArena::~MemoryArena()
+{
+	FreeChunks();
+}
+
+///----------------------------------------------------------------------------
+///Hands out uninitialized memory valid until the next Reset
+///@param	bytes - size of the block
+///@param	alignment - power of two the address is a multiple of
+///@return	the block, NULL if the heap is exhausted or bytes cannot be held
+///----------------------------------------------------------------------------
+void* MemoryArena::Allocate(size_t bytes, size_t alignment)
+{
+	alignment = std::max(alignment, (size_t)1);
+	unsigned char *block = (unsigned char*)(((size_t)m_Cursor + alignment - 1) & ~(alignment - 1));
+	if(!m_Chunks || block > m_End || bytes > (size_t)(m_End - block))
+	{
+		if(bytes > (size_t)-1 - alignment - HEADER_SIZE || !AddChunk(bytes + alignment))
+			return NULL;
+		block = (unsigned char*)(((size_t)m_Cursor + alignment - 1) & ~(alignment - 1));
+	}
+
+	m_Stats.used += (unsigned long long)(block + bytes - m_Cursor);
+	m_Stats.highWater = std::max(m_Stats.highWater, m_Stats.used);
+	m_Cursor = block + bytes;
+	return block;
+}
+
+///----------------------------------------------------------------------------
+///Frees every allocation at once. Memory stays with the arena; if the last
+///round needed several chunks they are replaced by one that holds them all.
+///----------------------------------------------------------------------------
+void MemoryArena::Reset()
+{
+	if(m_Chunks && m_Chunks->next)
+	{
+		size_t capacity = (size_t)m_Stats.capacity;
+		FreeChunks();
+		AddChunk(capacity);
+	}
+	else if(m_Chunks)
+	{
+		m_Cursor = (unsigned char*)m_Chunks + HEADER_SIZE;
+	}
+
+	m_Stats.used = 0;
+}
+
+///----------------------------------------------------------------------------
+///Frees every allocation and gives the memory back to the heap
+///----------------------------------------------------------------------------
+void MemoryArena::Release()
+{
+	FreeChunks();
+	m_Stats.used = 0;
+}
+
+///----------------------------------------------------------------------------
+///Current use, high-water mark and heap traffic
+///----------------------------------------------------------------------------
+const MemoryStats& MemoryArena::GetStats() const
+{
+	return m_Stats;
+}
+
+///----------------------------------------------------------------------------
+///Starts a new chunk of at least bytes, the rest of the current one is left
+///unused until the next Reset
+///----------------------------------------------------------------------------
+bool MemoryArena::AddChunk(size_t bytes)
+{
+	size_t size = std::max(bytes, m_ChunkSize);
+	Chunk *chunk = (Chunk*)::operator new(HEADER_SIZE + size, std::nothrow);
+	if(!chunk) return false;
+
+	chunk->next = m_Chunks;
+	chunk->size = size;
+	m_Chunks = chunk;
+	m_Cursor = (unsigned char*)chunk + HEADER_SIZE;
+	m_End = m_Cursor + size;
+	m_Stats.capacity += size;
+	m_Stats.systemAllocations++;
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Gives every chunk back to the heap
+///----------------------------------------------------------------------------
+void MemoryArena::FreeChunks()
+{
+	while(m_Chunks)
+	{
+		Chunk *chunk = m_Chunks;
+		m_Chunks = chunk->next;
+		::operator delete(chunk);
+	}
+
+	m_Cursor = NULL;
+	m_End = NULL;
+	m_Stats.capacity = 0;
+}
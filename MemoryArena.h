@@ -0,0 +1,105 @@
+///============================================================================
+///@file	MemoryArena.h
+///@brief	Linear (bump) allocator for transient data. Allocations are a
+///			pointer increment inside chunks taken from the heap; nothing is
+///			freed on its own, Reset hands everything back at once at the end
+///			of a frame or job. After a Reset the chunks are kept (merged into
+///			one sized to what was used), so a workload that repeats stops
+///			calling the global allocator after its first round.
+///
+///			m_Scratch.Reset();
+///			Entry *entries = m_Scratch.AllocateArray<Entry>(count);
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <new>
+#include <type_traits>
+
+//-------------------------------------------------------------------------
+//Memory use of an arena or a pool, in bytes
+//-------------------------------------------------------------------------
+struct MemoryStats
+{
+	unsigned long long	used;				///> Handed out now
+	unsigned long long	highWater;			///> Highest used seen
+	unsigned long long	capacity;			///> Taken from the heap now
+	unsigned long long	systemAllocations;	///> Calls into the global allocator so far
+};
+
+class MemoryArena
+{
+public:
+	//-------------------------------------------------------------------------
+	//Constructors and destructors
+	//-------------------------------------------------------------------------
+	explicit MemoryArena(size_t chunkSize = DEFAULT_CHUNK_SIZE);
+	~MemoryArena();
+
+	//-------------------------------------------------------------------------
+	//Public methods
+	//-------------------------------------------------------------------------
+	void* Allocate(size_t bytes, size_t alignment = DEFAULT_ALIGNMENT);
+	void Reset();
+	void Release();
+	const MemoryStats& GetStats() const;
+
+	///Allocates count default constructed values; they are never destroyed,
+	///so only types without a destructor are allowed. Returns NULL, with
+	///nothing constructed, when the memory cannot be had.
+	template <typename T>
+	T* AllocateArray(size_t count)
+	{
+		static_assert(std::is_trivially_destructible<T>::value, "arena values are never destroyed");
+		if(count > (size_t)-1 / sizeof(T))
+			return NULL;
+
+		T *values = (T*)Allocate(count * sizeof(T), alignof(T));
+		if(!values)
+			return NULL;
+
+		for(size_t i = 0; i < count; i++)
+			new(values + i) T();
+		return values;
+	}
+
+	//-------------------------------------------------------------------------
+	//Public members
+	//-------------------------------------------------------------------------
+	static const size_t DEFAULT_CHUNK_SIZE = 64 << 10;	///> Smallest chunk taken from the heap
+	static const size_t DEFAULT_ALIGNMENT = 16;			///> Alignment of Allocate unless asked
+
+private:
+	//-------------------------------------------------------------------------
+	//Header in front of each chunk, chunks are linked newest first
+	//-------------------------------------------------------------------------
+	struct Chunk
+	{
+		Chunk*	next;	///> Chunk filled before this one
+		size_t	size;	///> Bytes after the header
+	};
+
+	//-------------------------------------------------------------------------
+	//Private methods
+	//-------------------------------------------------------------------------
+	bool AddChunk(size_t bytes);
+	void FreeChunks();
+
+	//-------------------------------------------------------------------------
+	//Non copyable
+	//-------------------------------------------------------------------------
+	MemoryArena(const MemoryArena&);
+	MemoryArena& operator=(const MemoryArena&);
+
+	//-------------------------------------------------------------------------
+	//Private members
+	//-------------------------------------------------------------------------
+	Chunk*			m_Chunks;		///> Chunk allocated from, NULL if none
+	unsigned char*	m_Cursor;		///> Next free byte of m_Chunks
+	unsigned char*	m_End;			///> End of m_Chunks
+	size_t			m_ChunkSize;	///> Smallest chunk taken from the heap
+	MemoryStats		m_Stats;		///> Usage
+};
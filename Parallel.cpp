@@ -0,0 +1,141 @@
+///============================================================================
+///@file	Parallel.cpp
+///@brief	Parallel loop thread count and the helper threads that run the
+///			loops. One loop runs on the helpers at a time; the caller takes
+///			part as worker 0 and sleeps until the helpers are done.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "Parallel.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static unsigned int s_ThreadCount = 0;	///> 0 = one per hardware thread
+
+//-------------------------------------------------------------------------
+//Helper threads, joined at exit
+//-------------------------------------------------------------------------
+struct WorkerPool
+{
+	std::vector<std::thread>		threads;	///> Helpers, worker i + 1 is threads[i]
+	std::mutex						lock;		///> Guards everything below
+	std::condition_variable			wake;		///> Signaled when a loop starts or on exit
+	std::condition_variable			done;		///> Signaled when the last helper finishes
+	Parallel::TaskFunction			function;	///> Loop being run
+	void*							data;		///> Its argument
+	unsigned int					workers;	///> Threads of the loop, the caller included
+	unsigned int					running;	///> Helpers not finished with the loop
+	unsigned long long				loop;		///> Loops started so far
+	bool							quit;		///> Helpers exit
+
+	WorkerPool() : function(NULL), data(NULL), workers(0), running(0), loop(0), quit(false)
+	{
+	}
+
+	~WorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			quit = true;
+		}
+		wake.notify_all();
+		for(size_t i = 0; i < threads.size(); i++)
+			threads[i].join();
+	}
+};
+
+static WorkerPool s_Pool;					///> The helpers
+static std::atomic<bool> s_Busy(false);		///> A loop is running on the helpers
+
+///----------------------------------------------------------------------------
+///Helper thread: sleeps until a loop needs it, runs its share, reports back
+///@param	worker - worker index passed to the loops, 1 and up
+///----------------------------------------------------------------------------
+static void RunWorker(unsigned int worker)
+{
+	unsigned long long seen = 0;
+	std::unique_lock<std::mutex> guard(s_Pool.lock);
+	for(;;)
+	{
+		s_Pool.wake.wait(guard, [&]() { return s_Pool.quit || (s_Pool.loop != seen && worker < s_Pool.workers); });
+		if(s_Pool.quit)
+			return;
+
+		seen = s_Pool.loop;
+		Parallel::TaskFunction function = s_Pool.function;
+		void *data = s_Pool.data;
+		guard.unlock();
+
+		function(data, worker);
+
+		guard.lock();
+		if(--s_Pool.running == 0)
+			s_Pool.done.notify_one();
+	}
+}
+
+///----------------------------------------------------------------------------
+///Returns the number of threads Parallel::For uses
+///----------------------------------------------------------------------------
+unsigned int Parallel::GetThreadCount()
+{
+	if(s_ThreadCount)
+		return s_ThreadCount;
+
+	unsigned int hardware = std::thread::hardware_concurrency();
+	return hardware ? hardware : 1;
+}
+
+///----------------------------------------------------------------------------
+///Sets the number of threads Parallel::For uses, 0 for one per hardware
+///thread. Helpers already started stay asleep when fewer are needed.
+///----------------------------------------------------------------------------
+void Parallel::SetThreadCount(unsigned int threads)
+{
+	s_ThreadCount = threads;
+}
+
+///----------------------------------------------------------------------------
+///Calls function(data, worker) once on each of threads workers and returns
+///when all are done, the caller being worker 0. Helpers are started the
+///first time they are needed. When another loop holds the helpers (a
+///nested loop, or one on another thread) the caller runs as worker 0 alone,
+///so function must not rely on the other workers showing up.
+///@param	threads - workers to run on, the caller included
+///@param	function - called once per worker
+///@param	data - passed to function
+///----------------------------------------------------------------------------
+void Parallel::Run(unsigned int threads, TaskFunction function, void *data)
+{
+	bool idle = false;
+	if(threads <= 1 || !s_Busy.compare_exchange_strong(idle, true))
+	{
+		function(data, 0);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(s_Pool.lock);
+		while(s_Pool.threads.size() + 1 < threads)
+			s_Pool.threads.push_back(std::thread(RunWorker, (unsigned int)s_Pool.threads.size() + 1));
+
+		s_Pool.function = function;
+		s_Pool.data = data;
+		s_Pool.workers = threads;
+		s_Pool.running = threads - 1;
+		s_Pool.loop++;
+	}
+	s_Pool.wake.notify_all();
+
+	function(data, 0);
+
+	{
+		std::unique_lock<std::mutex> guard(s_Pool.lock);
+		s_Pool.done.wait(guard, []() { return s_Pool.running == 0; });
+	}
+	s_Busy = false;
+}
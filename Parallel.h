@@ -0,0 +1,84 @@
+///============================================================================
+///@file	Parallel.h
+///@brief	Minimal parallel loop for the bulk CPU kernels (mesh building,
+///			hierarchy precomputation, query batches). Work is handed out in
+///			chunks from a shared counter so uneven rows still balance across
+///			threads. The helper threads are started on first use and kept
+///			asleep between loops, so a small batch costs a wake-up instead
+///			of a thread creation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+#include <atomic>
+
+namespace Parallel
+{
+	typedef void (*TaskFunction)(void *data, unsigned int worker);
+
+	unsigned int GetThreadCount();
+	void SetThreadCount(unsigned int threads);
+	void Run(unsigned int threads, TaskFunction function, void *data);
+
+	//-------------------------------------------------------------------------
+	//A loop in flight, shared by the threads running it
+	//-------------------------------------------------------------------------
+	template <typename Body>
+	struct ForTask
+	{
+		Body*						body;	///> Called with each chunk
+		unsigned int				count;	///> Number of items
+		unsigned int				grain;	///> Items per chunk
+		unsigned int				chunks;	///> Number of chunks
+		std::atomic<unsigned int>	next;	///> Next chunk to hand out
+	};
+
+	///------------------------------------------------------------------------
+	///Takes chunks of a loop until none is left
+	///------------------------------------------------------------------------
+	template <typename Body>
+	void RunChunks(void *data, unsigned int worker)
+	{
+		ForTask<Body> *task = (ForTask<Body>*)data;
+		for(unsigned int chunk = task->next++; chunk < task->chunks; chunk = task->next++)
+		{
+			unsigned int begin = chunk * task->grain;
+			unsigned int end = (begin + task->grain < task->count) ? begin + task->grain : task->count;
+			(*task->body)(begin, end, worker);
+		}
+	}
+
+	///------------------------------------------------------------------------
+	///Calls body(begin, end, worker) over [0,count) in chunks of grain items.
+	///The calling thread is worker 0; worker is below GetThreadCount() and
+	///can index per-thread scratch. Runs inline when one thread is enough,
+	///and when called from inside another loop or while one runs elsewhere.
+	///@param	count - number of items
+	///@param	grain - items per chunk
+	///@param	body - functor called with each chunk
+	///------------------------------------------------------------------------
+	template <typename Body>
+	void For(unsigned int count, unsigned int grain, Body body)
+	{
+		if(grain < 1) grain = 1;
+		unsigned int chunks = (count + grain - 1) / grain;
+		unsigned int threads = GetThreadCount();
+		if(threads > chunks) threads = chunks;
+
+		if(threads <= 1)
+		{
+			if(count) body(0u, count, 0u);
+			return;
+		}
+
+		ForTask<Body> task;
+		task.body = &body;
+		task.count = count;
+		task.grain = grain;
+		task.chunks = chunks;
+		task.next = 0;
+		Run(threads, RunChunks<Body>, &task);
+	}
+}
@@ -0,0 +1,459 @@
+///============================================================================
+///@file	Profiler.cpp
+///@brief	Frame profiler implementation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "Profiler.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+//-------------------------------------------------------------------------
+//A zone event as the owning thread writes it
+//-------------------------------------------------------------------------
+struct ProfileEvent
+{
+	unsigned long long	start;	///> Start tick
+	unsigned long long	end;	///> End tick
+	unsigned int		zone;	///> Zone id
+};
+
+//-------------------------------------------------------------------------
+//Single producer ring of one thread. The owner writes the slot, then
+//publishes it by bumping head; Collect reads up to head and drops what the
+//owner lapped meanwhile.
+//-------------------------------------------------------------------------
+struct ProfileRing
+{
+	ProfileEvent					events[Profiler::RING_SIZE];	///> Event slots
+	std::atomic<unsigned long long>	head;		///> Events ever written
+	unsigned long long				tail;		///> Events drained, Collect only
+	std::atomic<bool>				owned;		///> A live thread writes into it
+	unsigned int					thread;		///> Trace thread id
+};
+
+//-------------------------------------------------------------------------
+//Hands the ring back when its thread exits, for the next thread to reuse
+//-------------------------------------------------------------------------
+struct ProfileRingOwner
+{
+	ProfileRing*	ring;	///> Ring of this thread, NULL until its first event
+
+	ProfileRingOwner() { ring = NULL; }
+	~ProfileRingOwner() { if(ring) ring->owned.store(false, std::memory_order_release); }
+};
+
+//-------------------------------------------------------------------------
+//What is kept of a zone
+//-------------------------------------------------------------------------
+struct ProfileZone
+{
+	const char*						name;		///> Name given to RegisterZone
+	unsigned long long				count;		///> Events drained
+	double							sum;		///> Total ticks
+	unsigned long long				max;		///> Longest event, ticks
+	std::vector<unsigned long long>	window;		///> Last WINDOW_SIZE durations, ticks
+};
+
+//-------------------------------------------------------------------------
+//An event kept for the trace
+//-------------------------------------------------------------------------
+struct ProfileTraceEvent
+{
+	unsigned long long	start;	///> Start tick
+	unsigned long long	end;	///> End tick
+	unsigned int		zone;	///> Zone id
+	unsigned int		thread;	///> Ring it came from
+};
+
+typedef std::chrono::steady_clock ProfileClock;
+
+static std::atomic<bool> s_Enabled(true);				///> Scopes record events
+static std::mutex s_Lock;								///> Guards everything below
+static std::vector<ProfileRing*> s_Rings;				///> Every ring handed out
+static std::vector<ProfileZone> s_Zones;				///> Registered zones, FRAME_ZONE first
+static std::vector<ProfileTraceEvent> s_Trace;			///> Last TRACE_SIZE events
+static size_t s_TraceNext = 0;							///> Oldest trace slot once full
+static std::vector<ProfileEvent> s_Scratch;				///> Events being drained
+static std::vector<unsigned long long> s_Sorted;		///> Window being sorted
+static unsigned long long s_Dropped = 0;				///> Events lost to full rings
+static unsigned long long s_LastFrame = 0;				///> Tick of the last EndFrame
+static unsigned long long s_BaseTicks = 0;				///> Tick of the calibration start
+static ProfileClock::time_point s_BaseTime;				///> Clock at the calibration start
+static double s_NanosecondsPerTick = 1.0;				///> Tick length
+static thread_local ProfileRingOwner s_RingOwner;		///> Ring of the calling thread
+
+///----------------------------------------------------------------------------
+///Sets up the frame zone and times the tick against the steady clock for a
+///millisecond, Collect refines it as time passes. Needs s_Lock.
+///----------------------------------------------------------------------------
+static void Initialize()
+{
+	if(!s_Zones.empty())
+		return;
+
+	//sized up front, so steady state frames allocate nothing
+	ProfileZone frame = { "frame", 0, 0.0, 0, std::vector<unsigned long long>() };
+	s_Zones.push_back(frame);
+	s_Zones.back().window.reserve(Profiler::WINDOW_SIZE);
+	s_Trace.reserve(Profiler::TRACE_SIZE);
+	s_Scratch.reserve(Profiler::RING_SIZE);
+	s_Sorted.reserve(Profiler::WINDOW_SIZE);
+
+	s_BaseTime = ProfileClock::now();
+	s_BaseTicks = Profiler::GetTicks();
+	ProfileClock::time_point now;
+	do
+		now = ProfileClock::now();
+	while(now - s_BaseTime < std::chrono::milliseconds(1));
+
+	unsigned long long ticks = Profiler::GetTicks() - s_BaseTicks;
+	double elapsed = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(now - s_BaseTime).count();
+	s_NanosecondsPerTick = ticks ? elapsed / (double)ticks : 1.0;
+}
+
+///----------------------------------------------------------------------------
+///Gives the calling thread a ring, reusing one whose thread has exited
+///----------------------------------------------------------------------------
+static ProfileRing* AttachThread()
+{
+	std::lock_guard<std::mutex> guard(s_Lock);
+	Initialize();
+
+	ProfileRing *ring = NULL;
+	for(size_t i = 0; i < s_Rings.size() && !ring; i++)
+	{
+		bool expected = false;
+		if(s_Rings[i]->owned.compare_exchange_strong(expected, true, std::memory_order_acquire))
+			ring = s_Rings[i];
+	}
+
+	if(!ring)
+	{
+		ring = new ProfileRing;
+		ring->head.store(0, std::memory_order_relaxed);
+		ring->tail = 0;
+		ring->owned.store(true, std::memory_order_relaxed);
+		ring->thread = (unsigned int)s_Rings.size();
+		s_Rings.push_back(ring);
+	}
+
+	s_RingOwner.ring = ring;
+	return ring;
+}
+
+///----------------------------------------------------------------------------
+///Adds a drained event to its zone and the trace. Needs s_Lock.
+///----------------------------------------------------------------------------
+static void AddEvent(const ProfileEvent &event, unsigned int thread)
+{
+	if(event.zone >= s_Zones.size() || event.end < event.start)
+		return;
+
+	ProfileZone &zone = s_Zones[event.zone];
+	unsigned long long duration = event.end - event.start;
+	if(zone.window.size() < Profiler::WINDOW_SIZE)
+		zone.window.push_back(duration);
+	else
+		zone.window[zone.count % Profiler::WINDOW_SIZE] = duration;
+	zone.count++;
+	zone.sum += (double)duration;
+	zone.max = std::max(zone.max, duration);
+
+	ProfileTraceEvent traced = { event.start, event.end, event.zone, thread };
+	if(s_Trace.size() < Profiler::TRACE_SIZE)
+		s_Trace.push_back(traced);
+	else
+	{
+		s_Trace[s_TraceNext] = traced;
+		s_TraceNext = (s_TraceNext + 1) % Profiler::TRACE_SIZE;
+	}
+}
+
+///----------------------------------------------------------------------------
+///Drains every ring. Needs s_Lock.
+///----------------------------------------------------------------------------
+static void Drain()
+{
+	for(size_t r = 0; r < s_Rings.size(); r++)
+	{
+		ProfileRing &ring = *s_Rings[r];
+		unsigned long long head = ring.head.load(std::memory_order_acquire);
+		unsigned long long tail = ring.tail;
+		if(head - tail > Profiler::RING_SIZE)
+		{
+			s_Dropped += head - tail - Profiler::RING_SIZE;
+			tail = head - Profiler::RING_SIZE;
+		}
+
+		s_Scratch.clear();
+		for(unsigned long long i = tail; i < head; i++)
+			s_Scratch.push_back(ring.events[i & (Profiler::RING_SIZE - 1)]);
+
+		//slots the owner reused while they were copied are not trusted
+		unsigned long long written = ring.head.load(std::memory_order_acquire);
+		unsigned long long valid = (written > Profiler::RING_SIZE) ? written - Profiler::RING_SIZE : 0;
+		valid = std::max(valid, tail);
+		if(valid > head)
+			valid = head;
+		s_Dropped += valid - tail;
+
+		for(unsigned long long i = valid; i < head; i++)
+			AddEvent(s_Scratch[(size_t)(i - tail)], ring.thread);
+		ring.tail = head;
+	}
+
+	//the longer the baseline the better the tick length
+	ProfileClock::time_point now = ProfileClock::now();
+	unsigned long long ticks = Profiler::GetTicks() - s_BaseTicks;
+	if(ticks && now - s_BaseTime > std::chrono::milliseconds(100))
+		s_NanosecondsPerTick = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(now - s_BaseTime).count() / (double)ticks;
+}
+
+///----------------------------------------------------------------------------
+///Nearest rank q quantile of sorted durations
+///----------------------------------------------------------------------------
+static double Percentile(const std::vector<unsigned long long> &sorted, double q)
+{
+	if(sorted.empty()) return 0.0;
+	size_t rank = (size_t)(q * (double)sorted.size() + 0.5);
+	if(rank > 0) rank--;
+	return (double)sorted[std::min(rank, sorted.size() - 1)];
+}
+
+///----------------------------------------------------------------------------
+///Turns recording on or off, on by default
+///----------------------------------------------------------------------------
+void Profiler::SetEnabled(bool enable)
+{
+	s_Enabled.store(enable, std::memory_order_relaxed);
+}
+
+///----------------------------------------------------------------------------
+///True if scopes record events
+///----------------------------------------------------------------------------
+bool Profiler::IsEnabled()
+{
+	return s_Enabled.load(std::memory_order_relaxed);
+}
+
+///----------------------------------------------------------------------------
+///Returns the id of a zone, registering it the first time. PROFILE_ZONE
+///calls it once per site.
+///@param	name - zone name, must stay valid (a string literal)
+///----------------------------------------------------------------------------
+unsigned int Profiler::RegisterZone(const char *name)
+{
+	std::lock_guard<std::mutex> guard(s_Lock);
+	Initialize();
+
+	for(size_t i = 0; i < s_Zones.size(); i++)
+		if(!strcmp(s_Zones[i].name, name))
+			return (unsigned int)i;
+
+	ProfileZone zone = { name, 0, 0.0, 0, std::vector<unsigned long long>() };
+	s_Zones.push_back(zone);
+	s_Zones.back().window.reserve(WINDOW_SIZE);
+	return (unsigned int)s_Zones.size() - 1;
+}
+
+///----------------------------------------------------------------------------
+///Number of zones, FRAME_ZONE included
+///----------------------------------------------------------------------------
+unsigned int Profiler::GetZoneCount()
+{
+	std::lock_guard<std::mutex> guard(s_Lock);
+	Initialize();
+	return (unsigned int)s_Zones.size();
+}
+
+///----------------------------------------------------------------------------
+///Name of a zone, or NULL
+///----------------------------------------------------------------------------
+const char* Profiler::GetZoneName(unsigned int zone)
+{
+	std::lock_guard<std::mutex> guard(s_Lock);
+	return (zone < s_Zones.size()) ? s_Zones[zone].name : NULL;
+}
+
+///----------------------------------------------------------------------------
+///Writes an event into the calling thread's ring. Lock free; if the ring
+///was not drained for RING_SIZE events the oldest are lost.
+///@param	zone - zone id
+///@param	start - start tick
+///@param	end - end tick
+///----------------------------------------------------------------------------
+void Profiler::Record(unsigned int zone, unsigned long long start, unsigned long long end)
+{
+	ProfileRing *ring = s_RingOwner.ring;
+	if(!ring)
+		ring = AttachThread();
+
+	unsigned long long head = ring->head.load(std::memory_order_relaxed);
+	ProfileEvent &event = ring->events[head & (RING_SIZE - 1)];
+	event.start = start;
+	event.end = end;
+	event.zone = zone;
+	ring->head.store(head + 1, std::memory_order_release);
+}
+
+///----------------------------------------------------------------------------
+///Ends a frame: records it in FRAME_ZONE (from the previous call) and
+///drains the rings. Call once per frame from the render thread.
+///----------------------------------------------------------------------------
+void Profiler::EndFrame()
+{
+	unsigned long long now = GetTicks();
+	if(s_LastFrame && IsEnabled())
+		Record(FRAME_ZONE, s_LastFrame, now);
+	s_LastFrame = now;
+
+	Collect();
+}
+
+///----------------------------------------------------------------------------
+///Drains the rings into the zone statistics and the trace
+///----------------------------------------------------------------------------
+void Profiler::Collect()
+{
+	std::lock_guard<std::mutex> guard(s_Lock);
+	Initialize();
+	Drain();
+}
+
+///----------------------------------------------------------------------------
+///Forgets every event recorded so far, zones stay registered
+///----------------------------------------------------------------------------
+void Profiler::Reset()
+{
+	std::lock_guard<std::mutex> guard(s_Lock);
+	for(size_t r = 0; r < s_Rings.size(); r++)
+		s_Rings[r]->tail = s_Rings[r]->head.load(std::memory_order_acquire);
+
+	for(size_t i = 0; i < s_Zones.size(); i++)
+	{
+		s_Zones[i].count = 0;
+		s_Zones[i].sum = 0.0;
+		s_Zones[i].max = 0;
+		s_Zones[i].window.clear();
+	}
+
+	s_Trace.clear();
+	s_TraceNext = 0;
+	s_Dropped = 0;
+	s_LastFrame = 0;
+}
+
+///----------------------------------------------------------------------------
+///Statistics of a zone over the events drained so far
+///@param	zone - zone id
+///@param	stats - receives the statistics, in nanoseconds
+///@return	false if the zone does not exist
+///----------------------------------------------------------------------------
+bool Profiler::GetZoneStats(unsigned int zone, ProfileZoneStats &stats)
+{
+	std::lock_guard<std::mutex> guard(s_Lock);
+	if(zone >= s_Zones.size())
+		return false;
+
+	const ProfileZone &data = s_Zones[zone];
+	std::vector<unsigned long long> &sorted = s_Sorted;
+	sorted.assign(data.window.begin(), data.window.end());
+	std::sort(sorted.begin(), sorted.end());
+
+	stats.name = data.name;
+	stats.count = data.count;
+	stats.mean = data.count ? data.sum / (double)data.count * s_NanosecondsPerTick : 0.0;
+	stats.p50 = Percentile(sorted, 0.50) * s_NanosecondsPerTick;
+	stats.p95 = Percentile(sorted, 0.95) * s_NanosecondsPerTick;
+	stats.p99 = Percentile(sorted, 0.99) * s_NanosecondsPerTick;
+	stats.max = (double)data.max * s_NanosecondsPerTick;
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Histogram of the last WINDOW_SIZE durations of a zone
+///@param	zone - zone id, FRAME_ZONE for frame times
+///@param	binWidth - nanoseconds per bin
+///@param	binCount - bins, the last one also counts everything longer
+///@param	counts - receives binCount counts
+///@return	durations counted
+///----------------------------------------------------------------------------
+unsigned int Profiler::GetHistogram(unsigned int zone, double binWidth, unsigned int binCount, unsigned int *counts)
+{
+	if(!binCount || !counts || binWidth <= 0.0)
+		return 0;
+
+	memset(counts, 0, binCount * sizeof(unsigned int));
+	std::lock_guard<std::mutex> guard(s_Lock);
+	if(zone >= s_Zones.size())
+		return 0;
+
+	const std::vector<unsigned long long> &window = s_Zones[zone].window;
+	double scale = s_NanosecondsPerTick / binWidth;
+	for(size_t i = 0; i < window.size(); i++)
+	{
+		double bin = (double)window[i] * scale;
+		counts[bin < (double)(binCount - 1) ? (unsigned int)bin : binCount - 1]++;
+	}
+	return (unsigned int)window.size();
+}
+
+///----------------------------------------------------------------------------
+///Events lost because a thread filled its ring between two drains
+///----------------------------------------------------------------------------
+unsigned long long Profiler::GetDroppedCount()
+{
+	std::lock_guard<std::mutex> guard(s_Lock);
+	return s_Dropped;
+}
+
+///----------------------------------------------------------------------------
+///Length of a GetTicks() tick in nanoseconds
+///----------------------------------------------------------------------------
+double Profiler::GetNanosecondsPerTick()
+{
+	std::lock_guard<std::mutex> guard(s_Lock);
+	Initialize();
+	return s_NanosecondsPerTick;
+}
+
+///----------------------------------------------------------------------------
+///Writes the last TRACE_SIZE drained events in the Chrome trace event
+///format (chrome://tracing, Perfetto), one track per thread
+///@param	filename - output file
+///@return	false if it cannot be written
+///----------------------------------------------------------------------------
+bool Profiler::WriteChromeTrace(const char *filename)
+{
+	std::lock_guard<std::mutex> guard(s_Lock);
+	FILE *out = fopen(filename, "w");
+	if(!out)
+		return false;
+
+	fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	for(size_t r = 0; r < s_Rings.size(); r++)
+		fprintf(out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s %u\"}},\n",
+				s_Rings[r]->thread, r ? "thread" : "main", s_Rings[r]->thread);
+
+	double microseconds = s_NanosecondsPerTick * 1e-3;
+	for(size_t n = 0; n < s_Trace.size(); n++)
+	{
+		const ProfileTraceEvent &event = s_Trace[(s_TraceNext + n) % s_Trace.size()];
+		fprintf(out, "{\"name\":\"");
+		for(const char *c = s_Zones[event.zone].name; *c; c++)
+			fprintf(out, (*c == '"' || *c == '\\') ? "\\%c" : "%c", *c);
+		fprintf(out, "\",\"cat\":\"terrain\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f},\n", event.thread,
+				(double)(long long)(event.start - s_BaseTicks) * microseconds, (double)(event.end - event.start) * microseconds);
+	}
+
+	//the array cannot end with a comma
+	fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"terrain\"}}\n]}\n");
+	return fclose(out) == 0;
+}
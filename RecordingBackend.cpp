@@ -0,0 +1,262 @@
+///============================================================================
+///@file	RecordingBackend.cpp
+///@brief	Null render backend implementation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "RecordingBackend.h"
+
+///----------------------------------------------------------------------------
+///Default constructor
+///----------------------------------------------------------------------------
+RecordingBackend::RecordingBackend()
+{
+	m_VertexBuffer = 0;
+	m_IndexBuffer = 0;
+	m_InvalidDraws = 0;
+	m_Recording = false;
+}
+
+///----------------------------------------------------------------------------
+///Default destructor
+///----------------------------------------------------------------------------
+RecordingBackend::~RecordingBackend()
+{
+}
+
+///----------------------------------------------------------------------------
+///Creates a vertex buffer of Vertex3D
+///@param	vertexCount - vertices it holds
+///@return	the buffer, 0 if vertexCount is 0
+///----------------------------------------------------------------------------
+RenderBuffer RecordingBackend::CreateVertexBuffer(unsigned int vertexCount)
+{
+	return Allocate(vertexCount, sizeof(Vertex3D), false);
+}
+
+///----------------------------------------------------------------------------
+///Creates an index buffer
+///@param	indexCount - indices it holds
+///@param	format - INDEX_16 or INDEX_32
+///@return	the buffer, 0 if indexCount is 0
+///----------------------------------------------------------------------------
+RenderBuffer RecordingBackend::CreateIndexBuffer(unsigned int indexCount, IndexFormat format)
+{
+	return Allocate(indexCount, (unsigned int)format, true);
+}
+
+///----------------------------------------------------------------------------
+///Checks a vertex upload fits its buffer, the data is not kept
+///@return	false if it does not
+///----------------------------------------------------------------------------
+bool RecordingBackend::UpdateVertices(RenderBuffer buffer, unsigned int first, const Vertex3D *vertices, unsigned int count)
+{
+	const Buffer *target = Find(buffer);
+	if(!target || target->index || !vertices || first > target->count || count > target->count - first)
+		return false;
+
+	m_Stats.uploadBytes += (unsigned long long)count * sizeof(Vertex3D);
+	Record(COMMAND_UPDATE_BUFFER, buffer, count);
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Checks an index upload fits its buffer, the data is not kept
+///@return	false if it does not
+///----------------------------------------------------------------------------
+bool RecordingBackend::UpdateIndices(RenderBuffer buffer, unsigned int first, const void *indices, unsigned int count)
+{
+	const Buffer *target = Find(buffer);
+	if(!target || !target->index || !indices || first > target->count || count > target->count - first)
+		return false;
+
+	m_Stats.uploadBytes += (unsigned long long)count * target->stride;
+	Record(COMMAND_UPDATE_BUFFER, buffer, count);
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Frees a buffer, unbinding it if bound
+///----------------------------------------------------------------------------
+void RecordingBackend::ReleaseBuffer(RenderBuffer buffer)
+{
+	if(!Find(buffer))
+		return;
+
+	m_Buffers[buffer - 1].stride = 0;
+	m_FreeBuffers.push_back(buffer);
+	if(m_VertexBuffer == buffer) m_VertexBuffer = 0;
+	if(m_IndexBuffer == buffer) m_IndexBuffer = 0;
+}
+
+///----------------------------------------------------------------------------
+///Starts a frame: zeroes the counters and drops the recorded commands
+///@param	clearColor - recorded only
+///----------------------------------------------------------------------------
+bool RecordingBackend::BeginFrame(unsigned int clearColor)
+{
+	ResetStats();
+	m_Commands.clear();
+	m_InvalidDraws = 0;
+	Record(COMMAND_BEGIN_FRAME, clearColor);
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Ends a frame
+///----------------------------------------------------------------------------
+void RecordingBackend::EndFrame()
+{
+	Record(COMMAND_END_FRAME);
+}
+
+///----------------------------------------------------------------------------
+///Counts a transform change, the matrix is not kept
+///----------------------------------------------------------------------------
+void RecordingBackend::SetTransform(TransformType type, const float *)
+{
+	m_Stats.stateChanges++;
+	Record(COMMAND_SET_TRANSFORM, (unsigned int)type);
+}
+
+///----------------------------------------------------------------------------
+///Counts a fill mode change
+///----------------------------------------------------------------------------
+void RecordingBackend::SetFillMode(FillMode mode)
+{
+	m_Stats.stateChanges++;
+	Record(COMMAND_SET_FILL_MODE, (unsigned int)mode);
+}
+
+///----------------------------------------------------------------------------
+///Binds a vertex buffer, rebinding the bound one is not counted
+///----------------------------------------------------------------------------
+void RecordingBackend::SetVertexBuffer(RenderBuffer buffer)
+{
+	if(buffer == m_VertexBuffer)
+		return;
+
+	m_VertexBuffer = buffer;
+	m_Stats.bufferBinds++;
+	Record(COMMAND_SET_VERTEX_BUFFER, buffer);
+}
+
+///----------------------------------------------------------------------------
+///Binds an index buffer, rebinding the bound one is not counted
+///----------------------------------------------------------------------------
+void RecordingBackend::SetIndexBuffer(RenderBuffer buffer)
+{
+	if(buffer == m_IndexBuffer)
+		return;
+
+	m_IndexBuffer = buffer;
+	m_Stats.bufferBinds++;
+	Record(COMMAND_SET_INDEX_BUFFER, buffer);
+}
+
+///----------------------------------------------------------------------------
+///Counts a triangle list draw and checks it reads inside the bound buffers
+///@param	firstIndex - first index drawn
+///@param	triangleCount - triangles drawn
+///----------------------------------------------------------------------------
+void RecordingBackend::DrawIndexed(unsigned int firstIndex, unsigned int triangleCount)
+{
+	const Buffer *vertices = Find(m_VertexBuffer), *indices = Find(m_IndexBuffer);
+	if(!vertices || vertices->index || !indices || !indices->index ||
+	   firstIndex > indices->count || (unsigned long long)triangleCount * 3 > indices->count - firstIndex)
+		m_InvalidDraws++;
+
+	m_Stats.drawCalls++;
+	m_Stats.triangles += triangleCount;
+	Record(COMMAND_DRAW_INDEXED, firstIndex, triangleCount);
+}
+
+///----------------------------------------------------------------------------
+///Keeps the calls of each frame in GetCommands, off by default
+///----------------------------------------------------------------------------
+void RecordingBackend::SetRecording(bool enable)
+{
+	m_Recording = enable;
+	if(!enable)
+		std::vector<RenderCommand>().swap(m_Commands);
+}
+
+///----------------------------------------------------------------------------
+///Calls recorded since BeginFrame
+///----------------------------------------------------------------------------
+const std::vector<RenderCommand>& RecordingBackend::GetCommands() const
+{
+	return m_Commands;
+}
+
+///----------------------------------------------------------------------------
+///Draws since BeginFrame that had no buffers bound or read past the index
+///buffer
+///----------------------------------------------------------------------------
+unsigned int RecordingBackend::GetInvalidDrawCount() const
+{
+	return m_InvalidDraws;
+}
+
+///----------------------------------------------------------------------------
+///Buffers alive
+///----------------------------------------------------------------------------
+unsigned int RecordingBackend::GetBufferCount() const
+{
+	return (unsigned int)(m_Buffers.size() - m_FreeBuffers.size());
+}
+
+///----------------------------------------------------------------------------
+///Bytes a device would hold for the buffers alive
+///----------------------------------------------------------------------------
+unsigned long long RecordingBackend::GetBufferBytes() const
+{
+	unsigned long long bytes = 0;
+	for(size_t i = 0; i < m_Buffers.size(); i++)
+		bytes += (unsigned long long)m_Buffers[i].count * m_Buffers[i].stride;
+	return bytes;
+}
+
+///----------------------------------------------------------------------------
+///Takes a free slot, or a new one
+///----------------------------------------------------------------------------
+RenderBuffer RecordingBackend::Allocate(unsigned int count, unsigned int stride, bool index)
+{
+	if(!count)
+		return 0;
+
+	Buffer buffer = { count, stride, index };
+	if(!m_FreeBuffers.empty())
+	{
+		RenderBuffer handle = m_FreeBuffers.back();
+		m_FreeBuffers.pop_back();
+		m_Buffers[handle - 1] = buffer;
+		return handle;
+	}
+
+	m_Buffers.push_back(buffer);
+	return (RenderBuffer)m_Buffers.size();
+}
+
+///----------------------------------------------------------------------------
+///Returns a live buffer, or NULL
+///----------------------------------------------------------------------------
+const RecordingBackend::Buffer* RecordingBackend::Find(RenderBuffer buffer) const
+{
+	if(!buffer || buffer > m_Buffers.size() || !m_Buffers[buffer - 1].stride)
+		return NULL;
+	return &m_Buffers[buffer - 1];
+}
+
+///----------------------------------------------------------------------------
+///Appends a command when recording
+///----------------------------------------------------------------------------
+void RecordingBackend::Record(RenderCommandType type, unsigned int arg0, unsigned int arg1)
+{
+	if(!m_Recording)
+		return;
+
+	RenderCommand command = { type, { arg0, arg1 } };
+	m_Commands.push_back(command);
+}
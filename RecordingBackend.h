@@ -0,0 +1,97 @@
+///============================================================================
+///@file	RecordingBackend.h
+///@brief	Null render backend: keeps only buffer sizes, checks every draw
+///			against the bound buffers and optionally records the command
+///			stream. Frames cost only the front end's own submission work,
+///			which is what it is for (benchmarks, tests of what gets drawn).
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+#include <vector>
+#include "RenderBackend.h"
+
+//-------------------------------------------------------------------------
+//Recorded backend calls
+//-------------------------------------------------------------------------
+enum RenderCommandType
+{
+	COMMAND_BEGIN_FRAME			= 0,	///> args: clear color
+	COMMAND_END_FRAME			= 1,
+	COMMAND_SET_TRANSFORM		= 2,	///> args: TransformType
+	COMMAND_SET_FILL_MODE		= 3,	///> args: FillMode
+	COMMAND_SET_VERTEX_BUFFER	= 4,	///> args: buffer
+	COMMAND_SET_INDEX_BUFFER	= 5,	///> args: buffer
+	COMMAND_DRAW_INDEXED		= 6,	///> args: first index, triangle count
+	COMMAND_UPDATE_BUFFER		= 7		///> args: buffer, elements written
+};
+
+struct RenderCommand
+{
+	RenderCommandType	type;		///> What was called
+	unsigned int		args[2];	///> Arguments, see RenderCommandType
+};
+
+class RecordingBackend : public RenderBackend
+{
+public:
+	//-------------------------------------------------------------------------
+	//Constructors and destructors
+	//-------------------------------------------------------------------------
+	RecordingBackend();
+	virtual ~RecordingBackend();
+
+	//-------------------------------------------------------------------------
+	//Public methods
+	//-------------------------------------------------------------------------
+	virtual RenderBuffer CreateVertexBuffer(unsigned int vertexCount);
+	virtual RenderBuffer CreateIndexBuffer(unsigned int indexCount, IndexFormat format);
+	virtual bool UpdateVertices(RenderBuffer buffer, unsigned int first, const Vertex3D *vertices, unsigned int count);
+	virtual bool UpdateIndices(RenderBuffer buffer, unsigned int first, const void *indices, unsigned int count);
+	virtual void ReleaseBuffer(RenderBuffer buffer);
+
+	virtual bool BeginFrame(unsigned int clearColor);
+	virtual void EndFrame();
+	virtual void SetTransform(TransformType type, const float *matrix);
+	virtual void SetFillMode(FillMode mode);
+	virtual void SetVertexBuffer(RenderBuffer buffer);
+	virtual void SetIndexBuffer(RenderBuffer buffer);
+	virtual void DrawIndexed(unsigned int firstIndex, unsigned int triangleCount);
+
+	void SetRecording(bool enable);
+	const std::vector<RenderCommand>& GetCommands() const;
+	unsigned int GetInvalidDrawCount() const;
+	unsigned int GetBufferCount() const;
+	unsigned long long GetBufferBytes() const;
+
+private:
+	//-------------------------------------------------------------------------
+	//Private types
+	//-------------------------------------------------------------------------
+	struct Buffer
+	{
+		unsigned int	count;		///> Vertices or indices
+		unsigned int	stride;		///> Bytes per element, 0 if the slot is free
+		bool			index;		///> Index buffer, vertex buffer otherwise
+	};
+
+	//-------------------------------------------------------------------------
+	//Private methods
+	//-------------------------------------------------------------------------
+	RenderBuffer Allocate(unsigned int count, unsigned int stride, bool index);
+	const Buffer* Find(RenderBuffer buffer) const;
+	void Record(RenderCommandType type, unsigned int arg0 = 0, unsigned int arg1 = 0);
+
+	//-------------------------------------------------------------------------
+	//Private members
+	//-------------------------------------------------------------------------
+	std::vector<Buffer>			m_Buffers;		///> Buffer slots, handle = slot + 1
+	std::vector<RenderBuffer>	m_FreeBuffers;	///> Released handles
+	std::vector<RenderCommand>	m_Commands;		///> Calls since BeginFrame, if recording
+	RenderBuffer				m_VertexBuffer;	///> Bound vertex buffer
+	RenderBuffer				m_IndexBuffer;	///> Bound index buffer
+	unsigned int				m_InvalidDraws;	///> Draws outside the bound buffers since BeginFrame
+	bool						m_Recording;	///> Commands are kept
+};
@@ -0,0 +1,43 @@
+///============================================================================
+///@file	RenderBackend.cpp
+///@brief	Render backend interface, shared statistics.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "RenderBackend.h"
+
+///----------------------------------------------------------------------------
+///Default constructor
+///----------------------------------------------------------------------------
+RenderBackend::RenderBackend()
+{
+	ResetStats();
+}
+
+///----------------------------------------------------------------------------
+///Default destructor
+///----------------------------------------------------------------------------
+RenderBackend::~RenderBackend()
+{
+}
+
+///----------------------------------------------------------------------------
+///Work submitted since the last BeginFrame
+///----------------------------------------------------------------------------
+const RenderStats& RenderBackend::GetStats() const
+{
+	return m_Stats;
+}
+
+///----------------------------------------------------------------------------
+///Zeroes the frame counters, backends call it from BeginFrame
+///----------------------------------------------------------------------------
+void RenderBackend::ResetStats()
+{
+	m_Stats.drawCalls = 0;
+	m_Stats.triangles = 0;
+	m_Stats.bufferBinds = 0;
+	m_Stats.stateChanges = 0;
+	m_Stats.uploadBytes = 0;
+}
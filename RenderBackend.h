@@ -0,0 +1,109 @@
+///============================================================================
+///@file	RenderBackend.h
+///@brief	Thin interface between the terrain front ends and a graphics API:
+///			buffer creation and updates, the little state the terrain uses
+///			and indexed draw submission. Implemented by Direct3D 9 for the
+///			viewer, by the software rasterizer for headless rendering and
+///			by a recording null device that only measures submission.
+///
+///			Vertices are always Vertex3D; index buffers are 16 or 32-bit.
+///			Matrices are D3D style (row vectors, left handed).
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+#include "TerrainMesh.h"
+
+//-------------------------------------------------------------------------
+//Buffer handle, 0 is no buffer
+//-------------------------------------------------------------------------
+typedef unsigned int RenderBuffer;
+
+//-------------------------------------------------------------------------
+//How triangles are filled, same values as D3DFILLMODE
+//-------------------------------------------------------------------------
+enum FillMode
+{
+	FILL_WIREFRAME	= 2,	///> Triangle edges only
+	FILL_SOLID		= 3		///> Gouraud shaded vertex colors
+};
+
+//-------------------------------------------------------------------------
+//Index buffer formats, bytes per index
+//-------------------------------------------------------------------------
+enum IndexFormat
+{
+	INDEX_16	= 2,	///> unsigned short
+	INDEX_32	= 4		///> unsigned int
+};
+
+//-------------------------------------------------------------------------
+//Transforms, as D3DTS_WORLD, D3DTS_VIEW and D3DTS_PROJECTION
+//-------------------------------------------------------------------------
+enum TransformType
+{
+	TRANSFORM_WORLD			= 0,
+	TRANSFORM_VIEW			= 1,
+	TRANSFORM_PROJECTION	= 2
+};
+
+//-------------------------------------------------------------------------
+//Work submitted since the last BeginFrame
+//-------------------------------------------------------------------------
+struct RenderStats
+{
+	unsigned int		drawCalls;		///> DrawIndexed calls
+	unsigned long long	triangles;		///> Triangles submitted
+	unsigned int		bufferBinds;	///> Vertex and index buffer changes
+	unsigned int		stateChanges;	///> Transform and fill mode changes
+	unsigned long long	uploadBytes;	///> Bytes written into buffers
+};
+
+class RenderBackend
+{
+public:
+	//-------------------------------------------------------------------------
+	//Constructors and destructors
+	//-------------------------------------------------------------------------
+	RenderBackend();
+	virtual ~RenderBackend();
+
+	//-------------------------------------------------------------------------
+	//Public methods
+	//-------------------------------------------------------------------------
+	virtual RenderBuffer CreateVertexBuffer(unsigned int vertexCount) = 0;
+	virtual RenderBuffer CreateIndexBuffer(unsigned int indexCount, IndexFormat format) = 0;
+	virtual bool UpdateVertices(RenderBuffer buffer, unsigned int first, const Vertex3D *vertices, unsigned int count) = 0;
+	virtual bool UpdateIndices(RenderBuffer buffer, unsigned int first, const void *indices, unsigned int count) = 0;
+	virtual void ReleaseBuffer(RenderBuffer buffer) = 0;
+
+	virtual bool BeginFrame(unsigned int clearColor) = 0;
+	virtual void EndFrame() = 0;
+	virtual void SetTransform(TransformType type, const float *matrix) = 0;
+	virtual void SetFillMode(FillMode mode) = 0;
+	virtual void SetVertexBuffer(RenderBuffer buffer) = 0;
+	virtual void SetIndexBuffer(RenderBuffer buffer) = 0;
+	virtual void DrawIndexed(unsigned int firstIndex, unsigned int triangleCount) = 0;
+
+	const RenderStats& GetStats() const;
+
+protected:
+	//-------------------------------------------------------------------------
+	//Protected methods
+	//-------------------------------------------------------------------------
+	void ResetStats();
+
+	//-------------------------------------------------------------------------
+	//Protected members
+	//-------------------------------------------------------------------------
+	RenderStats		m_Stats;	///> Counters of the current frame
+
+private:
+	//-------------------------------------------------------------------------
+	//Non copyable
+	//-------------------------------------------------------------------------
+	RenderBackend(const RenderBackend&);
+	RenderBackend& operator=(const RenderBackend&);
+};
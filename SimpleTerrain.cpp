@@ -8,6 +8,10 @@
 
 #include "SimpleTerrain.h"
 
+#include <stdio.h>
+
+static const float STREAM_RADIUS = 1000.0f;	///> Tiles are paged in up to the far plane
+
 ///----------------------------------------------------------------------------
 ///Default constructor
 ///----------------------------------------------------------------------------
@@ -16,11 +20,8 @@ SimpleTerrain::SimpleTerrain()
 	DXApp::InitApp("Simple Terrain Rendering", 800, 600);
 	DXApp::SetCameraPos(D3DXVECTOR3(0.0f, 50.0f, 90.0f));
 
-	m_FPS = new TCHAR[10];
-	m_VertexBuffer = NULL;
-	m_IndexBuffer = NULL;
-	m_VertexCount = (TERRAIN_WIDTH+1) * (TERRAIN_HEIGHT+1);
-	m_PrimitiveCount = TERRAIN_WIDTH * TERRAIN_HEIGHT * 2;
+	m_IndexBuffer = 0;
+	m_ProfileFrames = 0;
 }
 
 ///----------------------------------------------------------------------------
@@ -33,12 +34,22 @@ SimpleTerrain::~SimpleTerrain()
 }
 
 ///----------------------------------------------------------------------------
-///Loads and initializes the terrain vertex & index buffers
+///Starts streaming the terrain, the first tiles show up within a few frames
 ///----------------------------------------------------------------------------
 void SimpleTerrain::InitData()
 {
+	m_Backend.Create(DXApp::GetDevice());
 	LoadHeightMap("heightmap.raw");
-	CreateTerrain();
+
+	//the overlay owns its text, nothing is allocated once frames run;
+	//lines are added in OverlayLine order
+	m_Overlay.Clear();
+	m_Overlay.AddLine(NULL);
+	m_Overlay.SetText(LINE_DEVICE, DXApp::GetAdapterIdentifier().Description);
+	m_Overlay.AddLine("%.0f FPS  %.2f ms");
+	m_Overlay.AddLine("patches %.0f  triangles %.0f  draws %.0f");
+	m_Overlay.AddLine("tiles %.0f (+%.0f)  %.1f/%.0f MB  hits %.1f%%  stalls %.0f  prefetch %.0f%% of %.0f");
+	m_Overlay.AddLine("frame p50 %.2f p99 %.2f ms  cull p95 %.1f us  lod_select p95 %.1f us  draw_submit p95 %.1f us");
 }
 
 ///----------------------------------------------------------------------------
@@ -46,129 +57,207 @@ void SimpleTerrain::InitData()
 ///----------------------------------------------------------------------------
 bool SimpleTerrain::ShutDown()
 {
-	if(m_FPS)
-	{
-		delete[] m_FPS;
-		m_FPS = NULL;
-	}
+	//what the last frames did, for chrome://tracing
+	Profiler::WriteChromeTrace("SimpleTerrain.trace.json");
+
+	//the cache waits for loads in flight, so it goes before the workers
+	m_TileCache.Close();
+	m_Jobs.Stop();
+
+	m_TileBuffers.clear();
+	m_Backend.ReleaseBuffer(m_IndexBuffer);
+	m_IndexBuffer = 0;
+	m_Backend.Release();
 
-	if(m_DeviceDesc)
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Opens the heightmap for streaming, tiles are read and meshed on the
+///worker threads as the camera needs them
+///@param	filename - name of the map to load (.raw)
+///----------------------------------------------------------------------------
+void SimpleTerrain::LoadHeightMap(const char* filename)
+{
+	if(!m_TileCache.Open(filename))
 	{
-		delete m_DeviceDesc;
-		m_DeviceDesc = NULL;
+		MessageBox(NULL, "Unable to load the height map!", "ERROR", MB_ICONERROR);
+		return;
 	}
 
-	if(m_VertexBuffer)
+	m_Jobs.Start();
+	m_TileCache.SetJobSystem(&m_Jobs);
+}
+
+///----------------------------------------------------------------------------
+///Uploads a tile: one vertex buffer per patch, plus the LOD index sets
+///all patches share the first time
+///@param	tile - a resident tile
+///----------------------------------------------------------------------------
+bool SimpleTerrain::CreateTileBuffers(const TerrainTile &tile)
+{
+	//creates our index buffer, 32-bit only when a patch has more than 64k vertices
+	if(!m_IndexBuffer)
 	{
-		m_VertexBuffer->Release();
-		m_VertexBuffer = NULL;
+		m_IndexBuffer = TerrainBuffers::CreateIndexBuffer(m_Backend, tile.terrain);
+		if(!m_IndexBuffer) return false;
 	}
 
-	if(m_IndexBuffer)
+	//the vertices were built by the workers, only the copy is left
+	if(!m_TileBuffers[tile.key].Create(m_Backend, tile.terrain, &tile.vertices[0], m_IndexBuffer))
 	{
-		m_IndexBuffer->Release();
-		m_IndexBuffer = NULL;
+		m_TileBuffers.erase(tile.key);
+		return false;
 	}
 
 	return true;
 }
 
 ///----------------------------------------------------------------------------
-///Loads the heightmap from file
-///@param	filename - name of the map to load (.raw)
+///Releases the buffers of tiles the cache has evicted
 ///----------------------------------------------------------------------------
-void SimpleTerrain::LoadHeightMap(const char* filename)
+void SimpleTerrain::ReleaseEvictedTiles()
 {
-	std::ifstream File(filename, std::ios::binary);
+	unsigned int tilesX = m_TileCache.GetTilesX();
 
-	for(unsigned y=0; y<(TERRAIN_HEIGHT+1); y++)
+	std::unordered_map<unsigned int, TerrainBuffers>::iterator it = m_TileBuffers.begin();
+	while(it != m_TileBuffers.end())
 	{
-		for(unsigned x=0; x<(TERRAIN_WIDTH+1); x++)
-		{
-			m_HeightMap[x][y] = File.get();
-		}
+		if(m_TileCache.FindTile(it->first % tilesX, it->first / tilesX))
+			++it;
+		else
+			it = m_TileBuffers.erase(it);
 	}
+}
 
-	File.close();
+///----------------------------------------------------------------------------
+///Culls the patches of one tile, picks their levels and draws them. Tiles
+///are meshed in their own space and placed with the world matrix.
+///@param	tile - an uploaded tile
+///@param	eye - camera position in terrain space
+///@param	errorScale - LOD pixels per unit at distance one
+///----------------------------------------------------------------------------
+void SimpleTerrain::RenderTile(TerrainTile &tile, const D3DXVECTOR3 &eye, float errorScale)
+{
+	D3DXMATRIX offset, tileWorld;
+	D3DXMatrixTranslation(&offset, (float)tile.originX, 0.0f, (float)tile.originZ);
+	D3DXMatrixMultiply(&tileWorld, &offset, &DXApp::GetWorldMatrix());
+	m_Backend.SetTransform(TRANSFORM_WORLD, (const float*)&tileWorld);
+
+	D3DXVECTOR3 tileEye(eye.x - (float)tile.originX, eye.y, eye.z - (float)tile.originZ);
+	m_Frustum.Extract((const float*)&tileWorld,
+					  (const float*)&DXApp::GetViewMatrix(),
+					  (const float*)&DXApp::GetProjMatrix());
+	tile.terrain.Update(m_Frustum, (const float*)&tileEye, errorScale);
+	m_TileBuffers[tile.key].Draw(tile.terrain);
 }
 
 ///----------------------------------------------------------------------------
-///Creates the terrain mesh
+///Render the mesh object
 ///----------------------------------------------------------------------------
-void SimpleTerrain::CreateTerrain()
+void SimpleTerrain::Render()
 {
-	//creates our vertex buffer
-	DXApp::GetDevice()->CreateVertexBuffer( sizeof(Vertex3D)*m_VertexCount,
-											D3DUSAGE_WRITEONLY,
-											D3DFVF_XYZ | D3DFVF_DIFFUSE,
-											D3DPOOL_MANAGED,
-											&m_VertexBuffer,
-											NULL);
-
-	Vertex3D *pVertexData = NULL;
-	m_VertexBuffer->Lock(0,0,(void **)&pVertexData,0);
-	for(unsigned z=0; z<TERRAIN_HEIGHT+1; z++)
+	//lock timer to 60 fps
+	m_Timer.Tick(/*60*/);
+	DXApp::UpdateCameraMotion(m_Timer.GetTimeElapsed());
+
+	//clear buffers and begin the scene
+	if(m_Backend.BeginFrame(D3DCOLOR_ARGB(0, 45, 50, 170)))
 	{
-		for(unsigned x=0; x<TERRAIN_WIDTH+1; x++)
+		unsigned int patches = 0;
+		if(m_TileCache.IsOpen())
 		{
-			pVertexData[x + z * (TERRAIN_WIDTH+1)].x = (float)x;
-			pVertexData[x + z * (TERRAIN_WIDTH+1)].y = (float)m_HeightMap[x][z]/10.0f;
-			pVertexData[x + z * (TERRAIN_WIDTH+1)].z = (float)z;
-			pVertexData[x + z * (TERRAIN_WIDTH+1)].color = RGB(m_HeightMap[x][z],m_HeightMap[x][z],m_HeightMap[x][z]);
+			//the camera in terrain space drives streaming, culling and LOD;
+			//the error scale is pixels per unit at distance one
+			D3DXVECTOR3 eye = DXApp::GetLocalCameraPos();
+			D3DXVECTOR3 velocity = DXApp::GetCameraVelocity();
+			D3DVIEWPORT9 viewport;
+			DXApp::GetDevice()->GetViewport(&viewport);
+			float errorScale = (float)viewport.Height * DXApp::GetProjMatrix()._22 * 0.5f;
+
+			//keep the tiles around the camera resident and fetch the ones it
+			//is heading for, loads run on the workers
+			m_TileCache.Update((const float*)&eye, STREAM_RADIUS, (const float*)&velocity);
+			ReleaseEvictedTiles();
+
+			//upload newly arrived tiles while the frame budget lasts, draw the rest
+			unsigned int tileSize = m_TileCache.GetTileSize();
+			int x0 = max((int)floorf((eye.x - STREAM_RADIUS) / tileSize), 0);
+			int z0 = max((int)floorf((eye.z - STREAM_RADIUS) / tileSize), 0);
+			int x1 = min((int)floorf((eye.x + STREAM_RADIUS) / tileSize), (int)m_TileCache.GetTilesX() - 1);
+			int z1 = min((int)floorf((eye.z + STREAM_RADIUS) / tileSize), (int)m_TileCache.GetTilesZ() - 1);
+
+			for(int z=z0; z<=z1; z++)
+			{
+				for(int x=x0; x<=x1; x++)
+				{
+					TerrainTile *tile = m_TileCache.FindTile(x, z);
+					if(!tile) continue;
+
+					if(m_TileBuffers.find(tile->key) == m_TileBuffers.end())
+					{
+						if(!m_TileCache.HasFrameTime() || !CreateTileBuffers(*tile))
+							continue;
+					}
+
+					RenderTile(*tile, eye, errorScale);
+					patches += (unsigned int)tile->terrain.GetVisiblePatches().size();
+				}
+			}
+			m_Backend.SetTransform(TRANSFORM_WORLD, (const float*)&DXApp::GetWorldMatrix());
 		}
-	}
-	m_VertexBuffer->Unlock();
-
-	//creates our index buffer
-	DXApp::GetDevice()->CreateIndexBuffer(	sizeof(short)*m_PrimitiveCount*3,
-											D3DUSAGE_WRITEONLY,
-											D3DFMT_INDEX16,
-											D3DPOOL_MANAGED,
-											&m_IndexBuffer,
-											NULL);
-
-	short *pIndexData = NULL;
-	m_IndexBuffer->Lock(0,0,(void **)&pIndexData,0);
-	for(unsigned z=0; z<TERRAIN_HEIGHT; z++)
-	{
-		for(unsigned x=0; x<TERRAIN_WIDTH; x++)
+
+		//render some info about our graphics device, the frame and the cache
+		UpdateOverlay(patches);
+		for(unsigned int i = 0; i < m_Overlay.GetLineCount(); i++)
 		{
-			*pIndexData++ = x + z * (TERRAIN_WIDTH + 1); //v1
-			*pIndexData++ = x + 1 + z * (TERRAIN_WIDTH + 1); //v2
-			*pIndexData++ = x + 1 + (z + 1) * (TERRAIN_WIDTH + 1); //v4
-			
-			*pIndexData++ = x + z * (TERRAIN_WIDTH + 1); //v1
-			*pIndexData++ = x + 1 + (z + 1) * (TERRAIN_WIDTH + 1); //v4
-			*pIndexData++ = x + (z + 1) * (TERRAIN_WIDTH + 1); //v3
+			RECT rc = {5, 5 + 20 * (LONG)i, 0, 0};
+			DXApp::RenderText(m_Overlay.GetText(i), rc, D3DCOLOR_ARGB(200,255,255,255));
 		}
 	}
-	m_IndexBuffer->Unlock();
+
+	//end the scene and swap buffers
+	m_Backend.EndFrame();
+	Profiler::EndFrame();
 }
 
 ///----------------------------------------------------------------------------
-///Render the mesh object
+///Feeds this frame's numbers to the overlay, which only formats the lines
+///whose numbers changed
+///@param	patches - patches drawn this frame
 ///----------------------------------------------------------------------------
-void SimpleTerrain::Render()
+void SimpleTerrain::UpdateOverlay(unsigned int patches)
 {
-	//lock timer to 60 fps
-	m_Timer.Tick(/*60*/);
+	m_Overlay.SetValue(LINE_FRAME, 0, (double)m_Timer.GetFrameRate());
+	m_Overlay.SetValue(LINE_FRAME, 1, m_Timer.GetTimeElapsed() * 1e3);
 
-	//clear buffers
-	DXApp::GetDevice()->Clear(0, NULL, D3DCLEAR_TARGET | D3DCLEAR_ZBUFFER, D3DCOLOR_ARGB(0, 45, 50, 170), 1.0, 0);
-	
-	DXApp::GetDevice()->BeginScene();
+	const RenderStats &render = m_Backend.GetStats();
+	m_Overlay.SetValue(LINE_DRAWS, 0, (double)patches);
+	m_Overlay.SetValue(LINE_DRAWS, 1, (double)render.triangles);
+	m_Overlay.SetValue(LINE_DRAWS, 2, (double)render.drawCalls);
+
+	if(m_TileCache.IsOpen())
 	{
-		//render some info about our graphics device
-		m_Timer.GetFrameRate(m_FPS);
-		m_DeviceDesc = strcat(GetAdapterIdentifier().Description,"\n");
-		strcat(m_DeviceDesc, m_FPS);
-		DXApp::RenderText(m_DeviceDesc);
-		DXApp::GetDevice()->SetStreamSource(0,m_VertexBuffer,0,sizeof(Vertex3D));
-		DXApp::GetDevice()->SetIndices(m_IndexBuffer);
-		DXApp::GetDevice()->DrawIndexedPrimitive(D3DPT_TRIANGLELIST,0,0,m_VertexCount,0,m_PrimitiveCount);
+		const TileCacheStats &stats = m_TileCache.GetStats();
+		double tiles[] = { (double)stats.residentTiles, (double)stats.pendingTiles, stats.residentBytes / 1048576.0,
+						   m_TileCache.GetBudget() / 1048576.0, m_TileCache.GetHitRate() * 100.0, (double)stats.stalls,
+						   m_TileCache.GetPrefetchAccuracy() * 100.0, (double)stats.prefetches };
+		m_Overlay.SetValues(LINE_TILES, tiles, sizeof(tiles) / sizeof(tiles[0]));
 	}
-	DXApp::GetDevice()->EndScene();
 
-	//swap buffers
-	DXApp::GetDevice()->Present(NULL, NULL, NULL, NULL);
+	//sorting the profiler windows every frame is not worth it
+	if(m_ProfileFrames++ % 30 == 0)
+	{
+		static const char *zones[] = { "cull", "lod_select", "draw_submit" };
+
+		ProfileZoneStats stats;
+		Profiler::GetZoneStats(Profiler::FRAME_ZONE, stats);
+		m_Overlay.SetValue(LINE_PROFILE, 0, stats.p50 * 1e-6);
+		m_Overlay.SetValue(LINE_PROFILE, 1, stats.p99 * 1e-6);
+		for(unsigned int i = 0; i < sizeof(zones) / sizeof(zones[0]); i++)
+		{
+			if(Profiler::GetZoneStats(Profiler::RegisterZone(zones[i]), stats))
+				m_Overlay.SetValue(LINE_PROFILE, 2 + i, stats.p95 * 1e-3);
+		}
+	}
 }
@@ -8,9 +8,14 @@
 
 #pragma once
 
-#include <iostream>
-#include <fstream>
+#include <unordered_map>
+#include <vector>
+#include "D3D9Backend.h"
 #include "DXApp.h"
+#include "Profiler.h"
+#include "StatsOverlay.h"
+#include "TerrainBuffers.h"
+#include "TerrainTileCache.h"
 #include "Timer.h"
 
 template <typename T> inline void SafeRelease(T& x)
@@ -22,22 +27,6 @@ template <typename T> inline void SafeRelease(T& x)
 	}
 }
 
-//-------------------------------------------------------------------------
-//Defines our custom vertex 3D structure
-//-------------------------------------------------------------------------
-class Vertex3D
-{
-public:
-	Vertex3D(float fx, float fy, float fz, DWORD diffuse = 0xFF000000)
-	{x=fx; y=fy; z=fz; color=diffuse;}
-
-	Vertex3D()
-	{x=0.0f; y=0.0f; z=0.0f; color=0xFF000000;}
-
-	float x,y,z;
-	DWORD color;
-};
-
 class SimpleTerrain : public DXApp
 {
 public:
@@ -54,25 +43,39 @@ public:
 	virtual void Render();
 	virtual bool ShutDown();
 	void LoadHeightMap(const char* filename);
-	void CreateTerrain();
 
+private:
 	//-------------------------------------------------------------------------
-	//Public members
+	//Private types
 	//-------------------------------------------------------------------------
-	static const unsigned int TERRAIN_WIDTH  = 64;	///> Height map width
-	static const unsigned int TERRAIN_HEIGHT = 64;	///> Height map height
+	enum OverlayLine
+	{
+		LINE_DEVICE,	///> Adapter description
+		LINE_FRAME,		///> Frame rate and time
+		LINE_DRAWS,		///> Visible patches and submitted work
+		LINE_TILES,		///> Tile cache
+		LINE_PROFILE	///> Frame and zone percentiles
+	};
+
+	//-------------------------------------------------------------------------
+	//Private methods
+	//-------------------------------------------------------------------------
+	bool CreateTileBuffers(const TerrainTile &tile);
+	void ReleaseEvictedTiles();
+	void RenderTile(TerrainTile &tile, const D3DXVECTOR3 &eye, float errorScale);
+	void UpdateOverlay(unsigned int patches);
 
-private:
 	//-------------------------------------------------------------------------
 	//Private members
 	//-------------------------------------------------------------------------
 	Timer m_Timer;	///> GL Application timer
-	LPTSTR m_FPS;	///> FPS information string
-	LPDIRECT3DVERTEXBUFFER9 m_VertexBuffer;
-	LPDIRECT3DINDEXBUFFER9 m_IndexBuffer;
-	DWORD m_VertexCount;
-	DWORD m_PrimitiveCount;
-	char *m_DeviceDesc;
-	unsigned char m_HeightMap[TERRAIN_WIDTH + 1][TERRAIN_HEIGHT + 1];
+	D3D9Backend m_Backend;	///> Buffers and draws go through it
+	std::unordered_map<unsigned int, TerrainBuffers> m_TileBuffers;	///> Patch vertex buffers of each uploaded tile
+	RenderBuffer m_IndexBuffer;	///> LOD index sets shared by all tiles
+	Frustum m_Frustum;	///> Camera frustum in tile space
+	JobSystem m_Jobs;	///> Reads and meshes tiles off the render thread
+	TerrainTileCache m_TileCache;	///> Tiles paged in around the camera
+	StatsOverlay m_Overlay;	///> Device, frame, tile cache and profiler lines
+	unsigned int m_ProfileFrames;	///> Frames since the profiler line was refreshed
 };
 
@@ -0,0 +1,285 @@
+///============================================================================
+///@file	SoftwareBackend.cpp
+///@brief	Software rasterizer render backend implementation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "SoftwareBackend.h"
+#include "Profiler.h"
+
+#include <string.h>
+
+///----------------------------------------------------------------------------
+///Default constructor
+///----------------------------------------------------------------------------
+SoftwareBackend::SoftwareBackend()
+{
+	static const float identity[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1};
+	for(unsigned int i = 0; i < 3; i++)
+		memcpy(m_Transforms[i], identity, sizeof(identity));
+
+	m_VertexBuffer = 0;
+	m_IndexBuffer = 0;
+	m_Pending = false;
+}
+
+///----------------------------------------------------------------------------
+///Default destructor
+///----------------------------------------------------------------------------
+SoftwareBackend::~SoftwareBackend()
+{
+	Release();
+}
+
+///----------------------------------------------------------------------------
+///Creates the frame buffers
+///@param	width - frame width in pixels
+///@param	height - frame height in pixels
+///----------------------------------------------------------------------------
+bool SoftwareBackend::Create(unsigned int width, unsigned int height)
+{
+	Release();
+	return m_Renderer.Create(width, height);
+}
+
+///----------------------------------------------------------------------------
+///Frees the frame and every buffer
+///----------------------------------------------------------------------------
+void SoftwareBackend::Release()
+{
+	m_Renderer.Release();
+	std::vector<Buffer>().swap(m_Buffers);
+	std::vector<RenderBuffer>().swap(m_FreeBuffers);
+	m_VertexBuffer = 0;
+	m_IndexBuffer = 0;
+	m_Pending = false;
+}
+
+///----------------------------------------------------------------------------
+///The rasterizer, for the frame and settings the interface has no call for
+///(lighting)
+///----------------------------------------------------------------------------
+SoftwareRenderer& SoftwareBackend::GetRenderer()
+{
+	return m_Renderer;
+}
+
+///----------------------------------------------------------------------------
+///Creates a vertex buffer of Vertex3D
+///@param	vertexCount - vertices it holds
+///@return	the buffer, 0 if vertexCount is 0
+///----------------------------------------------------------------------------
+RenderBuffer SoftwareBackend::CreateVertexBuffer(unsigned int vertexCount)
+{
+	return Allocate(vertexCount, sizeof(Vertex3D), false);
+}
+
+///----------------------------------------------------------------------------
+///Creates an index buffer
+///@param	indexCount - indices it holds
+///@param	format - INDEX_16 or INDEX_32
+///@return	the buffer, 0 if indexCount is 0
+///----------------------------------------------------------------------------
+RenderBuffer SoftwareBackend::CreateIndexBuffer(unsigned int indexCount, IndexFormat format)
+{
+	return Allocate(indexCount, (unsigned int)format, true);
+}
+
+///----------------------------------------------------------------------------
+///Copies vertices into a buffer
+///@param	buffer - vertex buffer
+///@param	first - first vertex written
+///@param	vertices - source
+///@param	count - vertices to write
+///@return	false if they do not fit
+///----------------------------------------------------------------------------
+bool SoftwareBackend::UpdateVertices(RenderBuffer buffer, unsigned int first, const Vertex3D *vertices, unsigned int count)
+{
+	return Write(buffer, false, first, vertices, count);
+}
+
+///----------------------------------------------------------------------------
+///Copies indices into a buffer, in its format
+///@see		UpdateVertices
+///----------------------------------------------------------------------------
+bool SoftwareBackend::UpdateIndices(RenderBuffer buffer, unsigned int first, const void *indices, unsigned int count)
+{
+	return Write(buffer, true, first, indices, count);
+}
+
+///----------------------------------------------------------------------------
+///Frees a buffer, queued draws reading it are drawn first
+///----------------------------------------------------------------------------
+void SoftwareBackend::ReleaseBuffer(RenderBuffer buffer)
+{
+	Buffer *target = Find(buffer);
+	if(!target)
+		return;
+
+	if(m_Pending)
+	{
+		m_Renderer.Flush();
+		m_Pending = false;
+	}
+
+	std::vector<unsigned char>().swap(target->data);
+	target->stride = 0;
+	m_FreeBuffers.push_back(buffer);
+	if(m_VertexBuffer == buffer) m_VertexBuffer = 0;
+	if(m_IndexBuffer == buffer) m_IndexBuffer = 0;
+}
+
+///----------------------------------------------------------------------------
+///Clears the frame to a color and the far plane
+///@param	clearColor - 0xAARRGGBB
+///@return	false if the frame was not created
+///----------------------------------------------------------------------------
+bool SoftwareBackend::BeginFrame(unsigned int clearColor)
+{
+	ResetStats();
+	m_Renderer.Clear(clearColor);
+	m_Pending = false;
+	return m_Renderer.GetPixels() != NULL;
+}
+
+///----------------------------------------------------------------------------
+///Draws the queued calls, the frame is then in GetRenderer().GetPixels()
+///----------------------------------------------------------------------------
+void SoftwareBackend::EndFrame()
+{
+	PROFILE_ZONE("present");
+	m_Renderer.Flush();
+	m_Pending = false;
+}
+
+///----------------------------------------------------------------------------
+///Sets one of the transforms of the next draws
+///@param	type - which transform
+///@param	matrix - row vector matrix
+///----------------------------------------------------------------------------
+void SoftwareBackend::SetTransform(TransformType type, const float *matrix)
+{
+	if((unsigned int)type > TRANSFORM_PROJECTION || !matrix)
+		return;
+
+	memcpy(m_Transforms[type], matrix, sizeof(m_Transforms[type]));
+	m_Renderer.SetTransform(m_Transforms[TRANSFORM_WORLD], m_Transforms[TRANSFORM_VIEW], m_Transforms[TRANSFORM_PROJECTION]);
+	m_Stats.stateChanges++;
+}
+
+///----------------------------------------------------------------------------
+///Sets how the next draws fill their triangles
+///----------------------------------------------------------------------------
+void SoftwareBackend::SetFillMode(FillMode mode)
+{
+	m_Renderer.SetFillMode(mode);
+	m_Stats.stateChanges++;
+}
+
+///----------------------------------------------------------------------------
+///Binds the vertex buffer of the next draws
+///----------------------------------------------------------------------------
+void SoftwareBackend::SetVertexBuffer(RenderBuffer buffer)
+{
+	if(buffer == m_VertexBuffer)
+		return;
+
+	m_VertexBuffer = buffer;
+	m_Stats.bufferBinds++;
+}
+
+///----------------------------------------------------------------------------
+///Binds the index buffer of the next draws
+///----------------------------------------------------------------------------
+void SoftwareBackend::SetIndexBuffer(RenderBuffer buffer)
+{
+	if(buffer == m_IndexBuffer)
+		return;
+
+	m_IndexBuffer = buffer;
+	m_Stats.bufferBinds++;
+}
+
+///----------------------------------------------------------------------------
+///Queues a triangle list draw from the bound buffers, draws reading past
+///the index buffer are dropped
+///@param	firstIndex - first index drawn
+///@param	triangleCount - triangles drawn
+///----------------------------------------------------------------------------
+void SoftwareBackend::DrawIndexed(unsigned int firstIndex, unsigned int triangleCount)
+{
+	Buffer *vertices = Find(m_VertexBuffer), *indices = Find(m_IndexBuffer);
+	if(!vertices || vertices->index || !indices || !indices->index ||
+	   firstIndex > indices->count || (unsigned long long)triangleCount * 3 > indices->count - firstIndex)
+		return;
+
+	const Vertex3D *vertexData = (const Vertex3D*)&vertices->data[0];
+	if(indices->stride == INDEX_16)
+		m_Renderer.DrawIndexed(vertexData, vertices->count, (const unsigned short*)&indices->data[0], firstIndex, triangleCount);
+	else
+		m_Renderer.DrawIndexed(vertexData, vertices->count, (const unsigned int*)&indices->data[0], firstIndex, triangleCount);
+
+	m_Pending = true;
+	m_Stats.drawCalls++;
+	m_Stats.triangles += triangleCount;
+}
+
+///----------------------------------------------------------------------------
+///Takes a free slot, or a new one
+///----------------------------------------------------------------------------
+RenderBuffer SoftwareBackend::Allocate(unsigned int count, unsigned int stride, bool index)
+{
+	if(!count)
+		return 0;
+
+	RenderBuffer handle;
+	if(!m_FreeBuffers.empty())
+	{
+		handle = m_FreeBuffers.back();
+		m_FreeBuffers.pop_back();
+	}
+	else
+	{
+		m_Buffers.push_back(Buffer());
+		handle = (RenderBuffer)m_Buffers.size();
+	}
+
+	Buffer &buffer = m_Buffers[handle - 1];
+	buffer.data.assign((size_t)count * stride, 0);
+	buffer.count = count;
+	buffer.stride = stride;
+	buffer.index = index;
+	return handle;
+}
+
+///----------------------------------------------------------------------------
+///Returns a live buffer, or NULL
+///----------------------------------------------------------------------------
+SoftwareBackend::Buffer* SoftwareBackend::Find(RenderBuffer buffer)
+{
+	if(!buffer || buffer > m_Buffers.size() || !m_Buffers[buffer - 1].stride)
+		return NULL;
+	return &m_Buffers[buffer - 1];
+}
+
+///----------------------------------------------------------------------------
+///Copies elements into a buffer, queued draws are drawn first so they see
+///the contents they were submitted with
+///----------------------------------------------------------------------------
+bool SoftwareBackend::Write(RenderBuffer buffer, bool index, unsigned int first, const void *data, unsigned int count)
+{
+	Buffer *target = Find(buffer);
+	if(!target || target->index != index || !data || first > target->count || count > target->count - first)
+		return false;
+
+	if(m_Pending)
+	{
+		m_Renderer.Flush();
+		m_Pending = false;
+	}
+
+	memcpy(&target->data[(size_t)first * target->stride], data, (size_t)count * target->stride);
+	m_Stats.uploadBytes += (unsigned long long)count * target->stride;
+	return true;
+}
@@ -0,0 +1,76 @@
+///============================================================================
+///@file	SoftwareBackend.h
+///@brief	Render backend drawing with the software rasterizer, for
+///			headless front ends. Buffers live in system memory; draws are
+///			queued in the rasterizer and drawn by EndFrame, or earlier if a
+///			buffer they read is about to change.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+#include <vector>
+#include "RenderBackend.h"
+#include "SoftwareRenderer.h"
+
+class SoftwareBackend : public RenderBackend
+{
+public:
+	//-------------------------------------------------------------------------
+	//Constructors and destructors
+	//-------------------------------------------------------------------------
+	SoftwareBackend();
+	virtual ~SoftwareBackend();
+
+	//-------------------------------------------------------------------------
+	//Public methods
+	//-------------------------------------------------------------------------
+	bool Create(unsigned int width, unsigned int height);
+	void Release();
+	SoftwareRenderer& GetRenderer();
+
+	virtual RenderBuffer CreateVertexBuffer(unsigned int vertexCount);
+	virtual RenderBuffer CreateIndexBuffer(unsigned int indexCount, IndexFormat format);
+	virtual bool UpdateVertices(RenderBuffer buffer, unsigned int first, const Vertex3D *vertices, unsigned int count);
+	virtual bool UpdateIndices(RenderBuffer buffer, unsigned int first, const void *indices, unsigned int count);
+	virtual void ReleaseBuffer(RenderBuffer buffer);
+
+	virtual bool BeginFrame(unsigned int clearColor);
+	virtual void EndFrame();
+	virtual void SetTransform(TransformType type, const float *matrix);
+	virtual void SetFillMode(FillMode mode);
+	virtual void SetVertexBuffer(RenderBuffer buffer);
+	virtual void SetIndexBuffer(RenderBuffer buffer);
+	virtual void DrawIndexed(unsigned int firstIndex, unsigned int triangleCount);
+
+private:
+	//-------------------------------------------------------------------------
+	//Private types
+	//-------------------------------------------------------------------------
+	struct Buffer
+	{
+		std::vector<unsigned char>	data;	///> Contents
+		unsigned int				count;	///> Vertices or indices
+		unsigned int				stride;	///> Bytes per element, 0 if the slot is free
+		bool						index;	///> Index buffer, vertex buffer otherwise
+	};
+
+	//-------------------------------------------------------------------------
+	//Private methods
+	//-------------------------------------------------------------------------
+	RenderBuffer Allocate(unsigned int count, unsigned int stride, bool index);
+	Buffer* Find(RenderBuffer buffer);
+	bool Write(RenderBuffer buffer, bool index, unsigned int first, const void *data, unsigned int count);
+
+	//-------------------------------------------------------------------------
+	//Private members
+	//-------------------------------------------------------------------------
+	SoftwareRenderer			m_Renderer;		///> Rasterizer and frame buffers
+	std::vector<Buffer>			m_Buffers;		///> Buffer slots, handle = slot + 1
+	std::vector<RenderBuffer>	m_FreeBuffers;	///> Released handles
+	float						m_Transforms[3][16];	///> World, view and projection
+	RenderBuffer				m_VertexBuffer;	///> Bound vertex buffer
+	RenderBuffer				m_IndexBuffer;	///> Bound index buffer
+	bool						m_Pending;		///> Draws queued since the last flush
+};
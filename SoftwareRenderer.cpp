@@ -0,0 +1,722 @@
+///============================================================================
+///@file	SoftwareRenderer.cpp
+///@brief	Tile based software rasterizer implementation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "SoftwareRenderer.h"
+#include "Frustum.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+//-------------------------------------------------------------------------
+//Clip space vertex with its color channels, for near plane clipping
+//-------------------------------------------------------------------------
+struct ClipVertex
+{
+	float	position[4];	///> x, y, z, w
+	float	color[4];		///> b, g, r, a in [0,255]
+};
+
+static const float IDENTITY[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1};
+
+///----------------------------------------------------------------------------
+///Frustum planes a clip space point is outside of, one bit per plane
+///----------------------------------------------------------------------------
+static unsigned int OutCode(const float *p)
+{
+	unsigned int code = 0;
+	if(p[0] < -p[3]) code |= 1;
+	if(p[0] >  p[3]) code |= 2;
+	if(p[1] < -p[3]) code |= 4;
+	if(p[1] >  p[3]) code |= 8;
+	if(p[2] < 0.0f)  code |= 16;
+	if(p[2] >  p[3]) code |= 32;
+	return code;
+}
+
+///----------------------------------------------------------------------------
+///Clamps a viewport coordinate to [low,high] before it becomes an integer,
+///corners close to the eye can land far outside the frame
+///----------------------------------------------------------------------------
+static float ClampCoordinate(float value, float low, float high)
+{
+	return value < low ? low : (value > high ? high : value);
+}
+
+///----------------------------------------------------------------------------
+///Scales the rgb channels of a 0xAARRGGBB color
+///----------------------------------------------------------------------------
+static unsigned int ShadeColor(unsigned int color, float shade)
+{
+	unsigned int result = color & 0xFF000000;
+	for(unsigned int shift = 0; shift < 24; shift += 8)
+	{
+		unsigned int channel = (unsigned int)((float)((color >> shift) & 0xFF) * shade + 0.5f);
+		result |= (channel > 255 ? 255 : channel) << shift;
+	}
+	return result;
+}
+
+///----------------------------------------------------------------------------
+///Packs four [0,255] channels (b, g, r, a) into 0xAARRGGBB
+///----------------------------------------------------------------------------
+static unsigned int PackColor(const float *color)
+{
+	unsigned int result = 0;
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		int channel = (int)(color[i] + 0.5f);
+		if(channel < 0) channel = 0;
+		if(channel > 255) channel = 255;
+		result |= (unsigned int)channel << (i * 8);
+	}
+	return result;
+}
+
+///----------------------------------------------------------------------------
+///Default constructor
+///----------------------------------------------------------------------------
+SoftwareRenderer::SoftwareRenderer()
+{
+	m_Width = 0;
+	m_Height = 0;
+	m_TilesX = 0;
+	m_TilesY = 0;
+	memcpy(m_World, IDENTITY, sizeof(m_World));
+	memcpy(m_Transform, IDENTITY, sizeof(m_Transform));
+	m_Light[0] = 0.0f;
+	m_Light[1] = -1.0f;
+	m_Light[2] = 0.0f;
+	m_Ambient = 1.0f;
+	m_Lighting = false;
+	m_FillMode = FILL_SOLID;
+	m_TriangleCount = 0;
+}
+
+///----------------------------------------------------------------------------
+///Default destructor
+///----------------------------------------------------------------------------
+SoftwareRenderer::~SoftwareRenderer()
+{
+	Release();
+}
+
+///----------------------------------------------------------------------------
+///Allocates the color and depth buffers, cleared to black and the far plane
+///@param	width - frame width in pixels
+///@param	height - frame height in pixels
+///@return	false if the size is zero
+///----------------------------------------------------------------------------
+bool SoftwareRenderer::Create(unsigned int width, unsigned int height)
+{
+	Release();
+	if(!width || !height)
+		return false;
+
+	m_Width = width;
+	m_Height = height;
+	m_TilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+	m_TilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+	m_Color.assign((size_t)width * height, 0xFF000000);
+	m_Depth.assign((size_t)width * height, 1.0f);
+	m_Bins.resize((size_t)m_TilesX * m_TilesY);
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Frees the buffers and drops pending draws
+///----------------------------------------------------------------------------
+void SoftwareRenderer::Release()
+{
+	std::vector<unsigned int>().swap(m_Color);
+	std::vector<float>().swap(m_Depth);
+	std::vector<DrawCall>().swap(m_Draws);
+	std::vector<ScreenTriangle>().swap(m_Triangles);
+	std::vector<std::vector<unsigned int> >().swap(m_Bins);
+	std::vector<std::vector<float> >().swap(m_Clip);
+	m_Width = 0;
+	m_Height = 0;
+	m_TilesX = 0;
+	m_TilesY = 0;
+	m_TriangleCount = 0;
+}
+
+///----------------------------------------------------------------------------
+///Draws what is pending and fills the whole frame
+///@param	color - clear color (0xAARRGGBB)
+///@param	depth - clear depth
+///----------------------------------------------------------------------------
+void SoftwareRenderer::Clear(unsigned int color, float depth)
+{
+	Flush();
+	std::fill(m_Color.begin(), m_Color.end(), color);
+	std::fill(m_Depth.begin(), m_Depth.end(), depth);
+}
+
+///----------------------------------------------------------------------------
+///Sets the combined transform used by the next draws, the light direction
+///is then taken in object space
+///@param	worldViewProj - world * view * projection (row vectors)
+///----------------------------------------------------------------------------
+void SoftwareRenderer::SetTransform(const float *worldViewProj)
+{
+	memcpy(m_World, IDENTITY, sizeof(m_World));
+	memcpy(m_Transform, worldViewProj, sizeof(m_Transform));
+}
+
+///----------------------------------------------------------------------------
+///Sets the transforms used by the next draws, as D3DTS_WORLD, D3DTS_VIEW and
+///D3DTS_PROJECTION would
+///@param	world - world matrix
+///@param	view - view matrix
+///@param	proj - projection matrix
+///----------------------------------------------------------------------------
+void SoftwareRenderer::SetTransform(const float *world, const float *view, const float *proj)
+{
+	memcpy(m_World, world, sizeof(m_World));
+	Frustum::Multiply(world, view, m_Transform);
+	Frustum::Multiply(m_Transform, proj, m_Transform);
+}
+
+///----------------------------------------------------------------------------
+///Sets how the next draws fill their triangles
+///@param	mode - FILL_WIREFRAME or FILL_SOLID
+///----------------------------------------------------------------------------
+void SoftwareRenderer::SetFillMode(FillMode mode)
+{
+	m_FillMode = mode;
+}
+
+///----------------------------------------------------------------------------
+///Lights the next draws with a directional light, flat per triangle. Faces
+///are taken to point up (+y) as terrain triangles do, whatever their
+///winding. Without a light vertex colors are drawn as they are, which is
+///what the viewer does (D3DRS_LIGHTING off).
+///@param	direction - direction the light travels in world space, or NULL
+///					for no lighting
+///@param	ambient - fraction of the color faces turned away still get
+///----------------------------------------------------------------------------
+void SoftwareRenderer::SetLight(const float *direction, float ambient)
+{
+	m_Lighting = false;
+	if(!direction)
+		return;
+
+	float length = sqrtf(direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]);
+	if(length <= 0.0f)
+		return;
+
+	for(unsigned int i = 0; i < 3; i++)
+		m_Light[i] = direction[i] / length;
+	m_Ambient = ambient < 0.0f ? 0.0f : (ambient > 1.0f ? 1.0f : ambient);
+	m_Lighting = true;
+}
+
+///----------------------------------------------------------------------------
+///Records an indexed triangle list draw with 16-bit indices. The buffers
+///must stay alive until the next Flush or Clear.
+///@param	vertices - vertex buffer
+///@param	vertexCount - vertices in the buffer, larger indices are skipped
+///@param	indices - index buffer
+///@param	firstIndex - first index to draw
+///@param	triangleCount - triangles to draw
+///----------------------------------------------------------------------------
+void SoftwareRenderer::DrawIndexed(const Vertex3D *vertices, unsigned int vertexCount, const unsigned short *indices,
+								   unsigned int firstIndex, unsigned int triangleCount)
+{
+	Record(vertices, vertexCount, indices, false, firstIndex, triangleCount);
+}
+
+///----------------------------------------------------------------------------
+///Records an indexed triangle list draw with 32-bit indices
+///@see		DrawIndexed
+///----------------------------------------------------------------------------
+void SoftwareRenderer::DrawIndexed(const Vertex3D *vertices, unsigned int vertexCount, const unsigned int *indices,
+								   unsigned int firstIndex, unsigned int triangleCount)
+{
+	Record(vertices, vertexCount, indices, true, firstIndex, triangleCount);
+}
+
+///----------------------------------------------------------------------------
+///Draws the recorded calls into the frame: triangles are set up per draw
+///across threads, binned into tiles in draw order and the tiles rasterized
+///in parallel
+///----------------------------------------------------------------------------
+void SoftwareRenderer::Flush()
+{
+	m_TriangleCount = 0;
+	if(m_Draws.empty())
+		return;
+
+	size_t slots = 0;
+	for(size_t i = 0; i < m_Draws.size(); i++)
+	{
+		m_Draws[i].first = slots;
+		slots += (size_t)m_Draws[i].triangleCount * 2;
+	}
+	if(m_Triangles.size() < slots)
+		m_Triangles.resize(slots);
+
+	m_Clip.resize(Parallel::GetThreadCount());
+	Parallel::For((unsigned int)m_Draws.size(), 1, [&](unsigned int begin, unsigned int end, unsigned int worker)
+	{
+		for(unsigned int i = begin; i < end; i++)
+			SetupDraw(m_Draws[i], m_Clip[worker]);
+	});
+
+	for(size_t i = 0; i < m_Bins.size(); i++)
+		m_Bins[i].clear();
+
+	const int lastTileX = (int)m_TilesX - 1, lastTileY = (int)m_TilesY - 1;
+	const float width = (float)m_Width, height = (float)m_Height;
+	for(size_t i = 0; i < m_Draws.size(); i++)
+	{
+		const DrawCall &draw = m_Draws[i];
+		for(size_t slot = draw.first; slot < draw.first + draw.count; slot++)
+		{
+			const ScreenTriangle &triangle = m_Triangles[slot];
+			float minX = std::min(triangle.x[0], std::min(triangle.x[1], triangle.x[2]));
+			float maxX = std::max(triangle.x[0], std::max(triangle.x[1], triangle.x[2]));
+			float minY = std::min(triangle.y[0], std::min(triangle.y[1], triangle.y[2]));
+			float maxY = std::max(triangle.y[0], std::max(triangle.y[1], triangle.y[2]));
+
+			//Lines round to the nearest pixel, so pad by one
+			if(maxX < -1.0f || maxY < -1.0f || minX > width + 1.0f || minY > height + 1.0f)
+				continue;
+
+			int tx0 = (int)ClampCoordinate(minX - 1.0f, 0.0f, width) / (int)TILE_SIZE;
+			int ty0 = (int)ClampCoordinate(minY - 1.0f, 0.0f, height) / (int)TILE_SIZE;
+			int tx1 = std::min((int)ClampCoordinate(maxX + 1.0f, 0.0f, width) / (int)TILE_SIZE, lastTileX);
+			int ty1 = std::min((int)ClampCoordinate(maxY + 1.0f, 0.0f, height) / (int)TILE_SIZE, lastTileY);
+
+			for(int ty = ty0; ty <= ty1; ty++)
+				for(int tx = tx0; tx <= tx1; tx++)
+					m_Bins[(size_t)ty * m_TilesX + tx].push_back((unsigned int)slot);
+			m_TriangleCount++;
+		}
+	}
+
+	Parallel::For(m_TilesX * m_TilesY, 1, [&](unsigned int begin, unsigned int end, unsigned int)
+	{
+		for(unsigned int tile = begin; tile < end; tile++)
+			RasterTile(tile);
+	});
+
+	m_Draws.clear();
+}
+
+///----------------------------------------------------------------------------
+///Width of the frame in pixels
+///----------------------------------------------------------------------------
+unsigned int SoftwareRenderer::GetWidth() const
+{
+	return m_Width;
+}
+
+///----------------------------------------------------------------------------
+///Height of the frame in pixels
+///----------------------------------------------------------------------------
+unsigned int SoftwareRenderer::GetHeight() const
+{
+	return m_Height;
+}
+
+///----------------------------------------------------------------------------
+///Color buffer, width * height pixels (0xAARRGGBB), rows top down
+///----------------------------------------------------------------------------
+const unsigned int* SoftwareRenderer::GetPixels() const
+{
+	return m_Color.empty() ? NULL : &m_Color[0];
+}
+
+///----------------------------------------------------------------------------
+///Depth buffer, width * height values
+///----------------------------------------------------------------------------
+const float* SoftwareRenderer::GetDepth() const
+{
+	return m_Depth.empty() ? NULL : &m_Depth[0];
+}
+
+///----------------------------------------------------------------------------
+///Triangles that reached the raster stage in the last Flush, after culling
+///and clipping
+///----------------------------------------------------------------------------
+unsigned int SoftwareRenderer::GetTriangleCount() const
+{
+	return m_TriangleCount;
+}
+
+///----------------------------------------------------------------------------
+///Queues a draw with a copy of the current state
+///----------------------------------------------------------------------------
+void SoftwareRenderer::Record(const Vertex3D *vertices, unsigned int vertexCount, const void *indices, bool index32,
+							  unsigned int firstIndex, unsigned int triangleCount)
+{
+	if(!vertices || !indices || !vertexCount || !triangleCount || m_Color.empty())
+		return;
+
+	DrawCall draw;
+	draw.vertices = vertices;
+	draw.vertexCount = vertexCount;
+	draw.indices = indices;
+	draw.index32 = index32;
+	draw.firstIndex = firstIndex;
+	draw.triangleCount = triangleCount;
+	memcpy(draw.transform, m_Transform, sizeof(draw.transform));
+	draw.ambient = m_Ambient;
+	draw.lighting = m_Lighting;
+	draw.fill = m_FillMode;
+	draw.first = 0;
+	draw.count = 0;
+
+	//Object space light: the world normal is n * W, so n . L = n . (W L)
+	draw.light[0] = draw.light[1] = draw.light[2] = 0.0f;
+	if(m_Lighting)
+	{
+		float length = 0.0f;
+		for(unsigned int i = 0; i < 3; i++)
+		{
+			draw.light[i] = m_World[i*4 + 0] * m_Light[0] + m_World[i*4 + 1] * m_Light[1] + m_World[i*4 + 2] * m_Light[2];
+			length += draw.light[i] * draw.light[i];
+		}
+
+		length = sqrtf(length);
+		if(length > 0.0f)
+			for(unsigned int i = 0; i < 3; i++)
+				draw.light[i] /= length;
+		else
+			draw.lighting = false;
+	}
+
+	m_Draws.push_back(draw);
+}
+
+///----------------------------------------------------------------------------
+///Transforms the vertices of a draw and sets up its triangles
+///@param	draw - draw to set up, receives the triangle count
+///@param	clip - scratch for the clip space vertices
+///----------------------------------------------------------------------------
+void SoftwareRenderer::SetupDraw(DrawCall &draw, std::vector<float> &clip)
+{
+	const float *m = draw.transform;
+	clip.resize((size_t)draw.vertexCount * 4);
+	for(unsigned int i = 0; i < draw.vertexCount; i++)
+	{
+		const Vertex3D &v = draw.vertices[i];
+		float *p = &clip[(size_t)i * 4];
+		for(unsigned int j = 0; j < 4; j++)
+			p[j] = v.x * m[j] + v.y * m[4 + j] + v.z * m[8 + j] + m[12 + j];
+	}
+
+	const unsigned short *indices16 = (const unsigned short*)draw.indices + draw.firstIndex;
+	const unsigned int *indices32 = (const unsigned int*)draw.indices + draw.firstIndex;
+	ScreenTriangle *out = &m_Triangles[draw.first];
+	unsigned int count = 0;
+
+	for(unsigned int i = 0; i < draw.triangleCount; i++)
+	{
+		unsigned int index[3];
+		for(unsigned int k = 0; k < 3; k++)
+			index[k] = draw.index32 ? indices32[i*3 + k] : indices16[i*3 + k];
+		if(index[0] >= draw.vertexCount || index[1] >= draw.vertexCount || index[2] >= draw.vertexCount)
+			continue;
+
+		const float *corners[3] = {&clip[(size_t)index[0] * 4], &clip[(size_t)index[1] * 4], &clip[(size_t)index[2] * 4]};
+		if(OutCode(corners[0]) & OutCode(corners[1]) & OutCode(corners[2]))
+			continue;
+
+		const Vertex3D &a = draw.vertices[index[0]], &b = draw.vertices[index[1]], &c = draw.vertices[index[2]];
+		unsigned int colors[3] = {a.color, b.color, c.color};
+		if(draw.lighting)
+		{
+			float e1[3] = {b.x - a.x, b.y - a.y, b.z - a.z};
+			float e2[3] = {c.x - a.x, c.y - a.y, c.z - a.z};
+			float n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+			if(n[1] < 0.0f)
+			{
+				n[0] = -n[0];
+				n[1] = -n[1];
+				n[2] = -n[2];
+			}
+
+			float length = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+			float lambert = 0.0f;
+			if(length > 0.0f)
+				lambert = -(n[0] * draw.light[0] + n[1] * draw.light[1] + n[2] * draw.light[2]) / length;
+			float shade = draw.ambient + (1.0f - draw.ambient) * (lambert > 0.0f ? lambert : 0.0f);
+			for(unsigned int k = 0; k < 3; k++)
+				colors[k] = ShadeColor(colors[k], shade);
+		}
+
+		count += SetupTriangle(draw, corners, colors, out + count);
+	}
+
+	draw.count = count;
+}
+
+///----------------------------------------------------------------------------
+///Clips a triangle against the near plane and maps it to the viewport
+///@param	draw - draw the triangle belongs to
+///@param	clip - clip space corners
+///@param	colors - corner colors
+///@param	out - receives up to two screen triangles
+///@return	screen triangles written
+///----------------------------------------------------------------------------
+unsigned int SoftwareRenderer::SetupTriangle(const DrawCall &draw, const float *const *clip, const unsigned int *colors,
+											 ScreenTriangle *out) const
+{
+	ClipVertex input[3], polygon[4];
+	for(unsigned int k = 0; k < 3; k++)
+	{
+		memcpy(input[k].position, clip[k], sizeof(input[k].position));
+		for(unsigned int c = 0; c < 4; c++)
+			input[k].color[c] = (float)((colors[k] >> (c * 8)) & 0xFF);
+	}
+
+	//Sutherland-Hodgman against z >= 0, the other planes are left to the
+	//tile bounds and the depth test
+	unsigned int count = 0;
+	for(unsigned int k = 0; k < 3; k++)
+	{
+		const ClipVertex &a = input[k], &b = input[(k + 1) % 3];
+		bool insideA = a.position[2] >= 0.0f, insideB = b.position[2] >= 0.0f;
+		if(insideA)
+			polygon[count++] = a;
+		if(insideA != insideB)
+		{
+			float t = a.position[2] / (a.position[2] - b.position[2]);
+			ClipVertex &v = polygon[count++];
+			for(unsigned int c = 0; c < 4; c++)
+			{
+				v.position[c] = a.position[c] + (b.position[c] - a.position[c]) * t;
+				v.color[c] = a.color[c] + (b.color[c] - a.color[c]) * t;
+			}
+		}
+	}
+	if(count < 3)
+		return 0;
+
+	float x[4], y[4], z[4], w[4];
+	unsigned int packed[4];
+	for(unsigned int k = 0; k < count; k++)
+	{
+		const float *p = polygon[k].position;
+		if(p[3] <= 0.0f)
+			return 0;
+
+		float inverseW = 1.0f / p[3];
+		x[k] = (p[0] * inverseW + 1.0f) * 0.5f * (float)m_Width;
+		y[k] = (1.0f - p[1] * inverseW) * 0.5f * (float)m_Height;
+		z[k] = p[2] * inverseW;
+		w[k] = inverseW;
+		packed[k] = PackColor(polygon[k].color);
+	}
+
+	unsigned int triangles = count - 2;
+	for(unsigned int t = 0; t < triangles; t++)
+	{
+		const unsigned int corner[3] = {0, t + 1, t + 2};
+		ScreenTriangle &triangle = out[t];
+		for(unsigned int k = 0; k < 3; k++)
+		{
+			triangle.x[k] = x[corner[k]];
+			triangle.y[k] = y[corner[k]];
+			triangle.z[k] = z[corner[k]];
+			triangle.w[k] = w[corner[k]];
+			triangle.color[k] = packed[corner[k]];
+		}
+		triangle.fill = draw.fill;
+	}
+
+	return triangles;
+}
+
+///----------------------------------------------------------------------------
+///Rasterizes the triangles binned into a tile, in draw order
+///@param	tile - tile index, row major
+///----------------------------------------------------------------------------
+void SoftwareRenderer::RasterTile(unsigned int tile)
+{
+	const std::vector<unsigned int> &bin = m_Bins[tile];
+	int x0 = (int)((tile % m_TilesX) * TILE_SIZE);
+	int y0 = (int)((tile / m_TilesX) * TILE_SIZE);
+	int x1 = std::min(x0 + (int)TILE_SIZE, (int)m_Width);
+	int y1 = std::min(y0 + (int)TILE_SIZE, (int)m_Height);
+
+	for(size_t i = 0; i < bin.size(); i++)
+	{
+		const ScreenTriangle &triangle = m_Triangles[bin[i]];
+		if(triangle.fill == FILL_WIREFRAME)
+		{
+			DrawLine(triangle, 0, 1, x0, y0, x1, y1);
+			DrawLine(triangle, 1, 2, x0, y0, x1, y1);
+			DrawLine(triangle, 2, 0, x0, y0, x1, y1);
+		}
+		else
+			FillTriangle(triangle, x0, y0, x1, y1);
+	}
+}
+
+///----------------------------------------------------------------------------
+///Fills the part of a triangle inside [x0,x1) x [y0,y1). Pixels are sampled
+///at their integer coordinates and shared edges drawn once (top left rule).
+///----------------------------------------------------------------------------
+void SoftwareRenderer::FillTriangle(const ScreenTriangle &triangle, int x0, int y0, int x1, int y1)
+{
+	//Wind the corners so the edge functions are positive inside
+	unsigned int v[3] = {0, 1, 2};
+	float area = (triangle.x[1] - triangle.x[0]) * (triangle.y[2] - triangle.y[0]) -
+				 (triangle.y[1] - triangle.y[0]) * (triangle.x[2] - triangle.x[0]);
+	if(area == 0.0f)
+		return;
+	if(area < 0.0f)
+	{
+		std::swap(v[1], v[2]);
+		area = -area;
+	}
+
+	const float *x = triangle.x, *y = triangle.y;
+	int minX = (int)ceilf(ClampCoordinate(std::min(x[0], std::min(x[1], x[2])), (float)x0, (float)x1));
+	int maxX = (int)floorf(ClampCoordinate(std::max(x[0], std::max(x[1], x[2])), (float)x0, (float)(x1 - 1)));
+	int minY = (int)ceilf(ClampCoordinate(std::min(y[0], std::min(y[1], y[2])), (float)y0, (float)y1));
+	int maxY = (int)floorf(ClampCoordinate(std::max(y[0], std::max(y[1], y[2])), (float)y0, (float)(y1 - 1)));
+	if(minX > maxX || minY > maxY)
+		return;
+
+	//Edge k is opposite corner k, positive inside. Both triangles sharing an
+	//edge evaluate it from the same end point with the same arithmetic,
+	//only the sign differs, so their tests agree bit for bit. Pixels
+	//exactly on it go to the triangle walking it downwards (or leftwards
+	//when flat).
+	float edgeX[3], edgeY[3], edgeDX[3], edgeDY[3], edgeSign[3];
+	bool owned[3];
+	for(unsigned int k = 0; k < 3; k++)
+	{
+		unsigned int a = v[(k + 1) % 3], b = v[(k + 2) % 3];
+		float dx = x[b] - x[a], dy = y[b] - y[a];
+		owned[k] = dy > 0.0f || (dy == 0.0f && dx < 0.0f);
+
+		bool forward = y[a] < y[b] || (y[a] == y[b] && x[a] < x[b]);
+		unsigned int from = forward ? a : b, to = forward ? b : a;
+		edgeX[k] = x[from];
+		edgeY[k] = y[from];
+		edgeDX[k] = x[to] - x[from];
+		edgeDY[k] = y[to] - y[from];
+		edgeSign[k] = forward ? 1.0f : -1.0f;
+	}
+
+	float inverseArea = 1.0f / area;
+	float z[3], w[3], color[3][4];
+	for(unsigned int k = 0; k < 3; k++)
+	{
+		z[k] = triangle.z[v[k]];
+		w[k] = triangle.w[v[k]];
+		for(unsigned int c = 0; c < 4; c++)
+			color[k][c] = (float)((triangle.color[v[k]] >> (c * 8)) & 0xFF);
+	}
+
+	for(int py = minY; py <= maxY; py++)
+	{
+		float row[3];
+		for(unsigned int k = 0; k < 3; k++)
+			row[k] = edgeDX[k] * ((float)py - edgeY[k]);
+
+		unsigned int *colorRow = &m_Color[(size_t)py * m_Width];
+		float *depthRow = &m_Depth[(size_t)py * m_Width];
+		for(int px = minX; px <= maxX; px++)
+		{
+			float e[3];
+			for(unsigned int k = 0; k < 3; k++)
+				e[k] = edgeSign[k] * (row[k] - edgeDY[k] * ((float)px - edgeX[k]));
+
+			if(e[0] < 0.0f || e[1] < 0.0f || e[2] < 0.0f)
+				continue;
+			if((e[0] == 0.0f && !owned[0]) || (e[1] == 0.0f && !owned[1]) || (e[2] == 0.0f && !owned[2]))
+				continue;
+
+			float b0 = e[0] * inverseArea, b1 = e[1] * inverseArea, b2 = e[2] * inverseArea;
+			float depth = b0 * z[0] + b1 * z[1] + b2 * z[2];
+			if(depth < 0.0f || depth > 1.0f || depth > depthRow[px])
+				continue;
+
+			float q0 = b0 * w[0], q1 = b1 * w[1], q2 = b2 * w[2];
+			float inverseQ = 1.0f / (q0 + q1 + q2);
+			q0 *= inverseQ;
+			q1 *= inverseQ;
+			q2 *= inverseQ;
+
+			float pixel[4];
+			for(unsigned int c = 0; c < 4; c++)
+				pixel[c] = q0 * color[0][c] + q1 * color[1][c] + q2 * color[2][c];
+
+			depthRow[px] = depth;
+			colorRow[px] = PackColor(pixel);
+		}
+	}
+}
+
+///----------------------------------------------------------------------------
+///Draws the part of a triangle edge inside [x0,x1) x [y0,y1), one pixel per
+///step along its major axis, depth tested
+///@param	a, b - corners the edge joins
+///----------------------------------------------------------------------------
+void SoftwareRenderer::DrawLine(const ScreenTriangle &triangle, unsigned int a, unsigned int b,
+								int x0, int y0, int x1, int y1)
+{
+	float xa = triangle.x[a], ya = triangle.y[a], xb = triangle.x[b], yb = triangle.y[b];
+	float dx = xb - xa, dy = yb - ya;
+	bool majorX = fabsf(dx) >= fabsf(dy);
+	float start = majorX ? xa : ya, delta = majorX ? dx : dy;
+	if(delta == 0.0f)
+		return;
+
+	//Steps along the major axis, clamped to the tile
+	float first = (float)(majorX ? x0 : y0), last = (float)((majorX ? x1 : y1) - 1);
+	int low = (int)ceilf(ClampCoordinate(std::min(start, start + delta), first, last + 1.0f));
+	int high = (int)floorf(ClampCoordinate(std::max(start, start + delta), first - 1.0f, last));
+
+	float colorA[4], colorB[4];
+	for(unsigned int c = 0; c < 4; c++)
+	{
+		colorA[c] = (float)((triangle.color[a] >> (c * 8)) & 0xFF);
+		colorB[c] = (float)((triangle.color[b] >> (c * 8)) & 0xFF);
+	}
+
+	float inverseDelta = 1.0f / delta;
+	for(int step = low; step <= high; step++)
+	{
+		float t = ((float)step - start) * inverseDelta;
+		int px, py;
+		if(majorX)
+		{
+			px = step;
+			py = (int)floorf(ya + dy * t + 0.5f);
+			if(py < y0 || py >= y1)
+				continue;
+		}
+		else
+		{
+			py = step;
+			px = (int)floorf(xa + dx * t + 0.5f);
+			if(px < x0 || px >= x1)
+				continue;
+		}
+
+		size_t pixel = (size_t)py * m_Width + px;
+		float depth = triangle.z[a] + (triangle.z[b] - triangle.z[a]) * t;
+		if(depth < 0.0f || depth > 1.0f || depth > m_Depth[pixel])
+			continue;
+
+		float color[4];
+		for(unsigned int c = 0; c < 4; c++)
+			color[c] = colorA[c] + (colorB[c] - colorA[c]) * t;
+
+		m_Depth[pixel] = depth;
+		m_Color[pixel] = PackColor(color);
+	}
+}
@@ -0,0 +1,130 @@
+///============================================================================
+///@file	SoftwareRenderer.h
+///@brief	Tile based software rasterizer for headless rendering (servers
+///			without a GPU, image regression runs). It takes the same data
+///			the Direct3D 9 viewer draws (Vertex3D patches, LOD index ranges
+///			and D3D style row vector matrices) and follows its conventions:
+///			clip space z in [0,1], pixel centers on integer coordinates,
+///			no back face culling, LESSEQUAL depth test, and wireframe
+///			drawing every triangle edge like D3DFILL_WIREFRAME.
+///
+///			Draw calls are only recorded; Flush transforms and clips them
+///			across threads, bins the triangles into screen tiles in draw
+///			order and rasterizes the tiles in parallel, so the image does
+///			not depend on the thread count.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+#include <vector>
+#include "RenderBackend.h"
+#include "TerrainMesh.h"
+
+class SoftwareRenderer
+{
+public:
+	//-------------------------------------------------------------------------
+	//Constructors and destructors
+	//-------------------------------------------------------------------------
+	SoftwareRenderer();
+	~SoftwareRenderer();
+
+	//-------------------------------------------------------------------------
+	//Public methods
+	//-------------------------------------------------------------------------
+	bool Create(unsigned int width, unsigned int height);
+	void Release();
+	void Clear(unsigned int color, float depth = 1.0f);
+	void SetTransform(const float *worldViewProj);
+	void SetTransform(const float *world, const float *view, const float *proj);
+	void SetFillMode(FillMode mode);
+	void SetLight(const float *direction, float ambient = 0.3f);
+	void DrawIndexed(const Vertex3D *vertices, unsigned int vertexCount, const unsigned short *indices,
+					 unsigned int firstIndex, unsigned int triangleCount);
+	void DrawIndexed(const Vertex3D *vertices, unsigned int vertexCount, const unsigned int *indices,
+					 unsigned int firstIndex, unsigned int triangleCount);
+	void Flush();
+
+	unsigned int GetWidth() const;
+	unsigned int GetHeight() const;
+	const unsigned int* GetPixels() const;
+	const float* GetDepth() const;
+	unsigned int GetTriangleCount() const;
+
+	//-------------------------------------------------------------------------
+	//Public members
+	//-------------------------------------------------------------------------
+	static const unsigned int TILE_SIZE = 64;	///> Pixels per side of a raster tile
+
+private:
+	//-------------------------------------------------------------------------
+	//Private types
+	//-------------------------------------------------------------------------
+	struct DrawCall
+	{
+		const Vertex3D*	vertices;		///> Vertex buffer
+		unsigned int	vertexCount;	///> Vertices in the buffer
+		const void*		indices;		///> Index buffer
+		bool			index32;		///> 32-bit indices, 16-bit otherwise
+		unsigned int	firstIndex;		///> First index drawn
+		unsigned int	triangleCount;	///> Triangles drawn
+		float			transform[16];	///> World * view * projection
+		float			light[3];		///> Light direction in object space
+		float			ambient;		///> Light reaching faces turned away
+		bool			lighting;		///> Faces are lit
+		FillMode		fill;			///> Fill mode
+		size_t			first;			///> First slot in m_Triangles
+		unsigned int	count;			///> Triangles left after clipping
+	};
+
+	struct ScreenTriangle
+	{
+		float			x[3];			///> Viewport x
+		float			y[3];			///> Viewport y
+		float			z[3];			///> Depth, z / w
+		float			w[3];			///> 1 / w, for perspective correct colors
+		unsigned int	color[3];		///> Vertex colors (0xAARRGGBB)
+		FillMode		fill;			///> Fill mode
+	};
+
+	//-------------------------------------------------------------------------
+	//Private methods
+	//-------------------------------------------------------------------------
+	void Record(const Vertex3D *vertices, unsigned int vertexCount, const void *indices, bool index32,
+				unsigned int firstIndex, unsigned int triangleCount);
+	void SetupDraw(DrawCall &draw, std::vector<float> &clip);
+	unsigned int SetupTriangle(const DrawCall &draw, const float *const *clip, const unsigned int *colors,
+							   ScreenTriangle *out) const;
+	void RasterTile(unsigned int tile);
+	void FillTriangle(const ScreenTriangle &triangle, int x0, int y0, int x1, int y1);
+	void DrawLine(const ScreenTriangle &triangle, unsigned int a, unsigned int b, int x0, int y0, int x1, int y1);
+
+	//-------------------------------------------------------------------------
+	//Non copyable
+	//-------------------------------------------------------------------------
+	SoftwareRenderer(const SoftwareRenderer&);
+	SoftwareRenderer& operator=(const SoftwareRenderer&);
+
+	//-------------------------------------------------------------------------
+	//Private members
+	//-------------------------------------------------------------------------
+	unsigned int						m_Width;		///> Frame width in pixels
+	unsigned int						m_Height;		///> Frame height in pixels
+	unsigned int						m_TilesX;		///> Raster tiles along x
+	unsigned int						m_TilesY;		///> Raster tiles along y
+	std::vector<unsigned int>			m_Color;		///> Color buffer (0xAARRGGBB), rows top down
+	std::vector<float>					m_Depth;		///> Depth buffer
+	float								m_World[16];	///> Current world matrix, for lighting
+	float								m_Transform[16];///> Current world * view * projection
+	float								m_Light[3];		///> Current light direction (world space)
+	float								m_Ambient;		///> Current ambient term
+	bool								m_Lighting;		///> Light set
+	FillMode							m_FillMode;		///> Current fill mode
+	std::vector<DrawCall>				m_Draws;		///> Draws recorded since the last Flush
+	std::vector<ScreenTriangle>			m_Triangles;	///> Set up triangles, 2 slots per source triangle
+	std::vector<std::vector<unsigned int> >	m_Bins;		///> Per tile triangle slots, in draw order
+	std::vector<std::vector<float> >	m_Clip;			///> Per thread clip space vertices
+	unsigned int						m_TriangleCount;///> Triangles binned by the last Flush
+};
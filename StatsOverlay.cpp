@@ -0,0 +1,157 @@
+///============================================================================
+///@file	StatsOverlay.cpp
+///@brief	Statistics overlay implementation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "StatsOverlay.h"
+
+#include <stdio.h>
+#include <string.h>
+
+///----------------------------------------------------------------------------
+///Default constructor, no lines
+///----------------------------------------------------------------------------
+StatsOverlay::StatsOverlay()
+{
+	Clear();
+}
+
+///----------------------------------------------------------------------------
+///Default destructor
+///----------------------------------------------------------------------------
+StatsOverlay::~StatsOverlay()
+{
+}
+
+///----------------------------------------------------------------------------
+///Adds a line, its values start at 0
+///@param	format - printf format taking MAX_VALUES doubles at most, must
+///					stay valid (a string literal); NULL for a SetText line
+///@return	line index, or MAX_LINES when the overlay is full
+///----------------------------------------------------------------------------
+unsigned int StatsOverlay::AddLine(const char *format)
+{
+	if(m_LineCount >= MAX_LINES)
+		return MAX_LINES;
+
+	Line &line = m_Lines[m_LineCount];
+	line.format = format;
+	memset(line.values, 0, sizeof(line.values));
+	line.text[0] = '\0';
+	line.dirty = format != NULL;
+	line.version = 0;
+	return m_LineCount++;
+}
+
+///----------------------------------------------------------------------------
+///Removes every line
+///----------------------------------------------------------------------------
+void StatsOverlay::Clear()
+{
+	m_LineCount = 0;
+	m_FormatCount = 0;
+}
+
+///----------------------------------------------------------------------------
+///Replaces the text of a line, truncated to LINE_SIZE - 1 characters. The
+///line shows it as is until a value is set again.
+///----------------------------------------------------------------------------
+void StatsOverlay::SetText(unsigned int line, const char *text)
+{
+	if(line >= m_LineCount || !text)
+		return;
+
+	Line &target = m_Lines[line];
+	target.dirty = false;
+	if(!strncmp(target.text, text, LINE_SIZE - 1))
+		return;
+
+	strncpy(target.text, text, LINE_SIZE - 1);
+	target.text[LINE_SIZE - 1] = '\0';
+	target.version++;
+}
+
+///----------------------------------------------------------------------------
+///Sets one value of a line, the line is formatted again only if it changed
+///@param	line - line index
+///@param	slot - argument of the format, 0 to MAX_VALUES - 1
+///@param	value - new value
+///----------------------------------------------------------------------------
+void StatsOverlay::SetValue(unsigned int line, unsigned int slot, double value)
+{
+	if(line >= m_LineCount || slot >= MAX_VALUES)
+		return;
+
+	Line &target = m_Lines[line];
+	if(target.values[slot] != value)
+	{
+		target.values[slot] = value;
+		target.dirty = target.format != NULL;
+	}
+}
+
+///----------------------------------------------------------------------------
+///Sets the first count values of a line
+///----------------------------------------------------------------------------
+void StatsOverlay::SetValues(unsigned int line, const double *values, unsigned int count)
+{
+	for(unsigned int i = 0; i < count && i < MAX_VALUES; i++)
+		SetValue(line, i, values[i]);
+}
+
+///----------------------------------------------------------------------------
+///Text of a line, formatted first if a value changed
+///@return	the line, "" for an unknown index
+///----------------------------------------------------------------------------
+const char* StatsOverlay::GetText(unsigned int line)
+{
+	if(line >= m_LineCount)
+		return "";
+
+	Line &target = m_Lines[line];
+	if(target.dirty)
+	{
+		//unused trailing arguments are allowed, the format picks what it needs
+		char text[LINE_SIZE];
+		const double *v = target.values;
+		snprintf(text, LINE_SIZE, target.format, v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7]);
+		m_FormatCount++;
+		target.dirty = false;
+
+		//equal values can still round to the same text
+		if(strcmp(text, target.text))
+		{
+			memcpy(target.text, text, LINE_SIZE);
+			target.version++;
+		}
+	}
+
+	return target.text;
+}
+
+///----------------------------------------------------------------------------
+///Number of lines added
+///----------------------------------------------------------------------------
+unsigned int StatsOverlay::GetLineCount() const
+{
+	return m_LineCount;
+}
+
+///----------------------------------------------------------------------------
+///Times the text of a line changed, to know when to redraw or re-layout it
+///----------------------------------------------------------------------------
+unsigned int StatsOverlay::GetVersion(unsigned int line) const
+{
+	return (line < m_LineCount) ? m_Lines[line].version : 0;
+}
+
+///----------------------------------------------------------------------------
+///Lines formatted since Clear, against one per line per frame when every
+///value changes every frame
+///----------------------------------------------------------------------------
+unsigned long long StatsOverlay::GetFormatCount() const
+{
+	return m_FormatCount;
+}
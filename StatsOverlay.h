@@ -0,0 +1,72 @@
+///============================================================================
+///@file	StatsOverlay.h
+///@brief	On screen statistics without per frame allocations. Lines live in
+///			fixed buffers inside the object; a line is a printf format over
+///			up to MAX_VALUES numbers and is only formatted again when one of
+///			them changes. Values are doubles, so formats may only use
+///			floating point conversions (%.0f for counts).
+///
+///			unsigned int fps = overlay.AddLine("%.0f FPS  %.2f ms");
+///			...
+///			overlay.SetValue(fps, 0, timer.GetFrameRate());
+///			overlay.SetValue(fps, 1, timer.GetTimeElapsed() * 1e3);
+///			DrawText(overlay.GetText(fps));
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+class StatsOverlay
+{
+public:
+	static const unsigned int MAX_LINES = 8;		///> Lines an overlay holds
+	static const unsigned int MAX_VALUES = 8;		///> Numbers per line
+	static const unsigned int LINE_SIZE = 192;		///> Characters per line, with the terminator
+
+	//-------------------------------------------------------------------------
+	//Constructors and destructors
+	//-------------------------------------------------------------------------
+	StatsOverlay();
+	~StatsOverlay();
+
+	//-------------------------------------------------------------------------
+	//Public methods
+	//-------------------------------------------------------------------------
+	unsigned int AddLine(const char *format);
+	void Clear();
+	void SetText(unsigned int line, const char *text);
+	void SetValue(unsigned int line, unsigned int slot, double value);
+	void SetValues(unsigned int line, const double *values, unsigned int count);
+
+	const char* GetText(unsigned int line);
+	unsigned int GetLineCount() const;
+	unsigned int GetVersion(unsigned int line) const;
+	unsigned long long GetFormatCount() const;
+
+private:
+	//-------------------------------------------------------------------------
+	//A line and what it was last formatted from
+	//-------------------------------------------------------------------------
+	struct Line
+	{
+		const char*		format;					///> printf format, NULL for plain text
+		double			values[MAX_VALUES];		///> Current values
+		char			text[LINE_SIZE];		///> Formatted text
+		bool			dirty;					///> A value changed since the last format
+		unsigned int	version;				///> Times the text changed
+	};
+
+	//-------------------------------------------------------------------------
+	//Non copyable
+	//-------------------------------------------------------------------------
+	StatsOverlay(const StatsOverlay&);
+	StatsOverlay& operator=(const StatsOverlay&);
+
+	//-------------------------------------------------------------------------
+	//Private members
+	//-------------------------------------------------------------------------
+	Line				m_Lines[MAX_LINES];		///> The lines, m_LineCount used
+	unsigned int		m_LineCount;			///> Lines added
+	unsigned long long	m_FormatCount;			///> Lines formatted so far
+};
@@ -0,0 +1,456 @@
+///============================================================================
+///@file	Terrain.cpp
+///@brief	Renderer independent terrain implementation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "Terrain.h"
+#include "Profiler.h"
+
+#include <math.h>
+
+///----------------------------------------------------------------------------
+///Default constructor
+///----------------------------------------------------------------------------
+Terrain::Terrain()
+{
+	m_UseLOD = true;
+	m_MaxPixelError = TerrainLOD::DEFAULT_PIXEL_ERROR;
+}
+
+///----------------------------------------------------------------------------
+///Default destructor
+///----------------------------------------------------------------------------
+Terrain::~Terrain()
+{
+	Release();
+}
+
+///----------------------------------------------------------------------------
+///Loads a height map and builds the patches, culling and LOD data, reusing
+///the precomputed hierarchy when its sidecar still matches the map
+///@param	filename - name of the map to load (.raw)
+///@param	patchSize - quads per patch side, a power of two
+///----------------------------------------------------------------------------
+bool Terrain::Load(const char* filename, unsigned int patchSize)
+{
+	Release();
+
+	if(!m_HeightField.Load(filename))
+		return false;
+
+	TerrainCache cache;
+	if(cache.Open(filename, m_HeightField, patchSize))
+	{
+		if(!m_QuadTree.Build(m_HeightField, patchSize, cache.GetPatchHeights()))
+			return false;
+
+		m_Culler.Build(m_QuadTree, m_HeightField, cache.GetOccluderHeights());
+		return m_LOD.Build(m_QuadTree, m_HeightField, cache.GetErrors());
+	}
+
+	if(!Build(patchSize))
+		return false;
+
+	TerrainCache::Write(filename, m_HeightField, m_QuadTree, m_Culler, m_LOD);
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Builds the patches, culling and LOD data from the current height field
+///(e.g. one filled through GetHeightField().Create)
+///@param	patchSize - quads per patch side, a power of two
+///----------------------------------------------------------------------------
+bool Terrain::Build(unsigned int patchSize)
+{
+	m_DirtyPatches.clear();
+	m_StalePatches.clear();
+	m_Dirty.clear();
+	if(!m_Normals.empty())
+	{
+		m_Normals.clear();
+		EnableNormals(true);
+	}
+	if(m_Query.IsBuilt())
+		m_Query.Build(m_HeightField);
+
+	if(!m_QuadTree.Build(m_HeightField, patchSize))
+		return false;
+
+	m_Culler.Build(m_QuadTree, m_HeightField);
+	return m_LOD.Build(m_QuadTree, m_HeightField);
+}
+
+///----------------------------------------------------------------------------
+///Edits every sample of a rectangle at full strength
+///@param	mode - what to do with the samples
+///@param	x, z - first sample
+///@param	width, height - samples along x and z, clipped to the map
+///@param	amount - target height, height change or smoothing factor
+///@return	false if nothing is loaded or the rectangle misses the map
+///----------------------------------------------------------------------------
+bool Terrain::EditRect(TerrainEditMode mode, unsigned int x, unsigned int z, unsigned int width, unsigned int height,
+					   float amount)
+{
+	unsigned int mapWidth = m_HeightField.GetWidth(), mapHeight = m_HeightField.GetHeight();
+	if(!IsLoaded() || !width || !height || x >= mapWidth || z >= mapHeight)
+		return false;
+
+	unsigned int x1 = (width < mapWidth - x) ? x + width - 1 : mapWidth - 1;
+	unsigned int z1 = (height < mapHeight - z) ? z + height - 1 : mapHeight - 1;
+	return Edit(mode, x, z, x1, z1, amount, NULL);
+}
+
+///----------------------------------------------------------------------------
+///Edits the samples under a round brush. The brush has full strength up to
+///hardness * radius from its center and fades out smoothly at radius.
+///@param	mode - what to do with the samples
+///@param	x, z - brush center in terrain space
+///@param	radius - brush radius in samples
+///@param	amount - target height, height change or smoothing factor
+///@param	hardness - fraction of the radius at full strength (0..1)
+///@return	false if nothing is loaded or the brush misses the map
+///----------------------------------------------------------------------------
+bool Terrain::EditBrush(TerrainEditMode mode, float x, float z, float radius, float amount, float hardness)
+{
+	float lastX = (float)(m_HeightField.GetWidth() - 1), lastZ = (float)(m_HeightField.GetHeight() - 1);
+	if(!IsLoaded() || radius <= 0.0f || x + radius < 0.0f || z + radius < 0.0f || x - radius > lastX || z - radius > lastZ)
+		return false;
+
+	float brush[4] = { x, z, radius, hardness < 0.0f ? 0.0f : (hardness > 1.0f ? 1.0f : hardness) };
+	unsigned int x0 = (unsigned int)ceilf(x - radius > 0.0f ? x - radius : 0.0f);
+	unsigned int z0 = (unsigned int)ceilf(z - radius > 0.0f ? z - radius : 0.0f);
+	unsigned int x1 = (unsigned int)floorf(x + radius < lastX ? x + radius : lastX);
+	unsigned int z1 = (unsigned int)floorf(z + radius < lastZ ? z + radius : lastZ);
+	return Edit(mode, x0, z0, x1, z1, amount, brush);
+}
+
+///----------------------------------------------------------------------------
+///Applies an edit to [x0,x1] x [z0,z1] and marks what depends on it.
+///Integer maps round every result to their sample step, so changes below
+///half a step leave them as they are.
+///@param	brush - center x/z, radius and hardness, NULL for full strength
+///----------------------------------------------------------------------------
+bool Terrain::Edit(TerrainEditMode mode, unsigned int x0, unsigned int z0, unsigned int x1, unsigned int z1,
+				   float amount, const float *brush)
+{
+	if(x0 > x1 || z0 > z1 || !m_HeightField.GetWritableData())
+		return false;
+
+	//smoothing reads the neighbors as they were before the edit
+	unsigned int lastX = m_HeightField.GetWidth() - 1, lastZ = m_HeightField.GetHeight() - 1;
+	unsigned int sx0 = x0 > 0 ? x0 - 1 : 0, sz0 = z0 > 0 ? z0 - 1 : 0;
+	unsigned int sx1 = x1 < lastX ? x1 + 1 : lastX, sz1 = z1 < lastZ ? z1 + 1 : lastZ;
+	unsigned int pitch = sx1 - sx0 + 1;
+	m_EditScratch.resize((size_t)pitch * (sz1 - sz0 + 1));
+	for(unsigned int z = sz0; z <= sz1; z++)
+		for(unsigned int x = sx0; x <= sx1; x++)
+			m_EditScratch[(size_t)(z - sz0) * pitch + (x - sx0)] = m_HeightField.GetElevation(x, z);
+
+	float inner = brush ? brush[2] * brush[3] : 0.0f;
+	float fade = brush ? brush[2] - inner : 0.0f;
+
+	for(unsigned int z = z0; z <= z1; z++)
+	{
+		const float *row = &m_EditScratch[(size_t)(z - sz0) * pitch];
+		const float *above = z > sz0 ? row - pitch : row, *below = z < sz1 ? row + pitch : row;
+
+		for(unsigned int x = x0; x <= x1; x++)
+		{
+			float weight = 1.0f;
+			if(brush)
+			{
+				float dx = (float)x - brush[0], dz = (float)z - brush[1];
+				float distance = sqrtf(dx * dx + dz * dz);
+				if(distance >= brush[2]) continue;
+				if(distance > inner)
+				{
+					float t = 1.0f - (distance - inner) / fade;
+					weight = t * t * (3.0f - 2.0f * t);
+				}
+			}
+
+			unsigned int i = x - sx0;
+			float h = row[i];
+			if(mode == EDIT_SET)
+			{
+				h += (amount - h) * weight;
+			}
+			else if(mode == EDIT_RAISE)
+			{
+				h += amount * weight;
+			}
+			else
+			{
+				unsigned int xa = x > sx0 ? i - 1 : i, xb = x < sx1 ? i + 1 : i;
+				float mean = (above[xa] + above[i] + above[xb] + row[xa] + row[i] + row[xb] +
+							  below[xa] + below[i] + below[xb]) / 9.0f;
+				h += (mean - h) * amount * weight;
+			}
+
+			m_HeightField.SetElevation(x, z, h);
+		}
+	}
+
+	UpdateRegion(x0, z0, x1 - x0 + 1, z1 - z0 + 1);
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Notes a rectangle of samples changed through GetHeightField() (edits
+///call it themselves). The normals, if enabled, are updated right away;
+///the patches sharing the samples are marked for Refresh and added to the
+///dirty list for the front end to rebuild their vertices.
+///@param	x, z - first changed sample
+///@param	width, height - size of the changed rectangle
+///----------------------------------------------------------------------------
+void Terrain::UpdateRegion(unsigned int x, unsigned int z, unsigned int width, unsigned int height)
+{
+	unsigned int mapWidth = m_HeightField.GetWidth(), mapHeight = m_HeightField.GetHeight();
+	if(!IsLoaded() || !width || !height || x >= mapWidth || z >= mapHeight)
+		return;
+
+	if(!m_Normals.empty())
+		TerrainMesh::UpdateNormals(m_HeightField, x, z, width, height, &m_Normals[0], &m_Slopes[0]);
+	m_Query.UpdateRegion(x, z, width, height);
+
+	//patches share their border samples, and packed normals read one
+	//sample further
+	unsigned int patchSize = m_QuadTree.GetPatchSize();
+	unsigned int xa = x > 0 ? x - 1 : 0, za = z > 0 ? z - 1 : 0;
+	unsigned int xb = (width < mapWidth - x) ? x + width : mapWidth - 1;
+	unsigned int zb = (height < mapHeight - z) ? z + height : mapHeight - 1;
+	unsigned int px0 = xa ? (xa - 1) / patchSize : 0, pz0 = za ? (za - 1) / patchSize : 0;
+	unsigned int px1 = xb / patchSize, pz1 = zb / patchSize;
+	if(px1 >= m_QuadTree.GetPatchCountX()) px1 = m_QuadTree.GetPatchCountX() - 1;
+	if(pz1 >= m_QuadTree.GetPatchCountZ()) pz1 = m_QuadTree.GetPatchCountZ() - 1;
+
+	m_Dirty.resize(m_QuadTree.GetPatchCount(), 0);
+
+	for(unsigned int pz = pz0; pz <= pz1; pz++)
+	{
+		for(unsigned int px = px0; px <= px1; px++)
+		{
+			unsigned int i = px + pz * m_QuadTree.GetPatchCountX();
+			if(!(m_Dirty[i] & DIRTY_MESH))
+				m_DirtyPatches.push_back(i);
+			if(!(m_Dirty[i] & DIRTY_BOUNDS))
+				m_StalePatches.push_back(i);
+			m_Dirty[i] |= DIRTY_MESH | DIRTY_BOUNDS;
+		}
+	}
+}
+
+///----------------------------------------------------------------------------
+///Brings the bounds, occluders and LOD errors of the patches changed since
+///the last call up to date, once per patch however many edits touched it.
+///Update calls it; call it directly to query GetQuadTree or GetLOD after
+///editing without drawing.
+///----------------------------------------------------------------------------
+void Terrain::Refresh()
+{
+	for(size_t s = 0; s < m_StalePatches.size(); s++)
+	{
+		unsigned int i = m_StalePatches[s];
+		unsigned int px = i % m_QuadTree.GetPatchCountX(), pz = i / m_QuadTree.GetPatchCountX();
+
+		m_QuadTree.UpdatePatches(m_HeightField, px, pz, px, pz);
+		m_Culler.UpdatePatch(i, m_QuadTree.GetPatch(i).bounds, m_HeightField);
+		m_LOD.UpdatePatch(i, m_HeightField);
+		m_Dirty[i] &= ~DIRTY_BOUNDS;
+	}
+	m_StalePatches.clear();
+}
+
+///----------------------------------------------------------------------------
+///Returns the patches whose samples changed since the last
+///ClearDirtyPatches, each once
+///----------------------------------------------------------------------------
+const std::vector<unsigned int>& Terrain::GetDirtyPatches() const
+{
+	return m_DirtyPatches;
+}
+
+///----------------------------------------------------------------------------
+///Empties the dirty list, once the front end has rebuilt those patches
+///----------------------------------------------------------------------------
+void Terrain::ClearDirtyPatches()
+{
+	for(size_t i = 0; i < m_DirtyPatches.size(); i++)
+		m_Dirty[m_DirtyPatches[i]] &= ~DIRTY_MESH;
+	m_DirtyPatches.clear();
+}
+
+///----------------------------------------------------------------------------
+///Keeps a packed normal and slope per sample (TerrainMesh::BuildNormals),
+///updated along with every edit; 3 bytes per sample
+///----------------------------------------------------------------------------
+void Terrain::EnableNormals(bool enable)
+{
+	if(!enable || !m_HeightField.GetData())
+	{
+		std::vector<unsigned short>().swap(m_Normals);
+		std::vector<unsigned char>().swap(m_Slopes);
+		return;
+	}
+
+	size_t count = (size_t)m_HeightField.GetWidth() * m_HeightField.GetHeight();
+	if(m_Normals.size() == count)
+		return;
+
+	m_Normals.resize(count);
+	m_Slopes.resize(count);
+	TerrainMesh::BuildNormals(m_HeightField, &m_Normals[0], &m_Slopes[0]);
+}
+
+///----------------------------------------------------------------------------
+///Returns the packed normal of every sample, row major, NULL unless enabled
+///----------------------------------------------------------------------------
+const unsigned short* Terrain::GetNormals() const
+{
+	return m_Normals.empty() ? NULL : &m_Normals[0];
+}
+
+///----------------------------------------------------------------------------
+///Returns the slope of every sample, row major, NULL unless enabled
+///----------------------------------------------------------------------------
+const unsigned char* Terrain::GetSlopes() const
+{
+	return m_Slopes.empty() ? NULL : &m_Slopes[0];
+}
+
+///----------------------------------------------------------------------------
+///Keeps the min/max pyramid GetQuery needs, updated along with every edit;
+///8 bytes per BLOCK_SIZE^2 cells
+///----------------------------------------------------------------------------
+void Terrain::EnableQueries(bool enable)
+{
+	if(!enable || !m_HeightField.GetData())
+		m_Query.Release();
+	else if(!m_Query.IsBuilt())
+		m_Query.Build(m_HeightField);
+}
+
+///----------------------------------------------------------------------------
+///Returns the height, ray and line of sight queries, see EnableQueries
+///----------------------------------------------------------------------------
+const TerrainQuery& Terrain::GetQuery() const
+{
+	return m_Query;
+}
+
+///----------------------------------------------------------------------------
+///Frees the height field and everything built from it
+///----------------------------------------------------------------------------
+void Terrain::Release()
+{
+	m_QuadTree.Release();
+	m_HeightField.Release();
+	m_VisiblePatches.clear();
+	m_DirtyPatches.clear();
+	m_StalePatches.clear();
+	m_Dirty.clear();
+	EnableNormals(false);
+	m_Query.Release();
+}
+
+///----------------------------------------------------------------------------
+///Culls the patches and picks their levels for this frame
+///@param	frustum - camera frustum in terrain space
+///@param	eye - camera position in terrain space (x,y,z)
+///@param	errorScale - pixels per world unit at distance 1, i.e.
+///			viewportHeight / (2 * tan(fovY / 2))
+///@return	number of visible patches
+///----------------------------------------------------------------------------
+unsigned int Terrain::Update(const Frustum &frustum, const float *eye, float errorScale)
+{
+	if(!m_QuadTree.GetPatchCount())
+		return 0;
+
+	Refresh();
+	{
+		PROFILE_ZONE("cull");
+		m_Culler.Cull(frustum, eye, m_VisiblePatches);
+	}
+
+	PROFILE_ZONE("lod_select");
+	if(m_UseLOD)
+		m_LOD.Select(eye, errorScale, m_MaxPixelError);
+	else
+		m_LOD.SelectFull();
+
+	return (unsigned int)m_VisiblePatches.size();
+}
+
+///----------------------------------------------------------------------------
+///Enables or disables geomipmapping (full resolution when disabled)
+///----------------------------------------------------------------------------
+void Terrain::SetLOD(bool enable)
+{
+	m_UseLOD = enable;
+}
+
+///----------------------------------------------------------------------------
+///Sets the LOD screen space error bound in pixels
+///----------------------------------------------------------------------------
+void Terrain::SetMaxPixelError(float pixels)
+{
+	m_MaxPixelError = pixels;
+}
+
+///----------------------------------------------------------------------------
+///Returns true once a map is loaded and its patches are built
+///----------------------------------------------------------------------------
+bool Terrain::IsLoaded() const
+{
+	return m_QuadTree.GetPatchCount() > 0 && m_LOD.GetIndexCount() > 0;
+}
+
+///----------------------------------------------------------------------------
+///Returns the patches to draw this frame, front to back
+///----------------------------------------------------------------------------
+const std::vector<unsigned int>& Terrain::GetVisiblePatches() const
+{
+	return m_VisiblePatches;
+}
+
+///----------------------------------------------------------------------------
+///Returns the height samples
+///----------------------------------------------------------------------------
+HeightField& Terrain::GetHeightField()
+{
+	return m_HeightField;
+}
+
+///----------------------------------------------------------------------------
+///Returns the height samples
+///----------------------------------------------------------------------------
+const HeightField& Terrain::GetHeightField() const
+{
+	return m_HeightField;
+}
+
+///----------------------------------------------------------------------------
+///Returns the patches
+///----------------------------------------------------------------------------
+const TerrainQuadTree& Terrain::GetQuadTree() const
+{
+	return m_QuadTree;
+}
+
+///----------------------------------------------------------------------------
+///Returns the culler, e.g. to tune the horizon pass
+///----------------------------------------------------------------------------
+TerrainCuller& Terrain::GetCuller()
+{
+	return m_Culler;
+}
+
+///----------------------------------------------------------------------------
+///Returns the LOD state, index layout and selected levels
+///----------------------------------------------------------------------------
+const TerrainLOD& Terrain::GetLOD() const
+{
+	return m_LOD;
+}
@@ -0,0 +1,109 @@
+///============================================================================
+///@file	Terrain.h
+///@brief	Renderer independent terrain: owns the height field and every
+///			structure derived from it (patches, culling, LOD) and decides
+///			each frame which patches to draw and at which level. Front ends
+///			only upload patch vertices and the shared index sets, then draw
+///			what GetVisiblePatches returns. Edits only mark the patches
+///			they touch: bounds and LOD errors of those are refreshed once
+///			by the next Update, and front ends re-upload GetDirtyPatches.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+#include <vector>
+#include "Frustum.h"
+#include "HeightField.h"
+#include "TerrainCache.h"
+#include "TerrainCuller.h"
+#include "TerrainLOD.h"
+#include "TerrainMesh.h"
+#include "TerrainQuadTree.h"
+#include "TerrainQuery.h"
+
+//-------------------------------------------------------------------------
+//What an edit does to the samples under it
+//-------------------------------------------------------------------------
+enum TerrainEditMode
+{
+	EDIT_SET	= 0,	///> Pull heights to amount (world units)
+	EDIT_RAISE	= 1,	///> Add amount world units, negative to lower
+	EDIT_SMOOTH	= 2		///> Blend by amount (0..1) toward the 3x3 mean
+};
+
+class Terrain
+{
+public:
+	//-------------------------------------------------------------------------
+	//Constructors and destructors
+	//-------------------------------------------------------------------------
+	Terrain();
+	~Terrain();
+
+	//-------------------------------------------------------------------------
+	//Public methods
+	//-------------------------------------------------------------------------
+	bool Load(const char* filename, unsigned int patchSize = TerrainQuadTree::DEFAULT_PATCH_SIZE);
+	bool Build(unsigned int patchSize = TerrainQuadTree::DEFAULT_PATCH_SIZE);
+	void Release();
+	unsigned int Update(const Frustum &frustum, const float *eye, float errorScale);
+
+	bool EditRect(TerrainEditMode mode, unsigned int x, unsigned int z, unsigned int width, unsigned int height, float amount);
+	bool EditBrush(TerrainEditMode mode, float x, float z, float radius, float amount, float hardness = 0.5f);
+	void UpdateRegion(unsigned int x, unsigned int z, unsigned int width, unsigned int height);
+	void Refresh();
+	const std::vector<unsigned int>& GetDirtyPatches() const;
+	void ClearDirtyPatches();
+	void EnableNormals(bool enable);
+	const unsigned short* GetNormals() const;
+	const unsigned char* GetSlopes() const;
+	void EnableQueries(bool enable);
+	const TerrainQuery& GetQuery() const;
+
+	void SetLOD(bool enable);
+	void SetMaxPixelError(float pixels);
+	bool IsLoaded() const;
+	const std::vector<unsigned int>& GetVisiblePatches() const;
+
+	HeightField& GetHeightField();
+	const HeightField& GetHeightField() const;
+	const TerrainQuadTree& GetQuadTree() const;
+	TerrainCuller& GetCuller();
+	const TerrainLOD& GetLOD() const;
+
+private:
+	//-------------------------------------------------------------------------
+	//Non copyable
+	//-------------------------------------------------------------------------
+	Terrain(const Terrain&);
+	Terrain& operator=(const Terrain&);
+
+	//-------------------------------------------------------------------------
+	//Private methods
+	//-------------------------------------------------------------------------
+	bool Edit(TerrainEditMode mode, unsigned int x0, unsigned int z0, unsigned int x1, unsigned int z1,
+			  float amount, const float *brush);
+
+	//-------------------------------------------------------------------------
+	//Private members
+	//-------------------------------------------------------------------------
+	static const unsigned char DIRTY_MESH = 1;		///> In m_DirtyPatches
+	static const unsigned char DIRTY_BOUNDS = 2;	///> In m_StalePatches
+
+	HeightField					m_HeightField;		///> Terrain height samples
+	TerrainQuadTree				m_QuadTree;			///> Terrain patches
+	TerrainCuller				m_Culler;			///> Decides which patches get drawn
+	TerrainLOD					m_LOD;				///> Picks the detail level of each patch
+	std::vector<unsigned int>	m_VisiblePatches;	///> Patches drawn this frame
+	std::vector<unsigned int>	m_DirtyPatches;		///> Patches changed since ClearDirtyPatches
+	std::vector<unsigned int>	m_StalePatches;		///> Patches changed since Refresh
+	std::vector<unsigned char>	m_Dirty;			///> Per patch DIRTY_* flags
+	std::vector<unsigned short>	m_Normals;			///> Packed normal per sample, empty unless enabled
+	std::vector<unsigned char>	m_Slopes;			///> Slope per sample, empty unless enabled
+	std::vector<float>			m_EditScratch;		///> Elevations under an edit, before it
+	TerrainQuery				m_Query;			///> Height and ray queries, unbuilt unless enabled
+	bool						m_UseLOD;			///> Geomipmapping on, full resolution otherwise
+	float						m_MaxPixelError;	///> LOD screen space error bound
+};
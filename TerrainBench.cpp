@@ -0,0 +1,1530 @@
+///============================================================================
+///@file	TerrainBench.cpp
+///@brief	Headless benchmark of the terrain CPU paths: height map load,
+///			hierarchy build, vertex, index and normal generation, culling, LOD
+///			selection, terrain queries and software rendering, over map
+///			sizes from the shipped 65x65 map up to 16k x 16k, with 8-bit,
+///			16-bit and float samples.
+///			Every case records one sample per iteration and reports p50/p99
+///			latency plus throughput; --json writes the results in a stable
+///			format that can be diffed between releases.
+///
+///			TerrainBench [--sizes=65,257,...] [--formats=8,16,32] [--min-time=seconds]
+///						 [--filter=substring] [--json=file|-] [--work-dir=dir]
+///						 [--threads=count] [--cache-sizes=16,32,...]
+///						 [--tile-budget-mb=megabytes] [--job-threads=count]
+///						 [--flight-path=file] [--view-radius=units]
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "CpuInfo.h"
+#include "Parallel.h"
+#include "Profiler.h"
+#include "RecordingBackend.h"
+#include "SoftwareRenderer.h"
+#include "StatsOverlay.h"
+#include "Terrain.h"
+#include "TerrainBuffers.h"
+#include "TerrainIndexTable.h"
+#include "TerrainPackage.h"
+#include "TerrainTileCache.h"
+#include "Timer.h"
+
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+#ifndef TERRAIN_SOURCE_DIR
+#define TERRAIN_SOURCE_DIR "."
+#endif
+
+//-------------------------------------------------------------------------
+//One benchmark case and its per-iteration timings
+//-------------------------------------------------------------------------
+struct BenchResult
+{
+	std::string			name;		///> Case name
+	unsigned int		mapSize;	///> Samples per map side
+	unsigned int		sampleBits;	///> Bits per map sample, 0 if the case uses no map
+	std::vector<double>	samples;	///> Nanoseconds per iteration
+	double				items;		///> Work items per iteration
+	double				bytes;		///> Bytes processed per iteration
+	const char*			itemLabel;	///> What an item is (vertices, samples...)
+	std::vector<std::pair<std::string, double> > counters;	///> Extra per case values
+};
+
+//-------------------------------------------------------------------------
+//Command line options
+//-------------------------------------------------------------------------
+struct BenchOptions
+{
+	std::vector<unsigned int>	sizes;		///> Map sizes to run
+	std::vector<unsigned int>	formats;	///> Sample bits to run every size with
+	double						minTime;	///> Minimum seconds per case
+	unsigned int				minIters;	///> Minimum iterations per case
+	std::string					filter;		///> Only run cases containing this
+	std::string					json;		///> JSON output file, "-" for stdout
+	std::string					workDir;	///> Where the generated maps go, created if missing
+	std::vector<unsigned int>	cacheSizes;	///> Vertex cache sizes to simulate
+	double						tileBudget;	///> Tile cache budget in megabytes
+	unsigned int				jobThreads;	///> Job system workers, 0 = default
+	std::vector<float>			flightPath;	///> Recorded camera path, seconds x y z per frame
+	float						viewRadius;	///> Streaming distance in terrain units
+};
+
+typedef std::chrono::steady_clock BenchClock;
+
+static FILE *s_Table = stdout;	///> Where the human readable table goes
+static std::atomic<unsigned long long> s_Allocations(0);	///> operator new calls so far
+
+///----------------------------------------------------------------------------
+///Counts heap allocations, for the allocations per tile load of the
+///streaming cases. The array and nothrow forms end up here too. GCC flags
+///the free of memory from operator new once these inline, which is the
+///point of replacing both.
+///----------------------------------------------------------------------------
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(size_t size)
+{
+	s_Allocations.fetch_add(1, std::memory_order_relaxed);
+	void *memory = malloc(size ? size : 1);
+	if(!memory)
+		throw std::bad_alloc();
+	return memory;
+}
+
+void operator delete(void *memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+	free(memory);
+}
+
+///----------------------------------------------------------------------------
+///Integer hash used by the synthetic terrain
+///----------------------------------------------------------------------------
+static unsigned int Hash(unsigned int x, unsigned int z, unsigned int seed)
+{
+	unsigned int h = x * 0x8da6b343u ^ z * 0xd8163841u ^ seed * 0xcb1ab31fu;
+	h ^= h >> 13;
+	h *= 0x5bd1e995u;
+	h ^= h >> 15;
+	return h;
+}
+
+///----------------------------------------------------------------------------
+///Smoothed value noise in [0,1] with one lattice point every cell samples
+///----------------------------------------------------------------------------
+static float ValueNoise(unsigned int x, unsigned int z, unsigned int cell, unsigned int seed)
+{
+	unsigned int cx = x / cell, cz = z / cell;
+	float fx = (float)(x % cell) / (float)cell;
+	float fz = (float)(z % cell) / (float)cell;
+	fx = fx * fx * (3.0f - 2.0f * fx);
+	fz = fz * fz * (3.0f - 2.0f * fz);
+
+	float v00 = (float)(Hash(cx, cz, seed) & 0xffff);
+	float v10 = (float)(Hash(cx + 1, cz, seed) & 0xffff);
+	float v01 = (float)(Hash(cx, cz + 1, seed) & 0xffff);
+	float v11 = (float)(Hash(cx + 1, cz + 1, seed) & 0xffff);
+	float a = v00 + (v10 - v00) * fx;
+	float b = v01 + (v11 - v01) * fx;
+
+	return (a + (b - a) * fz) / 65535.0f;
+}
+
+///----------------------------------------------------------------------------
+///Writes a deterministic fractal height map, or converts the shipped 65x65
+///map when that is the size asked for. Every precision describes the same
+///terrain: 16-bit samples are 257 times the 8-bit ones and float samples
+///equal them, with the .hdr scale making up for it.
+///@param	size - samples per side
+///@param	bits - 8, 16 or 32 (float)
+///@param	filename - where to write the .raw file
+///----------------------------------------------------------------------------
+static bool GenerateHeightMap(unsigned int size, unsigned int bits, const std::string &filename)
+{
+	std::string header = filename + ".hdr";
+	remove(header.c_str());
+
+	if(bits != 8)
+	{
+		FILE *hdr = fopen(header.c_str(), "w");
+		if(!hdr) return false;
+		fprintf(hdr, "width %u\nheight %u\nbits %u\nscale %.9g\n", size, size, bits,
+				(bits == 16) ? HeightField::DEFAULT_VERTICAL_SCALE / 257.0f : HeightField::DEFAULT_VERTICAL_SCALE);
+		if(bits == 32)
+			fprintf(hdr, "min 0\nmax 255\n");
+		if(fclose(hdr) != 0) return false;
+	}
+
+	FILE *out = fopen(filename.c_str(), "wb");
+	if(!out) return false;
+
+	size_t sampleSize = bits / 8;
+	std::vector<unsigned char> source(size), row(size * sampleSize);
+	bool ok = true;
+
+	FILE *shipped = (size == 65) ? fopen(TERRAIN_SOURCE_DIR "/heightmap.raw", "rb") : NULL;
+	for(unsigned int z = 0; z < size && ok; z++)
+	{
+		if(shipped)
+		{
+			ok = fread(&source[0], 1, size, shipped) == size;
+		}
+		else
+		{
+			for(unsigned int x = 0; x < size; x++)
+			{
+				float h = 0.0f, amplitude = 0.5f;
+				for(unsigned int cell = 256, octave = 0; cell >= 8; cell >>= 1, octave++, amplitude *= 0.5f)
+					h += ValueNoise(x, z, cell, octave) * amplitude;
+				source[x] = (unsigned char)(h * 255.0f);
+			}
+		}
+
+		for(unsigned int x = 0; x < size; x++)
+		{
+			if(bits == 16)
+				((unsigned short*)&row[0])[x] = (unsigned short)(source[x] * 257);
+			else if(bits == 32)
+				((float*)&row[0])[x] = (float)source[x];
+			else
+				row[x] = source[x];
+		}
+		ok = ok && fwrite(&row[0], sampleSize, size, out) == size;
+	}
+
+	if(shipped)
+		fclose(shipped);
+
+	return (fclose(out) == 0) && ok;
+}
+
+///----------------------------------------------------------------------------
+///Builds a D3D style (row vector, left handed) view and projection for a
+///camera flying a circle over the map
+///@param	terrain - the loaded terrain
+///@param	frame - position along the path
+///@param	frames - poses in the path
+///@param	frustum - receives the camera frustum
+///@param	eye - receives the camera position
+///@param	errorScale - receives the LOD error scale of a 600 pixel high view
+///----------------------------------------------------------------------------
+static void CameraPose(const Terrain &terrain, unsigned int frame, unsigned int frames,
+					   Frustum &frustum, float *eye, float &errorScale)
+{
+	const HeightField &heightField = terrain.GetHeightField();
+	float size = (float)(heightField.GetWidth() - 1);
+	float angle = 6.2831853f * (float)frame / (float)frames;
+
+	eye[0] = size * (0.5f + 0.35f * cosf(angle));
+	eye[2] = size * (0.5f + 0.35f * sinf(angle));
+	eye[1] = heightField.GetElevation((unsigned int)eye[0], (unsigned int)eye[2]) + 10.0f;
+
+	//look along the path, slightly down
+	float dir[3] = { -sinf(angle), -0.15f, cosf(angle) };
+	float len = sqrtf(dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]);
+	float zx = dir[0] / len, zy = dir[1] / len, zz = dir[2] / len;
+
+	//x = normalize(up x z), y = z x x
+	float xx = zz, xy = 0.0f, xz = -zx;
+	len = sqrtf(xx * xx + xz * xz);
+	xx /= len; xz /= len;
+	float yx = zy * xz - zz * xy, yy = zz * xx - zx * xz, yz = zx * xy - zy * xx;
+
+	float view[16] = {
+		xx, yx, zx, 0.0f,
+		xy, yy, zy, 0.0f,
+		xz, yz, zz, 0.0f,
+		-(xx * eye[0] + xy * eye[1] + xz * eye[2]),
+		-(yx * eye[0] + yy * eye[1] + yz * eye[2]),
+		-(zx * eye[0] + zy * eye[1] + zz * eye[2]), 1.0f };
+
+	float zn = 1.0f, zf = size * 1.5f;
+	float yScale = 1.0f / tanf(3.14159265f / 8.0f);
+	float xScale = yScale * 600.0f / 800.0f;
+	float proj[16] = {
+		xScale, 0.0f, 0.0f, 0.0f,
+		0.0f, yScale, 0.0f, 0.0f,
+		0.0f, 0.0f, zf / (zf - zn), 1.0f,
+		0.0f, 0.0f, -zn * zf / (zf - zn), 0.0f };
+
+	frustum.Extract(view, proj);
+	errorScale = 600.0f * yScale * 0.5f;
+}
+
+///----------------------------------------------------------------------------
+///Runs body until both the minimum time and iteration count are reached,
+///timing each call separately
+///----------------------------------------------------------------------------
+template <typename Body>
+static void Measure(BenchResult &result, const BenchOptions &options, Body body)
+{
+	BenchClock::time_point start = BenchClock::now();
+	double elapsed = 0.0;
+
+	for(unsigned int i = 0; i < options.minIters || elapsed < options.minTime; i++)
+	{
+		BenchClock::time_point t0 = BenchClock::now();
+		body(i);
+		BenchClock::time_point t1 = BenchClock::now();
+
+		result.samples.push_back((double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+		elapsed = std::chrono::duration<double>(t1 - start).count();
+	}
+}
+
+///----------------------------------------------------------------------------
+///Returns the q quantile (nearest rank) of sorted samples
+///----------------------------------------------------------------------------
+static double Percentile(const std::vector<double> &sorted, double q)
+{
+	if(sorted.empty()) return 0.0;
+
+	size_t rank = (size_t)ceil(q * (double)sorted.size());
+	return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+///----------------------------------------------------------------------------
+///Prints one result as a table row
+///----------------------------------------------------------------------------
+static void PrintResult(const BenchResult &result)
+{
+	std::vector<double> sorted(result.samples);
+	std::sort(sorted.begin(), sorted.end());
+	double p50 = Percentile(sorted, 0.5);
+
+	fprintf(s_Table, "%-22s %6u %4u %8u %12.3f %12.3f %12.2f M%s/s %10.1f MB/s",
+		   result.name.c_str(), result.mapSize, result.sampleBits, (unsigned int)sorted.size(),
+		   p50 * 1e-6, Percentile(sorted, 0.99) * 1e-6,
+		   p50 > 0.0 ? result.items / p50 * 1e3 : 0.0, result.itemLabel,
+		   p50 > 0.0 ? result.bytes / p50 * 1e3 : 0.0);
+
+	for(size_t i = 0; i < result.counters.size(); i++)
+		fprintf(s_Table, " %s=%g", result.counters[i].first.c_str(), result.counters[i].second);
+	fprintf(s_Table, "\n");
+	fflush(s_Table);
+}
+
+///----------------------------------------------------------------------------
+///Writes every result as JSON
+///----------------------------------------------------------------------------
+static bool WriteJson(const std::vector<BenchResult> &results, const BenchOptions &options)
+{
+	FILE *f = (options.json == "-") ? stdout : fopen(options.json.c_str(), "w");
+	if(!f) return false;
+
+	char date[64];
+	time_t now = time(NULL);
+	strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+	fprintf(f, "{\n  \"context\": {\n");
+	fprintf(f, "    \"date\": \"%s\",\n", date);
+#if defined(_MSC_VER)
+	fprintf(f, "    \"compiler\": \"msvc %d\",\n", _MSC_VER);
+#elif defined(__VERSION__)
+	fprintf(f, "    \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+	fprintf(f, "    \"min_time_s\": %g,\n", options.minTime);
+	fprintf(f, "    \"threads\": %u,\n", Parallel::GetThreadCount());
+	fprintf(f, "    \"avx2\": %s,\n", (CpuInfo::HasAVX2() && TerrainMesh::HasAVX2Kernel()) ? "true" : "false");
+	fprintf(f, "    \"pointer_bits\": %u\n  },\n", (unsigned int)(sizeof(void*) * 8));
+	fprintf(f, "  \"benchmarks\": [");
+
+	for(size_t r = 0; r < results.size(); r++)
+	{
+		const BenchResult &result = results[r];
+		std::vector<double> sorted(result.samples);
+		std::sort(sorted.begin(), sorted.end());
+
+		double sum = 0.0;
+		for(size_t i = 0; i < sorted.size(); i++)
+			sum += sorted[i];
+		double p50 = Percentile(sorted, 0.5);
+
+		fprintf(f, "%s\n    {\n", r ? "," : "");
+		if(result.sampleBits)
+			fprintf(f, "      \"name\": \"%s/%u/%u\",\n", result.name.c_str(), result.mapSize, result.sampleBits);
+		else
+			fprintf(f, "      \"name\": \"%s/%u\",\n", result.name.c_str(), result.mapSize);
+		fprintf(f, "      \"case\": \"%s\",\n", result.name.c_str());
+		fprintf(f, "      \"map_size\": %u,\n", result.mapSize);
+		fprintf(f, "      \"sample_bits\": %u,\n", result.sampleBits);
+		fprintf(f, "      \"iterations\": %u,\n", (unsigned int)sorted.size());
+		fprintf(f, "      \"min_ns\": %.0f,\n", sorted.empty() ? 0.0 : sorted.front());
+		fprintf(f, "      \"mean_ns\": %.0f,\n", sorted.empty() ? 0.0 : sum / (double)sorted.size());
+		fprintf(f, "      \"p50_ns\": %.0f,\n", p50);
+		fprintf(f, "      \"p99_ns\": %.0f,\n", Percentile(sorted, 0.99));
+		fprintf(f, "      \"max_ns\": %.0f,\n", sorted.empty() ? 0.0 : sorted.back());
+		fprintf(f, "      \"item\": \"%s\",\n", result.itemLabel);
+		fprintf(f, "      \"items_per_second\": %.6g,\n", p50 > 0.0 ? result.items / p50 * 1e9 : 0.0);
+		fprintf(f, "      \"bytes_per_second\": %.6g", p50 > 0.0 ? result.bytes / p50 * 1e9 : 0.0);
+
+		for(size_t i = 0; i < result.counters.size(); i++)
+			fprintf(f, ",\n      \"%s\": %.6g", result.counters[i].first.c_str(), result.counters[i].second);
+		fprintf(f, "\n    }");
+	}
+
+	fprintf(f, "\n  ]\n}\n");
+	return (f == stdout) || fclose(f) == 0;
+}
+
+///----------------------------------------------------------------------------
+///Parses a comma separated list of numbers
+///----------------------------------------------------------------------------
+static bool ParseList(const char *s, std::vector<unsigned int> &values)
+{
+	while(*s)
+	{
+		values.push_back((unsigned int)strtoul(s, (char**)&s, 10));
+		if(*s == ',') s++;
+		else if(*s) return false;
+	}
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Reads a recorded camera path, one "seconds x y z" line per frame in
+///terrain units
+///----------------------------------------------------------------------------
+static bool LoadFlightPath(const char *filename, std::vector<float> &path)
+{
+	FILE *f = fopen(filename, "r");
+	if(!f) return false;
+
+	float point[4];
+	while(fscanf(f, "%f %f %f %f", &point[0], &point[1], &point[2], &point[3]) == 4)
+		path.insert(path.end(), point, point + 4);
+	fclose(f);
+
+	return path.size() >= 8;
+}
+
+///----------------------------------------------------------------------------
+///Camera position and velocity for a streaming frame: the recorded path if
+///there is one, else a loop around the map at 60 frames per second
+///@param	options - holds the recorded path
+///@param	size - samples per map side
+///@param	frame - frame number, paths repeat
+///@param	eye - receives the position
+///@param	velocity - receives the velocity in units per second
+///----------------------------------------------------------------------------
+static void GetFlightPose(const BenchOptions &options, unsigned int size, unsigned int frame, float *eye, float *velocity)
+{
+	if(!options.flightPath.empty())
+	{
+		//velocity from the previous point, or the next one for the first
+		const std::vector<float> &path = options.flightPath;
+		size_t i = frame % (path.size() / 4);
+		const float *a = &path[(i ? i - 1 : 0) * 4], *b = &path[(i ? i : 1) * 4];
+		float dt = b[0] - a[0];
+		for(int k = 0; k < 3; k++)
+		{
+			eye[k] = path[i * 4 + 1 + k];
+			velocity[k] = (dt > 0.0f) ? (b[1 + k] - a[1 + k]) / dt : 0.0f;
+		}
+		return;
+	}
+
+	const unsigned int steps = 1024;
+	float angle = 6.2831853f * (float)(frame % steps) / (float)steps;
+	float radius = (float)size * 0.35f, rate = 6.2831853f / (float)steps * 60.0f;
+	eye[0] = (float)size * 0.5f + radius * cosf(angle);
+	eye[1] = 0.0f;
+	eye[2] = (float)size * 0.5f + radius * sinf(angle);
+	velocity[0] = -radius * rate * sinf(angle);
+	velocity[1] = 0.0f;
+	velocity[2] = radius * rate * cosf(angle);
+}
+
+///----------------------------------------------------------------------------
+///Creates a directory and its missing parents
+///@return	false if path is not a directory and could not be made one
+///----------------------------------------------------------------------------
+static bool MakeDirectory(const std::string &path)
+{
+	for(size_t i = 1; i <= path.size(); i++)
+	{
+		if(i < path.size() && path[i] != '/' && path[i] != '\\')
+			continue;
+
+		std::string parent = path.substr(0, i);
+#ifdef _WIN32
+		int result = _mkdir(parent.c_str());
+#else
+		int result = mkdir(parent.c_str(), 0755);
+#endif
+		if(result != 0 && errno != EEXIST)
+			return false;
+	}
+
+	struct stat info;
+	return stat(path.c_str(), &info) == 0 && (info.st_mode & S_IFMT) == S_IFDIR;
+}
+
+///----------------------------------------------------------------------------
+///Parses the command line
+///----------------------------------------------------------------------------
+static bool ParseOptions(int argc, char **argv, BenchOptions &options)
+{
+	options.minTime = 0.5;
+	options.tileBudget = (double)(TerrainTileCache::DEFAULT_BUDGET >> 20);
+	options.jobThreads = 0;
+	options.viewRadius = 2048.0f;
+	options.minIters = 3;
+	options.workDir = ".";
+
+	for(int i = 1; i < argc; i++)
+	{
+		const char *arg = argv[i];
+		if(!strncmp(arg, "--sizes=", 8))
+		{
+			if(!ParseList(arg + 8, options.sizes)) return false;
+		}
+		else if(!strncmp(arg, "--formats=", 10))
+		{
+			if(!ParseList(arg + 10, options.formats)) return false;
+		}
+		else if(!strncmp(arg, "--cache-sizes=", 14))
+		{
+			if(!ParseList(arg + 14, options.cacheSizes)) return false;
+		}
+		else if(!strncmp(arg, "--min-time=", 11))	options.minTime = atof(arg + 11);
+		else if(!strncmp(arg, "--tile-budget-mb=", 17))	options.tileBudget = atof(arg + 17);
+		else if(!strncmp(arg, "--job-threads=", 14))	options.jobThreads = (unsigned int)strtoul(arg + 14, NULL, 10);
+		else if(!strncmp(arg, "--view-radius=", 14))	options.viewRadius = (float)atof(arg + 14);
+		else if(!strncmp(arg, "--flight-path=", 14))
+		{
+			if(!LoadFlightPath(arg + 14, options.flightPath)) return false;
+		}
+		else if(!strncmp(arg, "--filter=", 9))		options.filter = arg + 9;
+		else if(!strncmp(arg, "--json=", 7))		options.json = arg + 7;
+		else if(!strncmp(arg, "--work-dir=", 11))	options.workDir = arg + 11;
+		else if(!strncmp(arg, "--threads=", 10))	Parallel::SetThreadCount((unsigned int)strtoul(arg + 10, NULL, 10));
+		else return false;
+	}
+
+	if(options.sizes.empty())
+	{
+		static const unsigned int defaults[] = { 65, 257, 1025, 4097, 16385 };
+		options.sizes.assign(defaults, defaults + sizeof(defaults) / sizeof(defaults[0]));
+	}
+
+	if(options.formats.empty())
+	{
+		static const unsigned int defaults[] = { 8, 16, 32 };
+		options.formats.assign(defaults, defaults + sizeof(defaults) / sizeof(defaults[0]));
+	}
+
+	if(options.cacheSizes.empty())
+	{
+		static const unsigned int defaults[] = { 16, 24, 32 };
+		options.cacheSizes.assign(defaults, defaults + sizeof(defaults) / sizeof(defaults[0]));
+	}
+
+	for(size_t i = 0; i < options.sizes.size(); i++)
+		if(options.sizes[i] < 3) return false;
+	for(size_t i = 0; i < options.formats.size(); i++)
+		if(options.formats[i] != 8 && options.formats[i] != 16 && options.formats[i] != 32) return false;
+	for(size_t i = 0; i < options.cacheSizes.size(); i++)
+		if(options.cacheSizes[i] < 4) return false;
+
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Returns true if a case passes the filter
+///----------------------------------------------------------------------------
+static bool IsSelected(const BenchOptions &options, const char *name)
+{
+	return options.filter.empty() || strstr(name, options.filter.c_str()) != NULL;
+}
+
+///----------------------------------------------------------------------------
+///Creates a result if its case passes the filter
+///----------------------------------------------------------------------------
+static BenchResult* AddCase(std::vector<BenchResult> &results, const BenchOptions &options,
+							const char *name, unsigned int mapSize, const char *itemLabel)
+{
+	if(!IsSelected(options, name))
+		return NULL;
+
+	results.push_back(BenchResult());
+	BenchResult &result = results.back();
+	result.name = name;
+	result.mapSize = mapSize;
+	result.sampleBits = 0;
+	result.items = 0.0;
+	result.bytes = 0.0;
+	result.itemLabel = itemLabel;
+	return &result;
+}
+
+///----------------------------------------------------------------------------
+///Runs every case on one map size and sample precision
+///----------------------------------------------------------------------------
+static void RunMapSize(unsigned int size, unsigned int bits, const BenchOptions &options, std::vector<BenchResult> &results)
+{
+	char name[64];
+	sprintf(name, "bench_%u_%u.raw", size, bits);
+	std::string filename = options.workDir + "/" + name;
+	std::string cacheName = TerrainCache::GetCacheName(filename.c_str());
+
+	if(!GenerateHeightMap(size, bits, filename))
+	{
+		fprintf(stderr, "unable to write %s\n", filename.c_str());
+		return;
+	}
+	remove(cacheName.c_str());
+
+	double samples = (double)size * (double)size;
+	BenchResult *result;
+	size_t first = results.size();
+
+	//map the file and touch every sample
+	if((result = AddCase(results, options, "heightmap_load", size, "samples")) != NULL)
+	{
+		unsigned int checksum = 0;
+		Measure(*result, options, [&](unsigned int)
+		{
+			HeightField heightField;
+			heightField.Load(filename.c_str());
+			const unsigned char *data = (const unsigned char*)heightField.GetData();
+			size_t bytes = (size_t)heightField.GetSizeInBytes();
+			for(size_t i = 0; i < bytes; i++)
+				checksum += data[i];
+		});
+		result->items = samples;
+		result->bytes = samples * bits / 8;
+		result->counters.push_back(std::make_pair(std::string("checksum"), (double)(checksum & 0xffff)));
+		result->counters.push_back(std::make_pair(std::string("map_mb"), result->bytes / 1048576.0));
+	}
+
+	Terrain terrain;
+	if(!terrain.Load(filename.c_str()))
+	{
+		fprintf(stderr, "unable to load %s\n", filename.c_str());
+		results.resize(first);
+		return;
+	}
+
+	const HeightField &heightField = terrain.GetHeightField();
+	const TerrainQuadTree &quadTree = terrain.GetQuadTree();
+	unsigned int patchSize = quadTree.GetPatchSize();
+	unsigned int patchCount = quadTree.GetPatchCount();
+
+	//patches, occluders and LOD errors from the samples
+	if((result = AddCase(results, options, "hierarchy_build", size, "samples")) != NULL)
+	{
+		Measure(*result, options, [&](unsigned int)
+		{
+			TerrainQuadTree tree;
+			TerrainCuller culler;
+			TerrainLOD lod;
+			tree.Build(heightField, patchSize);
+			culler.Build(tree, heightField);
+			lod.Build(tree, heightField);
+		});
+		result->items = samples;
+		result->bytes = (double)heightField.GetSizeInBytes();
+	}
+
+	//the same structures from the mapped sidecar
+	if((result = AddCase(results, options, "hierarchy_cached", size, "samples")) != NULL)
+	{
+		Measure(*result, options, [&](unsigned int)
+		{
+			TerrainCache cache;
+			TerrainQuadTree tree;
+			TerrainCuller culler;
+			TerrainLOD lod;
+			if(!cache.Open(filename.c_str(), heightField, patchSize))
+				return;
+			tree.Build(heightField, patchSize, cache.GetPatchHeights());
+			culler.Build(tree, heightField, cache.GetOccluderHeights());
+			lod.Build(tree, heightField, cache.GetErrors());
+		});
+		result->items = samples;
+		result->bytes = (double)heightField.GetSizeInBytes();
+	}
+
+	//every patch into one scratch buffer, as CreateTerrain fills its buffers,
+	//with the scalar kernel, the best SIMD kernel, then SIMD on every thread
+	for(unsigned int mode = 0; mode < 3; mode++)
+	{
+		static const char *names[] = { "vertex_gen_scalar", "vertex_gen", "vertex_gen_mt" };
+		if((result = AddCase(results, options, names[mode], size, "vertices")) == NULL)
+			continue;
+
+		unsigned int threads = (mode == 2) ? Parallel::GetThreadCount() : 1;
+		std::vector<Vertex3D> vertices(quadTree.GetPatchVertexCount() * threads);
+		TerrainMesh::EnableSIMD(mode != 0);
+		Measure(*result, options, [&](unsigned int)
+		{
+			if(threads == 1)
+			{
+				for(unsigned int i = 0; i < patchCount; i++)
+					TerrainMesh::BuildPatchVertices(heightField, quadTree.GetPatch(i), patchSize, &vertices[0]);
+				return;
+			}
+
+			Parallel::For(patchCount, quadTree.GetPatchCountX(), [&](unsigned int begin, unsigned int end, unsigned int worker)
+			{
+				Vertex3D *scratch = &vertices[worker * quadTree.GetPatchVertexCount()];
+				for(unsigned int i = begin; i < end; i++)
+					TerrainMesh::BuildPatchVertices(heightField, quadTree.GetPatch(i), patchSize, scratch);
+			});
+		});
+		TerrainMesh::EnableSIMD(true);
+		result->items = (double)patchCount * quadTree.GetPatchVertexCount();
+		result->bytes = result->items * sizeof(Vertex3D);
+		result->counters.push_back(std::make_pair(std::string("threads"), (double)threads));
+	}
+
+	//compact layout, with the whole map mesh footprint of both layouts
+	if((result = AddCase(results, options, "vertex_gen_packed", size, "vertices")) != NULL)
+	{
+		std::vector<PackedVertex> vertices(quadTree.GetPatchVertexCount());
+		Measure(*result, options, [&](unsigned int)
+		{
+			for(unsigned int i = 0; i < patchCount; i++)
+				TerrainMesh::BuildPackedPatchVertices(heightField, quadTree.GetPatch(i), patchSize, &vertices[0]);
+		});
+		result->items = (double)patchCount * vertices.size();
+		result->bytes = result->items * sizeof(PackedVertex);
+		result->counters.push_back(std::make_pair(std::string("mesh_mb_float"), result->items * sizeof(Vertex3D) / 1048576.0));
+		result->counters.push_back(std::make_pair(std::string("mesh_mb_packed"), result->bytes / 1048576.0));
+		result->counters.push_back(std::make_pair(std::string("mesh_ratio"), (double)sizeof(Vertex3D) / sizeof(PackedVertex)));
+	}
+
+	if((result = AddCase(results, options, "vertex_decode", size, "vertices")) != NULL)
+	{
+		unsigned int count = quadTree.GetPatchVertexCount();
+		std::vector<PackedVertex> packed(count * patchCount);
+		std::vector<Vertex3D> vertices(count);
+		for(unsigned int i = 0; i < patchCount; i++)
+			TerrainMesh::BuildPackedPatchVertices(heightField, quadTree.GetPatch(i), patchSize, &packed[i * count]);
+		Measure(*result, options, [&](unsigned int)
+		{
+			for(unsigned int i = 0; i < patchCount; i++)
+				TerrainMesh::DecodePatchVertices(heightField, quadTree.GetPatch(i), &packed[i * count], count, &vertices[0]);
+		});
+		result->items = (double)patchCount * count;
+		result->bytes = result->items * sizeof(PackedVertex);
+
+		//what the 16-bit packed heights cost in precision
+		float maxError = 0.0f;
+		for(unsigned int i = 0; i < patchCount; i++)
+		{
+			TerrainMesh::DecodePatchVertices(heightField, quadTree.GetPatch(i), &packed[i * count], count, &vertices[0]);
+			for(unsigned int v = 0; v < count; v++)
+			{
+				float error = fabsf(vertices[v].y - heightField.GetElevation((unsigned int)vertices[v].x, (unsigned int)vertices[v].z));
+				maxError = std::max(maxError, error);
+			}
+		}
+		result->counters.push_back(std::make_pair(std::string("max_height_error"), (double)maxError));
+	}
+
+	//normals and slopes of the whole map: scalar, SIMD, SIMD on every
+	//thread, then a 64x64 brush sized dirty rectangle moving over the map
+	std::vector<unsigned short> normals;
+	std::vector<unsigned char> slopes;
+	for(unsigned int mode = 0; mode < 4; mode++)
+	{
+		static const char *names[] = { "normal_gen_scalar", "normal_gen", "normal_gen_mt", "normal_update" };
+		if((result = AddCase(results, options, names[mode], size, "samples")) == NULL)
+			continue;
+
+		normals.resize((size_t)size * size);
+		slopes.resize((size_t)size * size);
+		unsigned int threads = Parallel::GetThreadCount();
+		if(mode != 2) Parallel::SetThreadCount(1);
+		TerrainMesh::EnableSIMD(mode != 0);
+
+		const unsigned int brush = std::min(64u, size);
+		Measure(*result, options, [&](unsigned int i)
+		{
+			if(mode < 3)
+			{
+				TerrainMesh::BuildNormals(heightField, &normals[0], &slopes[0]);
+				return;
+			}
+
+			unsigned int x = (i * 97u) % (size - brush + 1), z = (i * 61u) % (size - brush + 1);
+			TerrainMesh::UpdateNormals(heightField, x, z, brush, brush, &normals[0], &slopes[0]);
+		});
+
+		TerrainMesh::EnableSIMD(true);
+		result->counters.push_back(std::make_pair(std::string("threads"), (double)Parallel::GetThreadCount()));
+		Parallel::SetThreadCount(threads);
+		result->items = (mode < 3) ? samples : (double)(brush + 2) * (brush + 2);
+		result->bytes = result->items * (heightField.GetSampleSize() + sizeof(unsigned short) + sizeof(unsigned char));
+	}
+	std::vector<unsigned short>().swap(normals);
+	std::vector<unsigned char>().swap(slopes);
+
+	//one frame per camera pose along a loop over the map
+	const unsigned int frames = 64;
+	std::vector<float> eyes(frames * 3), scales(frames);
+	std::vector<Frustum> frustums(frames);
+	for(unsigned int f = 0; f < frames; f++)
+		CameraPose(terrain, f, frames, frustums[f], &eyes[f * 3], scales[f]);
+
+	if((result = AddCase(results, options, "cull", size, "patches")) != NULL)
+	{
+		std::vector<unsigned int> visible;
+		double visibleSum = 0.0, horizonSum = 0.0;
+		Measure(*result, options, [&](unsigned int i)
+		{
+			unsigned int f = i % frames;
+			visibleSum += terrain.GetCuller().Cull(frustums[f], &eyes[f * 3], visible);
+			horizonSum += terrain.GetCuller().GetHorizonCulledCount();
+		});
+		double n = (double)result->samples.size();
+		result->items = patchCount;
+		result->counters.push_back(std::make_pair(std::string("visible_patches"), visibleSum / n));
+		result->counters.push_back(std::make_pair(std::string("horizon_culled"), horizonSum / n));
+	}
+
+	//per frame level selection, plus the submitted triangle counts it leads to
+	if((result = AddCase(results, options, "lod_select", size, "patches")) != NULL)
+	{
+		double lodTriangles = 0.0, fullTriangles = 0.0;
+		Measure(*result, options, [&](unsigned int i)
+		{
+			unsigned int f = i % frames;
+			terrain.SetLOD(true);
+			terrain.Update(frustums[f], &eyes[f * 3], scales[f]);
+		});
+		for(unsigned int f = 0; f < frames; f++)
+		{
+			terrain.SetLOD(true);
+			terrain.Update(frustums[f], &eyes[f * 3], scales[f]);
+			lodTriangles += terrain.GetLOD().GetTriangleCount(terrain.GetVisiblePatches());
+			terrain.SetLOD(false);
+			terrain.Update(frustums[f], &eyes[f * 3], scales[f]);
+			fullTriangles += terrain.GetLOD().GetTriangleCount(terrain.GetVisiblePatches());
+		}
+		result->items = patchCount;
+		result->counters.push_back(std::make_pair(std::string("triangles_lod"), lodTriangles / frames));
+		result->counters.push_back(std::make_pair(std::string("triangles_full"), fullTriangles / frames));
+		result->counters.push_back(std::make_pair(std::string("triangle_reduction"),
+								   lodTriangles > 0.0 ? fullTriangles / lodTriangles : 0.0));
+	}
+
+	//CPU cost of a frame on a null device: culling and level selection, then
+	//the draws the viewer makes, with the submission part reported apart
+	if((result = AddCase(results, options, "frame_null", size, "draws")) != NULL)
+	{
+		RecordingBackend backend;
+		TerrainBuffers buffers;
+		buffers.Create(backend, terrain);
+		static const float world[16] = { 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1 };
+		double submitNs = 0.0, draws = 0.0, triangles = 0.0;
+		unsigned int invalid = 0;
+		terrain.SetLOD(true);
+		Measure(*result, options, [&](unsigned int i)
+		{
+			unsigned int f = i % frames;
+			terrain.Update(frustums[f], &eyes[f * 3], scales[f]);
+
+			BenchClock::time_point t0 = BenchClock::now();
+			backend.BeginFrame(0xFF2D32AA);
+			backend.SetTransform(TRANSFORM_WORLD, world);
+			buffers.Draw(terrain);
+			backend.EndFrame();
+			submitNs += (double)std::chrono::duration_cast<std::chrono::nanoseconds>(BenchClock::now() - t0).count();
+
+			draws += backend.GetStats().drawCalls;
+			triangles += (double)backend.GetStats().triangles;
+			invalid += backend.GetInvalidDrawCount();
+		});
+
+		double n = (double)result->samples.size();
+		result->items = draws / n;
+		result->counters.push_back(std::make_pair(std::string("submit_us"), submitNs / n * 1e-3));
+		result->counters.push_back(std::make_pair(std::string("triangles"), triangles / n));
+		result->counters.push_back(std::make_pair(std::string("invalid_draws"), (double)invalid));
+	}
+
+	//the viewer's per frame work after culling, on a null device: submission,
+	//the profiler and the overlay (culling is timed by frame_null and would
+	//dominate here). TerrainTests checks that these frames do not allocate.
+	if((result = AddCase(results, options, "hud_frame", size, "frames")) != NULL)
+	{
+		RecordingBackend backend;
+		TerrainBuffers buffers;
+		buffers.Create(backend, terrain);
+		terrain.SetLOD(true);
+		terrain.Update(frustums[0], &eyes[0], scales[0]);
+		StatsOverlay overlay;
+		overlay.AddLine("%.0f FPS  %.2f ms");
+		overlay.AddLine("patches %.0f  triangles %.0f  draws %.0f");
+		overlay.AddLine("frame p50 %.2f p99 %.2f ms  draw_submit p95 %.1f us");
+		unsigned int submitZone = Profiler::RegisterZone("draw_submit");
+
+		unsigned long long frameCount = 0;
+		auto frame = [&]()
+		{
+			unsigned int f = (unsigned int)(frameCount++ % frames);
+			backend.BeginFrame(0xFF2D32AA);
+			buffers.Draw(terrain);
+
+			overlay.SetValue(0, 0, (double)(frameCount / 60));
+			overlay.SetValue(0, 1, (double)f);
+			overlay.SetValue(1, 0, (double)terrain.GetVisiblePatches().size());
+			overlay.SetValue(1, 1, (double)backend.GetStats().triangles);
+			overlay.SetValue(1, 2, (double)backend.GetStats().drawCalls);
+			if(frameCount % 30 == 0)
+			{
+				ProfileZoneStats stats;
+				Profiler::GetZoneStats(Profiler::FRAME_ZONE, stats);
+				overlay.SetValue(2, 0, stats.p50 * 1e-6);
+				overlay.SetValue(2, 1, stats.p99 * 1e-6);
+				Profiler::GetZoneStats(submitZone, stats);
+				overlay.SetValue(2, 2, stats.p95 * 1e-3);
+			}
+			for(unsigned int line = 0; line < overlay.GetLineCount(); line++)
+				overlay.GetText(line);
+
+			backend.EndFrame();
+			Profiler::EndFrame();
+		};
+
+		//warm up the buffers sized on first use
+		for(unsigned int n = 0; n < frames; n++)
+			frame();
+		Measure(*result, options, [&](unsigned int)
+		{
+			frame();
+		});
+
+		result->items = 1;
+		result->counters.push_back(std::make_pair(std::string("formats_per_frame"), (double)overlay.GetFormatCount() / (double)frameCount));
+	}
+
+	//software rasterizer, 800x600 frames of four poses along the path with
+	//the LOD ranges the viewer would draw; the visible patches are meshed
+	//up front so only the renderer is timed
+	static const char *renderNames[] = { "render_solid", "render_wireframe" };
+	for(unsigned int mode = 0; mode < 2; mode++)
+	{
+		if((result = AddCase(results, options, renderNames[mode], size, "triangles")) == NULL)
+			continue;
+
+		const unsigned int poses = 4, vertexCount = quadTree.GetPatchVertexCount();
+		bool index16 = TerrainMesh::FitsIndex16(patchSize);
+		std::vector<unsigned short> indices16(index16 ? terrain.GetLOD().GetIndexCount() : 0);
+		std::vector<unsigned int> indices32(index16 ? 0 : terrain.GetLOD().GetIndexCount());
+		if(index16)
+			terrain.GetLOD().BuildIndices(&indices16[0]);
+		else
+			terrain.GetLOD().BuildIndices(&indices32[0]);
+
+		std::vector<std::vector<unsigned int> > patches(poses);
+		std::vector<std::vector<IndexRange> > ranges(poses);
+		std::vector<std::vector<Vertex3D> > vertices(poses);
+		terrain.SetLOD(true);
+		for(unsigned int p = 0; p < poses; p++)
+		{
+			unsigned int f = p * frames / poses;
+			terrain.Update(frustums[f], &eyes[f * 3], scales[f]);
+			patches[p] = terrain.GetVisiblePatches();
+			vertices[p].resize(patches[p].size() * vertexCount);
+			for(size_t v = 0; v < patches[p].size(); v++)
+			{
+				ranges[p].push_back(terrain.GetLOD().GetPatchRange(patches[p][v]));
+				TerrainMesh::BuildPatchVertices(heightField, quadTree.GetPatch(patches[p][v]), patchSize,
+												&vertices[p][v * vertexCount]);
+			}
+		}
+
+		static const float sun[3] = { 0.4f, -1.0f, 0.3f };
+		SoftwareRenderer renderer;
+		renderer.Create(800, 600);
+		renderer.SetFillMode(mode ? FILL_WIREFRAME : FILL_SOLID);
+		renderer.SetLight(mode ? NULL : sun);
+		double triangleSum = 0.0;
+		Measure(*result, options, [&](unsigned int i)
+		{
+			unsigned int p = i % poses;
+			renderer.Clear(0xFF2D32AA);
+			renderer.SetTransform(frustums[p * frames / poses].GetViewProj());
+			for(size_t v = 0; v < patches[p].size(); v++)
+			{
+				const Vertex3D *patch = &vertices[p][v * vertexCount];
+				if(index16)
+					renderer.DrawIndexed(patch, vertexCount, &indices16[0], ranges[p][v].first, ranges[p][v].count / 3);
+				else
+					renderer.DrawIndexed(patch, vertexCount, &indices32[0], ranges[p][v].first, ranges[p][v].count / 3);
+			}
+			renderer.Flush();
+			triangleSum += renderer.GetTriangleCount();
+		});
+
+		result->items = triangleSum / result->samples.size();
+		result->bytes = 800.0 * 600.0 * (sizeof(unsigned int) + sizeof(float));
+		result->counters.push_back(std::make_pair(std::string("threads"), (double)Parallel::GetThreadCount()));
+	}
+
+	//CPU queries against the surface, batches of 4096: heights at random
+	//points, pick rays from the camera path toward random ground points, and
+	//line of sight between points 2 units above the ground up to 512 apart;
+	//the _mt cases spread the batch over every thread. The _256 cases run
+	//the first 256 queries only, where starting threads per batch would
+	//cost more than the queries.
+	static const char *queryNames[] = { "query_build", "height_query", "raycast", "raycast_mt", "line_of_sight", "line_of_sight_mt",
+										"raycast_256", "raycast_256_mt", "line_of_sight_256", "line_of_sight_256_mt" };
+	const unsigned int batch = 4096, smallBatch = 256;
+	std::vector<float> points(batch * 2), heights(batch), from(batch * 3), to(batch * 3);
+	std::vector<TerrainRay> rays(batch);
+	std::vector<TerrainHit> hits(batch);
+	std::vector<unsigned char> visible(batch);
+	terrain.EnableQueries(true);
+	const TerrainQuery &query = terrain.GetQuery();
+
+	float extent = (float)(size - 1);
+	for(unsigned int i = 0; i < batch; i++)
+	{
+		float x = (Hash(i, 0, 17) & 0xffff) / 65535.0f * extent, z = (Hash(i, 1, 17) & 0xffff) / 65535.0f * extent;
+		float dx = ((Hash(i, 2, 17) & 0xffff) / 65535.0f - 0.5f) * 1024.0f;
+		float dz = ((Hash(i, 3, 17) & 0xffff) / 65535.0f - 0.5f) * 1024.0f;
+		points[i * 2] = x;
+		points[i * 2 + 1] = z;
+
+		const float *eye = &eyes[(i % frames) * 3];
+		float ground;
+		query.GetHeight(x, z, ground);
+		TerrainRay &ray = rays[i];
+		for(unsigned int k = 0; k < 3; k++)
+			ray.origin[k] = eye[k];
+		ray.direction[0] = x - eye[0];
+		ray.direction[1] = ground - eye[1];
+		ray.direction[2] = z - eye[2];
+		ray.length = 1.5f;
+
+		from[i * 3] = x;
+		from[i * 3 + 1] = ground + 2.0f;
+		from[i * 3 + 2] = z;
+		to[i * 3] = std::min(std::max(x + dx, 0.0f), extent);
+		to[i * 3 + 2] = std::min(std::max(z + dz, 0.0f), extent);
+		query.GetHeight(to[i * 3], to[i * 3 + 2], to[i * 3 + 1]);
+		to[i * 3 + 1] += 2.0f;
+	}
+
+	for(unsigned int mode = 0; mode < 10; mode++)
+	{
+		if((result = AddCase(results, options, queryNames[mode], size, mode ? "queries" : "samples")) == NULL)
+			continue;
+
+		unsigned int threads = Parallel::GetThreadCount();
+		if(mode != 3 && mode != 5 && mode != 7 && mode != 9) Parallel::SetThreadCount(1);
+
+		//modes 6..9 repeat 2..5 on the small batch
+		unsigned int kind = (mode >= 6) ? mode - 4 : mode;
+		unsigned int count = (mode >= 6) ? smallBatch : batch;
+		unsigned int found = 0;
+		Measure(*result, options, [&](unsigned int)
+		{
+			if(kind == 0)
+			{
+				terrain.EnableQueries(false);
+				terrain.EnableQueries(true);
+			}
+			else if(kind == 1)
+				query.GetHeights(&points[0], count, &heights[0]);
+			else if(kind <= 3)
+				found += query.Raycast(&rays[0], count, &hits[0]);
+			else
+				found += query.TestLineOfSight(&from[0], &to[0], count, &visible[0]);
+		});
+
+		result->counters.push_back(std::make_pair(std::string("threads"), (double)Parallel::GetThreadCount()));
+		Parallel::SetThreadCount(threads);
+		if(mode == 0)
+		{
+			result->items = samples;
+			result->counters.push_back(std::make_pair(std::string("levels"), (double)query.GetLevelCount()));
+			result->counters.push_back(std::make_pair(std::string("pyramid_mb"), query.GetSizeInBytes() / 1048576.0));
+			continue;
+		}
+
+		result->items = count;
+		if(kind >= 2)
+			result->counters.push_back(std::make_pair(std::string(kind <= 3 ? "hit_rate" : "visible_rate"),
+									   found / ((double)count * result->samples.size())));
+	}
+	terrain.EnableQueries(false);
+
+	//paging the map through a bounded tile cache, one Update per frame along
+	//a slow loop (or --flight-path), 2048 units of view distance by default; loads
+	//(read + mesh) happen in Update or on the job system, the last case also
+	//prefetches along the camera velocity
+	static const char *streamNames[] = { "tile_stream", "tile_stream_async", "tile_stream_prefetch" };
+	for(unsigned int mode = 0; mode < 3; mode++)
+	{
+		if((result = AddCase(results, options, streamNames[mode], size, "tiles")) == NULL)
+			continue;
+
+		JobSystem jobs;
+		TerrainTileCache tiles;
+		tiles.Open(filename.c_str());
+		tiles.SetBudget((unsigned long long)(options.tileBudget * 1048576.0));
+		if(mode >= 1)
+		{
+			jobs.Start(options.jobThreads);
+			tiles.SetJobSystem(&jobs);
+		}
+
+		float radius = std::min(options.viewRadius, (float)size * 0.5f), resident = 0.0f;
+		unsigned long long allocations = 0;
+		Measure(*result, options, [&](unsigned int i)
+		{
+			float eye[3], velocity[3];
+			GetFlightPose(options, size, i, eye, velocity);
+			unsigned long long before = s_Allocations.load();
+			resident += (float)tiles.Update(eye, radius, (mode == 2) ? velocity : NULL);
+			allocations += s_Allocations.load() - before;
+		});
+
+		const TileCacheStats &stats = tiles.GetStats();
+		double n = (double)result->samples.size();
+		result->items = resident / n;
+		result->bytes = (double)stats.loads * heightField.GetSampleSize() * (TerrainTileCache::DEFAULT_TILE_SIZE + 1) *
+						(TerrainTileCache::DEFAULT_TILE_SIZE + 1) / n;
+		result->counters.push_back(std::make_pair(std::string("hit_rate"), (double)tiles.GetHitRate()));
+		result->counters.push_back(std::make_pair(std::string("loads"), (double)stats.loads));
+		result->counters.push_back(std::make_pair(std::string("evictions"), (double)stats.evictions));
+		result->counters.push_back(std::make_pair(std::string("stalls"), (double)stats.stalls));
+		result->counters.push_back(std::make_pair(std::string("stall_ms"), stats.stallNanoseconds * 1e-6));
+		result->counters.push_back(std::make_pair(std::string("skipped"), (double)stats.skipped));
+		result->counters.push_back(std::make_pair(std::string("max_update_ms"), stats.maxUpdateNanoseconds * 1e-6));
+		result->counters.push_back(std::make_pair(std::string("over_budget_frames"), (double)stats.overBudgetFrames));
+		result->counters.push_back(std::make_pair(std::string("resident_mb"), stats.residentBytes / 1048576.0));
+		result->counters.push_back(std::make_pair(std::string("peak_mb"), stats.peakBytes / 1048576.0));
+		result->counters.push_back(std::make_pair(std::string("budget_mb"), options.tileBudget));
+		result->counters.push_back(std::make_pair(std::string("allocs_per_load"), stats.loads ? (double)allocations / stats.loads : 0.0));
+		result->counters.push_back(std::make_pair(std::string("recycled"), (double)stats.recycled));
+		result->counters.push_back(std::make_pair(std::string("scratch_peak_kb"), tiles.GetScratchStats().highWater / 1024.0));
+		result->counters.push_back(std::make_pair(std::string("node_peak_kb"), tiles.GetNodeStats().highWater / 1024.0));
+		if(mode == 2)
+		{
+			result->counters.push_back(std::make_pair(std::string("prefetches"), (double)stats.prefetches));
+			result->counters.push_back(std::make_pair(std::string("prefetch_hits"), (double)stats.prefetchHits));
+			result->counters.push_back(std::make_pair(std::string("prefetch_late"), (double)stats.prefetchLate));
+			result->counters.push_back(std::make_pair(std::string("prefetch_wasted"), (double)stats.prefetchWasted));
+			result->counters.push_back(std::make_pair(std::string("prefetch_accuracy"), (double)tiles.GetPrefetchAccuracy()));
+		}
+		tiles.Close();
+	}
+
+	//the map as a terrain package: opening maps the header only, tiles are
+	//wrapped in place (raw) or inflated (deflate) and every sample is read
+	std::string packageName = filename + ".tpk";
+	static const char *packageNames[] = { "package_tile", "package_tile_deflate" };
+	for(unsigned int codec = PACKAGE_RAW; codec <= PACKAGE_DEFLATE; codec++)
+	{
+		bool open = (codec == PACKAGE_RAW) && IsSelected(options, "package_open");
+		if(!TerrainPackage::HasCodec((PackageCodec)codec) || (!open && !IsSelected(options, packageNames[codec])))
+			continue;
+
+		TerrainPackage package;
+		if(!TerrainPackage::Write(heightField, packageName.c_str(), TerrainTileCache::DEFAULT_TILE_SIZE, (PackageCodec)codec) ||
+		   !package.Open(packageName.c_str()))
+		{
+			fprintf(stderr, "unable to write %s\n", packageName.c_str());
+			continue;
+		}
+
+		if(open && (result = AddCase(results, options, "package_open", size, "opens")) != NULL)
+		{
+			Measure(*result, options, [&](unsigned int)
+			{
+				TerrainPackage reopened;
+				reopened.Open(packageName.c_str());
+			});
+			result->items = 1.0;
+			result->counters.push_back(std::make_pair(std::string("package_mb"), package.GetFileSize() / 1048576.0));
+		}
+
+		if((result = AddCase(results, options, packageNames[codec], size, "tiles")) != NULL)
+		{
+			unsigned int checksum = 0, tileCount = package.GetTilesX() * package.GetTilesZ();
+			unsigned long long stored = 0;
+			Measure(*result, options, [&](unsigned int)
+			{
+				HeightField tile;
+				for(unsigned int z = 0; z < package.GetTilesZ(); z++)
+				{
+					for(unsigned int x = 0; x < package.GetTilesX(); x++)
+					{
+						if(!package.GetTile(x, z, tile)) continue;
+						const unsigned char *data = (const unsigned char*)tile.GetData();
+						size_t bytes = (size_t)tile.GetSizeInBytes();
+						for(size_t i = 0; i < bytes; i++)
+							checksum += data[i];
+					}
+				}
+			});
+			for(unsigned int z = 0; z < package.GetTilesZ(); z++)
+				for(unsigned int x = 0; x < package.GetTilesX(); x++)
+					stored += package.GetTileInfo(x, z)->storedBytes;
+
+			result->items = tileCount;
+			result->bytes = samples * heightField.GetSampleSize();
+			result->counters.push_back(std::make_pair(std::string("stored_mb"), stored / 1048576.0));
+			result->counters.push_back(std::make_pair(std::string("ratio"), result->bytes / (double)stored));
+			result->counters.push_back(std::make_pair(std::string("checksum"), (double)(checksum & 0xffff)));
+		}
+
+		package.Close();
+		remove(packageName.c_str());
+	}
+
+	//sculpting: a radius 16 brush moving over the map, then the refresh and
+	//vertex rebuild of the patches it dirtied, as a frame after the stroke
+	//would do; the second case keeps normals up to date as well
+	static const char *editNames[] = { "edit_brush", "edit_brush_normals" };
+	for(unsigned int mode = 0; mode < 2; mode++)
+	{
+		if((result = AddCase(results, options, editNames[mode], size, "samples")) == NULL)
+			continue;
+
+		const float radius = std::min(16.0f, size * 0.25f);
+		std::vector<Vertex3D> vertices(quadTree.GetPatchVertexCount());
+		double dirtySum = 0.0;
+		terrain.EnableNormals(mode == 1);
+		terrain.EditBrush(EDIT_RAISE, size * 0.5f, size * 0.5f, radius, 0.0f);
+		terrain.Refresh();
+		terrain.ClearDirtyPatches();
+		Measure(*result, options, [&](unsigned int i)
+		{
+			float x = radius + (float)((i * 97u) % std::max(1u, (unsigned int)(size - 2.0f * radius)));
+			float z = radius + (float)((i * 61u) % std::max(1u, (unsigned int)(size - 2.0f * radius)));
+			terrain.EditBrush(EDIT_RAISE, x, z, radius, (i & 1) ? -1.0f : 1.0f);
+			terrain.Refresh();
+
+			const std::vector<unsigned int> &dirty = terrain.GetDirtyPatches();
+			for(size_t d = 0; d < dirty.size(); d++)
+				TerrainMesh::BuildPatchVertices(heightField, quadTree.GetPatch(dirty[d]), patchSize, &vertices[0]);
+			dirtySum += (double)dirty.size();
+			terrain.ClearDirtyPatches();
+		});
+		terrain.EnableNormals(false);
+
+		result->items = (2.0 * radius + 1.0) * (2.0 * radius + 1.0);
+		result->counters.push_back(std::make_pair(std::string("dirty_patches"), dirtySum / result->samples.size()));
+	}
+
+	for(size_t i = first; i < results.size(); i++)
+	{
+		results[i].sampleBits = bits;
+		PrintResult(results[i]);
+	}
+
+	terrain.Release();
+	remove(filename.c_str());
+	remove((filename + ".hdr").c_str());
+	remove(cacheName.c_str());
+}
+
+///----------------------------------------------------------------------------
+///Index generation does not depend on the map, only on the patch size
+///----------------------------------------------------------------------------
+static void RunIndexGeneration(const BenchOptions &options, std::vector<BenchResult> &results)
+{
+	unsigned int patchSize = TerrainQuadTree::DEFAULT_PATCH_SIZE;
+	BenchResult *result;
+
+	if((result = AddCase(results, options, "index_gen_full", patchSize, "indices")) != NULL)
+	{
+		std::vector<unsigned short> indices(TerrainMesh::GetPatchPrimitiveCount(patchSize) * 3);
+		Measure(*result, options, [&](unsigned int)
+		{
+			TerrainMesh::BuildPatchIndices(patchSize, &indices[0]);
+		});
+		result->items = (double)indices.size();
+		result->bytes = result->items * sizeof(unsigned short);
+		PrintResult(*result);
+	}
+
+	if((result = AddCase(results, options, "index_gen_lod", patchSize, "indices")) != NULL)
+	{
+		unsigned int count = 0;
+		for(unsigned int level = 0; (1u << level) <= patchSize; level++)
+			for(unsigned int mask = 0; mask < TerrainLOD::STITCH_VARIANTS; mask++)
+				count += TerrainMesh::BuildLODIndices<unsigned short>(patchSize, level, mask, NULL);
+
+		std::vector<unsigned short> indices(count);
+		Measure(*result, options, [&](unsigned int)
+		{
+			unsigned short *out = &indices[0];
+			for(unsigned int level = 0; (1u << level) <= patchSize; level++)
+				for(unsigned int mask = 0; mask < TerrainLOD::STITCH_VARIANTS; mask++)
+					out += TerrainMesh::BuildLODIndices(patchSize, level, mask, out);
+		});
+		result->items = (double)count;
+		result->bytes = result->items * sizeof(unsigned short);
+		PrintResult(*result);
+	}
+
+	//what startup pays for the sets with a compile time table: a copy
+	if((result = AddCase(results, options, "index_table", patchSize, "indices")) != NULL)
+	{
+		const LODIndexSets *sets = TerrainIndexTable::Find(patchSize);
+		std::vector<unsigned short> indices(sets ? sets->indexCount : 0);
+		Measure(*result, options, [&](unsigned int)
+		{
+			if(sets)
+				memcpy(&indices[0], sets->indices, indices.size() * sizeof(unsigned short));
+		});
+		result->items = (double)indices.size();
+		result->bytes = result->items * sizeof(unsigned short);
+		result->counters.push_back(std::make_pair(std::string("sets"), sets ? (double)sets->levelCount * TerrainIndexTable::STITCH_VARIANTS : 0.0));
+		result->counters.push_back(std::make_pair(std::string("table_kb"), result->bytes / 1024.0));
+		PrintResult(*result);
+	}
+
+	//reordering cost, and cache misses of every set (each drawn on its own)
+	//in the generated banded order against the reordered one
+	if((result = AddCase(results, options, "index_cache", patchSize, "indices")) != NULL)
+	{
+		TerrainQuadTree quadTree;
+		HeightField heightField;
+		heightField.Create(patchSize + 1, patchSize + 1, HEIGHT_UINT8);
+		quadTree.Build(heightField, patchSize);
+
+		TerrainLOD lod;
+		lod.Build(quadTree, heightField);
+		std::vector<unsigned short> banded(lod.GetIndexCount()), optimized(lod.GetIndexCount());
+		lod.BuildIndices(&banded[0]);
+
+		Measure(*result, options, [&](unsigned int)
+		{
+			lod.BuildIndices(&optimized[0], true);
+		});
+		result->items = (double)optimized.size();
+		result->bytes = result->items * sizeof(unsigned short);
+
+		static const char *policies[] = { "fifo", "lru" };
+		for(size_t i = 0; i < options.cacheSizes.size(); i++)
+		{
+			for(unsigned int policy = CACHE_FIFO; policy <= CACHE_LRU; policy++)
+			{
+				double misses[2] = { 0.0, 0.0 }, triangles = 0.0, vertices = 0.0;
+				for(unsigned int level = 0; level < lod.GetLevelCount(); level++)
+				{
+					for(unsigned int mask = 0; mask < TerrainLOD::STITCH_VARIANTS; mask++)
+					{
+						const IndexRange &range = lod.GetIndexRange(level, mask);
+						CacheStats before = VertexCache::Simulate(&banded[range.first], range.count, options.cacheSizes[i], (CachePolicy)policy);
+						CacheStats after = VertexCache::Simulate(&optimized[range.first], range.count, options.cacheSizes[i], (CachePolicy)policy);
+						misses[0] += before.misses;
+						misses[1] += after.misses;
+						triangles += before.triangles;
+						vertices += before.vertices;
+					}
+				}
+
+				char name[64];
+				sprintf(name, "acmr_%s%u_banded", policies[policy], options.cacheSizes[i]);
+				result->counters.push_back(std::make_pair(std::string(name), misses[0] / triangles));
+				sprintf(name, "acmr_%s%u", policies[policy], options.cacheSizes[i]);
+				result->counters.push_back(std::make_pair(std::string(name), misses[1] / triangles));
+				sprintf(name, "atvr_%s%u_banded", policies[policy], options.cacheSizes[i]);
+				result->counters.push_back(std::make_pair(std::string(name), misses[0] / vertices));
+				sprintf(name, "atvr_%s%u", policies[policy], options.cacheSizes[i]);
+				result->counters.push_back(std::make_pair(std::string(name), misses[1] / vertices));
+			}
+		}
+		PrintResult(*result);
+	}
+}
+
+///----------------------------------------------------------------------------
+///Job body of the job_submit case
+///----------------------------------------------------------------------------
+static void CountJob(void *data)
+{
+	((std::atomic<unsigned int>*)data)->fetch_add(1);
+}
+
+///----------------------------------------------------------------------------
+///Job system overhead: submitting empty jobs and waiting for them
+///----------------------------------------------------------------------------
+static void RunJobSystem(const BenchOptions &options, std::vector<BenchResult> &results)
+{
+	BenchResult *result;
+	if((result = AddCase(results, options, "job_submit", 0, "jobs")) == NULL)
+		return;
+
+	const unsigned int count = 10000;
+	std::atomic<unsigned int> done(0);
+	JobSystem jobs;
+	jobs.Start(options.jobThreads);
+
+	Measure(*result, options, [&](unsigned int)
+	{
+		for(unsigned int i = 0; i < count; i++)
+			jobs.Submit(CountJob, &done);
+		jobs.Wait();
+	});
+	result->items = count;
+	result->counters.push_back(std::make_pair(std::string("workers"), (double)jobs.GetThreadCount()));
+	result->counters.push_back(std::make_pair(std::string("steals"), (double)jobs.GetStealCount()));
+	result->counters.push_back(std::make_pair(std::string("completed"), (double)done.load()));
+	PrintResult(*result);
+}
+
+///----------------------------------------------------------------------------
+///Profiler overhead: an empty zone, enabled and disabled, and draining the
+///events into the statistics
+///----------------------------------------------------------------------------
+static void RunProfiler(const BenchOptions &options, std::vector<BenchResult> &results)
+{
+	BenchResult *result;
+	if((result = AddCase(results, options, "profile_zone", 0, "zones")) == NULL)
+		return;
+
+	//half a ring per iteration, so nothing is dropped between drains
+	const unsigned int count = Profiler::RING_SIZE / 2;
+	double zoneNs = 0.0, disabledNs = 0.0, collectNs = 0.0;
+	Profiler::Reset();
+	Measure(*result, options, [&](unsigned int)
+	{
+		BenchClock::time_point t0 = BenchClock::now();
+		for(unsigned int i = 0; i < count; i++)
+		{
+			PROFILE_ZONE("bench_zone");
+		}
+		BenchClock::time_point t1 = BenchClock::now();
+		Profiler::Collect();
+		BenchClock::time_point t2 = BenchClock::now();
+
+		Profiler::SetEnabled(false);
+		for(unsigned int i = 0; i < count; i++)
+		{
+			PROFILE_ZONE("bench_zone");
+		}
+		Profiler::SetEnabled(true);
+		BenchClock::time_point t3 = BenchClock::now();
+
+		zoneNs += (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+		collectNs += (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+		disabledNs += (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t3 - t2).count();
+	});
+
+	double zones = (double)result->samples.size() * count;
+	result->items = count;
+	result->counters.push_back(std::make_pair(std::string("zone_ns"), zoneNs / zones));
+	result->counters.push_back(std::make_pair(std::string("disabled_ns"), disabledNs / zones));
+	result->counters.push_back(std::make_pair(std::string("collect_ns"), collectNs / zones));
+	result->counters.push_back(std::make_pair(std::string("dropped"), (double)Profiler::GetDroppedCount()));
+	PrintResult(*result);
+	Profiler::Reset();
+}
+
+///----------------------------------------------------------------------------
+///Frame pacing at 500 fps through Timer::Tick: how close to the deadline
+///frames wake up and how much of a core the waiting costs
+///----------------------------------------------------------------------------
+static void RunFramePacer(const BenchOptions &options, std::vector<BenchResult> &results)
+{
+	BenchResult *result;
+	if((result = AddCase(results, options, "frame_pacer", 0, "frames")) == NULL)
+		return;
+
+	const float rate = 500.0f;
+	Timer timer;
+	timer.Tick(rate);
+
+	std::vector<double> errors;
+	clock_t cpuStart = clock();
+	BenchClock::time_point start = BenchClock::now();
+	Measure(*result, options, [&](unsigned int)
+	{
+		timer.Tick(rate);
+		errors.push_back((double)timer.GetPacer().GetStats().lastError);
+	});
+	double wall = std::chrono::duration<double>(BenchClock::now() - start).count();
+	double cpu = (double)(clock() - cpuStart) / CLOCKS_PER_SEC;
+
+	const FramePacerStats &stats = timer.GetPacer().GetStats();
+	std::sort(errors.begin(), errors.end());
+	result->items = 1;
+	result->counters.push_back(std::make_pair(std::string("jitter_p50_us"), Percentile(errors, 0.5) * 1e-3));
+	result->counters.push_back(std::make_pair(std::string("jitter_p99_us"), Percentile(errors, 0.99) * 1e-3));
+	result->counters.push_back(std::make_pair(std::string("missed"), (double)stats.missed));
+	result->counters.push_back(std::make_pair(std::string("spin_fraction"), (double)stats.spun / (double)(stats.spun + stats.slept)));
+	result->counters.push_back(std::make_pair(std::string("cpu_fraction"), wall > 0.0 ? cpu / wall : 0.0));
+	PrintResult(*result);
+}
+
+///----------------------------------------------------------------------------
+///Entry point
+///----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+	BenchOptions options;
+	if(!ParseOptions(argc, argv, options))
+	{
+		fprintf(stderr, "usage: %s [--sizes=65,257,...] [--formats=8,16,32] [--min-time=seconds] [--filter=substring]\n"
+						"       [--json=file|-] [--work-dir=dir] [--threads=count]\n"
+						"       [--cache-sizes=16,32,...] [--tile-budget-mb=megabytes] [--job-threads=count]\n"
+						"       [--flight-path=file] [--view-radius=units]\n", argv[0]);
+		return 1;
+	}
+
+	if(!MakeDirectory(options.workDir))
+	{
+		fprintf(stderr, "unable to create work directory %s\n", options.workDir.c_str());
+		return 1;
+	}
+
+	//keep the table off stdout when the JSON goes there
+	if(options.json == "-")
+		s_Table = stderr;
+
+	fprintf(s_Table, "%-22s %6s %4s %8s %12s %12s %17s %15s\n", "case", "size", "bits", "iters", "p50 ms", "p99 ms", "throughput", "bandwidth");
+
+	std::vector<BenchResult> results;
+	RunIndexGeneration(options, results);
+	RunJobSystem(options, results);
+	RunProfiler(options, results);
+	RunFramePacer(options, results);
+	for(size_t i = 0; i < options.sizes.size(); i++)
+	{
+		for(size_t j = 0; j < options.formats.size(); j++)
+			RunMapSize(options.sizes[i], options.formats[j], options, results);
+	}
+
+	if(!options.json.empty() && !WriteJson(results, options))
+	{
+		fprintf(stderr, "unable to write %s\n", options.json.c_str());
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,233 @@
+///============================================================================
+///@file	TerrainBuffers.cpp
+///@brief	Terrain render buffers implementation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "TerrainBuffers.h"
+#include "Profiler.h"
+
+///----------------------------------------------------------------------------
+///Default constructor
+///----------------------------------------------------------------------------
+TerrainBuffers::TerrainBuffers()
+{
+	m_Backend = NULL;
+	m_IndexBuffer = 0;
+	m_OwnsIndexBuffer = false;
+	m_VertexCount = 0;
+}
+
+///----------------------------------------------------------------------------
+///Default destructor
+///----------------------------------------------------------------------------
+TerrainBuffers::~TerrainBuffers()
+{
+	Release();
+}
+
+///----------------------------------------------------------------------------
+///Uploads the LOD index sets of a terrain, 32-bit only when a patch has more
+///than 64k vertices. Every terrain with the same patch size can draw with
+///them. Patch sizes with a compile time table upload it as is, the others
+///generate the sets first.
+///@param	backend - where to create the buffer
+///@param	terrain - a built terrain
+///@return	the index buffer, 0 on failure
+///----------------------------------------------------------------------------
+RenderBuffer TerrainBuffers::CreateIndexBuffer(RenderBackend &backend, const Terrain &terrain)
+{
+	const TerrainLOD &lod = terrain.GetLOD();
+	unsigned int count = lod.GetIndexCount();
+	bool index16 = TerrainMesh::FitsIndex16(terrain.GetQuadTree().GetPatchSize());
+
+	RenderBuffer buffer = backend.CreateIndexBuffer(count, index16 ? INDEX_16 : INDEX_32);
+	if(!buffer)
+		return 0;
+
+	bool uploaded;
+	if(lod.GetIndexTable())
+	{
+		uploaded = backend.UpdateIndices(buffer, 0, lod.GetIndexTable()->indices, count);
+	}
+	else if(index16)
+	{
+		std::vector<unsigned short> indices(count);
+		lod.BuildIndices(&indices[0]);
+		uploaded = backend.UpdateIndices(buffer, 0, &indices[0], count);
+	}
+	else
+	{
+		std::vector<unsigned int> indices(count);
+		lod.BuildIndices(&indices[0]);
+		uploaded = backend.UpdateIndices(buffer, 0, &indices[0], count);
+	}
+
+	if(!uploaded)
+	{
+		backend.ReleaseBuffer(buffer);
+		return 0;
+	}
+	return buffer;
+}
+
+///----------------------------------------------------------------------------
+///Creates a vertex buffer per patch and fills it
+///@param	backend - where to create the buffers, must outlive them
+///@param	terrain - a built terrain
+///@param	vertices - GetPatchVertexCount() vertices per patch in patch order
+///					(as TerrainTile::vertices), or NULL to mesh them here
+///@param	indexBuffer - index sets shared with other terrains, or 0 to
+///					create them
+///@return	false if a buffer could not be created
+///----------------------------------------------------------------------------
+bool TerrainBuffers::Create(RenderBackend &backend, const Terrain &terrain, const Vertex3D *vertices, RenderBuffer indexBuffer)
+{
+	Release();
+	if(!terrain.IsLoaded())
+		return false;
+
+	m_Backend = &backend;
+	m_IndexBuffer = indexBuffer;
+	if(!m_IndexBuffer)
+	{
+		m_IndexBuffer = CreateIndexBuffer(backend, terrain);
+		m_OwnsIndexBuffer = true;
+		if(!m_IndexBuffer)
+		{
+			Release();
+			return false;
+		}
+	}
+
+	const TerrainQuadTree &quadTree = terrain.GetQuadTree();
+	m_VertexCount = quadTree.GetPatchVertexCount();
+	m_PatchBuffers.resize(quadTree.GetPatchCount(), 0);
+	for(unsigned int i = 0; i < quadTree.GetPatchCount(); i++)
+	{
+		m_PatchBuffers[i] = backend.CreateVertexBuffer(m_VertexCount);
+		if(!m_PatchBuffers[i] || !UpdatePatch(terrain, i, vertices ? vertices + (size_t)i * m_VertexCount : NULL))
+		{
+			Release();
+			return false;
+		}
+	}
+
+	std::vector<Vertex3D>().swap(m_Scratch);
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Frees the patch buffers, and the index sets if they were created here
+///----------------------------------------------------------------------------
+void TerrainBuffers::Release()
+{
+	if(m_Backend)
+	{
+		for(size_t i = 0; i < m_PatchBuffers.size(); i++)
+			m_Backend->ReleaseBuffer(m_PatchBuffers[i]);
+		if(m_OwnsIndexBuffer)
+			m_Backend->ReleaseBuffer(m_IndexBuffer);
+	}
+
+	std::vector<RenderBuffer>().swap(m_PatchBuffers);
+	std::vector<Vertex3D>().swap(m_Scratch);
+	m_Backend = NULL;
+	m_IndexBuffer = 0;
+	m_OwnsIndexBuffer = false;
+	m_VertexCount = 0;
+}
+
+///----------------------------------------------------------------------------
+///Refills the vertex buffer of a patch, after an edit
+///@param	terrain - the terrain the buffers were created for
+///@param	patch - patch index
+///@param	vertices - its GetPatchVertexCount() vertices, or NULL to mesh them
+///@return	false if the upload failed
+///----------------------------------------------------------------------------
+bool TerrainBuffers::UpdatePatch(const Terrain &terrain, unsigned int patch, const Vertex3D *vertices)
+{
+	if(!m_Backend || patch >= m_PatchBuffers.size())
+		return false;
+
+	PROFILE_ZONE("buffer_upload");
+	if(!vertices)
+	{
+		const TerrainQuadTree &quadTree = terrain.GetQuadTree();
+		m_Scratch.resize(m_VertexCount);
+		TerrainMesh::BuildPatchVertices(terrain.GetHeightField(), quadTree.GetPatch(patch), quadTree.GetPatchSize(), &m_Scratch[0]);
+		vertices = &m_Scratch[0];
+	}
+
+	return m_Backend->UpdateVertices(m_PatchBuffers[patch], 0, vertices, m_VertexCount);
+}
+
+///----------------------------------------------------------------------------
+///Re-meshes and uploads a list of patches, as Terrain::GetDirtyPatches
+///returns them
+///@return	patches updated
+///----------------------------------------------------------------------------
+unsigned int TerrainBuffers::UpdatePatches(const Terrain &terrain, const std::vector<unsigned int> &patches)
+{
+	unsigned int updated = 0;
+	for(size_t i = 0; i < patches.size(); i++)
+		updated += UpdatePatch(terrain, patches[i]) ? 1 : 0;
+	return updated;
+}
+
+///----------------------------------------------------------------------------
+///Draws the patches the last Terrain::Update picked, each with the index
+///range of its level. The world transform and fill mode are left to the
+///caller.
+///@param	terrain - the terrain the buffers were created for
+///@return	triangles submitted
+///----------------------------------------------------------------------------
+unsigned long long TerrainBuffers::Draw(const Terrain &terrain) const
+{
+	if(!m_Backend)
+		return 0;
+
+	PROFILE_ZONE("draw_submit");
+	unsigned long long triangles = 0;
+	const std::vector<unsigned int> &visible = terrain.GetVisiblePatches();
+	const TerrainLOD &lod = terrain.GetLOD();
+	m_Backend->SetIndexBuffer(m_IndexBuffer);
+	for(size_t v = 0; v < visible.size(); v++)
+	{
+		unsigned int i = visible[v];
+		if(i >= m_PatchBuffers.size())
+			continue;
+
+		const IndexRange &range = lod.GetPatchRange(i);
+		m_Backend->SetVertexBuffer(m_PatchBuffers[i]);
+		m_Backend->DrawIndexed(range.first, range.count / 3);
+		triangles += range.count / 3;
+	}
+
+	return triangles;
+}
+
+///----------------------------------------------------------------------------
+///True once Create succeeded
+///----------------------------------------------------------------------------
+bool TerrainBuffers::IsCreated() const
+{
+	return m_Backend != NULL;
+}
+
+///----------------------------------------------------------------------------
+///The index sets drawn with, to share with other terrains
+///----------------------------------------------------------------------------
+RenderBuffer TerrainBuffers::GetIndexBuffer() const
+{
+	return m_IndexBuffer;
+}
+
+///----------------------------------------------------------------------------
+///Vertices per patch buffer
+///----------------------------------------------------------------------------
+unsigned int TerrainBuffers::GetVertexCount() const
+{
+	return m_VertexCount;
+}
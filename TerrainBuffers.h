@@ -0,0 +1,57 @@
+///============================================================================
+///@file	TerrainBuffers.h
+///@brief	A terrain's GPU side on any RenderBackend: one vertex buffer per
+///			patch plus the LOD index sets, which tiles of the same patch
+///			size can share. Draw submits what the last Terrain::Update
+///			picked, so front ends only own the frame around it.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+#include <vector>
+#include "RenderBackend.h"
+#include "Terrain.h"
+
+class TerrainBuffers
+{
+public:
+	//-------------------------------------------------------------------------
+	//Constructors and destructors
+	//-------------------------------------------------------------------------
+	TerrainBuffers();
+	~TerrainBuffers();
+
+	//-------------------------------------------------------------------------
+	//Public methods
+	//-------------------------------------------------------------------------
+	static RenderBuffer CreateIndexBuffer(RenderBackend &backend, const Terrain &terrain);
+
+	bool Create(RenderBackend &backend, const Terrain &terrain, const Vertex3D *vertices = NULL, RenderBuffer indexBuffer = 0);
+	void Release();
+	bool UpdatePatch(const Terrain &terrain, unsigned int patch, const Vertex3D *vertices = NULL);
+	unsigned int UpdatePatches(const Terrain &terrain, const std::vector<unsigned int> &patches);
+	unsigned long long Draw(const Terrain &terrain) const;
+
+	bool IsCreated() const;
+	RenderBuffer GetIndexBuffer() const;
+	unsigned int GetVertexCount() const;
+
+private:
+	//-------------------------------------------------------------------------
+	//Non copyable
+	//-------------------------------------------------------------------------
+	TerrainBuffers(const TerrainBuffers&);
+	TerrainBuffers& operator=(const TerrainBuffers&);
+
+	//-------------------------------------------------------------------------
+	//Private members
+	//-------------------------------------------------------------------------
+	RenderBackend*				m_Backend;			///> Owner of the buffers, NULL until Create
+	std::vector<RenderBuffer>	m_PatchBuffers;		///> Vertex buffer per patch
+	RenderBuffer				m_IndexBuffer;		///> LOD index sets
+	bool						m_OwnsIndexBuffer;	///> m_IndexBuffer was created here
+	unsigned int				m_VertexCount;		///> Vertices per patch
+	std::vector<Vertex3D>		m_Scratch;			///> Patch vertices meshed here
+};
@@ -0,0 +1,181 @@
+///============================================================================
+///@file	TerrainCache.cpp
+///@brief	Precomputed terrain hierarchy sidecar implementation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "TerrainCache.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+///----------------------------------------------------------------------------
+///Default constructor
+///----------------------------------------------------------------------------
+TerrainCache::TerrainCache()
+{
+	m_Header = NULL;
+}
+
+///----------------------------------------------------------------------------
+///Default destructor
+///----------------------------------------------------------------------------
+TerrainCache::~TerrainCache()
+{
+	Close();
+}
+
+///----------------------------------------------------------------------------
+///Returns the sidecar name of a height map
+///----------------------------------------------------------------------------
+std::string TerrainCache::GetCacheName(const char* heightMapName)
+{
+	return std::string(heightMapName) + ".hier";
+}
+
+///----------------------------------------------------------------------------
+///Fills the header fields that identify a height map and patch layout
+///----------------------------------------------------------------------------
+void TerrainCache::FillHeader(const char* heightMapName, const HeightField &heightField, unsigned int patchSize,
+							  TerrainCacheHeader &header)
+{
+	memset(&header, 0, sizeof(header));
+	header.magic = TERRAIN_CACHE_MAGIC;
+	header.version = TERRAIN_CACHE_VERSION;
+	header.width = heightField.GetWidth();
+	header.height = heightField.GetHeight();
+	header.format = heightField.GetFormat();
+	header.patchSize = patchSize;
+	header.patchCount = ((header.width - 2) / patchSize + 1) * ((header.height - 2) / patchSize + 1);
+	header.levelCount = 1;
+	while((1u << (header.levelCount - 1)) < patchSize)
+		header.levelCount++;
+	header.occluderCells = TerrainCuller::OCCLUDER_GRID * TerrainCuller::OCCLUDER_GRID;
+	header.verticalScale = heightField.GetVerticalScale();
+	header.verticalOffset = heightField.GetVerticalOffset();
+
+	struct stat info;
+	if(stat(heightMapName, &info) == 0)
+	{
+		header.sourceSize = (unsigned long long)info.st_size;
+		header.sourceTime = (unsigned long long)info.st_mtime;
+	}
+}
+
+///----------------------------------------------------------------------------
+///Maps the sidecar of a height map if it exists and still matches it
+///@param	heightMapName - name of the .raw file the height field came from
+///@param	heightField - the loaded height field
+///@param	patchSize - patch size the hierarchy has to be built for
+///@return	false if there is no usable sidecar (missing, stale or truncated)
+///----------------------------------------------------------------------------
+bool TerrainCache::Open(const char* heightMapName, const HeightField &heightField, unsigned int patchSize)
+{
+	Close();
+
+	if(patchSize < 1 || !m_File.Open(GetCacheName(heightMapName).c_str()))
+		return false;
+
+	TerrainCacheHeader expected;
+	FillHeader(heightMapName, heightField, patchSize, expected);
+
+	const TerrainCacheHeader *header = (const TerrainCacheHeader*)m_File.GetData();
+	unsigned long long size = sizeof(TerrainCacheHeader) + (unsigned long long)expected.patchCount *
+							  (2 + expected.levelCount + expected.occluderCells) * sizeof(float);
+
+	if(m_File.GetSize() != size || memcmp(header, &expected, sizeof(TerrainCacheHeader)) != 0)
+	{
+		m_File.Close();
+		return false;
+	}
+
+	m_Header = header;
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Unmaps the sidecar
+///----------------------------------------------------------------------------
+void TerrainCache::Close()
+{
+	m_File.Close();
+	m_Header = NULL;
+}
+
+///----------------------------------------------------------------------------
+///Returns true if a matching sidecar is mapped
+///----------------------------------------------------------------------------
+bool TerrainCache::IsOpen() const
+{
+	return m_Header != NULL;
+}
+
+///----------------------------------------------------------------------------
+///Returns the min/max elevation pair of every patch
+///----------------------------------------------------------------------------
+const float* TerrainCache::GetPatchHeights() const
+{
+	return m_Header ? (const float*)(m_Header + 1) : NULL;
+}
+
+///----------------------------------------------------------------------------
+///Returns the LOD errors of every patch, patch major
+///----------------------------------------------------------------------------
+const float* TerrainCache::GetErrors() const
+{
+	return m_Header ? GetPatchHeights() + m_Header->patchCount * 2 : NULL;
+}
+
+///----------------------------------------------------------------------------
+///Returns the horizon occluder heights of every patch, patch major
+///----------------------------------------------------------------------------
+const float* TerrainCache::GetOccluderHeights() const
+{
+	return m_Header ? GetErrors() + m_Header->patchCount * m_Header->levelCount : NULL;
+}
+
+///----------------------------------------------------------------------------
+///Writes the sidecar of a height map from freshly built structures.
+///The header is written last so an interrupted write never looks valid.
+///@param	heightMapName - name of the .raw file the height field came from
+///@param	heightField - the loaded height field
+///@param	quadTree, culler, lod - structures built from heightField
+///----------------------------------------------------------------------------
+bool TerrainCache::Write(const char* heightMapName, const HeightField &heightField, const TerrainQuadTree &quadTree,
+						 const TerrainCuller &culler, const TerrainLOD &lod)
+{
+	TerrainCacheHeader header;
+	FillHeader(heightMapName, heightField, quadTree.GetPatchSize(), header);
+
+	if(header.patchCount != quadTree.GetPatchCount() || header.levelCount != lod.GetLevelCount() ||
+	   !lod.GetErrors() || !culler.GetOccluderHeights())
+		return false;
+
+	std::string name = GetCacheName(heightMapName);
+	FILE *f = fopen(name.c_str(), "wb");
+	if(!f) return false;
+
+	TerrainCacheHeader blank;
+	memset(&blank, 0, sizeof(blank));
+	bool ok = fwrite(&blank, sizeof(blank), 1, f) == 1;
+
+	std::vector<float> heights(header.patchCount * 2);
+	for(unsigned int i = 0; i < header.patchCount; i++)
+	{
+		heights[i * 2] = quadTree.GetPatch(i).bounds.minY;
+		heights[i * 2 + 1] = quadTree.GetPatch(i).bounds.maxY;
+	}
+
+	ok = ok && fwrite(&heights[0], sizeof(float), heights.size(), f) == heights.size();
+	ok = ok && fwrite(lod.GetErrors(), sizeof(float) * header.levelCount, header.patchCount, f) == header.patchCount;
+	ok = ok && fwrite(culler.GetOccluderHeights(), sizeof(float) * header.occluderCells, header.patchCount, f) == header.patchCount;
+	ok = ok && fseek(f, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, f) == 1;
+	ok = (fclose(f) == 0) && ok;
+
+	if(!ok)
+		remove(name.c_str());
+
+	return ok;
+}
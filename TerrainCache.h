@@ -0,0 +1,89 @@
+///============================================================================
+///@file	TerrainCache.h
+///@brief	Binary sidecar holding the precomputed min/max/error hierarchy of
+///			a height map ("<map>.hier"). The first run writes it, later runs
+///			memory map it and hand the arrays straight to the quadtree,
+///			culler and LOD builders instead of scanning every sample.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+#include <string>
+#include "MappedFile.h"
+#include "TerrainCuller.h"
+#include "TerrainLOD.h"
+
+//-------------------------------------------------------------------------
+//Sidecar header, followed by the float arrays in the order listed
+//-------------------------------------------------------------------------
+struct TerrainCacheHeader
+{
+	unsigned int		magic;			///> TERRAIN_CACHE_MAGIC, also detects byte order
+	unsigned int		version;		///> TERRAIN_CACHE_VERSION
+	unsigned int		width;			///> Height map samples along x
+	unsigned int		height;			///> Height map samples along z
+	unsigned int		format;			///> HeightFormat of the samples
+	unsigned int		patchSize;		///> Quads per patch side
+	unsigned int		patchCount;		///> Patches in the map
+	unsigned int		levelCount;		///> LOD levels per patch
+	unsigned int		occluderCells;	///> Occluder heights per patch
+	float				verticalScale;	///> Sample to world height factor
+	float				verticalOffset;	///> World height of a zero sample
+	unsigned int		reserved;		///> Zero
+	unsigned long long	sourceSize;		///> Size of the .raw file
+	unsigned long long	sourceTime;		///> Modification time of the .raw file
+	//float	patchHeights[patchCount * 2];			min/max elevation per patch
+	//float	errors[patchCount * levelCount];		geometric error per level
+	//float	occluders[patchCount * occluderCells];	horizon occluder heights
+};
+
+class TerrainCache
+{
+public:
+	//-------------------------------------------------------------------------
+	//Constructors and destructors
+	//-------------------------------------------------------------------------
+	TerrainCache();
+	~TerrainCache();
+
+	//-------------------------------------------------------------------------
+	//Public methods
+	//-------------------------------------------------------------------------
+	bool Open(const char* heightMapName, const HeightField &heightField, unsigned int patchSize);
+	void Close();
+	bool IsOpen() const;
+	const float* GetPatchHeights() const;
+	const float* GetErrors() const;
+	const float* GetOccluderHeights() const;
+
+	static bool Write(const char* heightMapName, const HeightField &heightField, const TerrainQuadTree &quadTree,
+					  const TerrainCuller &culler, const TerrainLOD &lod);
+	static std::string GetCacheName(const char* heightMapName);
+
+	//-------------------------------------------------------------------------
+	//Public members
+	//-------------------------------------------------------------------------
+	static const unsigned int TERRAIN_CACHE_MAGIC = 0x52454948;	///> "HIER"
+	static const unsigned int TERRAIN_CACHE_VERSION = 2;
+
+private:
+	//-------------------------------------------------------------------------
+	//Non copyable
+	//-------------------------------------------------------------------------
+	TerrainCache(const TerrainCache&);
+	TerrainCache& operator=(const TerrainCache&);
+
+	//-------------------------------------------------------------------------
+	//Private methods
+	//-------------------------------------------------------------------------
+	static void FillHeader(const char* heightMapName, const HeightField &heightField, unsigned int patchSize,
+						   TerrainCacheHeader &header);
+
+	//-------------------------------------------------------------------------
+	//Private members
+	//-------------------------------------------------------------------------
+	MappedFile					m_File;		///> The mapped sidecar
+	const TerrainCacheHeader*	m_Header;	///> Header at the start of the mapping
+};
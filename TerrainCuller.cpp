@@ -0,0 +1,600 @@
+///============================================================================
+///@file	TerrainCuller.cpp
+///@brief	Terrain patch culling implementation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "TerrainCuller.h"
+
+#include <math.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TERRAIN_SSE2
+#include <emmintrin.h>
+#endif
+
+const float TerrainCuller::HORIZON_EPSILON = 1e-4f;
+
+///----------------------------------------------------------------------------
+///Andrew's monotone chain convex hull, returned as its lower and upper
+///chains, both sorted by ascending x
+///@param	px, py - input points (sorted in place)
+///@param	count - number of input points
+///@param	lx, ly, lower - receive the lower chain
+///@param	ux, uy, upper - receive the upper chain
+///----------------------------------------------------------------------------
+static void ConvexHull(float *px, float *py, int count,
+					   float *lx, float *ly, int &lower, float *ux, float *uy, int &upper)
+{
+	//insertion sort by x then y, count is tiny
+	for(int i = 1; i < count; i++)
+	{
+		float x = px[i], y = py[i];
+		int j = i - 1;
+		while(j >= 0 && (px[j] > x || (px[j] == x && py[j] > y)))
+		{
+			px[j + 1] = px[j];
+			py[j + 1] = py[j];
+			j--;
+		}
+		px[j + 1] = x;
+		py[j + 1] = y;
+	}
+
+	lower = upper = 0;
+	for(int i = 0; i < count; i++)
+	{
+		while(lower >= 2 && (lx[lower-1] - lx[lower-2]) * (py[i] - ly[lower-2]) -
+							(ly[lower-1] - ly[lower-2]) * (px[i] - lx[lower-2]) <= 0.0f)
+			lower--;
+		lx[lower] = px[i];
+		ly[lower] = py[i];
+		lower++;
+
+		while(upper >= 2 && (ux[upper-1] - ux[upper-2]) * (py[i] - uy[upper-2]) -
+							(uy[upper-1] - uy[upper-2]) * (px[i] - ux[upper-2]) >= 0.0f)
+			upper--;
+		ux[upper] = px[i];
+		uy[upper] = py[i];
+		upper++;
+	}
+}
+
+///----------------------------------------------------------------------------
+///Evaluates a chain sorted by ascending x at x, advancing the segment
+///cursor (x must not decrease between calls)
+///----------------------------------------------------------------------------
+static float EvaluateChain(const float *cx, const float *cy, int count, int &segment, float x)
+{
+	while(segment < count - 2 && cx[segment + 1] < x)
+		segment++;
+
+	float x0 = cx[segment], x1 = cx[segment + 1];
+	if(x1 <= x0)
+		return cy[segment + 1];
+
+	return cy[segment] + (cy[segment + 1] - cy[segment]) * (x - x0) / (x1 - x0);
+}
+
+///----------------------------------------------------------------------------
+///Default constructor
+///----------------------------------------------------------------------------
+TerrainCuller::TerrainCuller()
+{
+	m_QuadTree = NULL;
+	m_HeightField = NULL;
+	m_HorizonCulling = true;
+	m_FrustumCulled = 0;
+	m_HorizonCulled = 0;
+	m_Horizon.resize(DEFAULT_HORIZON_COLUMNS);
+}
+
+///----------------------------------------------------------------------------
+///Default destructor
+///----------------------------------------------------------------------------
+TerrainCuller::~TerrainCuller()
+{
+}
+
+///----------------------------------------------------------------------------
+///Copies the patch bounds of a quadtree into the culler and gathers the
+///occluder heights of every patch
+///@param	quadTree - the patches to cull
+///@param	heightField - the samples the patches were built from
+///@param	occluderHeights - precomputed OCCLUDER_GRID^2 heights per patch (see
+///			GetOccluderHeights), NULL to scan the samples
+///----------------------------------------------------------------------------
+void TerrainCuller::Build(const TerrainQuadTree &quadTree, const HeightField &heightField, const float *occluderHeights)
+{
+	m_QuadTree = &quadTree;
+	m_HeightField = &heightField;
+
+	//pad to a multiple of four with boxes that are never visible
+	size_t count = quadTree.GetPatchCount();
+	size_t padded = (count + 3) & ~(size_t)3;
+
+	m_CenterX.assign(padded, 0.0f);
+	m_CenterY.assign(padded, -1e30f);
+	m_CenterZ.assign(padded, 0.0f);
+	m_ExtentX.assign(padded, 0.0f);
+	m_ExtentY.assign(padded, 0.0f);
+	m_ExtentZ.assign(padded, 0.0f);
+	m_InFrustum.assign(padded, 0);
+	if(occluderHeights)
+	{
+		m_OccluderMin.assign(occluderHeights, occluderHeights + count * OCCLUDER_GRID * OCCLUDER_GRID);
+		for(unsigned int i = 0; i < count; i++)
+			SetPatchBounds(i, quadTree.GetPatch(i).bounds);
+		return;
+	}
+
+	m_OccluderMin.resize(count * OCCLUDER_GRID * OCCLUDER_GRID);
+	for(unsigned int i = 0; i < count; i++)
+		UpdatePatch(i, quadTree.GetPatch(i).bounds, heightField);
+}
+
+///----------------------------------------------------------------------------
+///Refreshes the bounds and occluder heights of one patch (e.g. after its
+///heights changed)
+///----------------------------------------------------------------------------
+void TerrainCuller::UpdatePatch(unsigned int patch, const BoundingBox &bounds, const HeightField &heightField)
+{
+	SetPatchBounds(patch, bounds);
+
+	//minimum height of each occluder cell, cells share their border samples
+	unsigned int x0 = (unsigned int)bounds.minX;
+	unsigned int z0 = (unsigned int)bounds.minZ;
+	unsigned int sizeX = (unsigned int)bounds.maxX - x0;
+	unsigned int sizeZ = (unsigned int)bounds.maxZ - z0;
+	float *cell = &m_OccluderMin[patch * OCCLUDER_GRID * OCCLUDER_GRID];
+
+	for(unsigned int cz = 0; cz < OCCLUDER_GRID; cz++)
+	{
+		for(unsigned int cx = 0; cx < OCCLUDER_GRID; cx++)
+		{
+			unsigned int xa = x0 + sizeX * cx / OCCLUDER_GRID, xb = x0 + sizeX * (cx + 1) / OCCLUDER_GRID;
+			unsigned int za = z0 + sizeZ * cz / OCCLUDER_GRID, zb = z0 + sizeZ * (cz + 1) / OCCLUDER_GRID;
+			float minHeight = heightField.GetElevation(xa, za);
+
+			for(unsigned int z = za; z <= zb; z++)
+				for(unsigned int x = xa; x <= xb; x++)
+				{
+					float h = heightField.GetElevation(x, z);
+					if(h < minHeight) minHeight = h;
+				}
+
+			*cell++ = minHeight;
+		}
+	}
+}
+
+///----------------------------------------------------------------------------
+///Stores the bounds of one patch in the SoA arrays
+///----------------------------------------------------------------------------
+void TerrainCuller::SetPatchBounds(unsigned int patch, const BoundingBox &bounds)
+{
+	m_CenterX[patch] = (bounds.minX + bounds.maxX) * 0.5f;
+	m_CenterY[patch] = (bounds.minY + bounds.maxY) * 0.5f;
+	m_CenterZ[patch] = (bounds.minZ + bounds.maxZ) * 0.5f;
+	m_ExtentX[patch] = (bounds.maxX - bounds.minX) * 0.5f;
+	m_ExtentY[patch] = (bounds.maxY - bounds.minY) * 0.5f;
+	m_ExtentZ[patch] = (bounds.maxZ - bounds.minZ) * 0.5f;
+}
+
+///----------------------------------------------------------------------------
+///Enables or disables the horizon pass
+///----------------------------------------------------------------------------
+void TerrainCuller::SetHorizonCulling(bool enable)
+{
+	m_HorizonCulling = enable;
+}
+
+///----------------------------------------------------------------------------
+///Sets the number of screen columns in the horizon buffer
+///----------------------------------------------------------------------------
+void TerrainCuller::SetHorizonResolution(unsigned int columns)
+{
+	m_Horizon.resize(columns > 0 ? columns : 1);
+}
+
+///----------------------------------------------------------------------------
+///Returns the number of patches rejected by the frustum in the last Cull
+///----------------------------------------------------------------------------
+unsigned int TerrainCuller::GetFrustumCulledCount() const
+{
+	return m_FrustumCulled;
+}
+
+///----------------------------------------------------------------------------
+///Returns the number of patches rejected by the horizon in the last Cull
+///----------------------------------------------------------------------------
+unsigned int TerrainCuller::GetHorizonCulledCount() const
+{
+	return m_HorizonCulled;
+}
+
+///----------------------------------------------------------------------------
+///Returns the OCCLUDER_GRID^2 occluder heights of every patch, patch major
+///----------------------------------------------------------------------------
+const float* TerrainCuller::GetOccluderHeights() const
+{
+	return m_OccluderMin.empty() ? NULL : &m_OccluderMin[0];
+}
+
+///----------------------------------------------------------------------------
+///Frustum culling only
+///@param	frustum - frustum in the patches' space
+///@param	visible - receives the visible patch indices in ascending order
+///@return	number of visible patches
+///----------------------------------------------------------------------------
+unsigned int TerrainCuller::Cull(const Frustum &frustum, std::vector<unsigned int> &visible)
+{
+	visible.clear();
+	m_HorizonCulled = 0;
+	if(!m_QuadTree) return 0;
+
+	TestFrustum(frustum);
+
+	unsigned int count = m_QuadTree->GetPatchCount();
+	for(unsigned int i = 0; i < count; i++)
+		if(m_InFrustum[i])
+			visible.push_back(i);
+
+	m_FrustumCulled = count - (unsigned int)visible.size();
+	return (unsigned int)visible.size();
+}
+
+///----------------------------------------------------------------------------
+///Frustum and horizon culling
+///@param	frustum - frustum in the patches' space
+///@param	eye - camera position in the patches' space (x,y,z)
+///@param	visible - receives the visible patch indices sorted front to back
+///@return	number of visible patches
+///----------------------------------------------------------------------------
+unsigned int TerrainCuller::Cull(const Frustum &frustum, const float *eye, std::vector<unsigned int> &visible)
+{
+	if(!m_HorizonCulling || !m_QuadTree || m_QuadTree->GetRoot() < 0)
+		return Cull(frustum, visible);
+
+	//occluders only hold for an eye above the terrain, from outside the map
+	//rays could also pass under its edge
+	const BoundingBox &root = m_QuadTree->GetNode(m_QuadTree->GetRoot()).bounds;
+	if(eye[0] < root.minX || eye[0] > root.maxX || eye[2] < root.minZ || eye[2] > root.maxZ)
+		return Cull(frustum, visible);
+
+	unsigned int ex = (unsigned int)eye[0], ez = (unsigned int)eye[2];
+	unsigned int lastX = m_HeightField->GetWidth() - 1, lastZ = m_HeightField->GetHeight() - 1;
+	unsigned int nx = ex < lastX ? ex + 1 : lastX, nz = ez < lastZ ? ez + 1 : lastZ;
+	if(eye[1] <= m_HeightField->GetElevation(ex, ez) || eye[1] <= m_HeightField->GetElevation(nx, ez) ||
+	   eye[1] <= m_HeightField->GetElevation(ex, nz) || eye[1] <= m_HeightField->GetElevation(nx, nz))
+		return Cull(frustum, visible);
+
+	visible.clear();
+	TestFrustum(frustum);
+
+	unsigned int inFrustum = 0;
+	unsigned int count = m_QuadTree->GetPatchCount();
+	for(unsigned int i = 0; i < count; i++)
+		inFrustum += m_InFrustum[i];
+	m_FrustumCulled = count - inFrustum;
+
+	//nothing is covered yet
+	float colWidth = 2.0f / m_Horizon.size();
+	for(size_t c = 0; c < m_Horizon.size(); c++)
+	{
+		HorizonColumn &column = m_Horizon[c];
+		column.height = -1.0f;
+		column.leftEnd = -1.0f + c * colWidth;
+		column.leftHeight = -1.0f;
+		column.rightStart = column.leftEnd + colWidth;
+		column.rightHeight = -1.0f;
+	}
+
+	WalkFrontToBack(m_QuadTree->GetRoot(), frustum, eye, visible);
+
+	m_HorizonCulled = inFrustum - (unsigned int)visible.size();
+	return (unsigned int)visible.size();
+}
+
+///----------------------------------------------------------------------------
+///Tests every patch box against the six planes, four boxes at a time
+///----------------------------------------------------------------------------
+void TerrainCuller::TestFrustum(const Frustum &frustum)
+{
+	size_t padded = m_CenterX.size();
+
+#ifdef TERRAIN_SSE2
+	__m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	__m128 pa[Frustum::PLANE_COUNT], pb[Frustum::PLANE_COUNT], pc[Frustum::PLANE_COUNT], pd[Frustum::PLANE_COUNT];
+	__m128 aa[Frustum::PLANE_COUNT], ab[Frustum::PLANE_COUNT], ac[Frustum::PLANE_COUNT];
+
+	for(int p = 0; p < Frustum::PLANE_COUNT; p++)
+	{
+		const Plane &plane = frustum.GetPlane(p);
+		pa[p] = _mm_set1_ps(plane.a);
+		pb[p] = _mm_set1_ps(plane.b);
+		pc[p] = _mm_set1_ps(plane.c);
+		pd[p] = _mm_set1_ps(plane.d);
+		aa[p] = _mm_and_ps(pa[p], absMask);
+		ab[p] = _mm_and_ps(pb[p], absMask);
+		ac[p] = _mm_and_ps(pc[p], absMask);
+	}
+
+	for(size_t i = 0; i < padded; i += 4)
+	{
+		__m128 cx = _mm_loadu_ps(&m_CenterX[i]);
+		__m128 cy = _mm_loadu_ps(&m_CenterY[i]);
+		__m128 cz = _mm_loadu_ps(&m_CenterZ[i]);
+		__m128 ex = _mm_loadu_ps(&m_ExtentX[i]);
+		__m128 ey = _mm_loadu_ps(&m_ExtentY[i]);
+		__m128 ez = _mm_loadu_ps(&m_ExtentZ[i]);
+		__m128 outside = _mm_setzero_ps();
+
+		for(int p = 0; p < Frustum::PLANE_COUNT; p++)
+		{
+			//signed distance of the center plus the projected radius
+			__m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(pa[p], cx), _mm_mul_ps(pb[p], cy)),
+								  _mm_add_ps(_mm_mul_ps(pc[p], cz), pd[p]));
+			__m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(aa[p], ex), _mm_mul_ps(ab[p], ey)),
+								  _mm_mul_ps(ac[p], ez));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(d, r), _mm_setzero_ps()));
+		}
+
+		int mask = _mm_movemask_ps(outside);
+		m_InFrustum[i + 0] = !(mask & 1);
+		m_InFrustum[i + 1] = !(mask & 2);
+		m_InFrustum[i + 2] = !(mask & 4);
+		m_InFrustum[i + 3] = !(mask & 8);
+	}
+#else
+	for(size_t i = 0; i < padded; i++)
+	{
+		bool inside = true;
+
+		for(int p = 0; p < Frustum::PLANE_COUNT && inside; p++)
+		{
+			const Plane &plane = frustum.GetPlane(p);
+			float d = plane.a * m_CenterX[i] + plane.b * m_CenterY[i] + plane.c * m_CenterZ[i] + plane.d;
+			float r = fabsf(plane.a) * m_ExtentX[i] + fabsf(plane.b) * m_ExtentY[i] + fabsf(plane.c) * m_ExtentZ[i];
+			inside = d + r >= 0.0f;
+		}
+
+		m_InFrustum[i] = inside;
+	}
+#endif
+}
+
+///----------------------------------------------------------------------------
+///Visits the quadtree nearest child first, which for a regular grid is a
+///valid front to back order. Leaves that survive the frustum and horizon
+///tests are emitted and then added to the horizon as occluders.
+///----------------------------------------------------------------------------
+void TerrainCuller::WalkFrontToBack(int node, const Frustum &frustum, const float *eye, std::vector<unsigned int> &visible)
+{
+	const TerrainQuadTreeNode &n = m_QuadTree->GetNode(node);
+
+	if(n.patch >= 0)
+	{
+		if(!m_InFrustum[n.patch])
+			return;
+
+		if(IsBelowHorizon(n.bounds, frustum))
+			return;
+
+		visible.push_back((unsigned int)n.patch);
+		AddOccluder((unsigned int)n.patch, frustum, eye);
+		return;
+	}
+
+	if(IsBelowHorizon(n.bounds, frustum))
+		return;
+
+	//visit the near side of both split lines first
+	float splitX = (float)((n.px + n.span / 2) * m_QuadTree->GetPatchSize());
+	float splitZ = (float)((n.pz + n.span / 2) * m_QuadTree->GetPatchSize());
+	int nearX = eye[0] >= splitX ? 1 : 0;
+	int nearZ = eye[2] >= splitZ ? 2 : 0;
+	int order[4] = { nearX | nearZ, (nearX ^ 1) | nearZ, nearX | (nearZ ^ 2), (nearX ^ 1) | (nearZ ^ 2) };
+
+	for(int i = 0; i < 4; i++)
+		if(n.children[order[i]] >= 0)
+			WalkFrontToBack(n.children[order[i]], frustum, eye, visible);
+}
+
+///----------------------------------------------------------------------------
+///Returns true if the whole box projects below the current horizon
+///----------------------------------------------------------------------------
+bool TerrainCuller::IsBelowHorizon(const BoundingBox &box, const Frustum &frustum) const
+{
+	float minSX = 1e30f, maxSX = -1e30f, maxSY = -1e30f;
+
+	for(int i = 0; i < 8; i++)
+	{
+		float sx, sy;
+		if(!frustum.Project((i & 1) ? box.maxX : box.minX,
+							(i & 2) ? box.maxY : box.minY,
+							(i & 4) ? box.maxZ : box.minZ, sx, sy))
+			return false;	//straddles the eye plane, keep it
+
+		if(sx < minSX) minSX = sx;
+		if(sx > maxSX) maxSX = sx;
+		if(sy > maxSY) maxSY = sy;
+	}
+
+	if(maxSX < -1.0f || minSX > 1.0f)
+		return false;	//off screen sideways, the frustum pass decides
+
+	int columns = (int)m_Horizon.size();
+	int c0 = (int)floorf((minSX + 1.0f) * 0.5f * columns);
+	int c1 = (int)floorf((maxSX + 1.0f) * 0.5f * columns);
+	if(c0 < 0) c0 = 0;
+	if(c1 > columns - 1) c1 = columns - 1;
+
+	for(int c = c0; c <= c1; c++)
+		if(m_Horizon[c].height < maxSY)
+			return false;
+
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Adds a visible patch to the horizon as a grid of solid columns, each
+///reaching from deep below the map up to the lowest terrain sample of its
+///cell. Cells are added nearest first so each one can extend what the
+///previous ones covered.
+///----------------------------------------------------------------------------
+void TerrainCuller::AddOccluder(unsigned int patch, const Frustum &frustum, const float *eye)
+{
+	const BoundingBox &bounds = m_QuadTree->GetPatch(patch).bounds;
+	const float *cell = &m_OccluderMin[patch * OCCLUDER_GRID * OCCLUDER_GRID];
+	//the columns reach far below the map so that, seen from above the
+	//terrain, their projection extends to the bottom of the screen
+	const BoundingBox &root = m_QuadTree->GetNode(m_QuadTree->GetRoot()).bounds;
+	float bottom = root.minY - 10.0f * (root.maxX - root.minX + root.maxZ - root.minZ);
+	float sizeX = (bounds.maxX - bounds.minX) / OCCLUDER_GRID;
+	float sizeZ = (bounds.maxZ - bounds.minZ) / OCCLUDER_GRID;
+
+	//walk the cells away from the eye
+	int nearX = eye[0] > (bounds.minX + bounds.maxX) * 0.5f;
+	int nearZ = eye[2] > (bounds.minZ + bounds.maxZ) * 0.5f;
+
+	for(unsigned int j = 0; j < OCCLUDER_GRID; j++)
+	{
+		unsigned int cz = nearZ ? OCCLUDER_GRID - 1 - j : j;
+
+		for(unsigned int i = 0; i < OCCLUDER_GRID; i++)
+		{
+			unsigned int cx = nearX ? OCCLUDER_GRID - 1 - i : i;
+			BoundingBox solid;
+			solid.minX = bounds.minX + cx * sizeX;
+			solid.maxX = solid.minX + sizeX;
+			solid.minZ = bounds.minZ + cz * sizeZ;
+			solid.maxZ = solid.minZ + sizeZ;
+			solid.minY = bottom;
+			solid.maxY = cell[cx + cz * OCCLUDER_GRID];
+
+			AddOccluderBox(solid, frustum);
+		}
+	}
+}
+
+///----------------------------------------------------------------------------
+///Adds a box lying entirely inside the terrain to the horizon. With the eye
+///above the terrain surface, any ray reaching such a box has already
+///crossed the surface. Columns are only raised where the box covers the
+///whole column width and touches what is already covered from the bottom
+///of the screen, keeping the buffer conservative.
+///----------------------------------------------------------------------------
+void TerrainCuller::AddOccluderBox(const BoundingBox &box, const Frustum &frustum)
+{
+	//corners in clip space, bit 0 = x, bit 1 = y, bit 2 = z
+	float corner[8][4];
+	for(int i = 0; i < 8; i++)
+		frustum.Transform((i & 1) ? box.maxX : box.minX,
+						  (i & 2) ? box.maxY : box.minY,
+						  (i & 4) ? box.maxZ : box.minZ, corner[i]);
+
+	//project the corners in front of the near plane (z >= 0) and the points
+	//where the box edges cross it
+	float px[20], py[20];
+	int count = 0;
+	for(int i = 0; i < 8; i++)
+	{
+		const float *a = corner[i];
+		if(a[2] >= 0.0f)
+		{
+			px[count] = a[0] / a[3];
+			py[count] = a[1] / a[3];
+			count++;
+		}
+
+		for(int axis = 1; axis < 8; axis <<= 1)
+		{
+			if(i & axis) continue;
+
+			const float *b = corner[i | axis];
+			if((a[2] >= 0.0f) == (b[2] >= 0.0f))
+				continue;
+
+			float t = a[2] / (a[2] - b[2]);
+			float w = a[3] + (b[3] - a[3]) * t;
+			if(w <= 1e-6f) return;
+			px[count] = (a[0] + (b[0] - a[0]) * t) / w;
+			py[count] = (a[1] + (b[1] - a[1]) * t) / w;
+			count++;
+		}
+	}
+
+	if(count < 3)
+		return;
+
+	//convex hull of the projected points
+	float lx[20], ly[20], ux[20], uy[20];
+	int lower, upper;
+	ConvexHull(px, py, count, lx, ly, lower, ux, uy, upper);
+	if(lower < 2 || upper < 2)
+		return;
+
+	//columns touched by the hull
+	int columns = (int)m_Horizon.size();
+	float colWidth = 2.0f / columns;
+	float minX = lx[0], maxX = lx[lower - 1];
+	int c0 = (int)floorf((minX + 1.0f) / colWidth);
+	int c1 = (int)floorf((maxX + 1.0f) / colWidth);
+	if(c0 < 0) c0 = 0;
+	if(c1 > columns - 1) c1 = columns - 1;
+
+	//the hull's bottom chain is convex and its top chain concave, so over
+	//any x range the bottom is highest and the top lowest at the range ends
+	int lowerSeg = 0, upperSeg = 0;
+	for(int c = c0; c <= c1; c++)
+	{
+		HorizonColumn &column = m_Horizon[c];
+		float left = -1.0f + c * colWidth;
+		float right = left + colWidth;
+		float xa = minX > left ? minX : left;
+		float xb = maxX < right ? maxX : right;
+
+		float bottomA = EvaluateChain(lx, ly, lower, lowerSeg, xa);
+		float topA = EvaluateChain(ux, uy, upper, upperSeg, xa);
+		float bottomB = EvaluateChain(lx, ly, lower, lowerSeg, xb);
+		float topB = EvaluateChain(ux, uy, upper, upperSeg, xb);
+		float bottom = bottomA > bottomB ? bottomA : bottomB;
+		float top = topA < topB ? topA : topB;
+
+		//must connect to what is already covered from the bottom
+		if(bottom > column.height + HORIZON_EPSILON || top <= column.height)
+			continue;
+
+		if(xa == left && xb == right)
+		{
+			column.height = top;
+			continue;
+		}
+
+		//partial cover from one of the column edges, it completes the column
+		//once it meets a partial cover from the other edge
+		if(xa == left && (xb > column.leftEnd || (xb == column.leftEnd && top > column.leftHeight)))
+		{
+			column.leftEnd = xb;
+			column.leftHeight = top;
+		}
+		else if(xb == right && (xa < column.rightStart || (xa == column.rightStart && top > column.rightHeight)))
+		{
+			column.rightStart = xa;
+			column.rightHeight = top;
+		}
+		else
+		{
+			continue;
+		}
+
+		if(column.leftEnd + HORIZON_EPSILON >= column.rightStart)
+		{
+			float joined = column.leftHeight < column.rightHeight ? column.leftHeight : column.rightHeight;
+			if(joined > column.height)
+				column.height = joined;
+		}
+	}
+}
@@ -0,0 +1,87 @@
+///============================================================================
+///@file	TerrainCuller.h
+///@brief	Decides which terrain patches have to be drawn each frame.
+///			Patch bounds are kept as structure-of-arrays so the frustum test
+///			runs four patches at a time, then an optional front to back
+///			quadtree walk drops patches hidden behind the terrain horizon.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+#include <vector>
+#include "Frustum.h"
+#include "TerrainQuadTree.h"
+
+//-------------------------------------------------------------------------
+//One screen column of the horizon buffer (NDC units, y pointing up)
+//-------------------------------------------------------------------------
+struct HorizonColumn
+{
+	float	height;			///> Covered from the bottom across the whole column
+	float	leftEnd;		///> Extent of the partial cover from the left edge
+	float	leftHeight;		///> Height of the partial cover from the left edge
+	float	rightStart;		///> Start of the partial cover reaching the right edge
+	float	rightHeight;	///> Height of the partial cover reaching the right edge
+};
+
+class TerrainCuller
+{
+public:
+	//-------------------------------------------------------------------------
+	//Constructors and destructors
+	//-------------------------------------------------------------------------
+	TerrainCuller();
+	~TerrainCuller();
+
+	//-------------------------------------------------------------------------
+	//Public methods
+	//-------------------------------------------------------------------------
+	void Build(const TerrainQuadTree &quadTree, const HeightField &heightField, const float *occluderHeights = NULL);
+	void UpdatePatch(unsigned int patch, const BoundingBox &bounds, const HeightField &heightField);
+	unsigned int Cull(const Frustum &frustum, std::vector<unsigned int> &visible);
+	unsigned int Cull(const Frustum &frustum, const float *eye, std::vector<unsigned int> &visible);
+
+	void SetHorizonCulling(bool enable);
+	void SetHorizonResolution(unsigned int columns);
+	unsigned int GetFrustumCulledCount() const;
+	unsigned int GetHorizonCulledCount() const;
+	const float* GetOccluderHeights() const;
+
+	//-------------------------------------------------------------------------
+	//Public members
+	//-------------------------------------------------------------------------
+	static const unsigned int DEFAULT_HORIZON_COLUMNS = 256;	///> Horizon buffer width
+	static const unsigned int OCCLUDER_GRID = 4;				///> Occluder cells per patch side
+	static const float HORIZON_EPSILON;							///> Slack when joining occluders
+
+private:
+	//-------------------------------------------------------------------------
+	//Private methods
+	//-------------------------------------------------------------------------
+	void SetPatchBounds(unsigned int patch, const BoundingBox &bounds);
+	void TestFrustum(const Frustum &frustum);
+	void WalkFrontToBack(int node, const Frustum &frustum, const float *eye, std::vector<unsigned int> &visible);
+	bool IsBelowHorizon(const BoundingBox &box, const Frustum &frustum) const;
+	void AddOccluder(unsigned int patch, const Frustum &frustum, const float *eye);
+	void AddOccluderBox(const BoundingBox &box, const Frustum &frustum);
+
+	//-------------------------------------------------------------------------
+	//Private members
+	//-------------------------------------------------------------------------
+	const TerrainQuadTree*		m_QuadTree;		///> Patches being culled
+	const HeightField*			m_HeightField;	///> Samples the patches were built from
+	std::vector<float>			m_CenterX;		///> Patch box centers (SoA, padded to 4)
+	std::vector<float>			m_CenterY;
+	std::vector<float>			m_CenterZ;
+	std::vector<float>			m_ExtentX;		///> Patch box half sizes (SoA, padded to 4)
+	std::vector<float>			m_ExtentY;
+	std::vector<float>			m_ExtentZ;
+	std::vector<float>			m_OccluderMin;	///> Per patch OCCLUDER_GRID^2 minimum heights
+	std::vector<unsigned char>	m_InFrustum;	///> Per patch result of the frustum pass
+	std::vector<HorizonColumn>	m_Horizon;		///> Horizon buffer
+	bool						m_HorizonCulling;
+	unsigned int				m_FrustumCulled;
+	unsigned int				m_HorizonCulled;
+};
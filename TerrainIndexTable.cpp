@@ -0,0 +1,43 @@
+///============================================================================
+///@file	TerrainIndexTable.cpp
+///@brief	Compile time LOD index tables of the supported patch sizes. The
+///			tables are constant initialized: nothing runs at startup.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "TerrainIndexTable.h"
+
+using TerrainIndexTable::Table;
+
+static constexpr Table<4> s_Table4 = Table<4>::Generate();
+static constexpr Table<8> s_Table8 = Table<8>::Generate();
+static constexpr Table<16> s_Table16 = Table<16>::Generate();
+static constexpr Table<32> s_Table32 = Table<32>::Generate();
+static constexpr Table<64> s_Table64 = Table<64>::Generate();
+
+static const LODIndexSets s_Sets[] =
+{
+	{ 4, Table<4>::LEVEL_COUNT, Table<4>::INDEX_COUNT, s_Table4.indices, s_Table4.ranges },
+	{ 8, Table<8>::LEVEL_COUNT, Table<8>::INDEX_COUNT, s_Table8.indices, s_Table8.ranges },
+	{ 16, Table<16>::LEVEL_COUNT, Table<16>::INDEX_COUNT, s_Table16.indices, s_Table16.ranges },
+	{ 32, Table<32>::LEVEL_COUNT, Table<32>::INDEX_COUNT, s_Table32.indices, s_Table32.ranges },
+	{ 64, Table<64>::LEVEL_COUNT, Table<64>::INDEX_COUNT, s_Table64.indices, s_Table64.ranges }
+};
+
+///----------------------------------------------------------------------------
+///Returns the index sets of a patch size
+///@param	patchSize - quads per patch side
+///@return	the sets, NULL if the size has no table (sizes that are not a
+///			power of two, or above MAX_PATCH_SIZE, generate them at runtime)
+///----------------------------------------------------------------------------
+const LODIndexSets* TerrainIndexTable::Find(unsigned int patchSize)
+{
+	for(unsigned int i = 0; i < sizeof(s_Sets) / sizeof(s_Sets[0]); i++)
+	{
+		if(s_Sets[i].patchSize == patchSize)
+			return &s_Sets[i];
+	}
+
+	return NULL;
+}
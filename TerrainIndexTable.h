@@ -0,0 +1,100 @@
+///============================================================================
+///@file	TerrainIndexTable.h
+///@brief	LOD index sets generated at compile time. Every patch of a given
+///			size draws from the same sets (each level times each stitch
+///			variant), so they only depend on the patch size: Table<size> is
+///			filled by constexpr evaluation of TerrainMesh::BuildLODIndices
+///			and lands in read-only data, ready to upload as is. Find returns
+///			the table of a size, for the sizes built into the library.
+///
+///			const LODIndexSets *sets = TerrainIndexTable::Find(64);
+///			backend.UpdateIndices(buffer, 0, sets->indices, sets->indexCount);
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+#include "TerrainMesh.h"
+
+//-------------------------------------------------------------------------
+//Slice of the shared LOD index buffer
+//-------------------------------------------------------------------------
+struct IndexRange
+{
+	unsigned int	first;		///> First index
+	unsigned int	count;		///> Number of indices (3 per triangle)
+};
+
+//-------------------------------------------------------------------------
+//Every LOD index set of one patch size, back to back, level major
+//-------------------------------------------------------------------------
+struct LODIndexSets
+{
+	unsigned int			patchSize;	///> Quads per patch side
+	unsigned int			levelCount;	///> Levels, 0 = full resolution
+	unsigned int			indexCount;	///> Indices of all sets
+	const unsigned short*	indices;	///> The sets
+	const IndexRange*		ranges;		///> Set of level l and stitch mask m at l * STITCH_VARIANTS + m
+};
+
+namespace TerrainIndexTable
+{
+	static const unsigned int STITCH_VARIANTS = STITCH_NEG_X * 2;	///> Combinations of STITCH_* edge bits
+	static const unsigned int MAX_PATCH_SIZE = 64;					///> Largest size with a table
+
+	const LODIndexSets* Find(unsigned int patchSize);
+
+	///Returns the number of geomipmap levels of a power of two patch size
+	constexpr unsigned int GetLevelCount(unsigned int patchSize)
+	{
+		unsigned int levels = 1;
+		while((1u << (levels - 1)) < patchSize)
+			levels++;
+		return levels;
+	}
+
+	///Returns the indices of every set of a patch size
+	constexpr unsigned int GetIndexCount(unsigned int patchSize)
+	{
+		unsigned int count = 0;
+		for(unsigned int level = 0; level < GetLevelCount(patchSize); level++)
+			for(unsigned int mask = 0; mask < STITCH_VARIANTS; mask++)
+				count += TerrainMesh::BuildLODIndices<unsigned short>(patchSize, level, mask, (unsigned short*)0);
+		return count;
+	}
+
+	//-------------------------------------------------------------------------
+	//The sets of one patch size, as a literal type constexpr code can fill
+	//-------------------------------------------------------------------------
+	template <unsigned int PatchSize>
+	struct Table
+	{
+		static_assert(PatchSize >= 1 && !(PatchSize & (PatchSize - 1)), "patch size must be a power of two");
+		static_assert(PatchSize <= MAX_PATCH_SIZE, "larger tables exceed compile time evaluation limits");
+
+		static const unsigned int LEVEL_COUNT = GetLevelCount(PatchSize);	///> Levels, 0 = full resolution
+		static const unsigned int INDEX_COUNT = GetIndexCount(PatchSize);	///> Indices of all sets
+
+		unsigned short	indices[INDEX_COUNT];						///> The sets
+		IndexRange		ranges[LEVEL_COUNT * STITCH_VARIANTS];		///> Where each set is
+
+		///Writes every set; meant for constexpr variables only
+		static constexpr Table Generate()
+		{
+			Table table{};
+			unsigned int first = 0;
+			for(unsigned int level = 0; level < LEVEL_COUNT; level++)
+			{
+				for(unsigned int mask = 0; mask < STITCH_VARIANTS; mask++)
+				{
+					IndexRange &range = table.ranges[level * STITCH_VARIANTS + mask];
+					range.first = first;
+					range.count = TerrainMesh::BuildLODIndices(PatchSize, level, mask, table.indices + first);
+					first += range.count;
+				}
+			}
+			return table;
+		}
+	};
+}
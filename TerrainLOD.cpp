@@ -0,0 +1,390 @@
+///============================================================================
+///@file	TerrainLOD.cpp
+///@brief	Geomipmap level of detail implementation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "TerrainLOD.h"
+
+#include <math.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TERRAIN_SSE2
+#include <emmintrin.h>
+#endif
+
+const float TerrainLOD::DEFAULT_PIXEL_ERROR = 2.0f;
+
+///----------------------------------------------------------------------------
+///Largest distance between row[u] and the line (base + u * invStep * slope)
+///+ rise over u in [begin,end), or maxError if larger
+///----------------------------------------------------------------------------
+static float RowError(const float *row, unsigned int begin, unsigned int end, float base, float slope,
+					  float rise, float invStep, float maxError)
+{
+	unsigned int u = begin;
+
+#ifdef TERRAIN_SSE2
+	if(end - begin >= 4)
+	{
+		__m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+		__m128 vbase = _mm_set1_ps(base), vslope = _mm_set1_ps(slope), vrise = _mm_set1_ps(rise);
+		__m128 vstep = _mm_set1_ps(invStep), vmax = _mm_set1_ps(maxError);
+		__m128i lanes = _mm_setr_epi32((int)u, (int)u + 1, (int)u + 2, (int)u + 3), four = _mm_set1_epi32(4);
+
+		for(; u + 4 <= end; u += 4, lanes = _mm_add_epi32(lanes, four))
+		{
+			__m128 fu = _mm_mul_ps(_mm_cvtepi32_ps(lanes), vstep);
+			__m128 coarse = _mm_add_ps(_mm_add_ps(vbase, _mm_mul_ps(fu, vslope)), vrise);
+			vmax = _mm_max_ps(vmax, _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(row + u), coarse), absMask));
+		}
+
+		vmax = _mm_max_ps(vmax, _mm_shuffle_ps(vmax, vmax, _MM_SHUFFLE(1, 0, 3, 2)));
+		vmax = _mm_max_ps(vmax, _mm_shuffle_ps(vmax, vmax, _MM_SHUFFLE(2, 3, 0, 1)));
+		maxError = _mm_cvtss_f32(vmax);
+	}
+#endif
+
+	for(; u < end; u++)
+	{
+		float error = fabsf(row[u] - ((base + (float)u * invStep * slope) + rise));
+		maxError = (error > maxError) ? error : maxError;
+	}
+
+	return maxError;
+}
+
+///----------------------------------------------------------------------------
+///Default constructor
+///----------------------------------------------------------------------------
+TerrainLOD::TerrainLOD()
+{
+	m_QuadTree = NULL;
+	m_PatchSize = 0;
+	m_LevelCount = 0;
+	m_Table = NULL;
+}
+
+///----------------------------------------------------------------------------
+///Default destructor
+///----------------------------------------------------------------------------
+TerrainLOD::~TerrainLOD()
+{
+}
+
+///----------------------------------------------------------------------------
+///Lays out the index sets of every level and computes the geometric error
+///of every patch. All patches start at full resolution.
+///@param	quadTree - the patches to LOD, their size must be a power of two
+///@param	heightField - the samples the patches were built from
+///@param	errors - precomputed errors (see GetErrors), NULL to compute them
+///@return	false if the patch size can not be decimated
+///----------------------------------------------------------------------------
+bool TerrainLOD::Build(const TerrainQuadTree &quadTree, const HeightField &heightField, const float *errors)
+{
+	unsigned int patchSize = quadTree.GetPatchSize();
+	if(patchSize < 1 || (patchSize & (patchSize - 1)))
+		return false;
+
+	m_QuadTree = &quadTree;
+	m_PatchSize = patchSize;
+	m_LevelCount = TerrainIndexTable::GetLevelCount(patchSize);
+
+	//index ranges, level major, from the compile time table if there is one
+	m_Table = TerrainIndexTable::Find(patchSize);
+	if(m_Table)
+	{
+		m_Ranges.assign(m_Table->ranges, m_Table->ranges + m_LevelCount * STITCH_VARIANTS);
+	}
+	else
+	{
+		unsigned int first = 0;
+		m_Ranges.resize(m_LevelCount * STITCH_VARIANTS);
+		for(unsigned int level = 0; level < m_LevelCount; level++)
+		{
+			for(unsigned int mask = 0; mask < STITCH_VARIANTS; mask++)
+			{
+				IndexRange &range = m_Ranges[level * STITCH_VARIANTS + mask];
+				range.first = first;
+				range.count = TerrainMesh::BuildLODIndices<unsigned int>(patchSize, level, mask, NULL);
+				first += range.count;
+			}
+		}
+	}
+
+	unsigned int count = quadTree.GetPatchCount();
+	m_Levels.assign(count, 0);
+	m_Stitch.assign(count, 0);
+	m_Samples.resize((patchSize + 1) * (patchSize + 1));
+
+	if(errors)
+	{
+		m_Errors.assign(errors, errors + count * m_LevelCount);
+		return true;
+	}
+
+	m_Errors.resize(count * m_LevelCount);
+	for(unsigned int i = 0; i < count; i++)
+		UpdatePatch(i, heightField);
+
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Recomputes the geometric error of each level of a patch: the largest
+///vertical distance between a dropped sample and the coarser surface
+///(cells split along the same diagonal as the index sets). Errors are made
+///monotonic so a coarser level is never reported as more accurate.
+///@param	patch - patch index
+///@param	heightField - the samples the patch was built from
+///----------------------------------------------------------------------------
+void TerrainLOD::UpdatePatch(unsigned int patch, const HeightField &heightField)
+{
+	const TerrainPatch &p = m_QuadTree->GetPatch(patch);
+	unsigned int pitch = m_PatchSize + 1;
+	unsigned int lastX = heightField.GetWidth() - 1;
+	unsigned int lastZ = heightField.GetHeight() - 1;
+
+	//same clamping as the patch vertices
+	float *h = &m_Samples[0];
+	for(unsigned int j = 0; j <= m_PatchSize; j++)
+	{
+		unsigned int z = p.z + j;
+		if(z > lastZ) z = lastZ;
+
+		for(unsigned int i = 0; i <= m_PatchSize; i++)
+		{
+			unsigned int x = p.x + i;
+			if(x > lastX) x = lastX;
+			*h++ = heightField.GetElevation(x, z);
+		}
+	}
+
+	h = &m_Samples[0];
+	float *errors = &m_Errors[patch * m_LevelCount];
+	errors[0] = 0.0f;
+
+	for(unsigned int level = 1; level < m_LevelCount; level++)
+	{
+		unsigned int step = 1 << level;
+		float invStep = 1.0f / (float)step;
+		float maxError = errors[level - 1];
+
+		for(unsigned int cz = 0; cz < m_PatchSize; cz += step)
+		{
+			for(unsigned int cx = 0; cx < m_PatchSize; cx += step)
+			{
+				float h1 = h[cx + cz * pitch];
+				float h2 = h[cx + step + cz * pitch];
+				float h3 = h[cx + (cz + step) * pitch];
+				float h4 = h[cx + step + (cz + step) * pitch];
+
+				for(unsigned int v = 0; v <= step; v++)
+				{
+					const float *row = &h[cx + (cz + v) * pitch];
+					float fv = (float)v * invStep;
+
+					//below the diagonal (u < v) the cell is (h1,h3,h4), on and
+					//above it (h1,h2,h4)
+					maxError = RowError(row, 0, v, h1 + fv * (h3 - h1), h4 - h3, 0.0f, invStep, maxError);
+					maxError = RowError(row, v, step + 1, h1, h2 - h1, fv * (h4 - h2), invStep, maxError);
+				}
+			}
+		}
+
+		errors[level] = maxError;
+	}
+}
+
+///----------------------------------------------------------------------------
+///Picks the level of every patch for this frame. A level is acceptable when
+///its error projected at the distance of the patch stays under
+///maxPixelError pixels.
+///@param	eye - camera position in terrain space (x,y,z)
+///@param	errorScale - pixels per world unit at distance 1, i.e.
+///			viewportHeight / (2 * tan(fovY / 2))
+///@param	maxPixelError - screen space error bound in pixels
+///----------------------------------------------------------------------------
+void TerrainLOD::Select(const float *eye, float errorScale, float maxPixelError)
+{
+	if(!m_QuadTree) return;
+
+	float scale = errorScale / (maxPixelError > 0.0f ? maxPixelError : 1e-3f);
+	unsigned int count = m_QuadTree->GetPatchCount();
+
+	for(unsigned int i = 0; i < count; i++)
+	{
+		//distance from the eye to the closest point of the patch
+		const BoundingBox &b = m_QuadTree->GetPatch(i).bounds;
+		float dx = eye[0] < b.minX ? b.minX - eye[0] : (eye[0] > b.maxX ? eye[0] - b.maxX : 0.0f);
+		float dy = eye[1] < b.minY ? b.minY - eye[1] : (eye[1] > b.maxY ? eye[1] - b.maxY : 0.0f);
+		float dz = eye[2] < b.minZ ? b.minZ - eye[2] : (eye[2] > b.maxZ ? eye[2] - b.maxZ : 0.0f);
+		float distance = sqrtf(dx * dx + dy * dy + dz * dz);
+
+		//errors grow with the level, so the first fit from the top is the coarsest
+		const float *errors = &m_Errors[i * m_LevelCount];
+		unsigned int level = m_LevelCount - 1;
+		while(level > 0 && errors[level] * scale > distance)
+			level--;
+
+		m_Levels[i] = (unsigned char)level;
+	}
+
+	LimitNeighborLevels();
+	ComputeStitchMasks();
+}
+
+///----------------------------------------------------------------------------
+///Puts every patch back at full resolution
+///----------------------------------------------------------------------------
+void TerrainLOD::SelectFull()
+{
+	m_Levels.assign(m_Levels.size(), 0);
+	m_Stitch.assign(m_Stitch.size(), 0);
+}
+
+///----------------------------------------------------------------------------
+///Refines patches until no two neighbors are more than one level apart.
+///Levels are settled from the finest up, so a patch is only ever refined.
+///----------------------------------------------------------------------------
+void TerrainLOD::LimitNeighborLevels()
+{
+	unsigned int countX = m_QuadTree->GetPatchCountX();
+	unsigned int countZ = m_QuadTree->GetPatchCountZ();
+
+	for(unsigned int level = 0; level + 2 < m_LevelCount; level++)
+	{
+		unsigned char limit = (unsigned char)(level + 1);
+
+		for(unsigned int pz = 0; pz < countZ; pz++)
+		{
+			for(unsigned int px = 0; px < countX; px++)
+			{
+				unsigned int i = px + pz * countX;
+				if(m_Levels[i] != level) continue;
+
+				if(px > 0			&& m_Levels[i - 1] > limit)			m_Levels[i - 1] = limit;
+				if(px + 1 < countX	&& m_Levels[i + 1] > limit)			m_Levels[i + 1] = limit;
+				if(pz > 0			&& m_Levels[i - countX] > limit)	m_Levels[i - countX] = limit;
+				if(pz + 1 < countZ	&& m_Levels[i + countX] > limit)	m_Levels[i + countX] = limit;
+			}
+		}
+	}
+}
+
+///----------------------------------------------------------------------------
+///Flags the edges of every patch that border a coarser neighbor
+///----------------------------------------------------------------------------
+void TerrainLOD::ComputeStitchMasks()
+{
+	unsigned int countX = m_QuadTree->GetPatchCountX();
+	unsigned int countZ = m_QuadTree->GetPatchCountZ();
+
+	for(unsigned int pz = 0; pz < countZ; pz++)
+	{
+		for(unsigned int px = 0; px < countX; px++)
+		{
+			unsigned int i = px + pz * countX;
+			unsigned char level = m_Levels[i];
+			unsigned char mask = 0;
+
+			if(pz > 0			&& m_Levels[i - countX] > level)	mask |= STITCH_NEG_Z;
+			if(px + 1 < countX	&& m_Levels[i + 1] > level)			mask |= STITCH_POS_X;
+			if(pz + 1 < countZ	&& m_Levels[i + countX] > level)	mask |= STITCH_POS_Z;
+			if(px > 0			&& m_Levels[i - 1] > level)			mask |= STITCH_NEG_X;
+
+			m_Stitch[i] = mask;
+		}
+	}
+}
+
+///----------------------------------------------------------------------------
+///Returns the number of decimation levels, 0 being full resolution
+///----------------------------------------------------------------------------
+unsigned int TerrainLOD::GetLevelCount() const
+{
+	return m_LevelCount;
+}
+
+///----------------------------------------------------------------------------
+///Returns the size of the shared index buffer written by BuildIndices
+///----------------------------------------------------------------------------
+unsigned int TerrainLOD::GetIndexCount() const
+{
+	if(m_Ranges.empty()) return 0;
+
+	const IndexRange &last = m_Ranges.back();
+	return last.first + last.count;
+}
+
+///----------------------------------------------------------------------------
+///Returns the compile time index sets of the patch size, the same indices
+///BuildIndices writes, or NULL if the size has none
+///----------------------------------------------------------------------------
+const LODIndexSets* TerrainLOD::GetIndexTable() const
+{
+	return m_Table;
+}
+
+///----------------------------------------------------------------------------
+///Returns where the index set of one level and stitch variant lives
+///----------------------------------------------------------------------------
+const IndexRange& TerrainLOD::GetIndexRange(unsigned int level, unsigned int stitchMask) const
+{
+	return m_Ranges[level * STITCH_VARIANTS + stitchMask];
+}
+
+///----------------------------------------------------------------------------
+///Returns the index set selected for a patch this frame
+///----------------------------------------------------------------------------
+const IndexRange& TerrainLOD::GetPatchRange(unsigned int patch) const
+{
+	return m_Ranges[m_Levels[patch] * STITCH_VARIANTS + m_Stitch[patch]];
+}
+
+///----------------------------------------------------------------------------
+///Returns the level selected for a patch this frame
+///----------------------------------------------------------------------------
+unsigned int TerrainLOD::GetPatchLevel(unsigned int patch) const
+{
+	return m_Levels[patch];
+}
+
+///----------------------------------------------------------------------------
+///Returns the STITCH_* edges of a patch this frame
+///----------------------------------------------------------------------------
+unsigned int TerrainLOD::GetPatchStitch(unsigned int patch) const
+{
+	return m_Stitch[patch];
+}
+
+///----------------------------------------------------------------------------
+///Returns the geometric error (world units) of a patch at one level
+///----------------------------------------------------------------------------
+float TerrainLOD::GetPatchError(unsigned int patch, unsigned int level) const
+{
+	return m_Errors[patch * m_LevelCount + level];
+}
+
+///----------------------------------------------------------------------------
+///Returns the errors of every level of every patch, patch major
+///----------------------------------------------------------------------------
+const float* TerrainLOD::GetErrors() const
+{
+	return m_Errors.empty() ? NULL : &m_Errors[0];
+}
+
+///----------------------------------------------------------------------------
+///Returns the number of triangles the selected levels submit for a set of
+///patches
+///@param	patches - patch indices, e.g. the visible set
+///----------------------------------------------------------------------------
+unsigned int TerrainLOD::GetTriangleCount(const std::vector<unsigned int> &patches) const
+{
+	unsigned int triangles = 0;
+	for(size_t i = 0; i < patches.size(); i++)
+		triangles += GetPatchRange(patches[i]).count / 3;
+
+	return triangles;
+}
@@ -0,0 +1,105 @@
+///============================================================================
+///@file	TerrainLOD.h
+///@brief	Geomipmap level of detail. Every patch keeps the geometric error
+///			of each decimation level; once per frame the coarsest level whose
+///			projected error stays under a pixel bound is picked, neighbors are
+///			kept within one level of each other and the edges facing a
+///			coarser neighbor get a stitched index set so no cracks appear.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+#include <vector>
+#include "TerrainIndexTable.h"
+#include "TerrainMesh.h"
+#include "TerrainQuadTree.h"
+#include "VertexCache.h"
+
+class TerrainLOD
+{
+public:
+	//-------------------------------------------------------------------------
+	//Constructors and destructors
+	//-------------------------------------------------------------------------
+	TerrainLOD();
+	~TerrainLOD();
+
+	//-------------------------------------------------------------------------
+	//Public methods
+	//-------------------------------------------------------------------------
+	bool Build(const TerrainQuadTree &quadTree, const HeightField &heightField, const float *errors = NULL);
+	void UpdatePatch(unsigned int patch, const HeightField &heightField);
+	void Select(const float *eye, float errorScale, float maxPixelError);
+	void SelectFull();
+
+	unsigned int GetLevelCount() const;
+	unsigned int GetIndexCount() const;
+	const LODIndexSets* GetIndexTable() const;
+	const IndexRange& GetIndexRange(unsigned int level, unsigned int stitchMask) const;
+	const IndexRange& GetPatchRange(unsigned int patch) const;
+	unsigned int GetPatchLevel(unsigned int patch) const;
+	unsigned int GetPatchStitch(unsigned int patch) const;
+	float GetPatchError(unsigned int patch, unsigned int level) const;
+	const float* GetErrors() const;
+	unsigned int GetTriangleCount(const std::vector<unsigned int> &patches) const;
+
+	///------------------------------------------------------------------------
+	///Writes the index sets of every level and stitch variant back to back,
+	///in the layout described by GetIndexRange, copied from the compile
+	///time table when the patch size has one (see GetIndexTable, which can
+	///be uploaded without this copy).
+	///@param	indices - receives GetIndexCount() indices
+	///@param	cacheOptimize - generate the sets and reorder them with
+	///			VertexCache::Optimize instead of keeping the banded order
+	///------------------------------------------------------------------------
+	template <typename IndexType>
+	void BuildIndices(IndexType *indices, bool cacheOptimize = false) const
+	{
+		if(m_Table && !cacheOptimize)
+		{
+			for(unsigned int i = 0; i < m_Table->indexCount; i++)
+				indices[i] = (IndexType)m_Table->indices[i];
+			return;
+		}
+
+		unsigned int vertexCount = (m_PatchSize + 1) * (m_PatchSize + 1);
+		for(unsigned int level = 0; level < m_LevelCount; level++)
+		{
+			for(unsigned int mask = 0; mask < STITCH_VARIANTS; mask++)
+			{
+				unsigned int count = TerrainMesh::BuildLODIndices(m_PatchSize, level, mask, indices);
+				if(cacheOptimize)
+					VertexCache::Optimize(indices, count, vertexCount);
+				indices += count;
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	//Public members
+	//-------------------------------------------------------------------------
+	static const unsigned int STITCH_VARIANTS = TerrainIndexTable::STITCH_VARIANTS;	///> Combinations of STITCH_* edge bits
+	static const float DEFAULT_PIXEL_ERROR;			///> Default screen space error bound
+
+private:
+	//-------------------------------------------------------------------------
+	//Private methods
+	//-------------------------------------------------------------------------
+	void LimitNeighborLevels();
+	void ComputeStitchMasks();
+
+	//-------------------------------------------------------------------------
+	//Private members
+	//-------------------------------------------------------------------------
+	const TerrainQuadTree*		m_QuadTree;		///> Patches being LOD'd
+	unsigned int				m_PatchSize;	///> Quads per patch side
+	unsigned int				m_LevelCount;	///> Levels, 0 = full resolution
+	const LODIndexSets*			m_Table;		///> Compile time index sets of the patch size, NULL if none
+	std::vector<IndexRange>		m_Ranges;		///> Index range per level and stitch mask
+	std::vector<float>			m_Errors;		///> Per patch geometric error of each level
+	std::vector<unsigned char>	m_Levels;		///> Per patch selected level
+	std::vector<unsigned char>	m_Stitch;		///> Per patch stitch mask
+	std::vector<float>			m_Samples;		///> Scratch copy of one patch's elevations
+};
@@ -0,0 +1,457 @@
+///============================================================================
+///@file	TerrainMesh.cpp
+///@brief	Terrain patch mesh generation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "TerrainMesh.h"
+
+#include <math.h>
+#include <string.h>
+#include "CpuInfo.h"
+#include "Parallel.h"
+
+static bool s_UseSIMD = true;	///> Let GetVertexRowKernel pick the SIMD kernels
+
+///----------------------------------------------------------------------------
+///Returns sample i of a row of any format as a float
+///----------------------------------------------------------------------------
+static inline float RowValue(const void *row, unsigned int sampleSize, ptrdiff_t i)
+{
+	if(sampleSize == 4) return ((const float*)row)[i];
+	if(sampleSize == 2) return (float)((const unsigned short*)row)[i];
+	return (float)((const unsigned char*)row)[i];
+}
+
+///----------------------------------------------------------------------------
+///Packed normal and slope of one sample from its four neighbors, the
+///reference the normal row kernels have to match bit for bit
+///@param	left, right - samples along x
+///@param	up, down - samples along z
+///@param	gradient - x and z world height per sample difference
+///----------------------------------------------------------------------------
+static inline void NormalSample(float left, float right, float up, float down, const float *gradient,
+								unsigned short &normal, unsigned char &slope)
+{
+	float dx = (right - left) * gradient[0];
+	float dz = (down - up) * gradient[1];
+
+	//PackNormal(-dx, 1, -dz) without its checks, the sum is at least 1
+	float k = 127.5f / (fabsf(dx) + 1.0f + fabsf(dz));
+	float u = -dx * k + 128.0f;
+	float v = -dz * k + 128.0f;
+	unsigned int iu = (unsigned int)(int)u, iv = (unsigned int)(int)v;
+	normal = (unsigned short)((iu > 255 ? 255 : iu) | ((iv > 255 ? 255 : iv) << 8));
+
+	//sin(angle) = |g| / sqrt(|g|^2 + 1)
+	float g2 = dx * dx + dz * dz;
+	slope = (unsigned char)(int)(sqrtf(g2 / (g2 + 1.0f)) * 255.0f + 0.5f);
+}
+
+///----------------------------------------------------------------------------
+///Computes the normals of columns [begin,end) of rows [z0,z1), the map
+///edges with one-sided differences
+///----------------------------------------------------------------------------
+static void BuildNormalRows(const HeightField &heightField, unsigned int begin, unsigned int end,
+							unsigned int z0, unsigned int z1, unsigned short *normals, unsigned char *slopes)
+{
+	unsigned int width = heightField.GetWidth();
+	unsigned int lastX = width - 1, lastZ = heightField.GetHeight() - 1;
+	unsigned int sampleSize = heightField.GetSampleSize();
+	const unsigned char *data = (const unsigned char*)heightField.GetData();
+	float half = heightField.GetVerticalScale() * 0.5f, full = heightField.GetVerticalScale();
+	TerrainMesh::NormalRowKernel kernel = TerrainMesh::GetNormalRowKernel();
+
+	//the first and last columns are done one sample at a time
+	unsigned int first = begin > 1 ? begin : 1;
+	unsigned int last = end < lastX ? end : lastX;
+
+	for(unsigned int z = z0; z < z1; z++)
+	{
+		const unsigned char *row = data + (size_t)z * width * sampleSize;
+		const unsigned char *above = (z > 0) ? row - (size_t)width * sampleSize : row;
+		const unsigned char *below = (z < lastZ) ? row + (size_t)width * sampleSize : row;
+		float gradient[2] = { half, (z > 0 && z < lastZ) ? half : full };
+		size_t at = (size_t)z * width;
+		unsigned char scratch;
+
+		if(first < last)
+		{
+			kernel(above + first * sampleSize, row + first * sampleSize, below + first * sampleSize, sampleSize,
+				   last - first, gradient, normals + at + first, slopes ? slopes + at + first : NULL);
+		}
+
+		float edge[2] = { full, gradient[1] };
+		if(begin == 0)
+		{
+			NormalSample(RowValue(row, sampleSize, 0), RowValue(row, sampleSize, 1), RowValue(above, sampleSize, 0),
+						 RowValue(below, sampleSize, 0), edge, normals[at], slopes ? slopes[at] : scratch);
+		}
+		if(end > lastX)
+		{
+			NormalSample(RowValue(row, sampleSize, lastX - 1), RowValue(row, sampleSize, lastX), RowValue(above, sampleSize, lastX),
+						 RowValue(below, sampleSize, lastX), edge, normals[at + lastX], slopes ? slopes[at + lastX] : scratch);
+		}
+	}
+}
+
+///----------------------------------------------------------------------------
+///Scalar vertex row kernel, the reference for the SIMD versions
+///@param	samples - first sample of the run
+///@param	sampleSize - bytes per sample (1, 2 or 4 for float)
+///@param	count - number of vertices to write
+///@param	x, z - map position of the first sample
+///@param	mapping - height scale and offset, shade base and scale
+///@param	vertices - receives count vertices
+///----------------------------------------------------------------------------
+void TerrainMesh::BuildVertexRow(const void *samples, unsigned int sampleSize, unsigned int count,
+								 unsigned int x, unsigned int z, const float *mapping, Vertex3D *vertices)
+{
+	const unsigned char *samples8 = (const unsigned char*)samples;
+	const unsigned short *samples16 = (const unsigned short*)samples;
+	const float *samples32 = (const float*)samples;
+
+	for(unsigned int i = 0; i < count; i++)
+	{
+		float s = (sampleSize == 4) ? samples32[i] : (float)((sampleSize == 2) ? samples16[i] : samples8[i]);
+
+		//over the type range this is s >> 8 for 16-bit and s for 8-bit; a
+		//.hdr min/max spreads the shades over that range instead
+		float level = (s - mapping[2]) * mapping[3];
+		unsigned int shade = (unsigned int)(level < 0.0f ? 0.0f : (level > 255.0f ? 255.0f : level));
+
+		vertices[i].x = (float)(x + i);
+		vertices[i].y = s * mapping[0] + mapping[1];
+		vertices[i].z = (float)z;
+		vertices[i].color = shade | (shade << 8) | (shade << 16);
+	}
+}
+
+///----------------------------------------------------------------------------
+///Fills the mapping the vertex row kernels take for a height field
+///@param	heightField - the terrain samples
+///@param	mapping - receives { scale, offset, shade base, shade scale }
+///----------------------------------------------------------------------------
+void TerrainMesh::GetVertexMapping(const HeightField &heightField, float *mapping)
+{
+	float low, high;
+	heightField.GetSampleRange(low, high);
+
+	mapping[0] = heightField.GetVerticalScale();
+	mapping[1] = heightField.GetVerticalOffset();
+	mapping[2] = low;
+	mapping[3] = heightField.GetShadeScale();
+}
+
+///----------------------------------------------------------------------------
+///Returns how PackedVertex heights map back to world heights, y = height *
+///scale + offset: integer samples are stored as they are, float samples
+///are quantized to 16 bits over the sample range of the map
+///----------------------------------------------------------------------------
+void TerrainMesh::GetPackedHeightMapping(const HeightField &heightField, float &scale, float &offset)
+{
+	scale = heightField.GetVerticalScale();
+	offset = heightField.GetVerticalOffset();
+
+	if(heightField.GetFormat() == HEIGHT_FLOAT32)
+	{
+		float low, high;
+		heightField.GetSampleRange(low, high);
+		offset += low * scale;
+		scale *= (high - low) / 65535.0f;
+	}
+}
+
+///----------------------------------------------------------------------------
+///Scalar normal row kernel, the reference for the SIMD versions
+///@param	above, row, below - first sample of the run in rows z-1, z, z+1
+///@param	sampleSize - bytes per sample (1, 2 or 4 for float)
+///@param	count - number of samples
+///@param	gradient - x and z world height per sample difference
+///@param	normals - receives count packed normals
+///@param	slopes - receives count slopes, or NULL
+///----------------------------------------------------------------------------
+void TerrainMesh::BuildNormalRow(const void *above, const void *row, const void *below, unsigned int sampleSize,
+								 unsigned int count, const float *gradient, unsigned short *normals, unsigned char *slopes)
+{
+	unsigned char scratch;
+	for(unsigned int i = 0; i < count; i++)
+	{
+		NormalSample(RowValue(row, sampleSize, (ptrdiff_t)i - 1), RowValue(row, sampleSize, i + 1),
+					 RowValue(above, sampleSize, i), RowValue(below, sampleSize, i), gradient,
+					 normals[i], slopes ? slopes[i] : scratch);
+	}
+}
+
+///----------------------------------------------------------------------------
+///Returns the fastest normal row kernel this machine can run
+///----------------------------------------------------------------------------
+TerrainMesh::NormalRowKernel TerrainMesh::GetNormalRowKernel()
+{
+	if(s_UseSIMD && HasAVX2Kernel() && CpuInfo::HasAVX2())
+		return BuildNormalRowAVX2;
+
+	return BuildNormalRow;
+}
+
+///----------------------------------------------------------------------------
+///Computes the packed normal and slope of every sample, rows in parallel
+///@param	heightField - the terrain samples
+///@param	normals - receives width * height packed normals, row major
+///@param	slopes - receives width * height slopes, or NULL
+///----------------------------------------------------------------------------
+void TerrainMesh::BuildNormals(const HeightField &heightField, unsigned short *normals, unsigned char *slopes)
+{
+	UpdateNormals(heightField, 0, 0, heightField.GetWidth(), heightField.GetHeight(), normals, slopes);
+}
+
+///----------------------------------------------------------------------------
+///Recomputes the normals a change of samples affects: the changed
+///rectangle plus a one sample border, clamped to the map
+///@param	heightField - the terrain samples, already changed
+///@param	x, z - first changed sample
+///@param	width, height - size of the changed rectangle
+///@param	normals - the map normals to update, row major
+///@param	slopes - the map slopes to update, or NULL
+///----------------------------------------------------------------------------
+void TerrainMesh::UpdateNormals(const HeightField &heightField, unsigned int x, unsigned int z, unsigned int width,
+								unsigned int height, unsigned short *normals, unsigned char *slopes)
+{
+	unsigned int mapWidth = heightField.GetWidth(), mapHeight = heightField.GetHeight();
+	if(!heightField.GetData() || !width || !height || x >= mapWidth || z >= mapHeight)
+		return;
+
+	unsigned int x0 = x > 0 ? x - 1 : 0, z0 = z > 0 ? z - 1 : 0;
+	unsigned int x1 = (width < mapWidth - x) ? x + width + 1 : mapWidth;
+	unsigned int z1 = (height < mapHeight - z) ? z + height + 1 : mapHeight;
+
+	//small rectangles are not worth waking threads for
+	unsigned int grain = 1 + 16384 / (x1 - x0);
+	Parallel::For(z1 - z0, grain, [&](unsigned int begin, unsigned int end, unsigned int)
+	{
+		BuildNormalRows(heightField, x0, x1, z0 + begin, z0 + end, normals, slopes);
+	});
+}
+
+///----------------------------------------------------------------------------
+///Returns the fastest vertex row kernel this machine can run
+///----------------------------------------------------------------------------
+TerrainMesh::VertexRowKernel TerrainMesh::GetVertexRowKernel()
+{
+	if(s_UseSIMD && HasAVX2Kernel() && CpuInfo::HasAVX2())
+		return BuildVertexRowAVX2;
+
+	return BuildVertexRow;
+}
+
+///----------------------------------------------------------------------------
+///Allows or forbids the SIMD kernels (e.g. to compare against scalar)
+///----------------------------------------------------------------------------
+void TerrainMesh::EnableSIMD(bool enable)
+{
+	s_UseSIMD = enable;
+}
+
+///----------------------------------------------------------------------------
+///Fills the (patchSize+1)^2 vertices of a patch in world space.
+///Samples past the edge of the map are clamped onto the last row/column.
+///@param	heightField - the terrain samples
+///@param	patch - the patch to build
+///@param	patchSize - quads per patch side
+///@param	vertices - receives the patch vertices, row major
+///----------------------------------------------------------------------------
+void TerrainMesh::BuildPatchVertices(const HeightField &heightField, const TerrainPatch &patch,
+									 unsigned int patchSize, Vertex3D *vertices)
+{
+	unsigned int width = heightField.GetWidth();
+	unsigned int lastZ = heightField.GetHeight() - 1;
+	unsigned int pitch = patchSize + 1;
+	unsigned int columns = (patch.x + patchSize < width) ? pitch : width - patch.x;
+	unsigned int sampleSize = heightField.GetSampleSize();
+	const unsigned char *data = (const unsigned char*)heightField.GetData();
+	float mapping[4];
+	GetVertexMapping(heightField, mapping);
+	VertexRowKernel kernel = GetVertexRowKernel();
+
+	for(unsigned int j = 0; j <= patchSize; j++)
+	{
+		Vertex3D *row = vertices + j * pitch;
+		unsigned int z = patch.z + j;
+
+		//rows past the edge repeat the last one
+		if(z > lastZ)
+		{
+			memcpy(row, row - pitch, pitch * sizeof(Vertex3D));
+			continue;
+		}
+
+		kernel(data + ((size_t)z * width + patch.x) * sampleSize, sampleSize, columns, patch.x, z, mapping, row);
+		for(unsigned int i = columns; i < pitch; i++)
+			row[i] = row[columns - 1];
+	}
+}
+
+///----------------------------------------------------------------------------
+///Fills the vertices of every patch, rows of patches in parallel
+///@param	heightField - the terrain samples
+///@param	quadTree - the patches
+///@param	patchVertices - per patch destination, GetPatchVertexCount() each
+///----------------------------------------------------------------------------
+void TerrainMesh::BuildVertices(const HeightField &heightField, const TerrainQuadTree &quadTree,
+								Vertex3D *const *patchVertices)
+{
+	unsigned int countX = quadTree.GetPatchCountX();
+	unsigned int patchSize = quadTree.GetPatchSize();
+
+	Parallel::For(quadTree.GetPatchCountZ(), 1, [&](unsigned int begin, unsigned int end, unsigned int)
+	{
+		for(unsigned int pz = begin; pz < end; pz++)
+		{
+			for(unsigned int px = 0; px < countX; px++)
+			{
+				unsigned int i = px + pz * countX;
+				if(patchVertices[i])
+					BuildPatchVertices(heightField, quadTree.GetPatch(i), patchSize, patchVertices[i]);
+			}
+		}
+	});
+}
+
+///----------------------------------------------------------------------------
+///Packs a unit normal pointing up (ny >= 0) into 16 bits: the normal is
+///projected onto the octahedron |x|+|y|+|z| = 1 and its x/z stored as bytes
+///----------------------------------------------------------------------------
+unsigned short TerrainMesh::PackNormal(float nx, float ny, float nz)
+{
+	float sum = fabsf(nx) + fabsf(ny) + fabsf(nz);
+	if(sum <= 0.0f)
+		return 0x8080;
+
+	//(n / sum * 0.5 + 0.5) * 255, rounded; always within [0,255]
+	float k = 127.5f / sum;
+	int u = (int)(nx * k + 128.0f);
+	int v = (int)(nz * k + 128.0f);
+	if(u > 255) u = 255;
+	if(v > 255) v = 255;
+
+	return (unsigned short)(u | (v << 8));
+}
+
+///----------------------------------------------------------------------------
+///Unpacks a normal written by PackNormal
+///----------------------------------------------------------------------------
+void TerrainMesh::UnpackNormal(unsigned short normal, float &nx, float &ny, float &nz)
+{
+	nx = (float)(normal & 0xff) / 255.0f * 2.0f - 1.0f;
+	nz = (float)(normal >> 8) / 255.0f * 2.0f - 1.0f;
+	ny = 1.0f - fabsf(nx) - fabsf(nz);
+	if(ny < 0.0f) ny = 0.0f;
+
+	float length = sqrtf(nx * nx + ny * ny + nz * nz);
+	nx /= length;
+	ny /= length;
+	nz /= length;
+}
+
+///----------------------------------------------------------------------------
+///Fills the (patchSize+1)^2 compact vertices of a patch. Positions are
+///clamped at the map edges exactly like BuildPatchVertices and the normal
+///comes from central differences of the neighboring samples, the same
+///BuildNormals computes.
+///@param	heightField - the terrain samples
+///@param	patch - the patch to build
+///@param	patchSize - quads per patch side, up to 65535
+///@param	vertices - receives the patch vertices, row major
+///@param	normals - normals of the whole map from BuildNormals, NULL to
+///			compute them here
+///----------------------------------------------------------------------------
+void TerrainMesh::BuildPackedPatchVertices(const HeightField &heightField, const TerrainPatch &patch,
+										   unsigned int patchSize, PackedVertex *vertices,
+										   const unsigned short *normals)
+{
+	unsigned int lastX = heightField.GetWidth() - 1;
+	unsigned int lastZ = heightField.GetHeight() - 1;
+	bool quantize = heightField.GetFormat() == HEIGHT_FLOAT32;
+	float low, high;
+	heightField.GetSampleRange(low, high);
+	float levels = (high > low) ? 65535.0f / (high - low) : 0.0f;
+	float scale = heightField.GetVerticalScale();
+
+	for(unsigned int j = 0; j <= patchSize; j++)
+	{
+		unsigned int z = patch.z + j;
+		if(z > lastZ) z = lastZ;
+		unsigned int z0 = z > 0 ? z - 1 : 0, z1 = z < lastZ ? z + 1 : lastZ;
+
+		for(unsigned int i = 0; i <= patchSize; i++)
+		{
+			unsigned int x = patch.x + i;
+			if(x > lastX) x = lastX;
+			unsigned int x0 = x > 0 ? x - 1 : 0, x1 = x < lastX ? x + 1 : lastX;
+
+			vertices->x = (unsigned short)(x - patch.x);
+			vertices->z = (unsigned short)(z - patch.z);
+			if(quantize)
+			{
+				float level = (heightField.GetValue(x, z) - low) * levels + 0.5f;
+				vertices->height = (unsigned short)(level < 0.0f ? 0.0f : (level > 65535.0f ? 65535.0f : level));
+			}
+			else
+			{
+				vertices->height = (unsigned short)heightField.GetSample(x, z);
+			}
+			if(normals)
+			{
+				vertices->normal = normals[(size_t)z * (lastX + 1) + x];
+			}
+			else
+			{
+				float gradient[2] = { (x1 - x0) == 2 ? scale * 0.5f : scale, (z1 - z0) == 2 ? scale * 0.5f : scale };
+				unsigned char slope;
+				NormalSample(heightField.GetValue(x0, z), heightField.GetValue(x1, z), heightField.GetValue(x, z0),
+							 heightField.GetValue(x, z1), gradient, vertices->normal, slope);
+			}
+			vertices++;
+		}
+	}
+}
+
+///----------------------------------------------------------------------------
+///Expands compact vertices back to world space Vertex3D, bit for bit what
+///BuildPatchVertices writes for the same patch of an integer map, shaded
+///over its sample range the same way (float heights come back within half
+///a 16-bit step of the sample range, their shades within one level)
+///@param	heightField - the samples the vertices were built from
+///@param	patch - the patch the vertices belong to
+///@param	packed - compact vertices
+///@param	count - number of vertices
+///@param	vertices - receives the expanded vertices
+///----------------------------------------------------------------------------
+void TerrainMesh::DecodePatchVertices(const HeightField &heightField, const TerrainPatch &patch,
+									  const PackedVertex *packed, unsigned int count, Vertex3D *vertices)
+{
+	float scale, offset, mapping[4];
+	GetPackedHeightMapping(heightField, scale, offset);
+	GetVertexMapping(heightField, mapping);
+
+	//float heights are stored over the sample range, shade them back from it
+	float step = 1.0f, base = 0.0f;
+	if(heightField.GetFormat() == HEIGHT_FLOAT32)
+	{
+		float high;
+		heightField.GetSampleRange(base, high);
+		step = (high - base) / 65535.0f;
+	}
+
+	for(unsigned int i = 0; i < count; i++)
+	{
+		float s = (float)packed[i].height * step + base;
+		float level = (s - mapping[2]) * mapping[3];
+		unsigned int shade = (unsigned int)(level < 0.0f ? 0.0f : (level > 255.0f ? 255.0f : level));
+		vertices[i].x = (float)(patch.x + packed[i].x);
+		vertices[i].y = (float)packed[i].height * scale + offset;
+		vertices[i].z = (float)(patch.z + packed[i].z);
+		vertices[i].color = shade | (shade << 8) | (shade << 16);
+	}
+}
@@ -0,0 +1,256 @@
+///============================================================================
+///@file	TerrainMesh.h
+///@brief	Generates the vertices and indices of terrain patches.
+///			Rows of vertices come from a scalar or an AVX2 kernel picked at
+///			runtime; packed vertices keep 16-bit heights over the map's
+///			sample range. Normals are packed octahedral in 16 bits with an
+///			8-bit slope per sample, built from central differences across
+///			threads and redone only over a dirty rectangle after an edit.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+#include "HeightField.h"
+#include "TerrainQuadTree.h"
+
+//-------------------------------------------------------------------------
+//Defines our custom vertex 3D structure (D3DFVF_XYZ | D3DFVF_DIFFUSE)
+//-------------------------------------------------------------------------
+class Vertex3D
+{
+public:
+	Vertex3D(float fx, float fy, float fz, unsigned int diffuse = 0xFF000000)
+	{x=fx; y=fy; z=fz; color=diffuse;}
+
+	Vertex3D()
+	{x=0.0f; y=0.0f; z=0.0f; color=0xFF000000;}
+
+	float x,y,z;
+	unsigned int color;
+};
+
+//-------------------------------------------------------------------------
+//Compact vertex, 8 bytes instead of 16: the position is stored relative
+//to the patch and the color is derived from the height when decoding
+//(D3DDECLTYPE_USHORT4 / shader friendly)
+//-------------------------------------------------------------------------
+struct PackedVertex
+{
+	unsigned short	x;			///> Patch local x, 0..patchSize
+	unsigned short	z;			///> Patch local z, 0..patchSize
+	unsigned short	height;		///> Height sample, float maps quantized over their sample range
+	unsigned short	normal;		///> Octahedral normal, x in the low byte, z in the high byte
+};
+
+//-------------------------------------------------------------------------
+//Patch edges, in the order the LOD index sets walk them
+//-------------------------------------------------------------------------
+enum PatchEdge
+{
+	STITCH_NEG_Z = 1,	///> Edge at z = 0
+	STITCH_POS_X = 2,	///> Edge at x = patchSize
+	STITCH_POS_Z = 4,	///> Edge at z = patchSize
+	STITCH_NEG_X = 8	///> Edge at x = 0
+};
+
+//-------------------------------------------------------------------------
+//Mesh generation
+//-------------------------------------------------------------------------
+namespace TerrainMesh
+{
+	static const unsigned int BAND_CELLS = 7;	///> Cells across a band of LOD indices, two rows of its vertices fit a 16 entry cache
+
+	///Returns the number of triangles in a full resolution patch
+	inline unsigned int GetPatchPrimitiveCount(unsigned int patchSize)
+	{
+		return patchSize * patchSize * 2;
+	}
+
+	///Returns true if a patch of this size can be drawn with 16-bit indices
+	inline bool FitsIndex16(unsigned int patchSize)
+	{
+		return (patchSize + 1) * (patchSize + 1) <= 0x10000;
+	}
+
+	///Converts count samples of one map row, starting at (x,z), to vertices;
+	///mapping is { scale, offset, shade base, shade scale } (GetVertexMapping)
+	typedef void (*VertexRowKernel)(const void *samples, unsigned int sampleSize, unsigned int count,
+									unsigned int x, unsigned int z, const float *mapping, Vertex3D *vertices);
+
+	void BuildVertexRow(const void *samples, unsigned int sampleSize, unsigned int count,
+						unsigned int x, unsigned int z, const float *mapping, Vertex3D *vertices);
+	void BuildVertexRowAVX2(const void *samples, unsigned int sampleSize, unsigned int count,
+							unsigned int x, unsigned int z, const float *mapping, Vertex3D *vertices);
+	bool HasAVX2Kernel();
+	void GetVertexMapping(const HeightField &heightField, float *mapping);
+	void GetPackedHeightMapping(const HeightField &heightField, float &scale, float &offset);
+	VertexRowKernel GetVertexRowKernel();
+	void EnableSIMD(bool enable);
+
+	void BuildPatchVertices(const HeightField &heightField, const TerrainPatch &patch,
+							unsigned int patchSize, Vertex3D *vertices);
+	void BuildVertices(const HeightField &heightField, const TerrainQuadTree &quadTree,
+					   Vertex3D *const *patchVertices);
+
+	unsigned short PackNormal(float nx, float ny, float nz);
+	void UnpackNormal(unsigned short normal, float &nx, float &ny, float &nz);
+
+	///Computes the packed normals (PackNormal) and slopes of count samples
+	///of one map row from central differences; row[-1] and row[count] must
+	///be readable. gradient is { x, z } world height per sample difference
+	///(half the vertical scale, or all of it for one-sided differences).
+	///slopes, which may be NULL, receive the sine of the slope angle * 255.
+	typedef void (*NormalRowKernel)(const void *above, const void *row, const void *below,
+									unsigned int sampleSize, unsigned int count, const float *gradient,
+									unsigned short *normals, unsigned char *slopes);
+
+	void BuildNormalRow(const void *above, const void *row, const void *below, unsigned int sampleSize,
+						unsigned int count, const float *gradient, unsigned short *normals, unsigned char *slopes);
+	void BuildNormalRowAVX2(const void *above, const void *row, const void *below, unsigned int sampleSize,
+							unsigned int count, const float *gradient, unsigned short *normals, unsigned char *slopes);
+	NormalRowKernel GetNormalRowKernel();
+	void BuildNormals(const HeightField &heightField, unsigned short *normals, unsigned char *slopes);
+	void UpdateNormals(const HeightField &heightField, unsigned int x, unsigned int z, unsigned int width,
+					   unsigned int height, unsigned short *normals, unsigned char *slopes);
+
+	void BuildPackedPatchVertices(const HeightField &heightField, const TerrainPatch &patch,
+								  unsigned int patchSize, PackedVertex *vertices,
+								  const unsigned short *normals = NULL);
+	void DecodePatchVertices(const HeightField &heightField, const TerrainPatch &patch,
+							 const PackedVertex *packed, unsigned int count, Vertex3D *vertices);
+
+	///------------------------------------------------------------------------
+	///Writes the index pattern shared by every patch: two triangles per quad,
+	///indices relative to the patch vertex grid. IndexType is unsigned short
+	///for patches of up to 255x255 quads and unsigned int otherwise.
+	///@return	number of indices written
+	///------------------------------------------------------------------------
+	template <typename IndexType>
+	unsigned int BuildPatchIndices(unsigned int patchSize, IndexType *indices)
+	{
+		unsigned int pitch = patchSize + 1;
+		IndexType *start = indices;
+
+		for(unsigned int z = 0; z < patchSize; z++)
+		{
+			for(unsigned int x = 0; x < patchSize; x++)
+			{
+				*indices++ = (IndexType)(x + z * pitch);			//v1
+				*indices++ = (IndexType)(x + 1 + z * pitch);		//v2
+				*indices++ = (IndexType)(x + 1 + (z + 1) * pitch);	//v4
+
+				*indices++ = (IndexType)(x + z * pitch);			//v1
+				*indices++ = (IndexType)(x + 1 + (z + 1) * pitch);	//v4
+				*indices++ = (IndexType)(x + (z + 1) * pitch);		//v3
+			}
+		}
+
+		return (unsigned int)(indices - start);
+	}
+
+	///------------------------------------------------------------------------
+	///Writes the index set of a patch decimated to one geomipmap level.
+	///Vertices are taken every 2^level samples. The interior is a regular
+	///grid and each border is a strip zipped between the border vertices
+	///and the first inner row, so an edge next to a coarser neighbor
+	///(bit set in stitchMask) can skip every other border vertex without
+	///leaving cracks or T-junctions.
+	///The interior goes row by row through bands of BAND_CELLS cells, so a
+	///row only loads the vertices below it and the post-transform cache
+	///hits the row above; from 32 quads per patch that order beats
+	///VertexCache::Optimize (on 16 the optimizer is slightly ahead) and needs
+	///no pass over the indices. constexpr, so the sets can be generated at
+	///compile time (TerrainIndexTable).
+	///@param	patchSize - quads per patch side, a power of two
+	///@param	level - decimation level, step = 1 << level
+	///@param	stitchMask - STITCH_* bits of the edges whose neighbor is one level coarser
+	///@param	indices - receives the indices, NULL to only count them
+	///@return	number of indices
+	///------------------------------------------------------------------------
+	template <typename IndexType>
+	constexpr unsigned int BuildLODIndices(unsigned int patchSize, unsigned int level, unsigned int stitchMask, IndexType *indices)
+	{
+		unsigned int pitch = patchSize + 1;
+		unsigned int step = 1 << level;
+		unsigned int cells = patchSize / step;
+		unsigned int count = 0;
+
+		if(cells < 2)
+		{
+			//coarsest level, two triangles and nothing coarser to stitch to
+			if(indices)
+			{
+				*indices++ = (IndexType)0;
+				*indices++ = (IndexType)patchSize;
+				*indices++ = (IndexType)(patchSize + patchSize * pitch);
+				*indices++ = (IndexType)0;
+				*indices++ = (IndexType)(patchSize + patchSize * pitch);
+				*indices++ = (IndexType)(patchSize * pitch);
+			}
+			return 6;
+		}
+
+		//interior cells, band by band
+		for(unsigned int band = step; band + step < patchSize; band += BAND_CELLS * step)
+		{
+			unsigned int end = band + BAND_CELLS * step;
+			for(unsigned int z = step; z + step < patchSize; z += step)
+			{
+				for(unsigned int x = band; x < end && x + step < patchSize; x += step)
+				{
+					if(indices)
+					{
+						*indices++ = (IndexType)(x + z * pitch);						//v1
+						*indices++ = (IndexType)(x + step + z * pitch);				//v2
+						*indices++ = (IndexType)(x + step + (z + step) * pitch);	//v4
+
+						*indices++ = (IndexType)(x + z * pitch);						//v1
+						*indices++ = (IndexType)(x + step + (z + step) * pitch);	//v4
+						*indices++ = (IndexType)(x + (z + step) * pitch);			//v3
+					}
+					count += 6;
+				}
+			}
+		}
+
+		//border strips, edge e is the bottom edge rotated e quarter turns
+		for(unsigned int e = 0; e < 4; e++)
+		{
+			unsigned int borderStep = (stitchMask & (1 << e)) ? step * 2 : step;
+			unsigned int b = 0;			//position along the border, 0..patchSize
+			unsigned int i = step;		//position along the inner row, step..patchSize-step
+
+			while(b < patchSize || i < patchSize - step)
+			{
+				//advance whichever row has the nearer next vertex
+				bool advanceBorder = (i >= patchSize - step) || (b < patchSize && b + borderStep <= i + step);
+
+				if(indices)
+				{
+					//triangle in edge space (t along the edge, d inwards)
+					unsigned int t[3] = { b, advanceBorder ? b + borderStep : i + step, i };
+					unsigned int d[3] = { 0, advanceBorder ? 0 : step, step };
+
+					for(unsigned int v = 0; v < 3; v++)
+					{
+						unsigned int x = t[v], z = d[v];
+						if(e == 1)		{ x = patchSize - d[v]; z = t[v]; }
+						else if(e == 2)	{ x = patchSize - t[v]; z = patchSize - d[v]; }
+						else if(e == 3)	{ x = d[v]; z = patchSize - t[v]; }
+						*indices++ = (IndexType)(x + z * pitch);
+					}
+				}
+				count += 3;
+
+				if(advanceBorder)
+					b += borderStep;
+				else
+					i += step;
+			}
+		}
+
+		return count;
+	}
+}
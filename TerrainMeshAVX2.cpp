@@ -0,0 +1,190 @@
+///============================================================================
+///@file	TerrainMeshAVX2.cpp
+///@brief	AVX2 vertex and normal row kernels. This file is the only one built with AVX2
+///			code generation, and it deliberately includes no project headers:
+///			inline functions compiled here could otherwise be picked by the
+///			linker for callers running on CPUs without AVX2.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include <stddef.h>
+
+#if defined(__AVX2__) || (defined(_MSC_VER) && _MSC_VER >= 1700 && (defined(_M_X64) || defined(_M_IX86)))
+#define TERRAIN_AVX2
+#include <immintrin.h>
+#endif
+
+class Vertex3D;
+
+namespace TerrainMesh
+{
+	void BuildVertexRow(const void *samples, unsigned int sampleSize, unsigned int count,
+						unsigned int x, unsigned int z, const float *mapping, Vertex3D *vertices);
+	void BuildVertexRowAVX2(const void *samples, unsigned int sampleSize, unsigned int count,
+							unsigned int x, unsigned int z, const float *mapping, Vertex3D *vertices);
+	void BuildNormalRow(const void *above, const void *row, const void *below, unsigned int sampleSize,
+						unsigned int count, const float *gradient, unsigned short *normals, unsigned char *slopes);
+	void BuildNormalRowAVX2(const void *above, const void *row, const void *below, unsigned int sampleSize,
+							unsigned int count, const float *gradient, unsigned short *normals, unsigned char *slopes);
+	bool HasAVX2Kernel();
+}
+
+#ifdef TERRAIN_AVX2
+///----------------------------------------------------------------------------
+///Loads eight samples of any format as floats
+///----------------------------------------------------------------------------
+static inline __m256 LoadSamples(const void *samples, unsigned int sampleSize, ptrdiff_t i)
+{
+	if(sampleSize == 4)
+		return _mm256_loadu_ps((const float*)samples + i);
+	if(sampleSize == 2)
+		return _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)((const unsigned short*)samples + i))));
+	return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)((const unsigned char*)samples + i))));
+}
+
+///----------------------------------------------------------------------------
+///Narrows eight 32-bit lanes holding 0..65535 to 16 bits, in order
+///----------------------------------------------------------------------------
+static inline __m128i Narrow16(__m256i v)
+{
+	return _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packus_epi32(v, v), _MM_SHUFFLE(3, 1, 2, 0)));
+}
+#endif
+
+///----------------------------------------------------------------------------
+///Returns true if this build contains the AVX2 kernel (the CPU still has
+///to be checked with CpuInfo::HasAVX2)
+///----------------------------------------------------------------------------
+bool TerrainMesh::HasAVX2Kernel()
+{
+#ifdef TERRAIN_AVX2
+	return true;
+#else
+	return false;
+#endif
+}
+
+///----------------------------------------------------------------------------
+///AVX2 version of BuildVertexRow: eight samples are widened to float,
+///converted to x/y/z/color lanes and transposed into eight interleaved
+///16 byte vertices. The tail is left to the scalar kernel.
+///----------------------------------------------------------------------------
+void TerrainMesh::BuildVertexRowAVX2(const void *samples, unsigned int sampleSize, unsigned int count,
+									 unsigned int x, unsigned int z, const float *mapping, Vertex3D *vertices)
+{
+	unsigned int i = 0;
+
+#ifdef TERRAIN_AVX2
+	const unsigned char *samples8 = (const unsigned char*)samples;
+	const unsigned short *samples16 = (const unsigned short*)samples;
+	const float *samples32 = (const float*)samples;
+	float *out = (float*)vertices;
+
+	__m256 vx = _mm256_add_ps(_mm256_set1_ps((float)x), _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7));
+	__m256 vz = _mm256_set1_ps((float)z);
+	__m256 vscale = _mm256_set1_ps(mapping[0]);
+	__m256 voffset = _mm256_set1_ps(mapping[1]);
+	__m256 vbase = _mm256_set1_ps(mapping[2]);
+	__m256 vlevels = _mm256_set1_ps(mapping[3]);
+	__m256 zero = _mm256_setzero_ps();
+	__m256 white = _mm256_set1_ps(255.0f);
+	__m256 eight = _mm256_set1_ps(8.0f);
+	__m256i grey = _mm256_set1_epi32(0x010101);
+
+	for(; i + 8 <= count; i += 8)
+	{
+		__m256 s;
+		if(sampleSize == 4)
+			s = _mm256_loadu_ps(samples32 + i);
+		else if(sampleSize == 2)
+			s = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(samples16 + i))));
+		else
+			s = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(samples8 + i))));
+
+		//same operations as the scalar kernel, so both give the same bits
+		__m256 vy = _mm256_add_ps(_mm256_mul_ps(s, vscale), voffset);
+		__m256 level = _mm256_mul_ps(_mm256_sub_ps(s, vbase), vlevels);
+		__m256i shade = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(level, zero), white));
+		__m256 vc = _mm256_castsi256_ps(_mm256_mullo_epi32(shade, grey));
+
+		//4x8 transpose into x,y,z,color records
+		__m256 t0 = _mm256_unpacklo_ps(vx, vy);
+		__m256 t1 = _mm256_unpackhi_ps(vx, vy);
+		__m256 t2 = _mm256_unpacklo_ps(vz, vc);
+		__m256 t3 = _mm256_unpackhi_ps(vz, vc);
+		__m256 u0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+		__m256 u1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+		__m256 u2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+		__m256 u3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+
+		_mm256_storeu_ps(out + i * 4,      _mm256_permute2f128_ps(u0, u1, 0x20));
+		_mm256_storeu_ps(out + i * 4 + 8,  _mm256_permute2f128_ps(u2, u3, 0x20));
+		_mm256_storeu_ps(out + i * 4 + 16, _mm256_permute2f128_ps(u0, u1, 0x31));
+		_mm256_storeu_ps(out + i * 4 + 24, _mm256_permute2f128_ps(u2, u3, 0x31));
+
+		vx = _mm256_add_ps(vx, eight);
+	}
+#endif
+
+	if(i < count)
+	{
+		BuildVertexRow((const unsigned char*)samples + (size_t)i * sampleSize, sampleSize, count - i,
+					   x + i, z, mapping, (Vertex3D*)((float*)vertices + (size_t)i * 4));
+	}
+}
+
+///----------------------------------------------------------------------------
+///AVX2 version of BuildNormalRow: eight samples per step with the same
+///operations in the same order as the scalar reference, so both kernels
+///give the same bits. The tail is left to the scalar kernel.
+///----------------------------------------------------------------------------
+void TerrainMesh::BuildNormalRowAVX2(const void *above, const void *row, const void *below, unsigned int sampleSize,
+									 unsigned int count, const float *gradient, unsigned short *normals, unsigned char *slopes)
+{
+	unsigned int i = 0;
+
+#ifdef TERRAIN_AVX2
+	__m256 gx = _mm256_set1_ps(gradient[0]);
+	__m256 gz = _mm256_set1_ps(gradient[1]);
+	__m256 sign = _mm256_set1_ps(-0.0f);
+	__m256 one = _mm256_set1_ps(1.0f);
+	__m256 half = _mm256_set1_ps(0.5f);
+	__m256 center = _mm256_set1_ps(128.0f);
+	__m256 radius = _mm256_set1_ps(127.5f);
+	__m256 levels = _mm256_set1_ps(255.0f);
+	__m256i top = _mm256_set1_epi32(255);
+
+	for(; i + 8 <= count; i += 8)
+	{
+		__m256 dx = _mm256_mul_ps(_mm256_sub_ps(LoadSamples(row, sampleSize, (ptrdiff_t)i + 1),
+												LoadSamples(row, sampleSize, (ptrdiff_t)i - 1)), gx);
+		__m256 dz = _mm256_mul_ps(_mm256_sub_ps(LoadSamples(below, sampleSize, i),
+												LoadSamples(above, sampleSize, i)), gz);
+
+		//octahedral packing of (-dx, 1, -dz)
+		__m256 sum = _mm256_add_ps(_mm256_add_ps(_mm256_andnot_ps(sign, dx), one), _mm256_andnot_ps(sign, dz));
+		__m256 k = _mm256_div_ps(radius, sum);
+		__m256i u = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(_mm256_xor_ps(dx, sign), k), center));
+		__m256i v = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(_mm256_xor_ps(dz, sign), k), center));
+		__m256i normal = _mm256_or_si256(_mm256_min_epi32(u, top), _mm256_slli_epi32(_mm256_min_epi32(v, top), 8));
+		_mm_storeu_si128((__m128i*)(normals + i), Narrow16(normal));
+
+		if(slopes)
+		{
+			__m256 g2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dz, dz));
+			__m256 sine = _mm256_sqrt_ps(_mm256_div_ps(g2, _mm256_add_ps(g2, one)));
+			__m256i slope = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(sine, levels), half));
+			__m128i slope16 = Narrow16(slope);
+			_mm_storel_epi64((__m128i*)(slopes + i), _mm_packus_epi16(slope16, slope16));
+		}
+	}
+#endif
+
+	if(i < count)
+	{
+		size_t skip = (size_t)i * sampleSize;
+		BuildNormalRow((const unsigned char*)above + skip, (const unsigned char*)row + skip, (const unsigned char*)below + skip,
+					   sampleSize, count - i, gradient, normals + i, slopes ? slopes + i : NULL);
+	}
+}
@@ -0,0 +1,112 @@
+///============================================================================
+///@file	TerrainPack.cpp
+///@brief	Converts a .raw height map (layout as in HeightField::Load) into a
+///			terrain package (TerrainPackage) the tile cache can map.
+///
+///			TerrainPack input.raw output.tpk [--tile-size=quads] [--deflate]
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include "TerrainPackage.h"
+#include "TerrainTileCache.h"
+
+typedef std::chrono::steady_clock PackClock;
+
+///----------------------------------------------------------------------------
+///Returns the seconds since start
+///----------------------------------------------------------------------------
+static double Seconds(PackClock::time_point start)
+{
+	return std::chrono::duration<double>(PackClock::now() - start).count();
+}
+
+///----------------------------------------------------------------------------
+///Entry point
+///----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+	const char *input = NULL, *output = NULL;
+	unsigned int tileSize = TerrainTileCache::DEFAULT_TILE_SIZE;
+	PackageCodec codec = PACKAGE_RAW;
+	bool usage = false;
+
+	for(int i = 1; i < argc; i++)
+	{
+		const char *arg = argv[i];
+		if(!strncmp(arg, "--tile-size=", 12))	tileSize = (unsigned int)strtoul(arg + 12, NULL, 10);
+		else if(!strcmp(arg, "--deflate"))		codec = PACKAGE_DEFLATE;
+		else if(arg[0] == '-')					usage = true;
+		else if(!input)							input = arg;
+		else if(!output)						output = arg;
+		else									usage = true;
+	}
+
+	if(usage || !input || !output || tileSize < 1)
+	{
+		fprintf(stderr, "usage: %s input.raw output.tpk [--tile-size=quads] [--deflate]\n", argv[0]);
+		return 1;
+	}
+
+	if(!TerrainPackage::HasCodec(codec))
+	{
+		fprintf(stderr, "%s: this build has no deflate support (zlib)\n", argv[0]);
+		return 1;
+	}
+
+	PackClock::time_point start = PackClock::now();
+	HeightField heightField;
+	if(!heightField.Load(input))
+	{
+		fprintf(stderr, "%s: cannot load %s\n", argv[0], input);
+		return 1;
+	}
+
+	if(!TerrainPackage::Write(heightField, output, tileSize, codec))
+	{
+		fprintf(stderr, "%s: cannot write %s\n", argv[0], output);
+		return 1;
+	}
+	double writeTime = Seconds(start);
+
+	//read it back as the runtime would
+	start = PackClock::now();
+	TerrainPackage package;
+	if(!package.Open(output))
+	{
+		fprintf(stderr, "%s: %s does not read back\n", argv[0], output);
+		return 1;
+	}
+	double openTime = Seconds(start);
+
+	unsigned long long stored = 0;
+	unsigned int packed = 0;
+	float maxError = 0.0f;
+	for(unsigned int z = 0; z < package.GetTilesZ(); z++)
+	{
+		for(unsigned int x = 0; x < package.GetTilesX(); x++)
+		{
+			const TerrainPackageTile *tile = package.GetTileInfo(x, z);
+			if(!tile)
+			{
+				fprintf(stderr, "%s: tile %u,%u of %s is invalid\n", argv[0], x, z, output);
+				return 1;
+			}
+			stored += tile->storedBytes;
+			packed += (tile->codec != PACKAGE_RAW) ? 1 : 0;
+			maxError = (tile->error > maxError) ? tile->error : maxError;
+		}
+	}
+
+	printf("%s: %ux%u %u-bit, %ux%u tiles of %u quads (%u compressed)\n", output, package.GetWidth(), package.GetHeight(),
+		   (unsigned int)package.GetFormat() * 8, package.GetTilesX(), package.GetTilesZ(), package.GetTileSize(), packed);
+	printf("%.1f MB (payload %.1f MB of %.1f MB samples), largest tile error %.2f, written in %.2f s, opened in %.3f ms\n",
+		   package.GetFileSize() / 1048576.0, stored / 1048576.0, heightField.GetSizeInBytes() / 1048576.0, maxError,
+		   writeTime, openTime * 1e3);
+
+	return 0;
+}
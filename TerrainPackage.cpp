@@ -0,0 +1,433 @@
+///============================================================================
+///@file	TerrainPackage.cpp
+///@brief	Packaged terrain format implementation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "TerrainPackage.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#ifdef TERRAIN_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+///----------------------------------------------------------------------------
+///Moves the file position to a 64-bit offset
+///----------------------------------------------------------------------------
+static bool Seek(FILE *f, unsigned long long offset)
+{
+#ifdef _WIN32
+	return _fseeki64(f, (__int64)offset, SEEK_SET) == 0;
+#else
+	return fseeko(f, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+///----------------------------------------------------------------------------
+///Writes zeros up to the next multiple of alignment
+///@param	position - current file position, advanced past the padding
+///----------------------------------------------------------------------------
+static bool Pad(FILE *f, unsigned long long &position, unsigned int alignment)
+{
+	static const unsigned char zeros[TerrainPackage::PAGE_ALIGNMENT] = { 0 };
+
+	size_t padding = (size_t)((alignment - position % alignment) % alignment);
+	position += padding;
+	return !padding || fwrite(zeros, 1, padding, f) == padding;
+}
+
+///----------------------------------------------------------------------------
+///Default constructor
+///----------------------------------------------------------------------------
+TerrainPackage::TerrainPackage()
+{
+	m_Header = NULL;
+	m_Tiles = NULL;
+}
+
+///----------------------------------------------------------------------------
+///Default destructor
+///----------------------------------------------------------------------------
+TerrainPackage::~TerrainPackage()
+{
+	Close();
+}
+
+///----------------------------------------------------------------------------
+///Maps a package. Only the header is checked, tile entries are checked as
+///they are used, so nothing beyond the first page is read here.
+///@param	filename - name of the .tpk file
+///@return	false if missing, not a package, another version or truncated
+///----------------------------------------------------------------------------
+bool TerrainPackage::Open(const char* filename)
+{
+	Close();
+
+	if(!m_File.Open(filename) || m_File.GetSize() < sizeof(TerrainPackageHeader))
+	{
+		m_File.Close();
+		return false;
+	}
+
+	const TerrainPackageHeader *header = (const TerrainPackageHeader*)m_File.GetData();
+	bool ok = header->magic == TERRAIN_PACKAGE_MAGIC && header->version == TERRAIN_PACKAGE_VERSION &&
+			  header->fileSize == m_File.GetSize() && header->width >= 2 && header->height >= 2 &&
+			  (header->format == HEIGHT_UINT8 || header->format == HEIGHT_UINT16 || header->format == HEIGHT_FLOAT32) && header->tileSize >= 1 &&
+			  header->tilesX == (header->width - 2) / header->tileSize + 1 &&
+			  header->tilesZ == (header->height - 2) / header->tileSize + 1;
+
+	//the tile table has to fit
+	ok = ok && sizeof(TerrainPackageHeader) + (unsigned long long)header->tilesX * header->tilesZ *
+		 sizeof(TerrainPackageTile) <= header->fileSize;
+
+	if(!ok)
+	{
+		m_File.Close();
+		return false;
+	}
+
+	m_Header = header;
+	m_Tiles = (const TerrainPackageTile*)(header + 1);
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Unmaps the package, pointers and wrapped height fields from it go stale
+///----------------------------------------------------------------------------
+void TerrainPackage::Close()
+{
+	m_File.Close();
+	m_Header = NULL;
+	m_Tiles = NULL;
+}
+
+///----------------------------------------------------------------------------
+///Returns true if a package is mapped
+///----------------------------------------------------------------------------
+bool TerrainPackage::IsOpen() const
+{
+	return m_Header != NULL;
+}
+
+///----------------------------------------------------------------------------
+///Returns the number of map samples along x
+///----------------------------------------------------------------------------
+unsigned int TerrainPackage::GetWidth() const
+{
+	return m_Header ? m_Header->width : 0;
+}
+
+///----------------------------------------------------------------------------
+///Returns the number of map samples along z
+///----------------------------------------------------------------------------
+unsigned int TerrainPackage::GetHeight() const
+{
+	return m_Header ? m_Header->height : 0;
+}
+
+///----------------------------------------------------------------------------
+///Returns the sample format
+///----------------------------------------------------------------------------
+HeightFormat TerrainPackage::GetFormat() const
+{
+	return m_Header ? (HeightFormat)m_Header->format : HEIGHT_UINT8;
+}
+
+///----------------------------------------------------------------------------
+///Returns the size, format and height mapping of the packaged map, as
+///HeightField::ReadLayout does for a .raw one
+///----------------------------------------------------------------------------
+void TerrainPackage::GetLayout(HeightLayout &layout) const
+{
+	memset(&layout, 0, sizeof(layout));
+	layout.format = GetFormat();
+	if(!m_Header) return;
+
+	layout.width = m_Header->width;
+	layout.height = m_Header->height;
+	layout.scale = m_Header->verticalScale;
+	layout.offset = m_Header->verticalOffset;
+	layout.low = m_Header->sampleLow;
+	layout.high = m_Header->sampleHigh;
+}
+
+///----------------------------------------------------------------------------
+///Returns the quads per tile side
+///----------------------------------------------------------------------------
+unsigned int TerrainPackage::GetTileSize() const
+{
+	return m_Header ? m_Header->tileSize : 0;
+}
+
+///----------------------------------------------------------------------------
+///Returns the number of tiles along x
+///----------------------------------------------------------------------------
+unsigned int TerrainPackage::GetTilesX() const
+{
+	return m_Header ? m_Header->tilesX : 0;
+}
+
+///----------------------------------------------------------------------------
+///Returns the number of tiles along z
+///----------------------------------------------------------------------------
+unsigned int TerrainPackage::GetTilesZ() const
+{
+	return m_Header ? m_Header->tilesZ : 0;
+}
+
+///----------------------------------------------------------------------------
+///Returns the size of the package in bytes
+///----------------------------------------------------------------------------
+unsigned long long TerrainPackage::GetFileSize() const
+{
+	return m_Header ? m_Header->fileSize : 0;
+}
+
+///----------------------------------------------------------------------------
+///Returns the table entry of a tile
+///@return	NULL if out of range or if the entry points outside the file
+///----------------------------------------------------------------------------
+const TerrainPackageTile* TerrainPackage::GetTileInfo(unsigned int tileX, unsigned int tileZ) const
+{
+	if(!m_Header || tileX >= m_Header->tilesX || tileZ >= m_Header->tilesZ)
+		return NULL;
+
+	const TerrainPackageTile *tile = &m_Tiles[(size_t)tileZ * m_Header->tilesX + tileX];
+	unsigned long long samples = (unsigned long long)tile->width * tile->height * m_Header->format;
+
+	if(tile->width < 2 || tile->height < 2 || tile->width > m_Header->tileSize + 1 || tile->height > m_Header->tileSize + 1 ||
+	   tile->offset > m_Header->fileSize || tile->storedBytes > m_Header->fileSize - tile->offset ||
+	   (tile->codec == PACKAGE_RAW && tile->storedBytes != samples))
+		return NULL;
+
+	return tile;
+}
+
+///----------------------------------------------------------------------------
+///Returns the samples of a raw tile inside the mapping (rows z-major)
+///@return	NULL if the tile is compressed or invalid
+///----------------------------------------------------------------------------
+const void* TerrainPackage::GetTileData(unsigned int tileX, unsigned int tileZ) const
+{
+	const TerrainPackageTile *tile = GetTileInfo(tileX, tileZ);
+	if(!tile || tile->codec != PACKAGE_RAW)
+		return NULL;
+
+	return m_File.GetData() + tile->offset;
+}
+
+///----------------------------------------------------------------------------
+///Gives a height field the samples of a tile: raw tiles are wrapped in
+///place, compressed ones are inflated into it. Safe to call from several
+///threads at once.
+///@param	tileX - tile column
+///@param	tileZ - tile row
+///@param	samples - receives the tile, valid while the package stays open
+///----------------------------------------------------------------------------
+bool TerrainPackage::GetTile(unsigned int tileX, unsigned int tileZ, HeightField &samples) const
+{
+	const TerrainPackageTile *tile = GetTileInfo(tileX, tileZ);
+	if(!tile) return false;
+
+	const unsigned char *payload = m_File.GetData() + tile->offset;
+	HeightFormat format = (HeightFormat)m_Header->format;
+
+	bool ok = false;
+
+	if(tile->codec == PACKAGE_RAW)
+		ok = samples.Wrap(payload, tile->width, tile->height, format);
+
+#ifdef TERRAIN_HAVE_ZLIB
+	if(tile->codec == PACKAGE_DEFLATE && samples.Create(tile->width, tile->height, format))
+	{
+		uLongf bytes = (uLongf)samples.GetSizeInBytes();
+		ok = uncompress((Bytef*)samples.GetWritableData(), &bytes, payload, tile->storedBytes) == Z_OK &&
+			 bytes == samples.GetSizeInBytes();
+		if(!ok) samples.Release();
+	}
+#endif
+
+	if(ok)
+	{
+		samples.SetVerticalScale(m_Header->verticalScale, m_Header->verticalOffset);
+		samples.SetSampleRange(m_Header->sampleLow, m_Header->sampleHigh);
+	}
+
+	return ok;
+}
+
+///----------------------------------------------------------------------------
+///Copies one tile out of a height field and fills its table entry
+///(size, height range and error)
+///@param	heightField - the whole map
+///@param	x0, z0 - first sample of the tile
+///@param	width, height - samples of the tile
+///@param	samples - receives the samples, rows z-major
+///@param	tile - receives the metadata
+///----------------------------------------------------------------------------
+void TerrainPackage::FillTile(const HeightField &heightField, unsigned int x0, unsigned int z0,
+							  unsigned int width, unsigned int height, unsigned char *samples,
+							  TerrainPackageTile &tile)
+{
+	unsigned int sampleSize = heightField.GetSampleSize();
+	size_t rowBytes = (size_t)width * sampleSize;
+	const unsigned char *data = (const unsigned char*)heightField.GetData();
+
+	for(unsigned int z = 0; z < height; z++)
+		memcpy(samples + z * rowBytes, data + ((unsigned long long)(z0 + z) * heightField.GetWidth() + x0) * sampleSize, rowBytes);
+
+	//how far the samples stray from the tile drawn as two triangles over
+	//its corners, what a tile seen from far away can be reduced to
+	float c00 = heightField.GetElevation(x0, z0), c10 = heightField.GetElevation(x0 + width - 1, z0);
+	float c01 = heightField.GetElevation(x0, z0 + height - 1), c11 = heightField.GetElevation(x0 + width - 1, z0 + height - 1);
+	float minHeight = c00, maxHeight = c00;
+	float error = 0.0f;
+
+	for(unsigned int z = 0; z < height; z++)
+	{
+		float v = (float)z / (float)(height - 1);
+		for(unsigned int x = 0; x < width; x++)
+		{
+			float u = (float)x / (float)(width - 1);
+			float plane = (c00 + (c10 - c00) * u) * (1.0f - v) + (c01 + (c11 - c01) * u) * v;
+			float elevation = heightField.GetElevation(x0 + x, z0 + z);
+
+			minHeight = std::min(minHeight, elevation);
+			maxHeight = std::max(maxHeight, elevation);
+			error = std::max(error, fabsf(elevation - plane));
+		}
+	}
+
+	memset(&tile, 0, sizeof(tile));
+	tile.width = width;
+	tile.height = height;
+	tile.minHeight = minHeight;
+	tile.maxHeight = maxHeight;
+	tile.error = error;
+}
+
+///----------------------------------------------------------------------------
+///Writes a height field as a package. Tiles are written one at a time, so
+///memory use does not grow with the map; the header goes last so an
+///interrupted write never looks valid.
+///@param	heightField - the map
+///@param	filename - name of the .tpk file to write
+///@param	tileSize - quads per tile side
+///@param	codec - payload codec, tiles that do not shrink are stored raw
+///----------------------------------------------------------------------------
+bool TerrainPackage::Write(const HeightField &heightField, const char* filename, unsigned int tileSize,
+						   PackageCodec codec)
+{
+	if(!heightField.GetData() || tileSize < 1 || !HasCodec(codec))
+		return false;
+
+	TerrainPackageHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = TERRAIN_PACKAGE_MAGIC;
+	header.version = TERRAIN_PACKAGE_VERSION;
+	header.width = heightField.GetWidth();
+	header.height = heightField.GetHeight();
+	header.format = heightField.GetFormat();
+	header.tileSize = tileSize;
+	header.tilesX = (header.width - 2) / tileSize + 1;
+	header.tilesZ = (header.height - 2) / tileSize + 1;
+	header.alignment = PAGE_ALIGNMENT;
+	header.verticalScale = heightField.GetVerticalScale();
+	header.verticalOffset = heightField.GetVerticalOffset();
+	heightField.GetSampleRange(header.sampleLow, header.sampleHigh);
+
+	FILE *f = fopen(filename, "wb");
+	if(!f) return false;
+
+	//blank header and table, filled in once the payloads are down
+	std::vector<TerrainPackageTile> tiles((size_t)header.tilesX * header.tilesZ);
+	TerrainPackageHeader blank;
+	memset(&blank, 0, sizeof(blank));
+	memset(&tiles[0], 0, tiles.size() * sizeof(TerrainPackageTile));
+	bool ok = fwrite(&blank, sizeof(blank), 1, f) == 1 &&
+			  fwrite(&tiles[0], sizeof(TerrainPackageTile), tiles.size(), f) == tiles.size();
+	unsigned long long position = sizeof(blank) + tiles.size() * sizeof(TerrainPackageTile);
+
+	unsigned int sampleSize = heightField.GetSampleSize();
+	std::vector<unsigned char> samples((size_t)(tileSize + 1) * (tileSize + 1) * sampleSize);
+	std::vector<unsigned char> packed;
+
+	for(unsigned int tz = 0; tz < header.tilesZ && ok; tz++)
+	{
+		for(unsigned int tx = 0; tx < header.tilesX && ok; tx++)
+		{
+			unsigned int x0 = tx * tileSize, z0 = tz * tileSize;
+			unsigned int width = std::min(tileSize + 1, header.width - x0);
+			unsigned int height = std::min(tileSize + 1, header.height - z0);
+			TerrainPackageTile &tile = tiles[(size_t)tz * header.tilesX + tx];
+			FillTile(heightField, x0, z0, width, height, &samples[0], tile);
+
+			const unsigned char *payload = &samples[0];
+			unsigned int bytes = width * height * sampleSize;
+			tile.codec = PACKAGE_RAW;
+			tile.storedBytes = bytes;
+
+#ifdef TERRAIN_HAVE_ZLIB
+			if(codec == PACKAGE_DEFLATE)
+			{
+				uLongf packedBytes = compressBound(bytes);
+				packed.resize(packedBytes);
+				if(compress2(&packed[0], &packedBytes, payload, bytes, Z_DEFAULT_COMPRESSION) == Z_OK && packedBytes < bytes)
+				{
+					payload = &packed[0];
+					tile.codec = PACKAGE_DEFLATE;
+					tile.storedBytes = (unsigned int)packedBytes;
+				}
+			}
+#endif
+
+			ok = Pad(f, position, (tile.codec == PACKAGE_RAW) ? PAGE_ALIGNMENT : PACKED_ALIGNMENT);
+			tile.offset = position;
+			ok = ok && fwrite(payload, 1, tile.storedBytes, f) == tile.storedBytes;
+			position += tile.storedBytes;
+		}
+	}
+
+	header.fileSize = position;
+	ok = ok && Seek(f, sizeof(header)) && fwrite(&tiles[0], sizeof(TerrainPackageTile), tiles.size(), f) == tiles.size();
+	ok = ok && Seek(f, 0) && fwrite(&header, sizeof(header), 1, f) == 1;
+	ok = (fclose(f) == 0) && ok;
+
+	if(!ok)
+		remove(filename);
+
+	return ok;
+}
+
+///----------------------------------------------------------------------------
+///Returns true if a file starts like a package of this version
+///----------------------------------------------------------------------------
+bool TerrainPackage::IsPackage(const char* filename)
+{
+	FILE *f = fopen(filename, "rb");
+	if(!f) return false;
+
+	unsigned int start[2] = { 0, 0 };
+	bool ok = fread(start, sizeof(start), 1, f) == 1;
+	fclose(f);
+
+	return ok && start[0] == TERRAIN_PACKAGE_MAGIC && start[1] == TERRAIN_PACKAGE_VERSION;
+}
+
+///----------------------------------------------------------------------------
+///Returns true if this build can read and write a codec
+///----------------------------------------------------------------------------
+bool TerrainPackage::HasCodec(PackageCodec codec)
+{
+#ifdef TERRAIN_HAVE_ZLIB
+	return codec == PACKAGE_RAW || codec == PACKAGE_DEFLATE;
+#else
+	return codec == PACKAGE_RAW;
+#endif
+}
@@ -0,0 +1,128 @@
+///============================================================================
+///@file	TerrainPackage.h
+///@brief	Packaged terrain ("<map>.tpk"): a header, a table with one entry
+///			per tile (payload offset, size, codec, height range and error)
+///			and the tile payloads, raw ones page aligned. Opening maps the
+///			file and reads the header only, so it takes the same time for
+///			any package size; raw tiles are handed out as pointers into the
+///			mapping and meshed without a copy, compressed ones are inflated.
+///			All values are little endian.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+#include "HeightField.h"
+#include "MappedFile.h"
+
+//-------------------------------------------------------------------------
+//How a tile payload is stored
+//-------------------------------------------------------------------------
+enum PackageCodec
+{
+	PACKAGE_RAW		= 0,	///> Samples as they are, zero-copy
+	PACKAGE_DEFLATE	= 1		///> zlib stream of the samples
+};
+
+//-------------------------------------------------------------------------
+//Package header, followed by the tile table (TerrainPackageTile per tile,
+//row major) and then the payloads
+//-------------------------------------------------------------------------
+struct TerrainPackageHeader
+{
+	unsigned int		magic;			///> TERRAIN_PACKAGE_MAGIC, also detects byte order
+	unsigned int		version;		///> TERRAIN_PACKAGE_VERSION
+	unsigned int		width;			///> Map samples along x
+	unsigned int		height;			///> Map samples along z
+	unsigned int		format;			///> HeightFormat of the samples
+	unsigned int		tileSize;		///> Quads per tile side, tiles share their border samples
+	unsigned int		tilesX;			///> Tiles along x
+	unsigned int		tilesZ;			///> Tiles along z
+	unsigned int		alignment;		///> Alignment of raw payloads in bytes
+	float				verticalScale;	///> Sample to world height factor
+	float				verticalOffset;	///> World height of a zero sample
+	float				sampleLow;		///> Lowest sample value of the map
+	float				sampleHigh;		///> Highest sample value of the map
+	unsigned int		reserved;		///> Zero
+	unsigned long long	fileSize;		///> Size of the whole package, detects truncation
+};
+
+//-------------------------------------------------------------------------
+//Tile table entry
+//-------------------------------------------------------------------------
+struct TerrainPackageTile
+{
+	unsigned long long	offset;			///> Payload position in the file
+	unsigned int		storedBytes;	///> Payload size as stored
+	unsigned int		codec;			///> PackageCodec of the payload
+	unsigned int		width;			///> Samples along x (tileSize + 1 but on the last column)
+	unsigned int		height;			///> Samples along z (tileSize + 1 but on the last row)
+	float				minHeight;		///> Lowest world height of the tile
+	float				maxHeight;		///> Highest world height of the tile
+	float				error;			///> World height error of the tile drawn as its four corners
+	unsigned int		reserved;		///> Zero
+};
+
+class TerrainPackage
+{
+public:
+	//-------------------------------------------------------------------------
+	//Constructors and destructors
+	//-------------------------------------------------------------------------
+	TerrainPackage();
+	~TerrainPackage();
+
+	//-------------------------------------------------------------------------
+	//Public methods
+	//-------------------------------------------------------------------------
+	bool Open(const char* filename);
+	void Close();
+	bool IsOpen() const;
+
+	unsigned int GetWidth() const;
+	unsigned int GetHeight() const;
+	HeightFormat GetFormat() const;
+	void GetLayout(HeightLayout &layout) const;
+	unsigned int GetTileSize() const;
+	unsigned int GetTilesX() const;
+	unsigned int GetTilesZ() const;
+	unsigned long long GetFileSize() const;
+	const TerrainPackageTile* GetTileInfo(unsigned int tileX, unsigned int tileZ) const;
+	const void* GetTileData(unsigned int tileX, unsigned int tileZ) const;
+	bool GetTile(unsigned int tileX, unsigned int tileZ, HeightField &samples) const;
+
+	static bool Write(const HeightField &heightField, const char* filename, unsigned int tileSize,
+					  PackageCodec codec = PACKAGE_RAW);
+	static bool IsPackage(const char* filename);
+	static bool HasCodec(PackageCodec codec);
+
+	//-------------------------------------------------------------------------
+	//Public members
+	//-------------------------------------------------------------------------
+	static const unsigned int TERRAIN_PACKAGE_MAGIC = 0x4B415054;	///> "TPAK"
+	static const unsigned int TERRAIN_PACKAGE_VERSION = 2;
+	static const unsigned int PAGE_ALIGNMENT = 4096;					///> Raw payload alignment
+	static const unsigned int PACKED_ALIGNMENT = 64;					///> Compressed payload alignment
+
+private:
+	//-------------------------------------------------------------------------
+	//Private methods
+	//-------------------------------------------------------------------------
+	static void FillTile(const HeightField &heightField, unsigned int x0, unsigned int z0,
+						 unsigned int width, unsigned int height, unsigned char *samples,
+						 TerrainPackageTile &tile);
+
+	//-------------------------------------------------------------------------
+	//Non copyable
+	//-------------------------------------------------------------------------
+	TerrainPackage(const TerrainPackage&);
+	TerrainPackage& operator=(const TerrainPackage&);
+
+	//-------------------------------------------------------------------------
+	//Private members
+	//-------------------------------------------------------------------------
+	MappedFile						m_File;		///> The mapped package
+	const TerrainPackageHeader*		m_Header;	///> Header at the start of the mapping
+	const TerrainPackageTile*		m_Tiles;	///> Tile table after the header
+};
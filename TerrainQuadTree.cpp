@@ -0,0 +1,299 @@
+///============================================================================
+///@file	TerrainQuadTree.cpp
+///@brief	Terrain patch quadtree implementation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "TerrainQuadTree.h"
+
+///----------------------------------------------------------------------------
+///Default constructor
+///----------------------------------------------------------------------------
+TerrainQuadTree::TerrainQuadTree()
+{
+	m_PatchSize = DEFAULT_PATCH_SIZE;
+	m_PatchCountX = 0;
+	m_PatchCountZ = 0;
+	m_Root = -1;
+}
+
+///----------------------------------------------------------------------------
+///Default destructor
+///----------------------------------------------------------------------------
+TerrainQuadTree::~TerrainQuadTree()
+{
+	Release();
+}
+
+///----------------------------------------------------------------------------
+///Frees all patches and nodes
+///----------------------------------------------------------------------------
+void TerrainQuadTree::Release()
+{
+	m_Patches.clear();
+	m_Nodes.clear();
+	m_PatchCountX = 0;
+	m_PatchCountZ = 0;
+	m_Root = -1;
+}
+
+///----------------------------------------------------------------------------
+///Splits the height field into patches and builds the quadtree over them.
+///Maps that are not a multiple of the patch size get partial patches at the
+///far edges; their out of range vertices are clamped onto the last row or
+///column so they only produce degenerate triangles.
+///@param	heightField - the terrain samples
+///@param	patchSize - quads per patch side
+///@param	patchHeights - precomputed min/max elevation pairs per patch (row
+///			major), NULL to scan the samples
+///----------------------------------------------------------------------------
+bool TerrainQuadTree::Build(const HeightField &heightField, unsigned int patchSize, const float *patchHeights)
+{
+	Release();
+
+	if(patchSize < 1 || heightField.GetWidth() < 2 || heightField.GetHeight() < 2)
+		return false;
+
+	m_PatchSize = patchSize;
+	m_PatchCountX = (heightField.GetWidth() - 2) / patchSize + 1;
+	m_PatchCountZ = (heightField.GetHeight() - 2) / patchSize + 1;
+
+	//create the patches
+	m_Patches.resize(m_PatchCountX * m_PatchCountZ);
+	for(unsigned int pz = 0; pz < m_PatchCountZ; pz++)
+	{
+		for(unsigned int px = 0; px < m_PatchCountX; px++)
+		{
+			TerrainPatch &patch = m_Patches[px + pz * m_PatchCountX];
+			patch.x = px * patchSize;
+			patch.z = pz * patchSize;
+			ComputePatchBounds(heightField, patch, patchHeights ? patchHeights + (px + pz * m_PatchCountX) * 2 : NULL);
+		}
+	}
+
+	//the root spans the smallest power of two number of patches covering the map
+	unsigned int span = 1;
+	while(span < m_PatchCountX || span < m_PatchCountZ)
+		span <<= 1;
+
+	m_Nodes.reserve(m_Patches.size() * 4 / 3 + 1);
+	m_Root = BuildNode(0, 0, span);
+
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Recursively builds the node covering span x span patches from (px,pz)
+///@return	node index, -1 if the area has no patches
+///----------------------------------------------------------------------------
+int TerrainQuadTree::BuildNode(unsigned int px, unsigned int pz, unsigned int span)
+{
+	if(px >= m_PatchCountX || pz >= m_PatchCountZ)
+		return -1;
+
+	int index = (int)m_Nodes.size();
+	m_Nodes.push_back(TerrainQuadTreeNode());
+
+	TerrainQuadTreeNode node;
+	node.px = px;
+	node.pz = pz;
+	node.span = span;
+	node.children[0] = node.children[1] = node.children[2] = node.children[3] = -1;
+	node.patch = -1;
+
+	if(span == 1)
+	{
+		node.patch = (int)(px + pz * m_PatchCountX);
+		node.bounds = m_Patches[node.patch].bounds;
+	}
+	else
+	{
+		unsigned int half = span / 2;
+		bool first = true;
+
+		for(unsigned int i = 0; i < 4; i++)
+		{
+			int child = BuildNode(px + (i & 1) * half, pz + (i >> 1) * half, half);
+			node.children[i] = child;
+			if(child < 0) continue;
+
+			if(first)
+				node.bounds = m_Nodes[child].bounds;
+			else
+				node.bounds.Merge(m_Nodes[child].bounds);
+			first = false;
+		}
+	}
+
+	m_Nodes[index] = node;
+	return index;
+}
+
+///----------------------------------------------------------------------------
+///Recomputes the bounds of the patches in [px0,px1] x [pz0,pz1] from the
+///current samples and refits the nodes above them, the rest of the tree
+///is not visited
+///@param	heightField - the terrain samples, already changed
+///@param	px0, pz0 - first patch column and row
+///@param	px1, pz1 - last patch column and row (inclusive)
+///----------------------------------------------------------------------------
+void TerrainQuadTree::UpdatePatches(const HeightField &heightField, unsigned int px0, unsigned int pz0,
+									unsigned int px1, unsigned int pz1)
+{
+	if(m_Root < 0 || px0 > px1 || pz0 > pz1 || px0 >= m_PatchCountX || pz0 >= m_PatchCountZ)
+		return;
+
+	if(px1 >= m_PatchCountX) px1 = m_PatchCountX - 1;
+	if(pz1 >= m_PatchCountZ) pz1 = m_PatchCountZ - 1;
+
+	for(unsigned int pz = pz0; pz <= pz1; pz++)
+		for(unsigned int px = px0; px <= px1; px++)
+			ComputePatchBounds(heightField, m_Patches[px + pz * m_PatchCountX], NULL);
+
+	RefitNode(m_Root, px0, pz0, px1, pz1);
+}
+
+///----------------------------------------------------------------------------
+///Refits the bounds of a node whose area overlaps the changed patches
+///----------------------------------------------------------------------------
+void TerrainQuadTree::RefitNode(int index, unsigned int px0, unsigned int pz0, unsigned int px1, unsigned int pz1)
+{
+	TerrainQuadTreeNode &node = m_Nodes[index];
+	if(node.px > px1 || node.pz > pz1 || node.px + node.span <= px0 || node.pz + node.span <= pz0)
+		return;
+
+	if(node.patch >= 0)
+	{
+		node.bounds = m_Patches[node.patch].bounds;
+		return;
+	}
+
+	bool first = true;
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		int child = node.children[i];
+		if(child < 0) continue;
+
+		RefitNode(child, px0, pz0, px1, pz1);
+		if(first)
+			node.bounds = m_Nodes[child].bounds;
+		else
+			node.bounds.Merge(m_Nodes[child].bounds);
+		first = false;
+	}
+}
+
+///----------------------------------------------------------------------------
+///Computes the world space bounds of a patch from its height samples, or
+///from a precomputed min/max elevation pair
+///----------------------------------------------------------------------------
+void TerrainQuadTree::ComputePatchBounds(const HeightField &heightField, TerrainPatch &patch, const float *heights) const
+{
+	unsigned int lastX = patch.x + m_PatchSize;
+	unsigned int lastZ = patch.z + m_PatchSize;
+	if(lastX > heightField.GetWidth() - 1) lastX = heightField.GetWidth() - 1;
+	if(lastZ > heightField.GetHeight() - 1) lastZ = heightField.GetHeight() - 1;
+
+	patch.bounds.minX = (float)patch.x;
+	patch.bounds.minZ = (float)patch.z;
+	patch.bounds.maxX = (float)lastX;
+	patch.bounds.maxZ = (float)lastZ;
+
+	if(heights)
+	{
+		patch.bounds.minY = heights[0];
+		patch.bounds.maxY = heights[1];
+		return;
+	}
+
+	float minSample = heightField.GetValue(patch.x, patch.z);
+	float maxSample = minSample;
+	for(unsigned int z = patch.z; z <= lastZ; z++)
+	{
+		for(unsigned int x = patch.x; x <= lastX; x++)
+		{
+			float s = heightField.GetValue(x, z);
+			if(s < minSample) minSample = s;
+			if(s > maxSample) maxSample = s;
+		}
+	}
+
+	//a negative scale flips the ends
+	float a = minSample * heightField.GetVerticalScale() + heightField.GetVerticalOffset();
+	float b = maxSample * heightField.GetVerticalScale() + heightField.GetVerticalOffset();
+	patch.bounds.minY = (a < b) ? a : b;
+	patch.bounds.maxY = (a < b) ? b : a;
+}
+
+///----------------------------------------------------------------------------
+///Returns the number of quads per patch side
+///----------------------------------------------------------------------------
+unsigned int TerrainQuadTree::GetPatchSize() const
+{
+	return m_PatchSize;
+}
+
+///----------------------------------------------------------------------------
+///Returns the number of vertices in one patch
+///----------------------------------------------------------------------------
+unsigned int TerrainQuadTree::GetPatchVertexCount() const
+{
+	return (m_PatchSize + 1) * (m_PatchSize + 1);
+}
+
+///----------------------------------------------------------------------------
+///Returns the number of patches along x
+///----------------------------------------------------------------------------
+unsigned int TerrainQuadTree::GetPatchCountX() const
+{
+	return m_PatchCountX;
+}
+
+///----------------------------------------------------------------------------
+///Returns the number of patches along z
+///----------------------------------------------------------------------------
+unsigned int TerrainQuadTree::GetPatchCountZ() const
+{
+	return m_PatchCountZ;
+}
+
+///----------------------------------------------------------------------------
+///Returns the total number of patches
+///----------------------------------------------------------------------------
+unsigned int TerrainQuadTree::GetPatchCount() const
+{
+	return (unsigned int)m_Patches.size();
+}
+
+///----------------------------------------------------------------------------
+///Returns the i-th patch (row major)
+///----------------------------------------------------------------------------
+const TerrainPatch& TerrainQuadTree::GetPatch(unsigned int i) const
+{
+	return m_Patches[i];
+}
+
+///----------------------------------------------------------------------------
+///Returns the number of quadtree nodes
+///----------------------------------------------------------------------------
+unsigned int TerrainQuadTree::GetNodeCount() const
+{
+	return (unsigned int)m_Nodes.size();
+}
+
+///----------------------------------------------------------------------------
+///Returns the i-th quadtree node
+///----------------------------------------------------------------------------
+const TerrainQuadTreeNode& TerrainQuadTree::GetNode(unsigned int i) const
+{
+	return m_Nodes[i];
+}
+
+///----------------------------------------------------------------------------
+///Returns the root node index, -1 if the tree is empty
+///----------------------------------------------------------------------------
+int TerrainQuadTree::GetRoot() const
+{
+	return m_Root;
+}
@@ -0,0 +1,89 @@
+///============================================================================
+///@file	TerrainQuadTree.h
+///@brief	Splits a height field into fixed size patches organised in a
+///			quadtree. Every patch has the same vertex grid so all of them can
+///			share one index pattern, and each one carries its own bounds so
+///			it can be culled, streamed or LOD'd on its own.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+#include "BoundingBox.h"
+#include "HeightField.h"
+
+//-------------------------------------------------------------------------
+//A square block of PatchSize x PatchSize quads of the height field
+//-------------------------------------------------------------------------
+struct TerrainPatch
+{
+	unsigned int	x;			///> First sample along x
+	unsigned int	z;			///> First sample along z
+	BoundingBox		bounds;		///> World space bounds
+};
+
+//-------------------------------------------------------------------------
+//Quadtree node, leaves reference exactly one patch
+//-------------------------------------------------------------------------
+struct TerrainQuadTreeNode
+{
+	BoundingBox		bounds;		///> Bounds of every patch below this node
+	unsigned int	px;			///> First patch covered along x
+	unsigned int	pz;			///> First patch covered along z
+	unsigned int	span;		///> Patches covered per side (power of two)
+	int				children[4];///> Child nodes (x,z): 0=(lo,lo) 1=(hi,lo) 2=(lo,hi) 3=(hi,hi), -1 if absent
+	int				patch;		///> Patch index for leaves, -1 otherwise
+};
+
+class TerrainQuadTree
+{
+public:
+	//-------------------------------------------------------------------------
+	//Constructors and destructors
+	//-------------------------------------------------------------------------
+	TerrainQuadTree();
+	~TerrainQuadTree();
+
+	//-------------------------------------------------------------------------
+	//Public methods
+	//-------------------------------------------------------------------------
+	bool Build(const HeightField &heightField, unsigned int patchSize = DEFAULT_PATCH_SIZE, const float *patchHeights = NULL);
+	void UpdatePatches(const HeightField &heightField, unsigned int px0, unsigned int pz0, unsigned int px1, unsigned int pz1);
+	void Release();
+
+	unsigned int GetPatchSize() const;
+	unsigned int GetPatchVertexCount() const;
+	unsigned int GetPatchCountX() const;
+	unsigned int GetPatchCountZ() const;
+	unsigned int GetPatchCount() const;
+	const TerrainPatch& GetPatch(unsigned int i) const;
+	unsigned int GetNodeCount() const;
+	const TerrainQuadTreeNode& GetNode(unsigned int i) const;
+	int GetRoot() const;
+
+	//-------------------------------------------------------------------------
+	//Public members
+	//-------------------------------------------------------------------------
+	static const unsigned int DEFAULT_PATCH_SIZE = 64;	///> Quads per patch side (65x65 vertices)
+
+private:
+	//-------------------------------------------------------------------------
+	//Private methods
+	//-------------------------------------------------------------------------
+	int BuildNode(unsigned int px, unsigned int pz, unsigned int span);
+	void RefitNode(int index, unsigned int px0, unsigned int pz0, unsigned int px1, unsigned int pz1);
+	void ComputePatchBounds(const HeightField &heightField, TerrainPatch &patch, const float *heights) const;
+
+	//-------------------------------------------------------------------------
+	//Private members
+	//-------------------------------------------------------------------------
+	unsigned int						m_PatchSize;	///> Quads per patch side
+	unsigned int						m_PatchCountX;	///> Patches along x
+	unsigned int						m_PatchCountZ;	///> Patches along z
+	std::vector<TerrainPatch>			m_Patches;		///> Patches, row major
+	std::vector<TerrainQuadTreeNode>	m_Nodes;		///> Quadtree nodes
+	int									m_Root;			///> Root node index
+};
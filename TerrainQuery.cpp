@@ -0,0 +1,589 @@
+///============================================================================
+///@file	TerrainQuery.cpp
+///@brief	Terrain height, ray and line of sight queries implementation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "TerrainQuery.h"
+#include "Parallel.h"
+
+#include <float.h>
+#include <math.h>
+
+///----------------------------------------------------------------------------
+///Finds the lowest and highest raw sample of [x0,x1] x [z0,z1]
+///----------------------------------------------------------------------------
+template <typename Sample>
+static void SampleRange(const Sample *data, unsigned int pitch, unsigned int x0, unsigned int z0,
+						unsigned int x1, unsigned int z1, float &low, float &high)
+{
+	Sample lo = data[(size_t)z0 * pitch + x0], hi = lo;
+	for(unsigned int z = z0; z <= z1; z++)
+	{
+		const Sample *row = data + (size_t)z * pitch;
+		for(unsigned int x = x0; x <= x1; x++)
+		{
+			if(row[x] < lo) lo = row[x];
+			if(row[x] > hi) hi = row[x];
+		}
+	}
+
+	low = (float)lo;
+	high = (float)hi;
+}
+
+///----------------------------------------------------------------------------
+///Height of a cell at (u,v) in [0,1]^2 from its corners (x,z): 0=(0,0)
+///1=(1,0) 2=(0,1) 3=(1,1). Below the diagonal (u < v) the cell is the
+///triangle (h1,h3,h4), on and above it (h1,h2,h4), as in the index sets.
+///@param	slope - receives the height change along u and v, or NULL
+///----------------------------------------------------------------------------
+static float CellHeight(const float *h, float u, float v, float *slope = NULL)
+{
+	float du, dv;
+	if(u < v)
+	{
+		du = h[3] - h[2];
+		dv = h[2] - h[0];
+	}
+	else
+	{
+		du = h[1] - h[0];
+		dv = h[3] - h[1];
+	}
+
+	if(slope)
+	{
+		slope[0] = du;
+		slope[1] = dv;
+	}
+	return h[0] + u * du + v * dv;
+}
+
+///----------------------------------------------------------------------------
+///Clips [t0,t1] to the part of a ray between two planes of one axis
+///@param	inverse - 1 / direction along the axis, 0 if the ray is parallel
+///@return	false if nothing is left
+///----------------------------------------------------------------------------
+static bool ClipSlab(float origin, float inverse, float low, float high, float &t0, float &t1)
+{
+	if(inverse == 0.0f)
+		return origin >= low && origin <= high;
+
+	float ta = (low - origin) * inverse, tb = (high - origin) * inverse;
+	if(ta > tb)
+	{
+		float swap = ta;
+		ta = tb;
+		tb = swap;
+	}
+	if(ta > t0) t0 = ta;
+	if(tb < t1) t1 = tb;
+	return t0 <= t1;
+}
+
+///----------------------------------------------------------------------------
+///Default constructor
+///----------------------------------------------------------------------------
+TerrainQuery::TerrainQuery()
+{
+	m_HeightField = NULL;
+	m_CellsX = 0;
+	m_CellsZ = 0;
+}
+
+///----------------------------------------------------------------------------
+///Default destructor
+///----------------------------------------------------------------------------
+TerrainQuery::~TerrainQuery()
+{
+}
+
+///----------------------------------------------------------------------------
+///Builds the min/max pyramid: leaf blocks of BLOCK_SIZE^2 cells, then
+///halved per level up to a single root node. Blocks are scanned in rows
+///across threads.
+///@param	heightField - the samples to query, kept by reference
+///@return	false if the map has fewer than 2x2 samples
+///----------------------------------------------------------------------------
+bool TerrainQuery::Build(const HeightField &heightField)
+{
+	Release();
+	if(heightField.GetWidth() < 2 || heightField.GetHeight() < 2 || !heightField.GetData())
+		return false;
+
+	m_HeightField = &heightField;
+	m_CellsX = heightField.GetWidth() - 1;
+	m_CellsZ = heightField.GetHeight() - 1;
+
+	Level level = { (m_CellsX + BLOCK_SIZE - 1) / BLOCK_SIZE, (m_CellsZ + BLOCK_SIZE - 1) / BLOCK_SIZE, 0 };
+	for(;;)
+	{
+		m_Levels.push_back(level);
+		level.offset += (size_t)level.width * level.height * 2;
+		if(level.width == 1 && level.height == 1)
+			break;
+
+		level.width = (level.width + 1) / 2;
+		level.height = (level.height + 1) / 2;
+	}
+	m_Bounds.resize(level.offset);
+
+	ScanBlocks(0, 0, m_Levels[0].width - 1, m_Levels[0].height - 1);
+	for(unsigned int i = 1; i < m_Levels.size(); i++)
+		MergeLevel(i, 0, 0, m_Levels[i].width - 1, m_Levels[i].height - 1);
+
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Refits the pyramid over a rectangle of samples that changed
+///@param	x, z - first changed sample
+///@param	width, height - size of the changed rectangle
+///----------------------------------------------------------------------------
+void TerrainQuery::UpdateRegion(unsigned int x, unsigned int z, unsigned int width, unsigned int height)
+{
+	if(!IsBuilt() || !width || !height || x > m_CellsX || z > m_CellsZ)
+		return;
+
+	//blocks share their border samples with the previous block
+	unsigned int nx0 = (x ? x - 1 : 0) / BLOCK_SIZE, nz0 = (z ? z - 1 : 0) / BLOCK_SIZE;
+	unsigned int nx1 = ((width <= m_CellsX - x) ? x + width - 1 : m_CellsX) / BLOCK_SIZE;
+	unsigned int nz1 = ((height <= m_CellsZ - z) ? z + height - 1 : m_CellsZ) / BLOCK_SIZE;
+	if(nx1 >= m_Levels[0].width) nx1 = m_Levels[0].width - 1;
+	if(nz1 >= m_Levels[0].height) nz1 = m_Levels[0].height - 1;
+
+	ScanBlocks(nx0, nz0, nx1, nz1);
+	for(unsigned int i = 1; i < m_Levels.size(); i++)
+	{
+		nx0 >>= 1;
+		nz0 >>= 1;
+		nx1 >>= 1;
+		nz1 >>= 1;
+		MergeLevel(i, nx0, nz0, nx1, nz1);
+	}
+}
+
+///----------------------------------------------------------------------------
+///Frees the pyramid
+///----------------------------------------------------------------------------
+void TerrainQuery::Release()
+{
+	m_HeightField = NULL;
+	m_CellsX = 0;
+	m_CellsZ = 0;
+	std::vector<Level>().swap(m_Levels);
+	std::vector<float>().swap(m_Bounds);
+}
+
+///----------------------------------------------------------------------------
+///Returns true once Build succeeded
+///----------------------------------------------------------------------------
+bool TerrainQuery::IsBuilt() const
+{
+	return m_HeightField != NULL;
+}
+
+///----------------------------------------------------------------------------
+///Returns the surface height at a point
+///@param	x, z - point in terrain space
+///@param	height - receives the height
+///@param	normal - receives the unit normal there, or NULL
+///@return	false if the point is off the map
+///----------------------------------------------------------------------------
+bool TerrainQuery::GetHeight(float x, float z, float &height, float *normal) const
+{
+	if(!IsBuilt() || !(x >= 0.0f && x <= (float)m_CellsX && z >= 0.0f && z <= (float)m_CellsZ))
+		return false;
+
+	unsigned int cx = (unsigned int)x, cz = (unsigned int)z;
+	if(cx >= m_CellsX) cx = m_CellsX - 1;
+	if(cz >= m_CellsZ) cz = m_CellsZ - 1;
+
+	float h[4] = { m_HeightField->GetElevation(cx, cz), m_HeightField->GetElevation(cx + 1, cz),
+				   m_HeightField->GetElevation(cx, cz + 1), m_HeightField->GetElevation(cx + 1, cz + 1) };
+	float slope[2];
+	height = CellHeight(h, x - (float)cx, z - (float)cz, slope);
+
+	if(normal)
+	{
+		float k = 1.0f / sqrtf(slope[0] * slope[0] + slope[1] * slope[1] + 1.0f);
+		normal[0] = -slope[0] * k;
+		normal[1] = k;
+		normal[2] = -slope[1] * k;
+	}
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Returns the surface height at many points, in parallel for large batches.
+///Points off the map are clamped onto its edge.
+///@param	xz - count (x,z) pairs in terrain space
+///@param	count - number of points
+///@param	heights - receives count heights
+///----------------------------------------------------------------------------
+void TerrainQuery::GetHeights(const float *xz, unsigned int count, float *heights) const
+{
+	if(!IsBuilt())
+		return;
+
+	float lastX = (float)m_CellsX, lastZ = (float)m_CellsZ;
+	Parallel::For(count, 4096, [&](unsigned int begin, unsigned int end, unsigned int)
+	{
+		for(unsigned int i = begin; i < end; i++)
+		{
+			float x = xz[i * 2], z = xz[i * 2 + 1];
+			x = (x > 0.0f) ? (x < lastX ? x : lastX) : 0.0f;
+			z = (z > 0.0f) ? (z < lastZ ? z : lastZ) : 0.0f;
+			GetHeight(x, z, heights[i]);
+		}
+	});
+}
+
+///----------------------------------------------------------------------------
+///Finds the first point of a ray at or below the surface. The terrain is
+///solid: a ray starting under the ground, or entering the map through its
+///side below the surface, hits right there.
+///@param	ray - the ray to cast
+///@param	hit - receives the hit, t is -1 on a miss
+///@return	true if the ray hits the terrain within its length
+///----------------------------------------------------------------------------
+bool TerrainQuery::Raycast(const TerrainRay &ray, TerrainHit &hit) const
+{
+	float t;
+	hit.t = -1.0f;
+	if(!Trace(ray.origin, ray.direction, ray.length, false, t))
+		return false;
+
+	hit.t = t;
+	for(unsigned int i = 0; i < 3; i++)
+		hit.position[i] = ray.origin[i] + ray.direction[i] * t;
+
+	//the hit can land a rounding error off the map
+	float x = hit.position[0], z = hit.position[2], height;
+	x = (x > 0.0f) ? (x < (float)m_CellsX ? x : (float)m_CellsX) : 0.0f;
+	z = (z > 0.0f) ? (z < (float)m_CellsZ ? z : (float)m_CellsZ) : 0.0f;
+	GetHeight(x, z, height, hit.normal);
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Casts a batch of rays across threads
+///@param	rays - the rays to cast
+///@param	count - number of rays
+///@param	hits - receives one hit per ray, t is -1 on a miss
+///@return	number of rays that hit
+///----------------------------------------------------------------------------
+unsigned int TerrainQuery::Raycast(const TerrainRay *rays, unsigned int count, TerrainHit *hits) const
+{
+	Parallel::For(count, 256, [&](unsigned int begin, unsigned int end, unsigned int)
+	{
+		for(unsigned int i = begin; i < end; i++)
+			Raycast(rays[i], hits[i]);
+	});
+
+	unsigned int hitCount = 0;
+	for(unsigned int i = 0; i < count; i++)
+		hitCount += (hits[i].t >= 0.0f) ? 1 : 0;
+	return hitCount;
+}
+
+///----------------------------------------------------------------------------
+///Returns true if nothing of the terrain lies between two points. Points on
+///or under the ground see nothing.
+///@param	from, to - the two points (x,y,z) in terrain space
+///----------------------------------------------------------------------------
+bool TerrainQuery::IsVisible(const float *from, const float *to) const
+{
+	float direction[3] = { to[0] - from[0], to[1] - from[1], to[2] - from[2] };
+	float t;
+	return !Trace(from, direction, 1.0f, true, t);
+}
+
+///----------------------------------------------------------------------------
+///Tests a batch of point pairs for line of sight across threads. The
+///search stops at the first blocking cell found, not the nearest one.
+///@param	from, to - count (x,y,z) points each
+///@param	count - number of pairs
+///@param	visible - receives 1 per pair that see each other, 0 otherwise
+///@return	number of visible pairs
+///----------------------------------------------------------------------------
+unsigned int TerrainQuery::TestLineOfSight(const float *from, const float *to, unsigned int count,
+										   unsigned char *visible) const
+{
+	Parallel::For(count, 256, [&](unsigned int begin, unsigned int end, unsigned int)
+	{
+		for(unsigned int i = begin; i < end; i++)
+			visible[i] = IsVisible(from + i * 3, to + i * 3) ? 1 : 0;
+	});
+
+	unsigned int visibleCount = 0;
+	for(unsigned int i = 0; i < count; i++)
+		visibleCount += visible[i];
+	return visibleCount;
+}
+
+///----------------------------------------------------------------------------
+///Returns the number of pyramid levels, leaf blocks included
+///----------------------------------------------------------------------------
+unsigned int TerrainQuery::GetLevelCount() const
+{
+	return (unsigned int)m_Levels.size();
+}
+
+///----------------------------------------------------------------------------
+///Returns the memory held by the pyramid
+///----------------------------------------------------------------------------
+unsigned long long TerrainQuery::GetSizeInBytes() const
+{
+	return (unsigned long long)m_Bounds.size() * sizeof(float);
+}
+
+///----------------------------------------------------------------------------
+///Recomputes the elevation range of the leaf blocks [bx0,bx1] x [bz0,bz1],
+///rows of blocks in parallel
+///----------------------------------------------------------------------------
+void TerrainQuery::ScanBlocks(unsigned int bx0, unsigned int bz0, unsigned int bx1, unsigned int bz1)
+{
+	const void *data = m_HeightField->GetData();
+	HeightFormat format = m_HeightField->GetFormat();
+	unsigned int pitch = m_CellsX + 1;
+	float scale = m_HeightField->GetVerticalScale(), offset = m_HeightField->GetVerticalOffset();
+	float *bounds = &m_Bounds[m_Levels[0].offset];
+
+	Parallel::For(bz1 - bz0 + 1, 1, [&](unsigned int begin, unsigned int end, unsigned int)
+	{
+		for(unsigned int bz = bz0 + begin; bz < bz0 + end; bz++)
+		{
+			unsigned int z0 = bz * BLOCK_SIZE, z1 = (z0 + BLOCK_SIZE < m_CellsZ) ? z0 + BLOCK_SIZE : m_CellsZ;
+			for(unsigned int bx = bx0; bx <= bx1; bx++)
+			{
+				unsigned int x0 = bx * BLOCK_SIZE, x1 = (x0 + BLOCK_SIZE < m_CellsX) ? x0 + BLOCK_SIZE : m_CellsX;
+				float low, high;
+				if(format == HEIGHT_UINT16)
+					SampleRange((const unsigned short*)data, pitch, x0, z0, x1, z1, low, high);
+				else if(format == HEIGHT_FLOAT32)
+					SampleRange((const float*)data, pitch, x0, z0, x1, z1, low, high);
+				else
+					SampleRange((const unsigned char*)data, pitch, x0, z0, x1, z1, low, high);
+
+				low = low * scale + offset;
+				high = high * scale + offset;
+				float *node = bounds + ((size_t)bz * m_Levels[0].width + bx) * 2;
+				node[0] = (low < high) ? low : high;
+				node[1] = (low < high) ? high : low;
+			}
+		}
+	});
+}
+
+///----------------------------------------------------------------------------
+///Recomputes the nodes [nx0,nx1] x [nz0,nz1] of a level from the level below
+///----------------------------------------------------------------------------
+void TerrainQuery::MergeLevel(unsigned int level, unsigned int nx0, unsigned int nz0, unsigned int nx1, unsigned int nz1)
+{
+	const Level &parent = m_Levels[level], &child = m_Levels[level - 1];
+	const float *children = &m_Bounds[child.offset];
+	float *nodes = &m_Bounds[parent.offset];
+
+	for(unsigned int nz = nz0; nz <= nz1; nz++)
+	{
+		for(unsigned int nx = nx0; nx <= nx1; nx++)
+		{
+			float low = FLT_MAX, high = -FLT_MAX;
+			for(unsigned int j = nz * 2; j <= nz * 2 + 1 && j < child.height; j++)
+			{
+				for(unsigned int i = nx * 2; i <= nx * 2 + 1 && i < child.width; i++)
+				{
+					const float *c = children + ((size_t)j * child.width + i) * 2;
+					if(c[0] < low) low = c[0];
+					if(c[1] > high) high = c[1];
+				}
+			}
+
+			float *node = nodes + ((size_t)nz * parent.width + nx) * 2;
+			node[0] = low;
+			node[1] = high;
+		}
+	}
+}
+
+///----------------------------------------------------------------------------
+///Walks the pyramid near nodes first. Nodes the ray passes above are
+///skipped, a ray entering a node at or below its lowest point hits right
+///there, and the rest are split down to leaf blocks.
+///@param	anyHit - stop at the first hit found rather than the nearest
+///@param	t - receives the ray parameter of the hit
+///@return	true if the ray hits within [0,length]
+///----------------------------------------------------------------------------
+bool TerrainQuery::Trace(const float *origin, const float *direction, float length, bool anyHit, float &t) const
+{
+	if(!IsBuilt() || !(length >= 0.0f))
+		return false;
+
+	struct Node
+	{
+		unsigned int level, x, z;
+	};
+	Node stack[4 * 32];
+	unsigned int depth = 0;
+	Node root = { (unsigned int)m_Levels.size() - 1, 0, 0 };
+	stack[depth++] = root;
+
+	unsigned int nearX = (direction[0] >= 0.0f) ? 0 : 1, nearZ = (direction[2] >= 0.0f) ? 0 : 1;
+	float inverseX = (direction[0] != 0.0f) ? 1.0f / direction[0] : 0.0f;
+	float inverseZ = (direction[2] != 0.0f) ? 1.0f / direction[2] : 0.0f;
+	float best = length;
+	bool found = false;
+
+	while(depth)
+	{
+		Node node = stack[--depth];
+		unsigned int size = BLOCK_SIZE << node.level;
+		unsigned int x0 = node.x * size, z0 = node.z * size;
+		unsigned int x1 = (size < m_CellsX - x0) ? x0 + size : m_CellsX;
+		unsigned int z1 = (size < m_CellsZ - z0) ? z0 + size : m_CellsZ;
+
+		float t0 = 0.0f, t1 = best;
+		if(!ClipSlab(origin[0], inverseX, (float)x0, (float)x1, t0, t1) ||
+		   !ClipSlab(origin[2], inverseZ, (float)z0, (float)z1, t0, t1))
+			continue;
+
+		const Level &level = m_Levels[node.level];
+		const float *bounds = &m_Bounds[level.offset + ((size_t)node.z * level.width + node.x) * 2];
+		float y0 = origin[1] + direction[1] * t0, y1 = origin[1] + direction[1] * t1;
+		if((y0 < y1 ? y0 : y1) > bounds[1])
+			continue;
+
+		float hit = t0;
+		if(y0 <= bounds[0] || (node.level == 0 && TraceBlock(x0, z0, x1, z1, origin, direction, t0, t1, hit)))
+		{
+			best = hit;
+			found = true;
+			if(anyHit)
+				break;
+			continue;
+		}
+		if(node.level == 0)
+			continue;
+
+		//far children first so the near one is popped next
+		const Level &below = m_Levels[node.level - 1];
+		for(unsigned int k = 0; k < 4; k++)
+		{
+			unsigned int i = (k & 1) ? nearX : 1 - nearX, j = (k & 2) ? nearZ : 1 - nearZ;
+			Node child = { node.level - 1, node.x * 2 + i, node.z * 2 + j };
+			if(child.x < below.width && child.z < below.height)
+				stack[depth++] = child;
+		}
+	}
+
+	t = best;
+	return found;
+}
+
+///----------------------------------------------------------------------------
+///Walks the cells of a leaf block along the ray in order (2D DDA)
+///@param	x0, z0, x1, z1 - cells [x0,x1) x [z0,z1) of the block
+///@param	t0, t1 - part of the ray over the block
+///@param	t - receives the ray parameter of the hit
+///@return	true if the ray hits a cell of the block
+///----------------------------------------------------------------------------
+bool TerrainQuery::TraceBlock(unsigned int x0, unsigned int z0, unsigned int x1, unsigned int z1,
+							  const float *origin, const float *direction, float t0, float t1, float &t) const
+{
+	float u = origin[0] + direction[0] * t0, v = origin[2] + direction[2] * t0;
+	unsigned int cx = (u > (float)x0) ? (unsigned int)u : x0, cz = (v > (float)z0) ? (unsigned int)v : z0;
+	if(cx >= x1) cx = x1 - 1;
+	if(cz >= z1) cz = z1 - 1;
+
+	float nextX = FLT_MAX, nextZ = FLT_MAX, deltaX = 0.0f, deltaZ = 0.0f;
+	if(direction[0] != 0.0f)
+	{
+		deltaX = fabsf(1.0f / direction[0]);
+		nextX = ((float)(direction[0] > 0.0f ? cx + 1 : cx) - origin[0]) / direction[0];
+	}
+	if(direction[2] != 0.0f)
+	{
+		deltaZ = fabsf(1.0f / direction[2]);
+		nextZ = ((float)(direction[2] > 0.0f ? cz + 1 : cz) - origin[2]) / direction[2];
+	}
+
+	float ta = t0;
+	for(;;)
+	{
+		float tb = (nextX < nextZ) ? nextX : nextZ;
+		if(tb > t1) tb = t1;
+		if(tb < ta) tb = ta;
+
+		if(TraceCell(cx, cz, origin, direction, ta, tb, t))
+			return true;
+		if(tb >= t1)
+			return false;
+
+		ta = tb;
+		if(nextX <= nextZ)
+		{
+			if(direction[0] > 0.0f ? cx + 1 >= x1 : cx <= x0)
+				return false;
+			cx = (direction[0] > 0.0f) ? cx + 1 : cx - 1;
+			nextX += deltaX;
+		}
+		else
+		{
+			if(direction[2] > 0.0f ? cz + 1 >= z1 : cz <= z0)
+				return false;
+			cz = (direction[2] > 0.0f) ? cz + 1 : cz - 1;
+			nextZ += deltaZ;
+		}
+	}
+}
+
+///----------------------------------------------------------------------------
+///Intersects the ray over [ta,tb] with the two triangles of a cell. The
+///height above the surface is linear along the ray on each side of the
+///diagonal, so a sign change gives the exact crossing.
+///@param	t - receives the ray parameter of the hit
+///@return	true if the ray is at or below the surface somewhere in [ta,tb]
+///----------------------------------------------------------------------------
+bool TerrainQuery::TraceCell(unsigned int cx, unsigned int cz, const float *origin, const float *direction,
+							 float ta, float tb, float &t) const
+{
+	float h[4] = { m_HeightField->GetElevation(cx, cz), m_HeightField->GetElevation(cx + 1, cz),
+				   m_HeightField->GetElevation(cx, cz + 1), m_HeightField->GetElevation(cx + 1, cz + 1) };
+	float u = origin[0] - (float)cx, v = origin[2] - (float)cz;
+
+	float fa = origin[1] + direction[1] * ta - CellHeight(h, u + direction[0] * ta, v + direction[2] * ta);
+	if(fa <= 0.0f)
+	{
+		t = ta;
+		return true;
+	}
+
+	//split at the diagonal crossing, if any
+	float turn = direction[0] - direction[2];
+	if(turn != 0.0f)
+	{
+		float td = (v - u) / turn;
+		if(td > ta && td < tb)
+		{
+			float fd = origin[1] + direction[1] * td - CellHeight(h, u + direction[0] * td, v + direction[2] * td);
+			if(fd <= 0.0f)
+			{
+				t = ta + (td - ta) * fa / (fa - fd);
+				return true;
+			}
+			ta = td;
+			fa = fd;
+		}
+	}
+
+	float fb = origin[1] + direction[1] * tb - CellHeight(h, u + direction[0] * tb, v + direction[2] * tb);
+	if(fb <= 0.0f)
+	{
+		t = ta + (tb - ta) * fa / (fa - fb);
+		return true;
+	}
+	return false;
+}
@@ -0,0 +1,104 @@
+///============================================================================
+///@file	TerrainQuery.h
+///@brief	CPU queries against the terrain surface: height at a point, ray
+///			intersection (picking, collision) and line of sight. The surface
+///			is the rendered one, every cell split along the same diagonal
+///			as the index sets. Rays walk a min/max pyramid over blocks of
+///			cells and only test the cells of leaf blocks they get close to.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+#include "HeightField.h"
+
+//-------------------------------------------------------------------------
+//A ray in terrain space, points are origin + t * direction for t in
+//[0,length]
+//-------------------------------------------------------------------------
+struct TerrainRay
+{
+	float	origin[3];		///> Start point
+	float	direction[3];	///> Direction, need not be normalized
+	float	length;			///> Largest t to test
+};
+
+//-------------------------------------------------------------------------
+//Where a ray meets the surface
+//-------------------------------------------------------------------------
+struct TerrainHit
+{
+	float	t;				///> Ray parameter of the hit, negative if none
+	float	position[3];	///> Hit point
+	float	normal[3];		///> Unit normal of the triangle hit
+};
+
+class TerrainQuery
+{
+public:
+	//-------------------------------------------------------------------------
+	//Constructors and destructors
+	//-------------------------------------------------------------------------
+	TerrainQuery();
+	~TerrainQuery();
+
+	//-------------------------------------------------------------------------
+	//Public methods
+	//-------------------------------------------------------------------------
+	bool Build(const HeightField &heightField);
+	void UpdateRegion(unsigned int x, unsigned int z, unsigned int width, unsigned int height);
+	void Release();
+	bool IsBuilt() const;
+
+	bool GetHeight(float x, float z, float &height, float *normal = NULL) const;
+	void GetHeights(const float *xz, unsigned int count, float *heights) const;
+	bool Raycast(const TerrainRay &ray, TerrainHit &hit) const;
+	unsigned int Raycast(const TerrainRay *rays, unsigned int count, TerrainHit *hits) const;
+	bool IsVisible(const float *from, const float *to) const;
+	unsigned int TestLineOfSight(const float *from, const float *to, unsigned int count, unsigned char *visible) const;
+
+	unsigned int GetLevelCount() const;
+	unsigned long long GetSizeInBytes() const;
+
+	//-------------------------------------------------------------------------
+	//Public members
+	//-------------------------------------------------------------------------
+	static const unsigned int BLOCK_SIZE = 8;	///> Cells per side of a leaf block
+
+private:
+	//-------------------------------------------------------------------------
+	//Private methods
+	//-------------------------------------------------------------------------
+	void ScanBlocks(unsigned int bx0, unsigned int bz0, unsigned int bx1, unsigned int bz1);
+	void MergeLevel(unsigned int level, unsigned int nx0, unsigned int nz0, unsigned int nx1, unsigned int nz1);
+	bool Trace(const float *origin, const float *direction, float length, bool anyHit, float &t) const;
+	bool TraceBlock(unsigned int x0, unsigned int z0, unsigned int x1, unsigned int z1,
+					const float *origin, const float *direction, float t0, float t1, float &t) const;
+	bool TraceCell(unsigned int cx, unsigned int cz, const float *origin, const float *direction,
+				   float ta, float tb, float &t) const;
+
+	//-------------------------------------------------------------------------
+	//Non copyable
+	//-------------------------------------------------------------------------
+	TerrainQuery(const TerrainQuery&);
+	TerrainQuery& operator=(const TerrainQuery&);
+
+	//-------------------------------------------------------------------------
+	//Private members
+	//-------------------------------------------------------------------------
+	struct Level
+	{
+		unsigned int	width;		///> Nodes along x
+		unsigned int	height;		///> Nodes along z
+		size_t			offset;		///> First node in m_Bounds
+	};
+
+	const HeightField*			m_HeightField;	///> Samples being queried
+	unsigned int				m_CellsX;		///> Cells along x (samples - 1)
+	unsigned int				m_CellsZ;		///> Cells along z
+	std::vector<Level>			m_Levels;		///> Pyramid levels, 0 = leaf blocks
+	std::vector<float>			m_Bounds;		///> Min and max elevation per node
+};
@@ -0,0 +1,181 @@
+///============================================================================
+///@file	TerrainRender.cpp
+///@brief	Renders a height map headless with the software rasterizer and
+///			writes the frame as PNG or PPM, optionally checking it against
+///			a reference image (exit code 2 when it differs). The default
+///			camera is the viewer's start view. --trace prints the profiled
+///			zones and writes every frame of them as Chrome trace JSON.
+///
+///			TerrainRender map.raw out.png [--size=WxH] [--frames=n]
+///						  [--wireframe] [--unlit] [--threads=n]
+///						  [--eye=x,y,z] [--target=x,y,z]
+///						  [--compare=reference.png] [--tolerance=n]
+///						  [--max-diff=pixels] [--trace=trace.json]
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "ImageFile.h"
+#include "Parallel.h"
+#include "Profiler.h"
+#include "SoftwareBackend.h"
+#include "TerrainBuffers.h"
+
+typedef std::chrono::steady_clock RenderClock;
+
+///----------------------------------------------------------------------------
+///Parses "x,y,z" into three floats
+///----------------------------------------------------------------------------
+static bool ParseVector(const char *text, float *v)
+{
+	return sscanf(text, "%f,%f,%f", &v[0], &v[1], &v[2]) == 3;
+}
+
+///----------------------------------------------------------------------------
+///Entry point
+///----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+	const char *input = NULL, *output = NULL, *reference = NULL, *trace = NULL;
+	unsigned int width = 800, height = 600, frames = 1, tolerance = 0, maxDiff = 0;
+	float eye[3] = { 32.0f, 50.0f, 90.0f }, target[3] = { 32.0f, 0.0f, 0.0f };
+	bool wireframe = false, lit = true, usage = false;
+
+	for(int i = 1; i < argc; i++)
+	{
+		const char *arg = argv[i];
+		if(!strncmp(arg, "--size=", 7))				usage |= sscanf(arg + 7, "%ux%u", &width, &height) != 2;
+		else if(!strncmp(arg, "--frames=", 9))		frames = (unsigned int)strtoul(arg + 9, NULL, 10);
+		else if(!strcmp(arg, "--wireframe"))		wireframe = true;
+		else if(!strcmp(arg, "--unlit"))			lit = false;
+		else if(!strncmp(arg, "--threads=", 10))	Parallel::SetThreadCount((unsigned int)strtoul(arg + 10, NULL, 10));
+		else if(!strncmp(arg, "--eye=", 6))			usage |= !ParseVector(arg + 6, eye);
+		else if(!strncmp(arg, "--target=", 9))		usage |= !ParseVector(arg + 9, target);
+		else if(!strncmp(arg, "--compare=", 10))	reference = arg + 10;
+		else if(!strncmp(arg, "--tolerance=", 12))	tolerance = (unsigned int)strtoul(arg + 12, NULL, 10);
+		else if(!strncmp(arg, "--max-diff=", 11))	maxDiff = (unsigned int)strtoul(arg + 11, NULL, 10);
+		else if(!strncmp(arg, "--trace=", 8))		trace = arg + 8;
+		else if(arg[0] == '-')						usage = true;
+		else if(!input)								input = arg;
+		else if(!output)							output = arg;
+		else										usage = true;
+	}
+
+	if(usage || !input || !output || !width || !height || !frames)
+	{
+		fprintf(stderr, "usage: %s map.raw out.png [--size=WxH] [--frames=n] [--wireframe] [--unlit] [--threads=n]\n"
+						"       [--eye=x,y,z] [--target=x,y,z] [--compare=reference.png] [--tolerance=n] [--max-diff=pixels]\n"
+						"       [--trace=trace.json]\n",
+				argv[0]);
+		return 1;
+	}
+
+	Terrain terrain;
+	if(!terrain.Load(input))
+	{
+		fprintf(stderr, "%s: cannot load %s\n", argv[0], input);
+		return 1;
+	}
+
+	float view[16], proj[16];
+	if(!Frustum::LookAtLH(eye, target, view))
+	{
+		fprintf(stderr, "%s: the eye must not be the target or straight above it\n", argv[0]);
+		return 1;
+	}
+	Frustum::PerspectiveFovLH(3.14159265f / 4.0f, (float)width / (float)height, 1.0f, 1000.0f, proj);
+
+	Frustum frustum;
+	frustum.Extract(view, proj);
+	terrain.Update(frustum, eye, (float)height * proj[5] * 0.5f);
+
+	//the same buffers and draws as the viewer, through the software backend
+	SoftwareBackend backend;
+	TerrainBuffers buffers;
+	if(!backend.Create(width, height) || !buffers.Create(backend, terrain))
+	{
+		fprintf(stderr, "%s: cannot create a %ux%u frame\n", argv[0], width, height);
+		return 1;
+	}
+
+	static const float world[16] = { 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1 };
+	static const float sun[3] = { 0.4f, -1.0f, 0.3f };
+	SoftwareRenderer &renderer = backend.GetRenderer();
+	backend.SetFillMode(wireframe ? FILL_WIREFRAME : FILL_SOLID);
+	backend.SetTransform(TRANSFORM_WORLD, world);
+	backend.SetTransform(TRANSFORM_VIEW, view);
+	backend.SetTransform(TRANSFORM_PROJECTION, proj);
+	renderer.SetLight(lit && !wireframe ? sun : NULL);
+
+	//starts the first profiled frame
+	Profiler::EndFrame();
+
+	double total = 0.0, best = 0.0;
+	for(unsigned int f = 0; f < frames; f++)
+	{
+		RenderClock::time_point start = RenderClock::now();
+		backend.BeginFrame(0xFF2D32AA);
+		buffers.Draw(terrain);
+		backend.EndFrame();
+		Profiler::EndFrame();
+
+		double elapsed = std::chrono::duration<double>(RenderClock::now() - start).count();
+		total += elapsed;
+		best = (f == 0 || elapsed < best) ? elapsed : best;
+	}
+
+	if(!ImageFile::Write(output, renderer.GetPixels(), width, height))
+	{
+		fprintf(stderr, "%s: cannot write %s\n", argv[0], output);
+		return 1;
+	}
+
+	unsigned int triangles = renderer.GetTriangleCount();
+	printf("%s: %ux%u %s, %u patches, %u triangles, %.3f ms/frame (best %.3f) on %u threads, %.1f M triangles/s\n",
+		   output, width, height, wireframe ? "wireframe" : "solid", (unsigned int)terrain.GetVisiblePatches().size(), triangles,
+		   total / frames * 1e3, best * 1e3, Parallel::GetThreadCount(), best > 0.0 ? triangles / best * 1e-6 : 0.0);
+
+	if(trace)
+	{
+		for(unsigned int zone = 0; zone < Profiler::GetZoneCount(); zone++)
+		{
+			ProfileZoneStats stats;
+			if(Profiler::GetZoneStats(zone, stats) && stats.count)
+				printf("  %-14s %8llu x  p50 %10.1f  p95 %10.1f  p99 %10.1f  max %10.1f us\n", stats.name, stats.count,
+					   stats.p50 * 1e-3, stats.p95 * 1e-3, stats.p99 * 1e-3, stats.max * 1e-3);
+		}
+
+		if(!Profiler::WriteChromeTrace(trace))
+		{
+			fprintf(stderr, "%s: cannot write %s\n", argv[0], trace);
+			return 1;
+		}
+	}
+
+	if(!reference)
+		return 0;
+
+	std::vector<unsigned int> expected;
+	unsigned int expectedWidth = 0, expectedHeight = 0;
+	if(!ImageFile::Read(reference, expected, expectedWidth, expectedHeight))
+	{
+		fprintf(stderr, "%s: cannot read %s\n", argv[0], reference);
+		return 1;
+	}
+	if(expectedWidth != width || expectedHeight != height)
+	{
+		fprintf(stderr, "%s: %s is %ux%u, the frame is %ux%u\n", argv[0], reference, expectedWidth, expectedHeight, width, height);
+		return 2;
+	}
+
+	unsigned int largest = 0;
+	unsigned int differing = ImageFile::Compare(renderer.GetPixels(), &expected[0], width * height, tolerance, &largest);
+	printf("%s: %u pixels differ by more than %u (largest difference %u)\n", reference, differing, tolerance, largest);
+	return differing > maxDiff ? 2 : 0;
+}
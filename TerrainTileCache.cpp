@@ -0,0 +1,943 @@
+///============================================================================
+///@file	TerrainTileCache.cpp
+///@brief	Out-of-core height map tile cache implementation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "TerrainTileCache.h"
+#include "Profiler.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+const float TerrainTileCache::DEFAULT_FRAME_BUDGET = 2.0f;
+const float TerrainTileCache::DEFAULT_PREFETCH_TIME = 2.0f;
+
+typedef std::chrono::steady_clock TileClock;
+
+///----------------------------------------------------------------------------
+///Moves the file position to a 64-bit offset
+///----------------------------------------------------------------------------
+static bool Seek(FILE *f, unsigned long long offset)
+{
+#ifdef _WIN32
+	return _fseeki64(f, (__int64)offset, SEEK_SET) == 0;
+#else
+	return fseeko(f, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+///----------------------------------------------------------------------------
+///Returns the squared distance from a point to a tile's rectangle
+///@param	x, z - tile column and row
+///@param	size - tile side
+///@param	px, pz - the point
+///----------------------------------------------------------------------------
+static float TileDistance(int x, int z, float size, float px, float pz)
+{
+	float dx = std::max(std::max((float)x * size - px, px - (float)(x + 1) * size), 0.0f);
+	float dz = std::max(std::max((float)z * size - pz, pz - (float)(z + 1) * size), 0.0f);
+	return dx * dx + dz * dz;
+}
+
+//-------------------------------------------------------------------------
+//Tile key and the time the camera reaches it, gathered by Prefetch
+//-------------------------------------------------------------------------
+typedef std::pair<unsigned int, float> TileArrival;
+
+///----------------------------------------------------------------------------
+///Returns true if two arrivals are at the same tile
+///----------------------------------------------------------------------------
+static bool SameTile(const TileArrival &a, const TileArrival &b)
+{
+	return a.first == b.first;
+}
+
+///----------------------------------------------------------------------------
+///Orders arrivals soonest first, by tile key at equal times
+///----------------------------------------------------------------------------
+static bool ArrivesSooner(const TileArrival &a, const TileArrival &b)
+{
+	return a.second < b.second || (a.second == b.second && a.first < b.first);
+}
+
+///----------------------------------------------------------------------------
+///Finds the sample range of a float .raw map in one pass over the file, so
+///every tile is shaded over the range of the whole map
+///@param	filename - name of the .raw file
+///@param	layout - its layout, receives low and high
+///@return	false if the file holds fewer samples than the layout says
+///----------------------------------------------------------------------------
+static bool ScanFloatRange(const char *filename, HeightLayout &layout)
+{
+	FILE *f = fopen(filename, "rb");
+	if(!f) return false;
+
+	const size_t BLOCK = 16384;
+	std::vector<float> block(BLOCK);
+	unsigned long long left = (unsigned long long)layout.width * layout.height;
+	float low = 0.0f, high = 0.0f;
+	bool first = true;
+
+	while(left)
+	{
+		size_t count = (size_t)std::min(left, (unsigned long long)BLOCK);
+		if(fread(&block[0], sizeof(float), count, f) != count)
+			break;
+
+		for(size_t i = 0; i < count; i++)
+		{
+			float value = block[i];
+			if(layout.bigEndian)
+				std::reverse((unsigned char*)&value, (unsigned char*)&value + sizeof(float));
+			low = (first || value < low) ? value : low;
+			high = (first || value > high) ? value : high;
+			first = false;
+		}
+		left -= count;
+	}
+
+	fclose(f);
+	layout.low = low;
+	layout.high = high;
+	return left == 0;
+}
+
+///----------------------------------------------------------------------------
+///Default constructor
+///----------------------------------------------------------------------------
+TerrainTileCache::TerrainTileCache() :
+	m_Arrived(MAX_PENDING_TILES),
+	m_Tiles(0, std::hash<unsigned int>(), std::equal_to<unsigned int>(), PoolAllocator<TileEntry>(&m_Nodes))
+{
+	memset(&m_Layout, 0, sizeof(m_Layout));
+	m_Layout.format = HEIGHT_UINT8;
+	m_TileSize = 0;
+	m_PatchSize = 0;
+	m_TilesX = 0;
+	m_TilesZ = 0;
+	m_Budget = DEFAULT_BUDGET;
+	m_TileBytes = 0;
+	m_PrefetchTime = DEFAULT_PREFETCH_TIME;
+	m_Frame = 0;
+	m_LastFrame = 0;
+	m_Jobs = NULL;
+	m_Head = NULL;
+	m_Tail = NULL;
+	m_Spare = NULL;
+	memset(&m_Stats, 0, sizeof(m_Stats));
+	SetFrameBudget(DEFAULT_FRAME_BUDGET);
+}
+
+///----------------------------------------------------------------------------
+///Default destructor
+///----------------------------------------------------------------------------
+TerrainTileCache::~TerrainTileCache()
+{
+	Close();
+}
+
+///----------------------------------------------------------------------------
+///Opens a .raw map or a package for paging, no sample is read until a tile
+///is asked for
+///@param	filename - name of the map (layout as in HeightField::Load) or
+///			of a TerrainPackage
+///@param	tileSize - quads per tile side, packages keep their own
+///@param	patchSize - quads per patch side of the tile terrains
+///----------------------------------------------------------------------------
+bool TerrainTileCache::Open(const char* filename, unsigned int tileSize, unsigned int patchSize)
+{
+	Close();
+
+	if(tileSize < 1 || patchSize < 1)
+		return false;
+
+	if(TerrainPackage::IsPackage(filename))
+	{
+		if(!m_Package.Open(filename))
+			return false;
+
+		m_Package.GetLayout(m_Layout);
+		tileSize = m_Package.GetTileSize();
+	}
+	else if(!HeightField::ReadLayout(filename, 0, m_Layout))
+		return false;
+
+	//a float map without a .hdr range is scanned once here, tiles scanning
+	//their own samples would each be shaded differently
+	if(m_Layout.format == HEIGHT_FLOAT32 && !(m_Layout.low < m_Layout.high) && !m_Package.IsOpen() &&
+	   !ScanFloatRange(filename, m_Layout))
+		return false;
+
+	m_FileName = filename;
+	m_TileSize = tileSize;
+	m_PatchSize = patchSize;
+	m_TilesX = (m_Layout.width - 1 + tileSize - 1) / tileSize;
+	m_TilesZ = (m_Layout.height - 1 + tileSize - 1) / tileSize;
+
+	//samples plus the vertices of its patches
+	unsigned long long patches = (tileSize + patchSize - 1) / patchSize;
+	m_TileBytes = (unsigned long long)(tileSize + 1) * (tileSize + 1) * (unsigned int)m_Layout.format +
+				  patches * patches * (patchSize + 1) * (patchSize + 1) * sizeof(Vertex3D);
+
+	//room for the tiles the budget holds plus those in flight, so the lookup
+	//only grows (once) if the budget is raised later
+	unsigned long long tiles = std::min(m_Budget / m_TileBytes + 1 + MAX_PENDING_TILES, (unsigned long long)m_TilesX * m_TilesZ);
+	m_Tiles.reserve((size_t)tiles);
+	ResetStats();
+
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Waits for the background loads, then drops every tile, spare ones too
+///----------------------------------------------------------------------------
+void TerrainTileCache::Close()
+{
+	while(m_Stats.pendingTiles)
+	{
+		if(!Drain(false))
+			std::this_thread::yield();
+	}
+
+	while(m_Head)
+	{
+		Tile *tile = m_Head;
+		m_Head = tile->next;
+		delete tile;
+	}
+	m_Tail = NULL;
+	m_Tiles.clear();
+
+	while(m_Spare)
+	{
+		Tile *tile = m_Spare;
+		m_Spare = tile->next;
+		delete tile;
+	}
+	m_Stats.spareTiles = 0;
+
+	m_Package.Close();
+	m_FileName.clear();
+	m_TilesX = 0;
+	m_TilesZ = 0;
+	m_Stats.residentBytes = 0;
+	m_Stats.residentTiles = 0;
+}
+
+///----------------------------------------------------------------------------
+///Returns true if a map is open
+///----------------------------------------------------------------------------
+bool TerrainTileCache::IsOpen() const
+{
+	return !m_FileName.empty();
+}
+
+///----------------------------------------------------------------------------
+///Brings in the tiles within radius of the camera, nearest first, as many
+///as the budget holds. Tiles asked for in this call are never evicted by
+///it.
+///With a job system, missing tiles are queued for the workers and tiles
+///they finished are linked in until the frame budget runs out; nothing
+///waits for the disk. Without one, missing tiles are loaded in place.
+///Given the camera velocity, budget and load slots left over go to tiles
+///along the predicted path (job system only).
+///@param	eye - camera position in terrain space
+///@param	radius - distance at which tiles are needed
+///@param	velocity - camera velocity in terrain units per second, or NULL
+///@return	number of tiles in range that are resident
+///----------------------------------------------------------------------------
+unsigned int TerrainTileCache::Update(const float *eye, float radius, const float *velocity)
+{
+	if(m_FileName.empty()) return 0;
+
+	//tiles stamped with this frame are pinned until the next Update
+	m_FrameStart = TileClock::now();
+	m_Frame = ++m_LastFrame;
+	if(!m_Frame) m_Frame = ++m_LastFrame;
+
+	//tile range bounding the circle
+	float size = (float)m_TileSize;
+	int x0 = (int)floor((eye[0] - radius) / size), x1 = (int)floor((eye[0] + radius) / size);
+	int z0 = (int)floor((eye[2] - radius) / size), z1 = (int)floor((eye[2] + radius) / size);
+	x0 = std::max(x0, 0);
+	z0 = std::max(z0, 0);
+	x1 = std::min(x1, (int)m_TilesX - 1);
+	z1 = std::min(z1, (int)m_TilesZ - 1);
+
+	//the lists of this Update live in the arena until the next one
+	m_Scratch.Reset();
+	size_t range = (x1 >= x0 && z1 >= z0) ? (size_t)(x1 - x0 + 1) * (z1 - z0 + 1) : 0;
+	std::pair<float, unsigned int> *inRange = m_Scratch.AllocateArray<std::pair<float, unsigned int> >(range);
+	if(!inRange && range)
+	{
+		//out of arena memory, the heap list still serves this frame
+		m_InRange.resize(range);
+		inRange = &m_InRange[0];
+	}
+	size_t count = 0;
+
+	for(int z = z0; z <= z1; z++)
+	{
+		for(int x = x0; x <= x1; x++)
+		{
+			float distance = TileDistance(x, z, size, eye[0], eye[2]);
+			if(distance <= radius * radius)
+				inRange[count++] = std::make_pair(distance, (unsigned int)z * m_TilesX + x);
+		}
+	}
+	std::sort(inRange, inRange + count);
+
+	//farther tiles than the budget holds would only evict nearer ones
+	size_t capacity = (size_t)std::max(m_Budget / m_TileBytes, 1ULL);
+	size_t wanted = std::min(count, capacity);
+	m_Stats.skipped += count - wanted;
+
+	//pin the resident tiles in range before anything is linked in, so the
+	//tiles arriving below or loaded in place evict others first
+	for(size_t i = 0; i < wanted; i++)
+	{
+		TileMap::iterator found = m_Tiles.find(inRange[i].second);
+		if(found != m_Tiles.end() && found->second->ready)
+			Touch(found->second);
+	}
+
+	Drain(true);
+
+	unsigned int resident = 0;
+	for(size_t i = 0; i < wanted; i++)
+	{
+		unsigned int key = inRange[i].second;
+		if(!m_Jobs)
+		{
+			if(GetTile(key % m_TilesX, key / m_TilesX))
+				resident++;
+			continue;
+		}
+
+		m_Stats.requests++;
+		TileMap::iterator found = m_Tiles.find(key);
+		if(found == m_Tiles.end())
+		{
+			//nearest tiles were queued first, the rest wait for a free slot
+			if(m_Stats.pendingTiles < MAX_PENDING_TILES)
+			{
+				Tile *tile = CreateTile(key % m_TilesX, key / m_TilesX);
+				m_Tiles[key] = tile;
+				m_Stats.pendingTiles++;
+				m_Jobs->Submit(LoadJob, tile);
+			}
+			continue;
+		}
+
+		Claim(found->second);
+		if(found->second->ready)
+		{
+			m_Stats.hits++;
+			Touch(found->second);
+			resident++;
+		}
+	}
+
+	if(m_Jobs && velocity && m_PrefetchTime > 0.0f)
+		Prefetch(eye, velocity, radius, capacity - wanted);
+
+	m_Frame = 0;
+
+	unsigned long long elapsed = (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		TileClock::now() - m_FrameStart).count();
+	m_Stats.maxUpdateNanoseconds = std::max(m_Stats.maxUpdateNanoseconds, elapsed);
+	if(elapsed > (unsigned long long)m_FrameBudget.count())
+		m_Stats.overBudgetFrames++;
+
+	return resident;
+}
+
+///----------------------------------------------------------------------------
+///Returns true while the frame budget of the last Update is not used up,
+///so the caller can spread its own per tile work (uploads) over frames
+///----------------------------------------------------------------------------
+bool TerrainTileCache::HasFrameTime() const
+{
+	return TileClock::now() - m_FrameStart < m_FrameBudget;
+}
+
+///----------------------------------------------------------------------------
+///Returns a tile, waiting for it if it is not resident (loading it in place,
+///or for its background load to finish)
+///@param	tileX - tile column
+///@param	tileZ - tile row
+///@return	the tile, or NULL if out of range or unreadable
+///----------------------------------------------------------------------------
+TerrainTile* TerrainTileCache::GetTile(unsigned int tileX, unsigned int tileZ)
+{
+	if(tileX >= m_TilesX || tileZ >= m_TilesZ)
+		return NULL;
+
+	unsigned int key = tileZ * m_TilesX + tileX;
+	m_Stats.requests++;
+
+	TileMap::iterator found = m_Tiles.find(key);
+	if(found != m_Tiles.end())
+		Claim(found->second);
+	if(found != m_Tiles.end() && found->second->ready)
+	{
+		m_Stats.hits++;
+		Touch(found->second);
+		return &found->second->tile;
+	}
+
+	//the caller needs it now, so it waits
+	TileClock::time_point start = TileClock::now();
+	Tile *tile = NULL;
+
+	if(found != m_Tiles.end())
+	{
+		for(;;)
+		{
+			Drain(false);
+			found = m_Tiles.find(key);
+			if(found == m_Tiles.end() || found->second->ready)
+				break;
+			std::this_thread::yield();
+		}
+
+		if(found != m_Tiles.end())
+		{
+			tile = found->second;
+			Touch(tile);
+		}
+	}
+	else
+	{
+		tile = CreateTile(tileX, tileZ);
+		if(LoadTile(tile))
+		{
+			m_Tiles[key] = tile;
+			Insert(tile);
+		}
+		else
+		{
+			RecycleTile(tile);
+			tile = NULL;
+		}
+	}
+
+	m_Stats.stalls++;
+	m_Stats.stallNanoseconds += (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		TileClock::now() - start).count();
+
+	return tile ? &tile->tile : NULL;
+}
+
+///----------------------------------------------------------------------------
+///Returns a tile if it is resident, without loading it or counting a request
+///----------------------------------------------------------------------------
+TerrainTile* TerrainTileCache::FindTile(unsigned int tileX, unsigned int tileZ)
+{
+	if(tileX >= m_TilesX || tileZ >= m_TilesZ)
+		return NULL;
+
+	TileMap::iterator found = m_Tiles.find(tileZ * m_TilesX + tileX);
+	return (found != m_Tiles.end() && found->second->ready) ? &found->second->tile : NULL;
+}
+
+///----------------------------------------------------------------------------
+///Worker side of a background load
+///----------------------------------------------------------------------------
+void TerrainTileCache::LoadJob(void *data)
+{
+	Tile *tile = (Tile*)data;
+	tile->failed = !tile->owner->LoadTile(tile);
+
+	//never full, at most MAX_PENDING_TILES tiles are in flight
+	while(!tile->owner->m_Arrived.Push(tile))
+		std::this_thread::yield();
+}
+
+///----------------------------------------------------------------------------
+///Returns an unloaded tile, a spare one if there is any: its samples,
+///patches and vertices keep their memory and are refilled in place
+///----------------------------------------------------------------------------
+TerrainTileCache::Tile* TerrainTileCache::CreateTile(unsigned int tileX, unsigned int tileZ)
+{
+	Tile *tile = m_Spare;
+	if(tile)
+	{
+		m_Spare = tile->next;
+		m_Stats.spareTiles--;
+		m_Stats.recycled++;
+	}
+	else
+	{
+		tile = new Tile;
+	}
+
+	tile->tile.x = tileX;
+	tile->tile.z = tileZ;
+	tile->tile.key = tileZ * m_TilesX + tileX;
+	tile->tile.originX = tileX * m_TileSize;
+	tile->tile.originZ = tileZ * m_TileSize;
+	tile->owner = this;
+	tile->frame = 0;
+	tile->ready = false;
+	tile->failed = false;
+	tile->prefetched = false;
+	tile->prev = NULL;
+	tile->next = NULL;
+	return tile;
+}
+
+///----------------------------------------------------------------------------
+///Keeps a tile that left the cache for the next CreateTile, or frees it when
+///MAX_SPARE_TILES are already kept
+///----------------------------------------------------------------------------
+void TerrainTileCache::RecycleTile(Tile *tile)
+{
+	if(m_Stats.spareTiles >= MAX_SPARE_TILES)
+	{
+		delete tile;
+		return;
+	}
+
+	tile->prev = NULL;
+	tile->next = m_Spare;
+	m_Spare = tile;
+	m_Stats.spareTiles++;
+}
+
+///----------------------------------------------------------------------------
+///Reads a tile and builds its terrain and patch vertices. Only touches the
+///tile and members fixed by Open, so it runs on any thread.
+///----------------------------------------------------------------------------
+bool TerrainTileCache::LoadTile(Tile *tile) const
+{
+	PROFILE_ZONE("load");
+	Terrain &terrain = tile->tile.terrain;
+	if(!ReadTile(tile->tile.x, tile->tile.z, terrain.GetHeightField()) || !terrain.Build(m_PatchSize))
+		return false;
+
+	const TerrainQuadTree &quadTree = terrain.GetQuadTree();
+	unsigned int count = quadTree.GetPatchVertexCount();
+	tile->tile.vertices.resize((size_t)quadTree.GetPatchCount() * count);
+	for(unsigned int i = 0; i < quadTree.GetPatchCount(); i++)
+		TerrainMesh::BuildPatchVertices(terrain.GetHeightField(), quadTree.GetPatch(i), m_PatchSize, &tile->tile.vertices[(size_t)i * count]);
+
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Reads the samples of one tile, row by row, or takes them from the package.
+///Tiles map samples to heights like the whole map; float maps without a
+///known range get the range of the tile.
+///----------------------------------------------------------------------------
+bool TerrainTileCache::ReadTile(unsigned int tileX, unsigned int tileZ, HeightField &samples) const
+{
+	if(m_Package.IsOpen())
+		return m_Package.GetTile(tileX, tileZ, samples);
+
+	unsigned int x0 = tileX * m_TileSize, z0 = tileZ * m_TileSize;
+	unsigned int width = std::min(m_TileSize + 1, m_Layout.width - x0);
+	unsigned int height = std::min(m_TileSize + 1, m_Layout.height - z0);
+	if(!samples.Create(width, height, m_Layout.format))
+		return false;
+
+	//a file per read keeps concurrent loads independent
+	FILE *f = fopen(m_FileName.c_str(), "rb");
+	if(!f) return false;
+
+	unsigned int sampleSize = samples.GetSampleSize();
+	size_t rowBytes = (size_t)width * sampleSize;
+	unsigned char *data = (unsigned char*)samples.GetWritableData();
+	bool ok = true;
+
+	for(unsigned int z = 0; z < height && ok; z++, data += rowBytes)
+	{
+		unsigned long long offset = ((unsigned long long)(z0 + z) * m_Layout.width + x0) * sampleSize;
+		ok = Seek(f, offset) && fread(data, 1, rowBytes, f) == rowBytes;
+
+		if(ok && m_Layout.bigEndian && sampleSize > 1)
+		{
+			for(size_t i = 0; i < rowBytes; i += sampleSize)
+				std::reverse(data + i, data + i + sampleSize);
+		}
+	}
+
+	fclose(f);
+
+	samples.SetVerticalScale(m_Layout.scale, m_Layout.offset);
+	if(m_Layout.low < m_Layout.high)
+		samples.SetSampleRange(m_Layout.low, m_Layout.high);
+
+	return ok;
+}
+
+///----------------------------------------------------------------------------
+///Makes a loaded tile resident, evicting to make room for it
+///----------------------------------------------------------------------------
+void TerrainTileCache::Insert(Tile *tile)
+{
+	unsigned long long bytes = GetTileBytes(tile);
+	Evict(bytes);
+
+	tile->ready = true;
+	Touch(tile);
+	m_Stats.loads++;
+	m_Stats.residentBytes += bytes;
+	m_Stats.residentTiles++;
+	m_Stats.peakBytes = std::max(m_Stats.peakBytes, m_Stats.residentBytes);
+}
+
+///----------------------------------------------------------------------------
+///Links in the tiles the workers finished
+///@param	limited - stop once the frame budget is used up (at least one
+///			tile is taken so streaming always progresses)
+///@return	number of tiles taken
+///----------------------------------------------------------------------------
+unsigned int TerrainTileCache::Drain(bool limited)
+{
+	unsigned int count = 0;
+	Tile *tile;
+
+	while((!limited || !count || HasFrameTime()) && m_Arrived.Pop(tile))
+	{
+		m_Stats.pendingTiles--;
+		count++;
+
+		if(tile->failed)
+		{
+			m_Tiles.erase(tile->tile.key);
+			RecycleTile(tile);
+			continue;
+		}
+
+		Insert(tile);
+	}
+
+	return count;
+}
+
+///----------------------------------------------------------------------------
+///Queues loads for the tiles the camera will reach within the prefetch time
+///if it keeps its velocity, soonest first. Tiles already in range are left
+///to Update; resident ones ahead are touched so they outlive those behind.
+///@param	eye - camera position in terrain space
+///@param	velocity - camera velocity in terrain units per second
+///@param	radius - distance at which tiles are needed
+///@param	slots - tiles the budget still holds after the ones in range
+///----------------------------------------------------------------------------
+void TerrainTileCache::Prefetch(const float *eye, const float *velocity, float radius, size_t slots)
+{
+	float speed = sqrtf(velocity[0] * velocity[0] + velocity[2] * velocity[2]);
+	if(speed <= 0.0f || !slots || m_Stats.pendingTiles >= MAX_PENDING_TILES) return;
+
+	//sample the path about every half tile
+	float size = (float)m_TileSize;
+	float samples = ceilf(m_PrefetchTime * speed / (0.5f * size));
+	unsigned int steps = (unsigned int)std::min(std::max(samples, 1.0f), (float)MAX_PREFETCH_STEPS);
+
+	//every step covers at most the tiles of a circle's bounding square
+	size_t span = (size_t)(2.0f * radius / size) + 2;
+	size_t bound = (size_t)steps * std::min(span, (size_t)m_TilesX) * std::min(span, (size_t)m_TilesZ);
+	TileArrival *ahead = m_Scratch.AllocateArray<TileArrival>(bound);
+
+	//prefetching is optional, out of arena memory it is skipped this frame
+	if(!ahead) return;
+	size_t count = 0;
+
+	for(unsigned int s = 1; s <= steps; s++)
+	{
+		float t = m_PrefetchTime * (float)s / (float)steps;
+		float px = eye[0] + velocity[0] * t, pz = eye[2] + velocity[2] * t;
+
+		int x0 = std::max((int)floor((px - radius) / size), 0);
+		int z0 = std::max((int)floor((pz - radius) / size), 0);
+		int x1 = std::min((int)floor((px + radius) / size), (int)m_TilesX - 1);
+		int z1 = std::min((int)floor((pz + radius) / size), (int)m_TilesZ - 1);
+
+		for(int z = z0; z <= z1; z++)
+		{
+			for(int x = x0; x <= x1; x++)
+			{
+				if(TileDistance(x, z, size, px, pz) <= radius * radius &&
+				   TileDistance(x, z, size, eye[0], eye[2]) > radius * radius)
+					ahead[count++] = std::make_pair((unsigned int)z * m_TilesX + x, t);
+			}
+		}
+	}
+
+	//earliest time per tile, then soonest first (stable_sort would take a
+	//buffer from the heap, keys break the ties instead)
+	std::sort(ahead, ahead + count);
+	count = std::unique(ahead, ahead + count, SameTile) - ahead;
+	std::sort(ahead, ahead + count, ArrivesSooner);
+
+	for(size_t i = 0; i < count && slots; i++, slots--)
+	{
+		unsigned int key = ahead[i].first;
+		TileMap::iterator found = m_Tiles.find(key);
+		if(found != m_Tiles.end())
+		{
+			if(found->second->ready)
+				Touch(found->second);
+			continue;
+		}
+
+		if(m_Stats.pendingTiles >= MAX_PENDING_TILES)
+			break;
+
+		Tile *tile = CreateTile(key % m_TilesX, key / m_TilesX);
+		tile->prefetched = true;
+		m_Tiles[key] = tile;
+		m_Stats.pendingTiles++;
+		m_Stats.prefetches++;
+		m_Jobs->Submit(LoadJob, tile);
+	}
+}
+
+///----------------------------------------------------------------------------
+///Scores a prefetched tile the first time it is actually needed
+///----------------------------------------------------------------------------
+void TerrainTileCache::Claim(Tile *tile)
+{
+	if(!tile->prefetched) return;
+
+	if(tile->ready)
+		m_Stats.prefetchHits++;
+	else
+		m_Stats.prefetchLate++;
+	tile->prefetched = false;
+}
+
+///----------------------------------------------------------------------------
+///Moves a tile to the front, pinning it if the current Update asked for it
+///----------------------------------------------------------------------------
+void TerrainTileCache::Touch(Tile *tile)
+{
+	tile->frame = m_Frame;
+	if(tile == m_Head) return;
+
+	Unlink(tile);
+	tile->prev = NULL;
+	tile->next = m_Head;
+	if(m_Head) m_Head->prev = tile;
+	m_Head = tile;
+	if(!m_Tail) m_Tail = tile;
+}
+
+///----------------------------------------------------------------------------
+///Takes a tile out of the LRU list
+///----------------------------------------------------------------------------
+void TerrainTileCache::Unlink(Tile *tile)
+{
+	if(tile->prev) tile->prev->next = tile->next;
+	if(tile->next) tile->next->prev = tile->prev;
+	if(m_Head == tile) m_Head = tile->next;
+	if(m_Tail == tile) m_Tail = tile->prev;
+	tile->prev = NULL;
+	tile->next = NULL;
+}
+
+///----------------------------------------------------------------------------
+///Drops least recently used tiles until incoming more bytes fit the budget,
+///stopping at tiles the current Update still needs
+///----------------------------------------------------------------------------
+void TerrainTileCache::Evict(unsigned long long incoming)
+{
+	while(m_Tail && (!m_Frame || m_Tail->frame != m_Frame) && m_Stats.residentBytes + incoming > m_Budget)
+	{
+		Tile *tile = m_Tail;
+		Unlink(tile);
+		m_Tiles.erase(tile->tile.key);
+
+		m_Stats.residentBytes -= GetTileBytes(tile);
+		m_Stats.residentTiles--;
+		m_Stats.evictions++;
+		if(tile->prefetched)
+			m_Stats.prefetchWasted++;
+		RecycleTile(tile);
+	}
+}
+
+///----------------------------------------------------------------------------
+///Returns the memory a loaded tile accounts for: samples and vertices
+///----------------------------------------------------------------------------
+unsigned long long TerrainTileCache::GetTileBytes(const Tile *tile)
+{
+	return tile->tile.terrain.GetHeightField().GetSizeInBytes() +
+		   (unsigned long long)tile->tile.vertices.size() * sizeof(Vertex3D);
+}
+
+///----------------------------------------------------------------------------
+///Sets the workers tiles are loaded on, NULL to load them in Update
+///----------------------------------------------------------------------------
+void TerrainTileCache::SetJobSystem(JobSystem *jobs)
+{
+	m_Jobs = jobs;
+}
+
+///----------------------------------------------------------------------------
+///Sets how many bytes of tiles may stay resident, evicting right away if
+///the cache is above it
+///----------------------------------------------------------------------------
+void TerrainTileCache::SetBudget(unsigned long long bytes)
+{
+	m_Budget = bytes;
+	Evict(0);
+}
+
+///----------------------------------------------------------------------------
+///Returns the resident bytes allowed
+///----------------------------------------------------------------------------
+unsigned long long TerrainTileCache::GetBudget() const
+{
+	return m_Budget;
+}
+
+///----------------------------------------------------------------------------
+///Sets how long Update (and the caller, see HasFrameTime) may spend on
+///streaming each frame
+///@param	milliseconds - main thread time per frame
+///----------------------------------------------------------------------------
+void TerrainTileCache::SetFrameBudget(float milliseconds)
+{
+	m_FrameBudget = std::chrono::nanoseconds((long long)(milliseconds * 1e6f));
+}
+
+///----------------------------------------------------------------------------
+///Returns the streaming time per frame in milliseconds
+///----------------------------------------------------------------------------
+float TerrainTileCache::GetFrameBudget() const
+{
+	return (float)m_FrameBudget.count() * 1e-6f;
+}
+
+///----------------------------------------------------------------------------
+///Sets how far ahead along the camera path tiles are prefetched
+///@param	seconds - look ahead time, 0 turns prefetching off
+///----------------------------------------------------------------------------
+void TerrainTileCache::SetPrefetchTime(float seconds)
+{
+	m_PrefetchTime = std::max(seconds, 0.0f);
+}
+
+///----------------------------------------------------------------------------
+///Returns the prefetch look ahead time in seconds
+///----------------------------------------------------------------------------
+float TerrainTileCache::GetPrefetchTime() const
+{
+	return m_PrefetchTime;
+}
+
+///----------------------------------------------------------------------------
+///Returns the quads per tile side
+///----------------------------------------------------------------------------
+unsigned int TerrainTileCache::GetTileSize() const
+{
+	return m_TileSize;
+}
+
+///----------------------------------------------------------------------------
+///Returns the quads per patch side of the tile terrains
+///----------------------------------------------------------------------------
+unsigned int TerrainTileCache::GetPatchSize() const
+{
+	return m_PatchSize;
+}
+
+///----------------------------------------------------------------------------
+///Returns the number of tiles along x
+///----------------------------------------------------------------------------
+unsigned int TerrainTileCache::GetTilesX() const
+{
+	return m_TilesX;
+}
+
+///----------------------------------------------------------------------------
+///Returns the number of tiles along z
+///----------------------------------------------------------------------------
+unsigned int TerrainTileCache::GetTilesZ() const
+{
+	return m_TilesZ;
+}
+
+///----------------------------------------------------------------------------
+///Returns the number of map samples along x
+///----------------------------------------------------------------------------
+unsigned int TerrainTileCache::GetWidth() const
+{
+	return m_Layout.width;
+}
+
+///----------------------------------------------------------------------------
+///Returns the number of map samples along z
+///----------------------------------------------------------------------------
+unsigned int TerrainTileCache::GetHeight() const
+{
+	return m_Layout.height;
+}
+
+///----------------------------------------------------------------------------
+///Returns the cache counters
+///----------------------------------------------------------------------------
+const TileCacheStats& TerrainTileCache::GetStats() const
+{
+	return m_Stats;
+}
+
+///----------------------------------------------------------------------------
+///Returns the memory of the per Update lists; the high-water mark is the
+///most one Update needed
+///----------------------------------------------------------------------------
+const MemoryStats& TerrainTileCache::GetScratchStats() const
+{
+	return m_Scratch.GetStats();
+}
+
+///----------------------------------------------------------------------------
+///Returns the memory of the tile lookup nodes
+///----------------------------------------------------------------------------
+const MemoryStats& TerrainTileCache::GetNodeStats() const
+{
+	return m_Nodes.GetStats();
+}
+
+///----------------------------------------------------------------------------
+///Returns the fraction of tile requests served from memory
+///----------------------------------------------------------------------------
+float TerrainTileCache::GetHitRate() const
+{
+	return m_Stats.requests ? (float)m_Stats.hits / (float)m_Stats.requests : 0.0f;
+}
+
+///----------------------------------------------------------------------------
+///Returns the fraction of scored prefetches that were needed (resident or
+///still loading) rather than evicted unused. Prefetches not scored yet are
+///left out.
+///----------------------------------------------------------------------------
+float TerrainTileCache::GetPrefetchAccuracy() const
+{
+	unsigned long long used = m_Stats.prefetchHits + m_Stats.prefetchLate;
+	return (used + m_Stats.prefetchWasted) ? (float)used / (float)(used + m_Stats.prefetchWasted) : 0.0f;
+}
+
+///----------------------------------------------------------------------------
+///Zeroes the running totals, resident and pending figures are kept
+///----------------------------------------------------------------------------
+void TerrainTileCache::ResetStats()
+{
+	unsigned long long residentBytes = m_Stats.residentBytes;
+	unsigned int residentTiles = m_Stats.residentTiles;
+	unsigned int pendingTiles = m_Stats.pendingTiles;
+	unsigned int spareTiles = m_Stats.spareTiles;
+
+	memset(&m_Stats, 0, sizeof(m_Stats));
+	m_Stats.residentBytes = residentBytes;
+	m_Stats.peakBytes = residentBytes;
+	m_Stats.residentTiles = residentTiles;
+	m_Stats.pendingTiles = pendingTiles;
+	m_Stats.spareTiles = spareTiles;
+}
@@ -0,0 +1,199 @@
+///============================================================================
+///@file	TerrainTileCache.h
+///@brief	Out-of-core paging of height maps too large to keep in memory.
+///			The map is cut into square tiles that share their border
+///			samples; tiles around the camera are read from disk on demand
+///			and kept in a least recently used cache bounded by a memory
+///			budget, older tiles are evicted as the camera moves on.
+///			Given a JobSystem, tiles are read and meshed on its workers and
+///			handed back through a lock-free queue, so Update never waits
+///			for the disk and its main thread work stays within a frame
+///			budget. With the camera velocity it also prefetches the tiles
+///			the camera is heading for, soonest first.
+///			Packages (TerrainPackage) are paged the same way, with raw tiles
+///			used in place from the mapping.
+///			Evicted tiles are kept for reuse with their buffers, lookup nodes
+///			come from a pool and per frame lists from an arena, so streaming
+///			at a steady rate does not call the global allocator.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "BlockPool.h"
+#include "JobSystem.h"
+#include "LockFreeQueue.h"
+#include "MemoryArena.h"
+#include "Terrain.h"
+#include "TerrainPackage.h"
+
+//-------------------------------------------------------------------------
+//A resident tile: its own terrain (patches, culling, LOD) in tile local
+//coordinates plus the vertices of every patch, ready to upload
+//-------------------------------------------------------------------------
+struct TerrainTile
+{
+	unsigned int			x;			///> Tile column
+	unsigned int			z;			///> Tile row
+	unsigned int			key;		///> z * tiles along x + x
+	unsigned int			originX;	///> Map sample of the tile's first column
+	unsigned int			originZ;	///> Map sample of the tile's first row
+	Terrain					terrain;	///> Samples, patches, culling and LOD
+	std::vector<Vertex3D>	vertices;	///> GetPatchVertexCount() vertices per patch, in patch order
+};
+
+//-------------------------------------------------------------------------
+//Cache counters, totals since the last ResetStats
+//-------------------------------------------------------------------------
+struct TileCacheStats
+{
+	unsigned long long	requests;		///> Tile lookups
+	unsigned long long	hits;			///> Lookups served from memory
+	unsigned long long	loads;			///> Tiles read from disk
+	unsigned long long	evictions;		///> Tiles dropped to stay in budget
+	unsigned long long	stalls;			///> Loads the caller had to wait for
+	unsigned long long	stallNanoseconds;	///> Time spent waiting for them
+	unsigned long long	skipped;		///> Tiles in range left out because the budget is full
+	unsigned long long	overBudgetFrames;	///> Updates that took longer than the frame budget
+	unsigned long long	maxUpdateNanoseconds;	///> Longest Update
+	unsigned long long	prefetches;		///> Loads queued ahead of the camera
+	unsigned long long	prefetchHits;	///> Prefetched tiles that were resident when needed
+	unsigned long long	prefetchLate;	///> Prefetched tiles still loading when needed
+	unsigned long long	prefetchWasted;	///> Prefetched tiles evicted before they were needed
+	unsigned long long	residentBytes;	///> Bytes of tiles in memory now
+	unsigned long long	peakBytes;		///> Highest residentBytes seen
+	unsigned long long	recycled;		///> Loads into an evicted tile instead of a new one
+	unsigned int		residentTiles;	///> Tiles in memory now
+	unsigned int		pendingTiles;	///> Tiles being loaded in the background now
+	unsigned int		spareTiles;		///> Evicted tiles kept for reuse now
+};
+
+class TerrainTileCache
+{
+public:
+	//-------------------------------------------------------------------------
+	//Constructors and destructors
+	//-------------------------------------------------------------------------
+	TerrainTileCache();
+	~TerrainTileCache();
+
+	//-------------------------------------------------------------------------
+	//Public methods
+	//-------------------------------------------------------------------------
+	bool Open(const char* filename, unsigned int tileSize = DEFAULT_TILE_SIZE,
+			  unsigned int patchSize = TerrainQuadTree::DEFAULT_PATCH_SIZE);
+	void Close();
+	bool IsOpen() const;
+	unsigned int Update(const float *eye, float radius, const float *velocity = NULL);
+	bool HasFrameTime() const;
+	TerrainTile* GetTile(unsigned int tileX, unsigned int tileZ);
+	TerrainTile* FindTile(unsigned int tileX, unsigned int tileZ);
+
+	void SetJobSystem(JobSystem *jobs);
+	void SetBudget(unsigned long long bytes);
+	unsigned long long GetBudget() const;
+	void SetFrameBudget(float milliseconds);
+	float GetFrameBudget() const;
+	void SetPrefetchTime(float seconds);
+	float GetPrefetchTime() const;
+	unsigned int GetTileSize() const;
+	unsigned int GetPatchSize() const;
+	unsigned int GetTilesX() const;
+	unsigned int GetTilesZ() const;
+	unsigned int GetWidth() const;
+	unsigned int GetHeight() const;
+
+	const TileCacheStats& GetStats() const;
+	const MemoryStats& GetScratchStats() const;
+	const MemoryStats& GetNodeStats() const;
+	float GetHitRate() const;
+	float GetPrefetchAccuracy() const;
+	void ResetStats();
+
+	//-------------------------------------------------------------------------
+	//Public members
+	//-------------------------------------------------------------------------
+	static const unsigned int DEFAULT_TILE_SIZE = 256;					///> Quads per tile side
+	static const unsigned long long DEFAULT_BUDGET = 256ULL << 20;		///> Bytes of resident tiles
+	static const float DEFAULT_FRAME_BUDGET;							///> Milliseconds of streaming work per frame
+	static const unsigned int MAX_PENDING_TILES = 64;					///> Background loads in flight
+	static const float DEFAULT_PREFETCH_TIME;							///> Seconds of camera path to prefetch
+	static const unsigned int MAX_PREFETCH_STEPS = 32;					///> Points sampled along that path
+	static const unsigned int MAX_SPARE_TILES = 8;						///> Evicted tiles kept for reuse
+
+private:
+	//-------------------------------------------------------------------------
+	//A tile and its bookkeeping, linked in LRU order once loaded
+	//-------------------------------------------------------------------------
+	struct Tile
+	{
+		TerrainTile			tile;		///> What the caller sees
+		TerrainTileCache*	owner;		///> Cache that requested it
+		unsigned int		frame;		///> Last Update that asked for it, 0 if none
+		bool				ready;		///> Loaded and linked, false while in flight
+		bool				failed;		///> The background load failed
+		bool				prefetched;	///> Loaded ahead of need and not needed yet
+		Tile*				prev;		///> More recently used
+		Tile*				next;		///> Less recently used, or next spare tile
+	};
+
+	typedef std::pair<const unsigned int, Tile*> TileEntry;
+	typedef std::unordered_map<unsigned int, Tile*, std::hash<unsigned int>, std::equal_to<unsigned int>,
+							   PoolAllocator<TileEntry> > TileMap;
+
+	//-------------------------------------------------------------------------
+	//Private methods
+	//-------------------------------------------------------------------------
+	static void LoadJob(void *data);
+	Tile* CreateTile(unsigned int tileX, unsigned int tileZ);
+	void RecycleTile(Tile *tile);
+	bool LoadTile(Tile *tile) const;
+	bool ReadTile(unsigned int tileX, unsigned int tileZ, HeightField &samples) const;
+	void Insert(Tile *tile);
+	unsigned int Drain(bool limited);
+	void Prefetch(const float *eye, const float *velocity, float radius, size_t slots);
+	void Claim(Tile *tile);
+	void Touch(Tile *tile);
+	void Unlink(Tile *tile);
+	void Evict(unsigned long long incoming);
+	static unsigned long long GetTileBytes(const Tile *tile);
+
+	//-------------------------------------------------------------------------
+	//Non copyable
+	//-------------------------------------------------------------------------
+	TerrainTileCache(const TerrainTileCache&);
+	TerrainTileCache& operator=(const TerrainTileCache&);
+
+	//-------------------------------------------------------------------------
+	//Private members
+	//-------------------------------------------------------------------------
+	std::string							m_FileName;		///> Paged .raw or package file
+	TerrainPackage						m_Package;		///> The package, if m_FileName is one
+	HeightLayout						m_Layout;		///> Size, format and height mapping of the map
+	unsigned int						m_TileSize;		///> Quads per tile side
+	unsigned int						m_PatchSize;	///> Quads per patch side inside tiles
+	unsigned int						m_TilesX;		///> Tiles along x
+	unsigned int						m_TilesZ;		///> Tiles along z
+	unsigned long long					m_Budget;		///> Resident bytes allowed
+	unsigned long long					m_TileBytes;	///> Memory of a full tile
+	std::chrono::nanoseconds			m_FrameBudget;	///> Main thread streaming time per Update
+	float								m_PrefetchTime;	///> Seconds of predicted path to prefetch, 0 for none
+	std::chrono::steady_clock::time_point	m_FrameStart;	///> When the last Update started
+	unsigned int						m_Frame;		///> Number of the Update running, 0 outside one
+	unsigned int						m_LastFrame;	///> Last Update number handed out
+	JobSystem*							m_Jobs;			///> Background loaders, NULL to load in place
+	LockFreeQueue<Tile*>				m_Arrived;		///> Tiles finished by the workers
+	BlockPool							m_Nodes;		///> Nodes of m_Tiles
+	TileMap								m_Tiles;		///> Loaded and in flight tiles by key
+	Tile*								m_Head;			///> Most recently used tile
+	Tile*								m_Tail;			///> Least recently used tile
+	Tile*								m_Spare;		///> Evicted tiles kept for reuse, linked through next
+	TileCacheStats						m_Stats;		///> Counters
+	MemoryArena							m_Scratch;		///> Per Update lists (tiles in range, tiles ahead), reset each Update
+	std::vector<std::pair<float, unsigned int> >	m_InRange;	///> Tiles in range when m_Scratch is out of memory
+};
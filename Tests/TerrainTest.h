@@ -0,0 +1,44 @@
+///============================================================================
+///@file	TerrainTest.h
+///@brief	Minimal unit test harness of the TerrainTests target. Tests
+///			register themselves at static initialization and CHECK records
+///			a failure without stopping the test, so one run reports every
+///			broken expectation.
+///
+///			TERRAIN_TEST(HeightFieldCreate)
+///			{
+///				HeightField field;
+///				CHECK(field.Create(4, 4, HEIGHT_UINT8));
+///			}
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+class Frustum;
+
+namespace TerrainTest
+{
+	typedef void (*TestFunction)();
+
+	bool Register(const char *name, TestFunction function);
+	void Fail(const char *file, int line, const char *expression);
+	unsigned int GetFailureCount();
+	bool WriteFile(const char *filename, const void *data, unsigned int bytes);
+	bool LookAt(const float *eye, const float *target, float fovY, Frustum &frustum);
+}
+
+//-------------------------------------------------------------------------
+//Records a failure when expression is false, the test goes on
+//-------------------------------------------------------------------------
+#define CHECK(expression) \
+	do { if(!(expression)) TerrainTest::Fail(__FILE__, __LINE__, #expression); } while(0)
+
+//-------------------------------------------------------------------------
+//Defines and registers a test, run by TerrainTests <name prefix>
+//-------------------------------------------------------------------------
+#define TERRAIN_TEST(name) \
+	static void name(); \
+	static bool s_Registered_##name = TerrainTest::Register(#name, name); \
+	static void name()
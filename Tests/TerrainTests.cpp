@@ -0,0 +1,140 @@
+///============================================================================
+///@file	TerrainTests.cpp
+///@brief	Runs the registered unit tests. Every argument is a name prefix,
+///			a test runs if it matches any of them (all tests without
+///			arguments). Returns 1 if a check failed or no test matched.
+///
+///			TerrainTests Core Culler
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "TerrainTest.h"
+#include "Frustum.h"
+
+#include <stdio.h>
+#include <string.h>
+
+//-------------------------------------------------------------------------
+//A registered test
+//-------------------------------------------------------------------------
+struct TestEntry
+{
+	const char*					name;		///> Name, prefixed by its group
+	TerrainTest::TestFunction	function;	///> Body
+};
+
+static const unsigned int MAX_TESTS = 256;
+
+static TestEntry s_Tests[MAX_TESTS];		///> Registered tests, in registration order
+static unsigned int s_TestCount = 0;		///> Entries of s_Tests in use
+static unsigned int s_Failures = 0;			///> Failed checks so far
+
+///----------------------------------------------------------------------------
+///Adds a test to the run list; called by TERRAIN_TEST at static init time
+///----------------------------------------------------------------------------
+bool TerrainTest::Register(const char *name, TestFunction function)
+{
+	if(s_TestCount >= MAX_TESTS)
+	{
+		fprintf(stderr, "too many tests, %s dropped\n", name);
+		return false;
+	}
+
+	s_Tests[s_TestCount].name = name;
+	s_Tests[s_TestCount].function = function;
+	s_TestCount++;
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Reports a failed check
+///----------------------------------------------------------------------------
+void TerrainTest::Fail(const char *file, int line, const char *expression)
+{
+	fprintf(stderr, "%s(%d): CHECK(%s) failed\n", file, line, expression);
+	s_Failures++;
+}
+
+///----------------------------------------------------------------------------
+///Returns the number of failed checks so far
+///----------------------------------------------------------------------------
+unsigned int TerrainTest::GetFailureCount()
+{
+	return s_Failures;
+}
+
+///----------------------------------------------------------------------------
+///Writes a scratch file for a test, in the working directory
+///----------------------------------------------------------------------------
+bool TerrainTest::WriteFile(const char *filename, const void *data, unsigned int bytes)
+{
+	FILE *f = fopen(filename, "wb");
+	if(!f) return false;
+
+	bool written = (fwrite(data, 1, bytes, f) == bytes);
+	return (fclose(f) == 0) && written;
+}
+
+///----------------------------------------------------------------------------
+///Builds the frustum of a square view from eye toward target, near plane 1
+///and far plane 1000 as in TerrainRender
+///----------------------------------------------------------------------------
+bool TerrainTest::LookAt(const float *eye, const float *target, float fovY, Frustum &frustum)
+{
+	float view[16], proj[16];
+	if(!Frustum::LookAtLH(eye, target, view))
+		return false;
+
+	Frustum::PerspectiveFovLH(fovY, 1.0f, 1.0f, 1000.0f, proj);
+	frustum.Extract(view, proj);
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Returns true if the test is selected by the command line
+///----------------------------------------------------------------------------
+static bool IsSelected(const char *name, int argc, char **argv)
+{
+	if(argc < 2)
+		return true;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(!strncmp(name, argv[i], strlen(argv[i])))
+			return true;
+	}
+
+	return false;
+}
+
+///----------------------------------------------------------------------------
+///Entry point
+///----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+	unsigned int run = 0, failed = 0;
+	for(unsigned int i = 0; i < s_TestCount; i++)
+	{
+		if(!IsSelected(s_Tests[i].name, argc, argv))
+			continue;
+
+		unsigned int before = s_Failures;
+		s_Tests[i].function();
+		run++;
+
+		bool passed = (s_Failures == before);
+		if(!passed) failed++;
+		printf("%-40s %s\n", s_Tests[i].name, passed ? "ok" : "FAILED");
+	}
+
+	printf("%u tests, %u failed\n", run, failed);
+
+	if(!run)
+	{
+		fprintf(stderr, "no test matches\n");
+		return 1;
+	}
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,195 @@
+///============================================================================
+///@file	TestAllocations.cpp
+///@brief	Steady state frames must not touch the heap. The test binary
+///			replaces operator new with a counting one; after a warm-up that
+///			sizes the buffers grown on first use, 10000 frames of draw
+///			submission, profiler and stats overlay work must allocate
+///			nothing, with and without culling a moving camera first. Arena
+///			requests that cannot be met come back NULL.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "TerrainTest.h"
+#include "MemoryArena.h"
+#include "Profiler.h"
+#include "RecordingBackend.h"
+#include "StatsOverlay.h"
+#include "Terrain.h"
+#include "TerrainBuffers.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <atomic>
+#include <new>
+
+static std::atomic<unsigned long long> s_Allocations(0);	///> operator new calls so far
+
+///----------------------------------------------------------------------------
+///Counts heap allocations. The array and nothrow forms end up here too.
+///GCC flags the free of memory from operator new once these inline, which
+///is the point of replacing both.
+///----------------------------------------------------------------------------
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(size_t size)
+{
+	s_Allocations.fetch_add(1, std::memory_order_relaxed);
+	void *memory = malloc(size ? size : 1);
+	if(!memory)
+		throw std::bad_alloc();
+	return memory;
+}
+
+void operator delete(void *memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+	free(memory);
+}
+
+static const unsigned int WARM_UP_FRAMES = 120;		///> Frames before counting starts
+static const unsigned int COUNTED_FRAMES = 10000;	///> Frames that must not allocate
+
+///----------------------------------------------------------------------------
+///What the viewer keeps between frames, on a recording device
+///----------------------------------------------------------------------------
+struct HudScene
+{
+	Terrain				terrain;		///> 129 x 129 hills
+	RecordingBackend	backend;		///> Null device
+	TerrainBuffers		buffers;		///> Patch vertices and LOD indices
+	StatsOverlay		overlay;		///> The viewer's text lines
+	unsigned int		submitZone;		///> Profiler zone of the draw submission
+	unsigned long long	frameCount;		///> Frames run so far
+};
+
+///----------------------------------------------------------------------------
+///Builds the terrain, its buffers and the overlay lines
+///----------------------------------------------------------------------------
+static bool CreateScene(HudScene &scene)
+{
+	HeightField &field = scene.terrain.GetHeightField();
+	if(!field.Create(129, 129, HEIGHT_UINT8))
+		return false;
+
+	for(unsigned int z = 0; z < 129; z++)
+		for(unsigned int x = 0; x < 129; x++)
+			field.SetElevation(x, z, (float)((x * 5 + z * 3) % 50) * field.GetVerticalScale());
+
+	if(!scene.terrain.Build(16) || !scene.buffers.Create(scene.backend, scene.terrain))
+		return false;
+
+	scene.terrain.SetLOD(true);
+	scene.overlay.AddLine("%.0f FPS  %.2f ms");
+	scene.overlay.AddLine("patches %.0f  triangles %.0f  draws %.0f");
+	scene.overlay.AddLine("frame p50 %.2f p99 %.2f ms  draw_submit p95 %.1f us");
+	scene.submitZone = Profiler::RegisterZone("draw_submit");
+	scene.frameCount = 0;
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Runs one frame: optionally culls from a camera circling the map, then
+///submits the patches, updates the overlay and closes the profiler frame
+///----------------------------------------------------------------------------
+static void RunFrame(HudScene &scene, bool cull)
+{
+	unsigned long long frame = scene.frameCount++;
+
+	if(cull || frame == 0)
+	{
+		float angle = (float)(frame % 360) * 0.0174533f;
+		float eye[3] = { 64.0f + 90.0f * cosf(angle), 40.0f, 64.0f + 90.0f * sinf(angle) };
+		float center[3] = { 64.0f, 0.0f, 64.0f };
+		Frustum frustum;
+		TerrainTest::LookAt(eye, center, 3.14159265f / 4.0f, frustum);
+		scene.terrain.Update(frustum, eye, 300.0f);
+	}
+
+	scene.backend.BeginFrame(0xFF2D32AA);
+	scene.buffers.Draw(scene.terrain);
+
+	StatsOverlay &overlay = scene.overlay;
+	overlay.SetValue(0, 0, (double)(frame / 60));
+	overlay.SetValue(0, 1, (double)(frame % 100));
+	overlay.SetValue(1, 0, (double)scene.terrain.GetVisiblePatches().size());
+	overlay.SetValue(1, 1, (double)scene.backend.GetStats().triangles);
+	overlay.SetValue(1, 2, (double)scene.backend.GetStats().drawCalls);
+	if(frame % 30 == 0)
+	{
+		ProfileZoneStats stats;
+		Profiler::GetZoneStats(Profiler::FRAME_ZONE, stats);
+		overlay.SetValue(2, 0, stats.p50 * 1e-6);
+		overlay.SetValue(2, 1, stats.p99 * 1e-6);
+		Profiler::GetZoneStats(scene.submitZone, stats);
+		overlay.SetValue(2, 2, stats.p95 * 1e-3);
+	}
+	for(unsigned int line = 0; line < overlay.GetLineCount(); line++)
+		CHECK(overlay.GetText(line) != NULL);
+
+	scene.backend.EndFrame();
+	Profiler::EndFrame();
+}
+
+///----------------------------------------------------------------------------
+///Returns the allocations of COUNTED_FRAMES frames after the warm-up
+///----------------------------------------------------------------------------
+static unsigned long long CountFrameAllocations(bool cull)
+{
+	HudScene *scene = new HudScene;
+	CHECK(CreateScene(*scene));
+
+	for(unsigned int i = 0; i < WARM_UP_FRAMES; i++)
+		RunFrame(*scene, cull);
+
+	unsigned long long before = s_Allocations.load();
+	for(unsigned int i = 0; i < COUNTED_FRAMES; i++)
+		RunFrame(*scene, cull);
+	unsigned long long allocations = s_Allocations.load() - before;
+
+	CHECK(scene->backend.GetStats().drawCalls > 0);
+	CHECK(scene->overlay.GetFormatCount() < scene->frameCount * scene->overlay.GetLineCount());
+	delete scene;
+	return allocations;
+}
+
+TERRAIN_TEST(AllocationsCounterWorks)
+{
+	unsigned long long before = s_Allocations.load();
+	int *volatile value = new int(1);
+	delete value;
+	CHECK(s_Allocations.load() == before + 1);
+}
+
+TERRAIN_TEST(AllocationsHudFrame)
+{
+	CHECK(CountFrameAllocations(false) == 0);
+}
+
+TERRAIN_TEST(AllocationsCulledFrame)
+{
+	CHECK(CountFrameAllocations(true) == 0);
+}
+
+TERRAIN_TEST(AllocationsArenaFailure)
+{
+	//sizes that overflow or that no heap holds: NULL, nothing constructed,
+	//and the arena still works afterwards
+	MemoryArena arena;
+	CHECK(arena.AllocateArray<unsigned int>((size_t)-1 / 2) == NULL);
+	CHECK(arena.AllocateArray<unsigned char>((size_t)1 << 60) == NULL);
+	CHECK(arena.Allocate((size_t)-1 - 8) == NULL);
+	CHECK(arena.GetStats().used == 0);
+
+	unsigned int *values = arena.AllocateArray<unsigned int>(100);
+	CHECK(values != NULL);
+	if(values)
+		CHECK(values[0] == 0 && values[99] == 0);
+	CHECK(arena.GetStats().used >= 100 * sizeof(unsigned int));
+}
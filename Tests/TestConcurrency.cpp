@@ -0,0 +1,388 @@
+///============================================================================
+///@file	TestConcurrency.cpp
+///@brief	Stress tests of the lock free queue and the work stealing job
+///			system: every value and every job must arrive exactly once.
+///			Parallel::For loops on its kept helper threads, nested and from
+///			several threads at once, must cover every item exactly once.
+///			Meant to also run in a -DTERRAIN_SANITIZE=thread build.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "TerrainTest.h"
+#include "JobSystem.h"
+#include "LockFreeQueue.h"
+#include "Parallel.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+static const unsigned int PRODUCERS = 4;				///> Threads pushing to the queue
+static const unsigned int CONSUMERS = 3;				///> Threads popping from it
+static const unsigned int VALUES_PER_PRODUCER = 20000;	///> Values each producer pushes
+
+///----------------------------------------------------------------------------
+///Pushes producer << 24 | n for n = 0..VALUES_PER_PRODUCER-1, waiting while
+///the queue is full
+///----------------------------------------------------------------------------
+static void Produce(LockFreeQueue<unsigned int> *queue, unsigned int producer)
+{
+	for(unsigned int n = 0; n < VALUES_PER_PRODUCER; n++)
+	{
+		while(!queue->Push((producer << 24) | n))
+			std::this_thread::yield();
+	}
+}
+
+//-------------------------------------------------------------------------
+//What a consumer thread saw
+//-------------------------------------------------------------------------
+struct ConsumerLog
+{
+	std::vector<unsigned int>	values;		///> Values popped, in order
+};
+
+///----------------------------------------------------------------------------
+///Pops until every value of every producer was taken by some consumer
+///----------------------------------------------------------------------------
+static void Consume(LockFreeQueue<unsigned int> *queue, std::atomic<unsigned int> *taken, ConsumerLog *log)
+{
+	const unsigned int total = PRODUCERS * VALUES_PER_PRODUCER;
+	while(taken->load() < total)
+	{
+		unsigned int value;
+		if(queue->Pop(value))
+		{
+			log->values.push_back(value);
+			taken->fetch_add(1);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+TERRAIN_TEST(ConcurrencyQueueSingleThread)
+{
+	LockFreeQueue<unsigned int> queue(5);
+	CHECK(queue.GetCapacity() == 8);
+
+	unsigned int value = 0;
+	CHECK(!queue.Pop(value));
+	for(unsigned int round = 0; round < 3; round++)
+	{
+		for(unsigned int i = 0; i < 8; i++)
+			CHECK(queue.Push(round * 8 + i));
+		CHECK(!queue.Push(99));
+		for(unsigned int i = 0; i < 8; i++)
+			CHECK(queue.Pop(value) && value == round * 8 + i);
+		CHECK(!queue.Pop(value));
+	}
+}
+
+TERRAIN_TEST(ConcurrencyQueueProducersConsumers)
+{
+	//a small ring so producers keep running into a full queue and the
+	//positions wrap many times
+	LockFreeQueue<unsigned int> queue(64);
+	std::atomic<unsigned int> taken(0);
+	ConsumerLog logs[CONSUMERS];
+	std::vector<std::thread> threads;
+
+	for(unsigned int c = 0; c < CONSUMERS; c++)
+		threads.push_back(std::thread(Consume, &queue, &taken, &logs[c]));
+	for(unsigned int p = 0; p < PRODUCERS; p++)
+		threads.push_back(std::thread(Produce, &queue, p));
+	for(size_t i = 0; i < threads.size(); i++)
+		threads[i].join();
+
+	//no value lost or duplicated, and each consumer saw each producer's
+	//values in the order they were pushed
+	std::vector<unsigned char> seen(PRODUCERS * VALUES_PER_PRODUCER, 0);
+	unsigned int duplicates = 0, outOfOrder = 0, invalid = 0;
+	for(unsigned int c = 0; c < CONSUMERS; c++)
+	{
+		int last[PRODUCERS];
+		for(unsigned int p = 0; p < PRODUCERS; p++)
+			last[p] = -1;
+
+		for(size_t i = 0; i < logs[c].values.size(); i++)
+		{
+			unsigned int producer = logs[c].values[i] >> 24, n = logs[c].values[i] & 0xFFFFFF;
+			if(producer >= PRODUCERS || n >= VALUES_PER_PRODUCER)
+			{
+				invalid++;
+				continue;
+			}
+
+			if(seen[producer * VALUES_PER_PRODUCER + n]++)
+				duplicates++;
+			if((int)n <= last[producer])
+				outOfOrder++;
+			last[producer] = (int)n;
+		}
+	}
+
+	unsigned int missing = 0;
+	for(size_t i = 0; i < seen.size(); i++)
+		missing += !seen[i];
+
+	CHECK(taken.load() == PRODUCERS * VALUES_PER_PRODUCER);
+	CHECK(invalid == 0);
+	CHECK(duplicates == 0);
+	CHECK(missing == 0);
+	CHECK(outOfOrder == 0);
+
+	unsigned int value;
+	CHECK(!queue.Pop(value));
+}
+
+static const unsigned int SUM_ELEMENTS = 1 << 16;	///> Elements of the fork/join sum
+static const unsigned int SUM_LEAF = 64;			///> Elements summed without splitting
+static const unsigned int SUM_NODES = SUM_ELEMENTS / SUM_LEAF * 2;	///> Nodes of the range tree
+
+//-------------------------------------------------------------------------
+//State shared by the jobs of a fork/join sum
+//-------------------------------------------------------------------------
+struct SumState
+{
+	JobSystem*						jobs;					///> Where the halves go
+	std::atomic<unsigned char>		visits[SUM_ELEMENTS];	///> Per element visit count
+	std::atomic<unsigned long long>	sum;					///> Sum of the visited elements
+	std::atomic<unsigned int>		leaves;					///> Leaf jobs run
+};
+
+//-------------------------------------------------------------------------
+//One node of the range tree, the job data of the range
+//-------------------------------------------------------------------------
+struct SumTask
+{
+	SumState*		state;	///> Shared state
+	SumTask*		tree;	///> Every node, children of node k at 2k+1 and 2k+2
+	unsigned int	node;	///> This node
+	unsigned int	first;	///> First element
+	unsigned int	count;	///> Elements
+};
+
+///----------------------------------------------------------------------------
+///Forks the two halves of a range as jobs, or sums a small one. The nodes
+///are preallocated so their data stays valid until the join.
+///----------------------------------------------------------------------------
+static void SumJob(void *data)
+{
+	SumTask *task = (SumTask*)data;
+	SumState *state = task->state;
+	if(task->count <= SUM_LEAF)
+	{
+		unsigned long long sum = 0;
+		for(unsigned int i = task->first; i < task->first + task->count; i++)
+		{
+			state->visits[i].fetch_add(1, std::memory_order_relaxed);
+			sum += i;
+		}
+		state->sum.fetch_add(sum);
+		state->leaves.fetch_add(1);
+		return;
+	}
+
+	unsigned int half = task->count / 2;
+	SumTask *left = &task->tree[task->node * 2 + 1], *right = &task->tree[task->node * 2 + 2];
+	*left = *task;
+	left->node = task->node * 2 + 1;
+	left->count = half;
+	*right = *task;
+	right->node = task->node * 2 + 2;
+	right->first = task->first + half;
+	right->count = task->count - half;
+	state->jobs->Submit(SumJob, left);
+	state->jobs->Submit(SumJob, right);
+}
+
+//-------------------------------------------------------------------------
+//A job that forks children onto its own deque and spins until they ran
+//-------------------------------------------------------------------------
+struct StealState
+{
+	JobSystem*					jobs;		///> Where the children go
+	std::atomic<unsigned int>	done;		///> Children finished
+	std::atomic<unsigned int>	elsewhere;	///> Children run by another thread than the parent's
+	std::thread::id				parent;		///> Thread of the forking job
+};
+
+static const unsigned int STEAL_CHILDREN = 32;	///> Children of the forking job
+
+///----------------------------------------------------------------------------
+///Child: records where it ran
+///----------------------------------------------------------------------------
+static void StealChildJob(void *data)
+{
+	StealState *state = (StealState*)data;
+	if(std::this_thread::get_id() != state->parent)
+		state->elsewhere.fetch_add(1);
+	state->done.fetch_add(1);
+}
+
+///----------------------------------------------------------------------------
+///Parent: its children land on its own deque, which it never gets back
+///to while it spins, so only thieves can run them
+///----------------------------------------------------------------------------
+static void StealParentJob(void *data)
+{
+	StealState *state = (StealState*)data;
+	state->parent = std::this_thread::get_id();
+	for(unsigned int i = 0; i < STEAL_CHILDREN; i++)
+		state->jobs->Submit(StealChildJob, state);
+
+	while(state->done.load() < STEAL_CHILDREN)
+		std::this_thread::yield();
+}
+
+TERRAIN_TEST(ConcurrencyJobsForkJoin)
+{
+	JobSystem jobs;
+	CHECK(jobs.Start(4));
+	CHECK(jobs.GetThreadCount() == 4);
+
+	std::vector<SumTask> tree(SUM_NODES);
+	SumState *state = new SumState;
+	state->jobs = &jobs;
+	for(unsigned int round = 0; round < 8; round++)
+	{
+		for(unsigned int i = 0; i < SUM_ELEMENTS; i++)
+			state->visits[i].store(0);
+		state->sum = 0;
+		state->leaves = 0;
+
+		SumTask root = { state, &tree[0], 0, 0, SUM_ELEMENTS };
+		tree[0] = root;
+		jobs.Submit(SumJob, &tree[0]);
+		jobs.Wait();
+
+		CHECK(jobs.GetPendingCount() == 0);
+		CHECK(state->leaves.load() == SUM_ELEMENTS / SUM_LEAF);
+		CHECK(state->sum.load() == (unsigned long long)SUM_ELEMENTS * (SUM_ELEMENTS - 1) / 2);
+
+		unsigned int wrong = 0;
+		for(unsigned int i = 0; i < SUM_ELEMENTS; i++)
+			wrong += (state->visits[i].load() != 1);
+		CHECK(wrong == 0);
+	}
+
+	delete state;
+	jobs.Stop();
+	CHECK(!jobs.IsRunning());
+}
+
+TERRAIN_TEST(ConcurrencyJobsSteal)
+{
+	JobSystem jobs;
+	CHECK(jobs.Start(3));
+
+	StealState state;
+	state.jobs = &jobs;
+	state.done = 0;
+	state.elsewhere = 0;
+	jobs.Submit(StealParentJob, &state);
+	jobs.Wait();
+
+	CHECK(state.done.load() == STEAL_CHILDREN);
+	CHECK(state.elsewhere.load() == STEAL_CHILDREN);
+	CHECK(jobs.GetStealCount() >= STEAL_CHILDREN);
+	CHECK(jobs.GetPendingCount() == 0);
+}
+
+TERRAIN_TEST(ConcurrencyJobsStopDrains)
+{
+	//Stop runs what is still queued, and a stopped system runs jobs inline
+	JobSystem jobs;
+	StealState state;
+	state.jobs = &jobs;
+	state.done = 0;
+	state.elsewhere = 0;
+	state.parent = std::this_thread::get_id();
+
+	CHECK(jobs.Start(2));
+	for(unsigned int i = 0; i < 1000; i++)
+		jobs.Submit(StealChildJob, &state);
+	jobs.Stop();
+	CHECK(state.done.load() == 1000);
+	CHECK(state.elsewhere.load() == 1000);
+
+	jobs.Submit(StealChildJob, &state);
+	CHECK(state.done.load() == 1001);
+	CHECK(state.elsewhere.load() == 1000);
+}
+
+///----------------------------------------------------------------------------
+///Runs many small loops, each a nested loop per item, and counts the visits
+///of every item; false if any item was missed or run twice. Worker indices
+///out of range are counted in badWorker.
+///----------------------------------------------------------------------------
+static bool RunLoops(unsigned int loops, std::atomic<unsigned int> *badWorker)
+{
+	const unsigned int outer = 64, inner = 16;
+	std::vector<std::atomic<unsigned int>> visits(outer * inner);
+	bool ok = true;
+	for(unsigned int loop = 0; loop < loops; loop++)
+	{
+		for(size_t i = 0; i < visits.size(); i++)
+			visits[i].store(0);
+
+		Parallel::For(outer, 4, [&](unsigned int begin, unsigned int end, unsigned int worker)
+		{
+			if(worker >= Parallel::GetThreadCount())
+				badWorker->fetch_add(1);
+			for(unsigned int o = begin; o < end; o++)
+			{
+				Parallel::For(inner, 1, [&](unsigned int first, unsigned int last, unsigned int)
+				{
+					for(unsigned int i = first; i < last; i++)
+						visits[o * inner + i].fetch_add(1);
+				});
+			}
+		});
+
+		for(size_t i = 0; i < visits.size(); i++)
+			ok = ok && (visits[i].load() == 1);
+	}
+	return ok;
+}
+
+TERRAIN_TEST(ConcurrencyParallelFor)
+{
+	unsigned int threads = Parallel::GetThreadCount();
+	Parallel::SetThreadCount(4);
+
+	//the same helpers serve every loop
+	std::atomic<unsigned int> bad(0);
+	CHECK(RunLoops(2000, &bad));
+	CHECK(bad.load() == 0);
+
+	//loops started from several threads at once: one gets the helpers, the
+	//others run inline
+	std::atomic<unsigned int> failed(0);
+	std::vector<std::thread> callers;
+	for(unsigned int c = 0; c < 3; c++)
+	{
+		callers.push_back(std::thread([&]()
+		{
+			std::atomic<unsigned int> wrong(0);
+			if(!RunLoops(500, &wrong) || wrong.load())
+				failed.fetch_add(1);
+		}));
+	}
+	for(size_t i = 0; i < callers.size(); i++)
+		callers[i].join();
+	CHECK(failed.load() == 0);
+
+	//fewer threads than helpers started, then more again
+	Parallel::SetThreadCount(2);
+	CHECK(RunLoops(100, &bad));
+	Parallel::SetThreadCount(4);
+	CHECK(RunLoops(100, &bad));
+	CHECK(bad.load() == 0);
+
+	Parallel::SetThreadCount(threads);
+}
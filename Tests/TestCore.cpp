@@ -0,0 +1,306 @@
+///============================================================================
+///@file	TestCore.cpp
+///@brief	Height field loading, quadtree patch bounds and the visible sets
+///			Terrain::Update produces on synthetic maps.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "TerrainTest.h"
+#include "Terrain.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+
+static const float FOV = 3.14159265f / 4.0f;	///> Vertical field of view of the test cameras
+
+///----------------------------------------------------------------------------
+///Returns the visible patches of Update, sorted (they come front to back)
+///----------------------------------------------------------------------------
+static std::vector<unsigned int> UpdateVisible(Terrain &terrain, const float *eye, const float *target, float fovY = FOV)
+{
+	Frustum frustum;
+	CHECK(TerrainTest::LookAt(eye, target, fovY, frustum));
+	unsigned int count = terrain.Update(frustum, eye, 300.0f);
+	std::vector<unsigned int> visible = terrain.GetVisiblePatches();
+	CHECK(count == visible.size());
+	std::sort(visible.begin(), visible.end());
+	return visible;
+}
+
+///----------------------------------------------------------------------------
+///Fills a terrain with rolling hills, elevations 0..25
+///----------------------------------------------------------------------------
+static bool BuildHills(Terrain &terrain, unsigned int size, unsigned int patchSize)
+{
+	HeightField &field = terrain.GetHeightField();
+	if(!field.Create(size, size, HEIGHT_UINT8))
+		return false;
+
+	for(unsigned int z = 0; z < size; z++)
+		for(unsigned int x = 0; x < size; x++)
+			field.SetElevation(x, z, (float)(((x * 7 + z * 13) % 64) * 4) * field.GetVerticalScale());
+
+	return terrain.Build(patchSize);
+}
+
+TERRAIN_TEST(CoreHeightFieldInferSquare)
+{
+	unsigned char samples[25];
+	for(unsigned int i = 0; i < 25; i++)
+		samples[i] = (unsigned char)(i * 10);
+	CHECK(TerrainTest::WriteFile("test_core_square.raw", samples, sizeof(samples)));
+
+	HeightField field;
+	CHECK(field.Load("test_core_square.raw"));
+	CHECK(field.GetWidth() == 5 && field.GetHeight() == 5);
+	CHECK(field.GetFormat() == HEIGHT_UINT8);
+	CHECK(field.GetSample(0, 0) == 0);
+	CHECK(field.GetSample(4, 0) == 40);
+	CHECK(field.GetSample(2, 3) == 170);
+	CHECK(field.GetElevation(1, 1) == 60.0f * HeightField::DEFAULT_VERTICAL_SCALE);
+
+	field.Release();
+	remove("test_core_square.raw");
+}
+
+TERRAIN_TEST(CoreHeightFieldSidecar)
+{
+	//3 x 2 big endian 16-bit samples
+	unsigned char samples[] = { 0x00, 0x01, 0x01, 0x00, 0xff, 0xff, 0x00, 0x00, 0x12, 0x34, 0x00, 0x02 };
+	const char header[] = "width 3\nheight 2\nbits 16\nendian big\nscale 0.5\noffset -10\n";
+	CHECK(TerrainTest::WriteFile("test_core_sidecar.raw", samples, sizeof(samples)));
+	CHECK(TerrainTest::WriteFile("test_core_sidecar.raw.hdr", header, sizeof(header) - 1));
+
+	HeightField field;
+	CHECK(field.Load("test_core_sidecar.raw"));
+	CHECK(field.GetWidth() == 3 && field.GetHeight() == 2);
+	CHECK(field.GetFormat() == HEIGHT_UINT16);
+	CHECK(!field.IsMapped());
+	CHECK(field.GetSample(0, 0) == 1);
+	CHECK(field.GetSample(1, 0) == 256);
+	CHECK(field.GetSample(2, 0) == 65535);
+	CHECK(field.GetSample(1, 1) == 0x1234);
+	CHECK(field.GetElevation(2, 1) == 2.0f * 0.5f - 10.0f);
+	CHECK(field.GetVerticalScale() == 0.5f && field.GetVerticalOffset() == -10.0f);
+
+	//a header promising more samples than the file holds
+	const char large[] = "width 30\nheight 2\nbits 16\n";
+	CHECK(TerrainTest::WriteFile("test_core_sidecar.raw.hdr", large, sizeof(large) - 1));
+	CHECK(!field.Load("test_core_sidecar.raw"));
+	CHECK(field.GetWidth() == 0 && field.GetData() == NULL);
+
+	remove("test_core_sidecar.raw");
+	remove("test_core_sidecar.raw.hdr");
+}
+
+TERRAIN_TEST(CoreHeightFieldMissing)
+{
+	HeightField field;
+	CHECK(!field.Load("test_core_missing.raw"));
+	CHECK(field.GetData() == NULL);
+}
+
+TERRAIN_TEST(CoreHeightFieldCreate)
+{
+	HeightField field;
+	CHECK(!field.Create(1, 8, HEIGHT_UINT8));
+	CHECK(field.Create(4, 3, HEIGHT_FLOAT32));
+	CHECK(field.GetSizeInBytes() == 4 * 3 * 4);
+	CHECK(field.GetValue(3, 2) == 0.0f);
+
+	field.SetVerticalScale(2.0f, 1.0f);
+	field.SetElevation(3, 2, 7.0f);
+	CHECK(field.GetValue(3, 2) == 3.0f);
+	CHECK(field.GetElevation(3, 2) == 7.0f);
+
+	//integer samples round and clamp
+	CHECK(field.Create(4, 3, HEIGHT_UINT8));
+	field.SetVerticalScale(1.0f);
+	field.SetElevation(0, 0, 12.4f);
+	field.SetElevation(1, 0, 300.0f);
+	field.SetElevation(2, 0, -5.0f);
+	CHECK(field.GetSample(0, 0) == 12);
+	CHECK(field.GetSample(1, 0) == 255);
+	CHECK(field.GetSample(2, 0) == 0);
+}
+
+TERRAIN_TEST(CoreHeightFieldWritable)
+{
+	//nothing loaded, including after a Create that failed over a buffer
+	HeightField field;
+	CHECK(field.GetWritableData() == NULL);
+	CHECK(field.Create(4, 4, HEIGHT_UINT8));
+	CHECK(field.GetWritableData() == field.GetData());
+	CHECK(!field.Create(1, 4, HEIGHT_UINT8));
+	CHECK(field.GetWritableData() == NULL);
+
+	//wrapped samples are copied before the first write, the source stays
+	unsigned short samples[6] = { 1, 2, 3, 4, 5, 6 };
+	CHECK(field.Wrap(samples, 3, 2, HEIGHT_UINT16));
+	CHECK(field.IsMapped());
+	unsigned short *data = (unsigned short*)field.GetWritableData();
+	CHECK(data != NULL && data != samples);
+	CHECK(!field.IsMapped());
+	CHECK(field.GetData() == data);
+	if(data)
+		CHECK(data[0] == 1 && data[5] == 6);
+	field.SetVerticalScale(1.0f);
+	field.SetElevation(2, 1, 60.0f);
+	CHECK(field.GetSample(2, 1) == 60 && samples[5] == 6);
+
+	//mapped samples likewise, the file is left alone
+	unsigned char bytes[16];
+	for(unsigned int i = 0; i < 16; i++)
+		bytes[i] = (unsigned char)(i * 3);
+	CHECK(TerrainTest::WriteFile("test_core_writable.raw", bytes, sizeof(bytes)));
+	CHECK(field.Load("test_core_writable.raw"));
+	CHECK(field.GetWidth() == 4 && field.GetSample(3, 3) == 45);
+	CHECK(field.GetWritableData() != NULL);
+	CHECK(field.GetWritableData() == field.GetData());
+	field.SetVerticalScale(1.0f);
+	field.SetElevation(3, 3, 200.0f);
+	CHECK(field.GetSample(3, 3) == 200);
+
+	field.Release();
+	CHECK(field.GetWritableData() == NULL);
+	HeightField reloaded;
+	CHECK(reloaded.Load("test_core_writable.raw"));
+	CHECK(reloaded.GetSample(3, 3) == 45);
+	reloaded.Release();
+	remove("test_core_writable.raw");
+}
+
+TERRAIN_TEST(CoreQuadTreeBounds)
+{
+	//37 x 21 samples in 8 quad patches: partial patches at the far edges
+	HeightField field;
+	CHECK(field.Create(37, 21, HEIGHT_UINT8));
+	field.SetVerticalScale(0.5f, 2.0f);
+	field.SetElevation(16, 8, 2.0f + 100.0f * 0.5f);	//on the corner patches (1,0), (2,0), (1,1) and (2,1) share
+	field.SetElevation(36, 20, 2.0f + 40.0f * 0.5f);	//last sample
+
+	TerrainQuadTree tree;
+	CHECK(!tree.Build(field, 0));
+	CHECK(tree.Build(field, 8));
+	CHECK(tree.GetPatchSize() == 8);
+	CHECK(tree.GetPatchCountX() == 5 && tree.GetPatchCountZ() == 3);
+	CHECK(tree.GetPatchCount() == 15);
+
+	for(unsigned int pz = 0; pz < 3; pz++)
+	{
+		for(unsigned int px = 0; px < 5; px++)
+		{
+			const TerrainPatch &patch = tree.GetPatch(px + pz * 5);
+			CHECK(patch.x == px * 8 && patch.z == pz * 8);
+			CHECK(patch.bounds.minX == (float)(px * 8));
+			CHECK(patch.bounds.maxX == (float)std::min(px * 8 + 8, 36u));
+			CHECK(patch.bounds.minZ == (float)(pz * 8));
+			CHECK(patch.bounds.maxZ == (float)std::min(pz * 8 + 8, 20u));
+			CHECK(patch.bounds.minY == 2.0f);
+
+			bool spike = (px == 1 || px == 2) && (pz == 0 || pz == 1);
+			bool corner = (px == 4 && pz == 2);
+			CHECK(patch.bounds.maxY == (spike ? 52.0f : (corner ? 22.0f : 2.0f)));
+		}
+	}
+
+	//the root encloses every patch
+	const BoundingBox &root = tree.GetNode(tree.GetRoot()).bounds;
+	CHECK(root.minX == 0.0f && root.maxX == 36.0f);
+	CHECK(root.minZ == 0.0f && root.maxZ == 20.0f);
+	CHECK(root.minY == 2.0f && root.maxY == 52.0f);
+
+	//leaves reference each patch once
+	std::vector<int> leaves(tree.GetPatchCount(), 0);
+	for(unsigned int i = 0; i < tree.GetNodeCount(); i++)
+	{
+		const TerrainQuadTreeNode &node = tree.GetNode(i);
+		if(node.patch >= 0)
+			leaves[node.patch]++;
+	}
+	CHECK(std::count(leaves.begin(), leaves.end(), 1) == 15);
+
+	//refitting after an edit
+	field.SetElevation(36, 20, 2.0f);
+	tree.UpdatePatches(field, 4, 2, 4, 2);
+	CHECK(tree.GetPatch(14).bounds.maxY == 2.0f);
+}
+
+TERRAIN_TEST(CoreUpdateFlat)
+{
+	//129 x 129 flat map at height 0, 8 x 8 patches of 16
+	Terrain terrain;
+	CHECK(terrain.GetHeightField().Create(129, 129, HEIGHT_UINT8));
+	CHECK(terrain.Build(16));
+	CHECK(terrain.GetQuadTree().GetPatchCount() == 64);
+
+	//far above, the whole map is in view
+	float eye[3] = { 64.0f, 400.0f, -300.0f }, center[3] = { 64.0f, 0.0f, 64.0f };
+	CHECK(UpdateVisible(terrain, eye, center).size() == 64);
+
+	//looking away from the map
+	float away[3] = { 64.0f, 10.0f, -500.0f };
+	eye[1] = 10.0f; eye[2] = -10.0f;
+	CHECK(UpdateVisible(terrain, eye, away).empty());
+
+	//a narrow view down the row z = 8 sees the first row of patches only
+	float rowEye[3] = { -10.0f, 0.0f, 8.0f }, rowTarget[3] = { 200.0f, 0.0f, 8.0f };
+	std::vector<unsigned int> row = UpdateVisible(terrain, rowEye, rowTarget, 0.1f);
+	CHECK(row.size() == 8);
+	for(unsigned int i = 0; i < row.size(); i++)
+		CHECK(row[i] == i);
+
+	//the same view down the last column
+	float columnEye[3] = { 120.0f, 0.0f, 140.0f }, columnTarget[3] = { 120.0f, 0.0f, -100.0f };
+	std::vector<unsigned int> column = UpdateVisible(terrain, columnEye, columnTarget, 0.1f);
+	CHECK(column.size() == 8);
+	for(unsigned int i = 0; i < column.size(); i++)
+		CHECK(column[i] == 7 + i * 8);
+}
+
+TERRAIN_TEST(CoreUpdateMatchesBoxTests)
+{
+	//without horizon culling Update draws exactly the patches whose bounds
+	//touch the frustum
+	Terrain terrain;
+	CHECK(BuildHills(terrain, 129, 16));
+	terrain.GetCuller().SetHorizonCulling(false);
+
+	static const float poses[][6] =
+	{
+		{ 64.0f, 60.0f, -40.0f,		64.0f, 0.0f, 64.0f },
+		{ 10.0f, 30.0f, 10.0f,		120.0f, 0.0f, 90.0f },
+		{ 64.0f, 5.0f, 64.0f,		0.0f, 10.0f, 64.0f },
+		{ 200.0f, 80.0f, 200.0f,	100.0f, 0.0f, 110.0f },
+		{ -50.0f, 20.0f, 64.0f,		0.0f, 20.0f, 64.0f },
+	};
+
+	const TerrainQuadTree &tree = terrain.GetQuadTree();
+	for(unsigned int p = 0; p < sizeof(poses) / sizeof(poses[0]); p++)
+	{
+		Frustum frustum;
+		CHECK(TerrainTest::LookAt(poses[p], poses[p] + 3, FOV, frustum));
+		std::vector<unsigned int> expected;
+		for(unsigned int i = 0; i < tree.GetPatchCount(); i++)
+		{
+			if(frustum.TestBox(tree.GetPatch(i).bounds))
+				expected.push_back(i);
+		}
+
+		std::vector<unsigned int> visible = UpdateVisible(terrain, poses[p], poses[p] + 3);
+		CHECK(!expected.empty());
+		CHECK(visible == expected);
+	}
+}
+
+TERRAIN_TEST(CoreUpdateUnbuilt)
+{
+	Terrain terrain;
+	float eye[3] = { 0.0f, 10.0f, -10.0f }, target[3] = { 0.0f, 0.0f, 0.0f };
+	Frustum frustum;
+	CHECK(TerrainTest::LookAt(eye, target, FOV, frustum));
+	CHECK(!terrain.IsLoaded());
+	CHECK(terrain.Update(frustum, eye, 300.0f) == 0);
+}
@@ -0,0 +1,184 @@
+///============================================================================
+///@file	TestCuller.cpp
+///@brief	Patch culling: the four-wide plane tests against a scalar per
+///			plane reference, and the exact visible and occluded sets of
+///			known camera poses, horizon occlusion behind a ridge included.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "TerrainTest.h"
+#include "Terrain.h"
+
+#include <math.h>
+#include <vector>
+
+static const float FOV = 3.14159265f / 4.0f;	///> Vertical field of view of the test cameras
+
+///----------------------------------------------------------------------------
+///Scalar reference of TerrainCuller::TestFrustum: the center distance plus
+///the projected half size against each plane in turn
+///----------------------------------------------------------------------------
+static bool InFrustumScalar(const Frustum &frustum, const BoundingBox &box)
+{
+	float cx = (box.minX + box.maxX) * 0.5f, ex = (box.maxX - box.minX) * 0.5f;
+	float cy = (box.minY + box.maxY) * 0.5f, ey = (box.maxY - box.minY) * 0.5f;
+	float cz = (box.minZ + box.maxZ) * 0.5f, ez = (box.maxZ - box.minZ) * 0.5f;
+
+	for(int p = 0; p < Frustum::PLANE_COUNT; p++)
+	{
+		const Plane &plane = frustum.GetPlane(p);
+		float d = (plane.a * cx + plane.b * cy) + (plane.c * cz + plane.d);
+		float r = (fabsf(plane.a) * ex + fabsf(plane.b) * ey) + fabsf(plane.c) * ez;
+		if(d + r < 0.0f)
+			return false;
+	}
+
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Culls with a camera at eye looking at target, front to back set
+///----------------------------------------------------------------------------
+static std::vector<unsigned int> CullPose(Terrain &terrain, const float *eye, const float *target)
+{
+	Frustum frustum;
+	std::vector<unsigned int> visible;
+	CHECK(TerrainTest::LookAt(eye, target, FOV, frustum));
+	terrain.GetCuller().Cull(frustum, eye, visible);
+	return visible;
+}
+
+///----------------------------------------------------------------------------
+///129 x 17 strip of 8 patches of 16 along x, flat at 0 with an optional
+///ridge 40 units high across the second patch
+///----------------------------------------------------------------------------
+static bool BuildStrip(Terrain &terrain, bool ridge)
+{
+	HeightField &field = terrain.GetHeightField();
+	if(!field.Create(129, 17, HEIGHT_UINT8))
+		return false;
+	field.SetVerticalScale(1.0f);
+
+	if(ridge)
+	{
+		for(unsigned int z = 0; z < 17; z++)
+			for(unsigned int x = 17; x < 32; x++)
+				field.SetElevation(x, z, 40.0f);
+	}
+
+	return terrain.Build(16);
+}
+
+TERRAIN_TEST(CullerPlanesMatchScalar)
+{
+	//7 x 5 patches: 35 is not a multiple of four, the last group is padded
+	Terrain terrain;
+	HeightField &field = terrain.GetHeightField();
+	CHECK(field.Create(113, 81, HEIGHT_UINT8));
+	for(unsigned int z = 0; z < 81; z++)
+		for(unsigned int x = 0; x < 113; x++)
+			field.SetElevation(x, z, (float)((x * x + z * 3) % 97) * field.GetVerticalScale());
+	CHECK(terrain.Build(16));
+	CHECK(terrain.GetQuadTree().GetPatchCount() == 35);
+
+	const TerrainQuadTree &tree = terrain.GetQuadTree();
+	TerrainCuller &culler = terrain.GetCuller();
+	unsigned int partial = 0;
+
+	//poses orbiting the map at several heights and distances
+	for(unsigned int i = 0; i < 256; i++)
+	{
+		float angle = i * 0.37f, radius = 20.0f + (i % 7) * 25.0f;
+		float eye[3] = { 56.0f + radius * cosf(angle), 2.0f + (i % 5) * 15.0f, 40.0f + radius * sinf(angle) };
+		float target[3] = { 56.0f + (float)(i % 11) * 8.0f - 40.0f, 0.0f, 40.0f + (float)(i % 13) * 6.0f - 36.0f };
+
+		Frustum frustum;
+		if(!TerrainTest::LookAt(eye, target, FOV, frustum))
+			continue;
+
+		std::vector<unsigned int> visible, expected;
+		culler.Cull(frustum, visible);
+		for(unsigned int p = 0; p < tree.GetPatchCount(); p++)
+		{
+			bool inside = InFrustumScalar(frustum, tree.GetPatch(p).bounds);
+			CHECK(inside == frustum.TestBox(tree.GetPatch(p).bounds));
+			if(inside)
+				expected.push_back(p);
+		}
+
+		CHECK(visible == expected);
+		CHECK(culler.GetFrustumCulledCount() == tree.GetPatchCount() - expected.size());
+		CHECK(culler.GetHorizonCulledCount() == 0);
+		if(!expected.empty() && expected.size() < tree.GetPatchCount())
+			partial++;
+	}
+
+	//the poses must exercise both outcomes
+	CHECK(partial > 64);
+}
+
+TERRAIN_TEST(CullerKnownPoses)
+{
+	Terrain terrain;
+	CHECK(BuildStrip(terrain, false));
+
+	//down the strip from its near end: every patch, nearest first
+	float eye[3] = { 4.0f, 3.0f, 8.0f }, ahead[3] = { 128.0f, 0.0f, 8.0f };
+	std::vector<unsigned int> visible = CullPose(terrain, eye, ahead);
+	CHECK(visible.size() == 8);
+	for(unsigned int i = 0; i < visible.size(); i++)
+		CHECK(visible[i] == i);
+	CHECK(terrain.GetCuller().GetFrustumCulledCount() == 0);
+	CHECK(terrain.GetCuller().GetHorizonCulledCount() == 0);
+
+	//turned around near the far end: the last patch is behind the eye and
+	//the ground of the one under it is below the view
+	float back[3] = { 100.0f, 3.0f, 8.0f }, toward[3] = { 0.0f, 0.0f, 8.0f };
+	visible = CullPose(terrain, back, toward);
+	CHECK(visible.size() == 6);
+	for(unsigned int i = 0; i < visible.size(); i++)
+		CHECK(visible[i] == 5 - i);
+	CHECK(terrain.GetCuller().GetFrustumCulledCount() == 2);
+
+	//looking off the side of the strip
+	float side[3] = { 64.0f, 3.0f, 200.0f };
+	visible = CullPose(terrain, eye, side);
+	CHECK(visible.size() == 1 && visible[0] == 0);
+	CHECK(terrain.GetCuller().GetFrustumCulledCount() == 7);
+}
+
+TERRAIN_TEST(CullerHorizonBehindRidge)
+{
+	Terrain terrain;
+	CHECK(BuildStrip(terrain, true));
+
+	//at eye level the ridge hides everything past it
+	float eye[3] = { 4.0f, 3.0f, 8.0f }, ahead[3] = { 128.0f, 0.0f, 8.0f };
+	std::vector<unsigned int> visible = CullPose(terrain, eye, ahead);
+	CHECK(visible.size() == 2 && visible[0] == 0 && visible[1] == 1);
+	CHECK(terrain.GetCuller().GetFrustumCulledCount() == 0);
+	CHECK(terrain.GetCuller().GetHorizonCulledCount() == 6);
+
+	//without the horizon pass the same patches all pass the frustum
+	terrain.GetCuller().SetHorizonCulling(false);
+	visible = CullPose(terrain, eye, ahead);
+	CHECK(visible.size() == 8);
+	CHECK(terrain.GetCuller().GetHorizonCulledCount() == 0);
+	terrain.GetCuller().SetHorizonCulling(true);
+
+	//high above the ridge the far patches come back in view
+	float above[3] = { 4.0f, 400.0f, 8.0f };
+	visible = CullPose(terrain, above, ahead);
+	CHECK(visible.size() == 8);
+	CHECK(terrain.GetCuller().GetHorizonCulledCount() == 0);
+
+	//from the far end the ridge hides the first patch only
+	float beyond[3] = { 124.0f, 3.0f, 8.0f }, toward[3] = { 0.0f, 0.0f, 8.0f };
+	visible = CullPose(terrain, beyond, toward);
+	CHECK(visible.size() == 7);
+	for(unsigned int i = 0; i < visible.size(); i++)
+		CHECK(visible[i] == 7 - i);
+	CHECK(terrain.GetCuller().GetFrustumCulledCount() == 0);
+	CHECK(terrain.GetCuller().GetHorizonCulledCount() == 1);
+}
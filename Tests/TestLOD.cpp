@@ -0,0 +1,184 @@
+///============================================================================
+///@file	TestLOD.cpp
+///@brief	Geomipmap stitching: along every shared edge the vertices one
+///			patch emits must be the ones its neighbor emits, for every level
+///			pair and all 16 stitch masks, and for the levels and masks
+///			Select picks on a small map.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "TerrainTest.h"
+#include "Terrain.h"
+
+#include <math.h>
+#include <set>
+#include <vector>
+
+static const unsigned int PATCH_SIZE = 16;	///> Quads per patch side of the test maps
+
+//-------------------------------------------------------------------------
+//Edges as STITCH_* bits, the opposite edge and where their vertices are
+//-------------------------------------------------------------------------
+static const unsigned int EDGES[4] = { STITCH_NEG_Z, STITCH_POS_X, STITCH_POS_Z, STITCH_NEG_X };
+static const unsigned int OPPOSITE[4] = { STITCH_POS_Z, STITCH_NEG_X, STITCH_NEG_Z, STITCH_POS_X };
+
+///----------------------------------------------------------------------------
+///Returns the positions along an edge (x for z edges, z for x edges) of the
+///vertices an index set references on it
+///----------------------------------------------------------------------------
+static std::set<unsigned int> GetEdgeVertices(const unsigned int *indices, const IndexRange &range, unsigned int edge)
+{
+	std::set<unsigned int> positions;
+	unsigned int pitch = PATCH_SIZE + 1;
+	for(unsigned int i = range.first; i < range.first + range.count; i++)
+	{
+		unsigned int x = indices[i] % pitch, z = indices[i] / pitch;
+		if(edge == STITCH_NEG_Z && z == 0)					positions.insert(x);
+		else if(edge == STITCH_POS_Z && z == PATCH_SIZE)	positions.insert(x);
+		else if(edge == STITCH_NEG_X && x == 0)				positions.insert(z);
+		else if(edge == STITCH_POS_X && x == PATCH_SIZE)	positions.insert(z);
+	}
+	return positions;
+}
+
+///----------------------------------------------------------------------------
+///Builds a terrain of hills on a map of size x size samples, and its index
+///sets of every level and stitch mask
+///----------------------------------------------------------------------------
+static bool BuildHills(Terrain &terrain, unsigned int size, std::vector<unsigned int> &indices)
+{
+	HeightField &field = terrain.GetHeightField();
+	if(!field.Create(size, size, HEIGHT_UINT8))
+		return false;
+
+	field.SetVerticalScale(0.5f);
+	for(unsigned int z = 0; z < size; z++)
+		for(unsigned int x = 0; x < size; x++)
+			field.SetElevation(x, z, 40.0f + 30.0f * sinf(x * 0.13f) * cosf(z * 0.09f) + 8.0f * sinf((x * 3 + z) * 0.4f));
+
+	if(!terrain.Build(PATCH_SIZE))
+		return false;
+
+	const TerrainLOD &lod = terrain.GetLOD();
+	indices.resize(lod.GetIndexCount());
+	lod.BuildIndices(&indices[0]);
+	return true;
+}
+
+TERRAIN_TEST(LODStitchEveryMask)
+{
+	Terrain terrain;
+	std::vector<unsigned int> indices;
+	CHECK(BuildHills(terrain, 65, indices));
+	const TerrainLOD &lod = terrain.GetLOD();
+	CHECK(lod.GetLevelCount() >= 3);
+
+	//a patch at level l next to a neighbor at l (edge not stitched) or at
+	//l + 1 (edge stitched); the neighbor's other edges may carry any mask
+	unsigned int pairs = 0, cracks = 0;
+	for(unsigned int level = 0; level + 1 < lod.GetLevelCount(); level++)
+	{
+		for(unsigned int mask = 0; mask < TerrainLOD::STITCH_VARIANTS; mask++)
+		{
+			const IndexRange &range = lod.GetIndexRange(level, mask);
+			for(unsigned int e = 0; e < 4; e++)
+			{
+				std::set<unsigned int> mine = GetEdgeVertices(&indices[0], range, EDGES[e]);
+				unsigned int neighborLevel = (mask & EDGES[e]) ? level + 1 : level;
+
+				for(unsigned int other = 0; other < TerrainLOD::STITCH_VARIANTS; other++)
+				{
+					//the neighbor is never coarser than it is across this edge
+					if(other & OPPOSITE[e])
+						continue;
+
+					const IndexRange &theirs = lod.GetIndexRange(neighborLevel, other);
+					if(GetEdgeVertices(&indices[0], theirs, OPPOSITE[e]) != mine)
+						cracks++;
+					pairs++;
+				}
+			}
+		}
+	}
+
+	CHECK(pairs > 0);
+	CHECK(cracks == 0);
+
+	//the stitched edge drops to the coarser spacing, the others keep their own
+	std::set<unsigned int> fine = GetEdgeVertices(&indices[0], lod.GetIndexRange(1, 0), STITCH_NEG_Z);
+	std::set<unsigned int> stitched = GetEdgeVertices(&indices[0], lod.GetIndexRange(1, STITCH_NEG_Z), STITCH_NEG_Z);
+	CHECK(fine.size() == PATCH_SIZE / 2 + 1);
+	CHECK(stitched.size() == PATCH_SIZE / 4 + 1);
+}
+
+TERRAIN_TEST(LODSelectMixedLevels)
+{
+	//129 x 129 map of 8 x 8 patches seen from a corner, the middle and an
+	//edge at a few error scales: near patches fine, far ones coarse
+	Terrain terrain;
+	std::vector<unsigned int> indices;
+	CHECK(BuildHills(terrain, 129, indices));
+	const TerrainQuadTree &tree = terrain.GetQuadTree();
+	TerrainLOD lod;
+	CHECK(lod.Build(tree, terrain.GetHeightField()));
+	unsigned int countX = tree.GetPatchCountX(), countZ = tree.GetPatchCountZ();
+
+	static const float eyes[][3] = { { 2.0f, 45.0f, 2.0f }, { 64.0f, 60.0f, 64.0f }, { 130.0f, 42.0f, 20.0f } };
+	static const float errorScales[] = { 2.0f, 8.0f, 30.0f };
+	std::set<unsigned int> seen;
+	unsigned int mixed = 0, stitchedEdges = 0, cracks = 0, steps = 0, masks = 0;
+
+	for(unsigned int e = 0; e < sizeof(eyes) / sizeof(eyes[0]); e++)
+	{
+		for(unsigned int s = 0; s < sizeof(errorScales) / sizeof(errorScales[0]); s++)
+		{
+			lod.Select(eyes[e], errorScales[s], TerrainLOD::DEFAULT_PIXEL_ERROR);
+
+			std::set<unsigned int> levels;
+			for(unsigned int pz = 0; pz < countZ; pz++)
+			{
+				for(unsigned int px = 0; px < countX; px++)
+				{
+					unsigned int i = px + pz * countX;
+					unsigned int level = lod.GetPatchLevel(i), mask = lod.GetPatchStitch(i);
+					levels.insert(level);
+					seen.insert(mask);
+
+					//neighbors across +x and +z: at most a level apart, the
+					//finer one stitched, and the same vertices on the edge
+					for(unsigned int d = 0; d < 2; d++)
+					{
+						if((d == 0 && px + 1 >= countX) || (d == 1 && pz + 1 >= countZ))
+							continue;
+
+						unsigned int j = d == 0 ? i + 1 : i + countX;
+						unsigned int edge = d == 0 ? STITCH_POS_X : STITCH_POS_Z;
+						unsigned int opposite = d == 0 ? STITCH_NEG_X : STITCH_NEG_Z;
+						unsigned int other = lod.GetPatchLevel(j), otherMask = lod.GetPatchStitch(j);
+
+						steps += (level > other + 1 || other > level + 1) ? 1 : 0;
+						masks += (((mask & edge) != 0) != (other > level)) ? 1 : 0;
+						masks += (((otherMask & opposite) != 0) != (level > other)) ? 1 : 0;
+						stitchedEdges += (level != other) ? 1 : 0;
+
+						std::set<unsigned int> a = GetEdgeVertices(&indices[0], lod.GetIndexRange(level, mask), edge);
+						std::set<unsigned int> b = GetEdgeVertices(&indices[0], lod.GetIndexRange(other, otherMask), opposite);
+						cracks += (a != b) ? 1 : 0;
+					}
+				}
+			}
+
+			mixed += (levels.size() >= 3) ? 1 : 0;
+		}
+	}
+
+	CHECK(steps == 0);
+	CHECK(masks == 0);
+	CHECK(cracks == 0);
+	CHECK(stitchedEdges > 0);
+	CHECK(mixed > 0);
+
+	//LODStitchEveryMask covers the masks a selection never picks
+	CHECK(seen.size() >= 8);
+}
@@ -0,0 +1,116 @@
+///============================================================================
+///@file	TestMesh.cpp
+///@brief	Patch vertices: the 16-bit packed vertices decoded back must be
+///			what BuildPatchVertices writes, colors included, for 8-bit and
+///			16-bit maps over their type range or a .hdr sample range.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "TerrainTest.h"
+#include "Terrain.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+static const unsigned int PATCH_SIZE = 8;	///> Quads per patch side of the test maps
+
+///----------------------------------------------------------------------------
+///Builds every patch of a map both ways and counts the vertices that
+///differ; float heights may be off by maxError and shades by one level
+///----------------------------------------------------------------------------
+static unsigned int CountDecodeMismatches(const HeightField &field, float maxError)
+{
+	TerrainQuadTree tree;
+	CHECK(tree.Build(field, PATCH_SIZE));
+
+	unsigned int count = (PATCH_SIZE + 1) * (PATCH_SIZE + 1), wrong = 0;
+	std::vector<Vertex3D> built(count), decoded(count);
+	std::vector<PackedVertex> packed(count);
+
+	for(unsigned int simd = 0; simd < 2; simd++)
+	{
+		TerrainMesh::EnableSIMD(simd != 0);
+		for(unsigned int p = 0; p < tree.GetPatchCount(); p++)
+		{
+			const TerrainPatch &patch = tree.GetPatch(p);
+			TerrainMesh::BuildPatchVertices(field, patch, PATCH_SIZE, &built[0]);
+			TerrainMesh::BuildPackedPatchVertices(field, patch, PATCH_SIZE, &packed[0]);
+			TerrainMesh::DecodePatchVertices(field, patch, &packed[0], count, &decoded[0]);
+
+			for(unsigned int i = 0; i < count; i++)
+			{
+				const Vertex3D &a = built[i], &b = decoded[i];
+				int shade = (int)(a.color & 0xFF) - (int)(b.color & 0xFF);
+				bool same = a.x == b.x && a.z == b.z && (a.color & 0xFF000000) == (b.color & 0xFF000000);
+				if(maxError > 0.0f)
+					same = same && fabsf(a.y - b.y) <= maxError && shade >= -1 && shade <= 1;
+				else
+					same = same && a.y == b.y && a.color == b.color;
+				wrong += same ? 0 : 1;
+			}
+		}
+	}
+
+	TerrainMesh::EnableSIMD(true);
+	return wrong;
+}
+
+///----------------------------------------------------------------------------
+///Fills a map with a ramp over samples low..high
+///----------------------------------------------------------------------------
+static void FillRamp(HeightField &field, float low, float high)
+{
+	unsigned int w = field.GetWidth(), h = field.GetHeight();
+	for(unsigned int z = 0; z < h; z++)
+	{
+		for(unsigned int x = 0; x < w; x++)
+		{
+			float t = (float)((x * 5 + z * 11) % (w + h)) / (float)(w + h - 1);
+			field.SetElevation(x, z, (low + (high - low) * t) * field.GetVerticalScale() + field.GetVerticalOffset());
+		}
+	}
+}
+
+TERRAIN_TEST(MeshPackedDecodeTypeRange)
+{
+	HeightField field;
+	CHECK(field.Create(33, 25, HEIGHT_UINT8));
+	FillRamp(field, 0.0f, 255.0f);
+	CHECK(CountDecodeMismatches(field, 0.0f) == 0);
+
+	CHECK(field.Create(33, 25, HEIGHT_UINT16));
+	field.SetVerticalScale(0.01f, -20.0f);
+	FillRamp(field, 0.0f, 65535.0f);
+	CHECK(CountDecodeMismatches(field, 0.0f) == 0);
+}
+
+TERRAIN_TEST(MeshPackedDecodeSampleRange)
+{
+	//17 x 17 16-bit samples 1000..5000, shaded over that range by the .hdr
+	std::vector<unsigned short> samples(17 * 17);
+	for(unsigned int i = 0; i < samples.size(); i++)
+		samples[i] = (unsigned short)(1000 + (i * 37) % 4001);
+	const char header[] = "width 17\nheight 17\nbits 16\nendian little\nmin 1000\nmax 5000\n";
+	CHECK(TerrainTest::WriteFile("test_mesh_range.raw", &samples[0], (unsigned int)samples.size() * 2));
+	CHECK(TerrainTest::WriteFile("test_mesh_range.raw.hdr", header, sizeof(header) - 1));
+
+	HeightField field;
+	CHECK(field.Load("test_mesh_range.raw"));
+	float low, high;
+	field.GetSampleRange(low, high);
+	CHECK(low == 1000.0f && high == 5000.0f);
+	CHECK(field.GetSample8(0, 0) != (unsigned char)(field.GetSample(0, 0) >> 8));
+	CHECK(CountDecodeMismatches(field, 0.0f) == 0);
+	field.Release();
+
+	//float samples come back quantized
+	CHECK(field.Create(33, 25, HEIGHT_FLOAT32));
+	FillRamp(field, -40.0f, 300.0f);
+	field.UpdateSampleRange();
+	CHECK(CountDecodeMismatches(field, 340.0f * field.GetVerticalScale() / 65535.0f) == 0);
+
+	remove("test_mesh_range.raw");
+	remove("test_mesh_range.raw.hdr");
+}
@@ -0,0 +1,203 @@
+///============================================================================
+///@file	TestPackage.cpp
+///@brief	Terrain packages: heightmap.raw and synthetic maps packed, mapped
+///			back and compared sample by sample tile by tile, and damaged
+///			packages rejected: cut inside the header, the tile table or a
+///			payload; a wrong magic, version, file size, format, tile size,
+///			tile count or width; a tile entry running past the end of the
+///			file, which only loses that tile.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "TerrainTest.h"
+#include "TerrainPackage.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+///----------------------------------------------------------------------------
+///Reads a whole file
+///----------------------------------------------------------------------------
+static std::vector<unsigned char> ReadFile(const char *filename)
+{
+	std::vector<unsigned char> data;
+	FILE *f = fopen(filename, "rb");
+	if(!f) return data;
+
+	unsigned char block[4096];
+	size_t bytes;
+	while((bytes = fread(block, 1, sizeof(block), f)) > 0)
+		data.insert(data.end(), block, block + bytes);
+	fclose(f);
+	return data;
+}
+
+///----------------------------------------------------------------------------
+///Packs a map, opens the package and compares every sample of every tile
+///with the map, tiles sharing their border samples
+///----------------------------------------------------------------------------
+static void CheckRoundTrip(const HeightField &field, const char *filename, unsigned int tileSize, PackageCodec codec)
+{
+	CHECK(TerrainPackage::Write(field, filename, tileSize, codec));
+	CHECK(TerrainPackage::IsPackage(filename));
+
+	TerrainPackage package;
+	CHECK(package.Open(filename));
+	if(!package.IsOpen()) return;
+
+	CHECK(package.GetWidth() == field.GetWidth() && package.GetHeight() == field.GetHeight());
+	CHECK(package.GetFormat() == field.GetFormat());
+	CHECK(package.GetTileSize() == tileSize);
+	CHECK(package.GetTilesX() == (field.GetWidth() - 2) / tileSize + 1);
+	CHECK(package.GetTilesZ() == (field.GetHeight() - 2) / tileSize + 1);
+
+	unsigned int wrong = 0, tiles = 0;
+	for(unsigned int tz = 0; tz < package.GetTilesZ(); tz++)
+	{
+		for(unsigned int tx = 0; tx < package.GetTilesX(); tx++)
+		{
+			unsigned int x0 = tx * tileSize, z0 = tz * tileSize;
+			unsigned int width = (field.GetWidth() - x0 < tileSize + 1) ? field.GetWidth() - x0 : tileSize + 1;
+			unsigned int height = (field.GetHeight() - z0 < tileSize + 1) ? field.GetHeight() - z0 : tileSize + 1;
+
+			const TerrainPackageTile *info = package.GetTileInfo(tx, tz);
+			CHECK(info != NULL);
+			if(!info) continue;
+			CHECK(info->width == width && info->height == height);
+			CHECK(info->codec == (unsigned int)codec || info->codec == PACKAGE_RAW);
+			CHECK((package.GetTileData(tx, tz) != NULL) == (info->codec == PACKAGE_RAW));
+
+			HeightField samples;
+			CHECK(package.GetTile(tx, tz, samples));
+			if(samples.GetWidth() != width || samples.GetHeight() != height)
+			{
+				wrong++;
+				continue;
+			}
+
+			float low = info->maxHeight, high = info->minHeight;
+			for(unsigned int z = 0; z < height; z++)
+			{
+				for(unsigned int x = 0; x < width; x++)
+				{
+					float elevation = field.GetElevation(x0 + x, z0 + z);
+					wrong += (samples.GetValue(x, z) != field.GetValue(x0 + x, z0 + z));
+					wrong += (samples.GetElevation(x, z) != elevation);
+					low = (elevation < low) ? elevation : low;
+					high = (elevation > high) ? elevation : high;
+				}
+			}
+
+			CHECK(low == info->minHeight && high == info->maxHeight);
+			tiles++;
+		}
+	}
+
+	CHECK(tiles == package.GetTilesX() * package.GetTilesZ());
+	CHECK(wrong == 0);
+	package.Close();
+	CHECK(!package.IsOpen());
+}
+
+TERRAIN_TEST(PackageRoundTripHeightmap)
+{
+	//the map the viewer ships with, copied to the build tree
+	HeightField field;
+	CHECK(field.Load("heightmap.raw"));
+	if(!field.GetData()) return;
+
+	CheckRoundTrip(field, "test_package_heightmap.tpk", 16, PACKAGE_RAW);
+	CheckRoundTrip(field, "test_package_heightmap.tpk", 64, PACKAGE_RAW);
+	if(TerrainPackage::HasCodec(PACKAGE_DEFLATE))
+		CheckRoundTrip(field, "test_package_heightmap.tpk", 16, PACKAGE_DEFLATE);
+
+	remove("test_package_heightmap.tpk");
+}
+
+TERRAIN_TEST(PackageRoundTripFormats)
+{
+	//not square, partial tiles along both edges
+	static const HeightFormat formats[] = { HEIGHT_UINT8, HEIGHT_UINT16, HEIGHT_FLOAT32 };
+	for(unsigned int f = 0; f < sizeof(formats) / sizeof(formats[0]); f++)
+	{
+		HeightField field;
+		CHECK(field.Create(100, 37, formats[f]));
+		field.SetVerticalScale(0.25f, -3.0f);
+		for(unsigned int z = 0; z < 37; z++)
+			for(unsigned int x = 0; x < 100; x++)
+				field.SetElevation(x, z, (float)((x * 31 + z * 17) % 200) * 0.25f - 3.0f);
+
+		CheckRoundTrip(field, "test_package_formats.tpk", 16, PACKAGE_RAW);
+		CheckRoundTrip(field, "test_package_formats.tpk", 7, PACKAGE_RAW);
+		if(TerrainPackage::HasCodec(PACKAGE_DEFLATE))
+			CheckRoundTrip(field, "test_package_formats.tpk", 16, PACKAGE_DEFLATE);
+	}
+
+	remove("test_package_formats.tpk");
+}
+
+TERRAIN_TEST(PackageRejectsDamage)
+{
+	HeightField field;
+	CHECK(field.Create(65, 65, HEIGHT_UINT8));
+	CHECK(TerrainPackage::Write(field, "test_package_good.tpk", 16));
+	std::vector<unsigned char> good = ReadFile("test_package_good.tpk");
+	CHECK(good.size() > sizeof(TerrainPackageHeader));
+	if(good.size() <= sizeof(TerrainPackageHeader)) return;
+
+	TerrainPackage package;
+	const char *damaged = "test_package_damaged.tpk";
+
+	//cut anywhere: inside the header, inside the table, inside a payload
+	const size_t cuts[] = { 0, 8, sizeof(TerrainPackageHeader) - 1, sizeof(TerrainPackageHeader) + 10, good.size() / 2, good.size() - 1 };
+	for(unsigned int i = 0; i < sizeof(cuts) / sizeof(cuts[0]); i++)
+	{
+		CHECK(TerrainTest::WriteFile(damaged, &good[0], (unsigned int)cuts[i]));
+		CHECK(!package.Open(damaged));
+		CHECK(!package.IsOpen());
+	}
+
+	//header fields that do not add up
+	for(unsigned int field = 0; field < 7; field++)
+	{
+		std::vector<unsigned char> bad(good);
+		TerrainPackageHeader *header = (TerrainPackageHeader*)&bad[0];
+		switch(field)
+		{
+		case 0: header->magic = 0x4B415055; break;
+		case 1: header->version = TerrainPackage::TERRAIN_PACKAGE_VERSION + 1; break;
+		case 2: header->fileSize += 1; break;
+		case 3: header->format = 3; break;
+		case 4: header->tileSize = 0; break;
+		case 5: header->tilesX += 1; break;
+		case 6: header->width = 1; break;
+		}
+
+		CHECK(TerrainTest::WriteFile(damaged, &bad[0], (unsigned int)bad.size()));
+		CHECK(!package.Open(damaged));
+		CHECK(!package.IsOpen());
+	}
+	CHECK(!TerrainPackage::IsPackage("test_package_missing.tpk"));
+
+	//a tile entry pointing past the end opens, but that tile is refused
+	std::vector<unsigned char> bad(good);
+	TerrainPackageTile *tiles = (TerrainPackageTile*)(&bad[0] + sizeof(TerrainPackageHeader));
+	tiles[5].offset = bad.size() - 4;
+	CHECK(TerrainTest::WriteFile(damaged, &bad[0], (unsigned int)bad.size()));
+	CHECK(package.Open(damaged));
+	HeightField samples;
+	CHECK(package.GetTileInfo(1, 1) == NULL);
+	CHECK(!package.GetTile(1, 1, samples));
+	CHECK(package.GetTileInfo(0, 1) != NULL);
+	CHECK(package.GetTile(0, 1, samples));
+	package.Close();
+
+	//the untouched bytes still open
+	CHECK(package.Open("test_package_good.tpk"));
+	package.Close();
+
+	remove("test_package_good.tpk");
+	remove(damaged);
+}
@@ -0,0 +1,305 @@
+///============================================================================
+///@file	TestQuery.cpp
+///@brief	Surface queries: rays walked through the min/max pyramid against
+///			a fine brute force march over GetHeight, line of sight across
+///			a ridge, and the pyramid refit by UpdateRegion after an edit
+///			across a block border against a fresh Build.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "TerrainTest.h"
+#include "Terrain.h"
+
+#include <math.h>
+#include <vector>
+
+static const float MARCH_STEP = 0.01f;		///> Brute force step in cells along x,z
+static const float GRAZING = 0.02f;			///> Closest approach treated as ambiguous
+
+///----------------------------------------------------------------------------
+///Small deterministic generator, 0..1
+///----------------------------------------------------------------------------
+static float Random(unsigned int &state)
+{
+	state = state * 1664525u + 1013904223u;
+	return (float)(state >> 8) / 16777216.0f;
+}
+
+///----------------------------------------------------------------------------
+///Fills a terrain with smooth hills and a few sharp steps
+///----------------------------------------------------------------------------
+static bool BuildHills(Terrain &terrain, unsigned int size)
+{
+	HeightField &field = terrain.GetHeightField();
+	if(!field.Create(size, size, HEIGHT_FLOAT32))
+		return false;
+
+	field.SetVerticalScale(1.0f);
+	for(unsigned int z = 0; z < size; z++)
+	{
+		for(unsigned int x = 0; x < size; x++)
+		{
+			float h = 12.0f * sinf(x * 0.11f) * cosf(z * 0.07f) + 6.0f * sinf((x + z) * 0.31f);
+			if((x / 13 + z / 17) % 5 == 0)
+				h += 9.0f;
+			field.SetElevation(x, z, h + 20.0f);
+		}
+	}
+
+	if(!terrain.Build(16))
+		return false;
+	terrain.EnableQueries(true);
+	return terrain.GetQuery().IsBuilt();
+}
+
+///----------------------------------------------------------------------------
+///First t where a ray is at or below the surface, marching in small steps
+///and bisecting the crossing. A ray that only touches the surface within
+///GRAZING (passing that close over it, or dipping that little under it) is
+///reported as grazing: the march and the exact walk may disagree on it.
+///@return	the hit t, negative if none
+///----------------------------------------------------------------------------
+static float March(const TerrainQuery &query, const TerrainRay &ray, bool &grazing)
+{
+	float run = sqrtf(ray.direction[0] * ray.direction[0] + ray.direction[2] * ray.direction[2]);
+	float dt = (run > 0.0f) ? MARCH_STEP / run : ray.length / 1000.0f;
+	float previous = -1.0f, hit = -1.0f, clearance = 1e30f, depth = 0.0f;
+
+	for(float t = 0.0f; t <= ray.length + dt; t += dt)
+	{
+		float s = (t < ray.length) ? t : ray.length;
+		float ground;
+		if(!query.GetHeight(ray.origin[0] + ray.direction[0] * s, ray.origin[2] + ray.direction[2] * s, ground))
+			continue;
+
+		float above = ray.origin[1] + ray.direction[1] * s - ground;
+		if(hit >= 0.0f)
+		{
+			//past the hit: how deep the ray goes before it comes out again
+			if(above > 0.0f)
+				break;
+			depth = (-above > depth) ? -above : depth;
+			continue;
+		}
+
+		if(above > 0.0f)
+		{
+			clearance = (above < clearance) ? above : clearance;
+			previous = s;
+			continue;
+		}
+
+		//bisect the crossing (the origins are above the surface)
+		float a = (previous >= 0.0f) ? previous : s, b = s;
+		for(unsigned int i = 0; i < 40; i++)
+		{
+			float m = (a + b) * 0.5f;
+			query.GetHeight(ray.origin[0] + ray.direction[0] * m, ray.origin[2] + ray.direction[2] * m, ground);
+			if(ray.origin[1] + ray.direction[1] * m > ground)
+				a = m;
+			else
+				b = m;
+		}
+		hit = b;
+		depth = -above;
+	}
+
+	grazing = (hit >= 0.0f) ? depth < GRAZING : clearance < GRAZING;
+	return hit;
+}
+
+TERRAIN_TEST(QueryRaycastMatchesMarch)
+{
+	Terrain terrain;
+	CHECK(BuildHills(terrain, 97));
+	const TerrainQuery &query = terrain.GetQuery();
+	CHECK(query.GetLevelCount() > 1);
+
+	//rays from above the highest hill (47), steep and shallow, many of them
+	//leaving the map before they come down
+	const unsigned int count = 4000;
+	std::vector<TerrainRay> rays(count);
+	unsigned int state = 12345;
+	for(unsigned int i = 0; i < count; i++)
+	{
+		TerrainRay &ray = rays[i];
+		ray.origin[0] = Random(state) * 96.0f;
+		ray.origin[1] = 48.0f + Random(state) * 30.0f;
+		ray.origin[2] = Random(state) * 96.0f;
+		float angle = Random(state) * 6.2831853f;
+		ray.direction[0] = cosf(angle);
+		ray.direction[1] = -Random(state) * 1.5f;
+		ray.direction[2] = sinf(angle);
+		ray.length = 20.0f + Random(state) * 120.0f;
+	}
+
+	std::vector<TerrainHit> hits(count);
+	unsigned int hitCount = query.Raycast(&rays[0], count, &hits[0]);
+
+	unsigned int hitsMarched = 0, grazing = 0, wrong = 0, far = 0, offSurface = 0;
+	for(unsigned int i = 0; i < count; i++)
+	{
+		const TerrainRay &ray = rays[i];
+		bool touch;
+		float t = March(query, ray, touch);
+		hitsMarched += (t >= 0.0f) ? 1 : 0;
+
+		//the march can step over a contact thinner than its step, and
+		//rounding decides a touch; neither is a disagreement
+		if(touch)
+		{
+			grazing++;
+			continue;
+		}
+
+		if((t >= 0.0f) != (hits[i].t >= 0.0f))
+		{
+			wrong++;
+			continue;
+		}
+		if(t < 0.0f)
+			continue;
+
+		float scale = sqrtf(ray.direction[0] * ray.direction[0] + ray.direction[1] * ray.direction[1] +
+							ray.direction[2] * ray.direction[2]);
+		if(fabsf(hits[i].t - t) * scale > 0.01f)
+			far++;
+
+		float ground, normal[3];
+		float x = hits[i].position[0] < 0.0f ? 0.0f : (hits[i].position[0] > 96.0f ? 96.0f : hits[i].position[0]);
+		float z = hits[i].position[2] < 0.0f ? 0.0f : (hits[i].position[2] > 96.0f ? 96.0f : hits[i].position[2]);
+		CHECK(query.GetHeight(x, z, ground, normal));
+		if(fabsf(hits[i].position[1] - ground) > 0.01f ||
+		   fabsf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2] - 1.0f) > 1e-4f)
+			offSurface++;
+	}
+
+	CHECK(wrong == 0);
+	CHECK(far == 0);
+	CHECK(offSurface == 0);
+	CHECK(grazing < count / 50);
+
+	//the set must exercise both outcomes
+	CHECK(hitsMarched > count / 5 && hitsMarched < count * 4 / 5);
+	CHECK(hitCount >= hitsMarched - grazing && hitCount <= hitsMarched + grazing);
+}
+
+TERRAIN_TEST(QueryLineOfSightRidge)
+{
+	//flat at 0 with a wall 20 high across x = 40..41
+	Terrain terrain;
+	HeightField &field = terrain.GetHeightField();
+	CHECK(field.Create(81, 81, HEIGHT_UINT8));
+	field.SetVerticalScale(1.0f);
+	for(unsigned int z = 0; z < 81; z++)
+	{
+		field.SetElevation(40, z, 20.0f);
+		field.SetElevation(41, z, 20.0f);
+	}
+	CHECK(terrain.Build(16));
+	terrain.EnableQueries(true);
+	const TerrainQuery &query = terrain.GetQuery();
+
+	float west[3] = { 10.0f, 5.0f, 30.0f }, east[3] = { 70.0f, 5.0f, 50.0f };
+	float westHigh[3] = { 10.0f, 30.0f, 30.0f }, eastHigh[3] = { 70.0f, 30.0f, 50.0f };
+	float westNear[3] = { 30.0f, 2.0f, 70.0f };
+	CHECK(!query.IsVisible(west, east));
+	CHECK(!query.IsVisible(east, west));
+	CHECK(query.IsVisible(westHigh, eastHigh));
+	CHECK(query.IsVisible(west, westNear));
+
+	//just over the crest, and inside the wall
+	float over[3] = { 40.5f, 20.5f, 40.0f }, under[3] = { 40.5f, 19.0f, 10.0f };
+	float overFar[3] = { 70.0f, 20.5f, 40.0f };
+	CHECK(query.IsVisible(over, overFar));
+	CHECK(query.IsVisible(westHigh, over));
+	CHECK(!query.IsVisible(westHigh, under));
+	CHECK(!query.IsVisible(under, eastHigh));
+
+	//the batch agrees with the single tests
+	float from[12], to[12];
+	const float *pairs[4][2] = { { west, east }, { westHigh, eastHigh }, { west, westNear }, { east, west } };
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		for(unsigned int k = 0; k < 3; k++)
+		{
+			from[i * 3 + k] = pairs[i][0][k];
+			to[i * 3 + k] = pairs[i][1][k];
+		}
+	}
+	unsigned char visible[4];
+	CHECK(query.TestLineOfSight(from, to, 4, visible) == 2);
+	CHECK(!visible[0] && visible[1] && visible[2] && !visible[3]);
+}
+
+TERRAIN_TEST(QueryUpdateRegionMatchesBuild)
+{
+	Terrain terrain;
+	CHECK(BuildHills(terrain, 97));
+	const TerrainQuery &query = terrain.GetQuery();
+
+	//a query left as it was before the edit, to show the edit matters
+	TerrainQuery stale;
+	CHECK(stale.Build(terrain.GetHeightField()));
+
+	//a tower over the block border at x = 16 and z = 24
+	CHECK(terrain.EditRect(EDIT_SET, 14, 22, 5, 5, 90.0f));
+	TerrainQuery fresh;
+	CHECK(fresh.Build(terrain.GetHeightField()));
+	CHECK(fresh.GetLevelCount() == query.GetLevelCount());
+	CHECK(fresh.GetSizeInBytes() == query.GetSizeInBytes());
+
+	//level rays at heights only the tower reaches, through every column
+	//and row of it, from both sides
+	unsigned int rays = 0, differ = 0, staleMisses = 0;
+	for(unsigned int i = 0; i <= 12; i++)
+	{
+		for(unsigned int side = 0; side < 4; side++)
+		{
+			float c = 13.0f + i * 0.5f;
+			TerrainRay ray;
+			ray.origin[1] = 60.0f + (i % 4) * 7.0f;
+			ray.direction[1] = 0.0f;
+			ray.length = 96.0f;
+			ray.origin[0] = (side == 0) ? 0.0f : ((side == 1) ? 96.0f : c);
+			ray.origin[2] = (side == 2) ? 0.0f : ((side == 3) ? 96.0f : c + 10.0f);
+			ray.direction[0] = (side == 0) ? 1.0f : ((side == 1) ? -1.0f : 0.0f);
+			ray.direction[2] = (side == 2) ? 1.0f : ((side == 3) ? -1.0f : 0.0f);
+
+			TerrainHit updated, rebuilt, old;
+			bool hit = query.Raycast(ray, updated);
+			CHECK(fresh.Raycast(ray, rebuilt) == hit);
+			if(hit != (rebuilt.t >= 0.0f) || (hit && updated.t != rebuilt.t))
+				differ++;
+			staleMisses += (hit && !stale.Raycast(ray, old)) ? 1 : 0;
+			rays += hit ? 1 : 0;
+		}
+	}
+
+	CHECK(differ == 0);
+	CHECK(rays > 20);
+	CHECK(staleMisses > 0);
+
+	//and the same over the whole map after lowering it again
+	CHECK(terrain.EditBrush(EDIT_RAISE, 16.0f, 24.0f, 6.0f, -70.0f, 1.0f));
+	CHECK(fresh.Build(terrain.GetHeightField()));
+	unsigned int state = 777;
+	for(unsigned int i = 0; i < 500; i++)
+	{
+		TerrainRay ray;
+		ray.origin[0] = Random(state) * 96.0f;
+		ray.origin[1] = 30.0f + Random(state) * 40.0f;
+		ray.origin[2] = Random(state) * 96.0f;
+		ray.direction[0] = Random(state) - 0.5f;
+		ray.direction[1] = -Random(state) * 0.3f;
+		ray.direction[2] = Random(state) - 0.5f;
+		ray.length = 200.0f;
+
+		TerrainHit a, b;
+		bool hitA = query.Raycast(ray, a), hitB = fresh.Raycast(ray, b);
+		if(hitA != hitB || (hitA && a.t != b.t))
+			differ++;
+	}
+	CHECK(differ == 0);
+}
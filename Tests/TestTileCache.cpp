@@ -0,0 +1,114 @@
+///============================================================================
+///@file	TestTileCache.cpp
+///@brief	Tile cache eviction: the resident tiles an Update needs are pinned
+///			before the tiles finished in the background are linked in, so
+///			those evict tiles out of range instead. Tiles of a float map
+///			without a .hdr range share the range of the whole map.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "TerrainTest.h"
+#include "JobSystem.h"
+#include "TerrainTileCache.h"
+
+#include <stdio.h>
+#include <vector>
+
+///----------------------------------------------------------------------------
+///Runs an Update with the camera over the middle of a tile, radius small
+///enough to need that tile only
+///----------------------------------------------------------------------------
+static unsigned int UpdateOver(TerrainTileCache &cache, unsigned int tileX, unsigned int tileZ)
+{
+	float size = (float)cache.GetTileSize();
+	float eye[3] = { (tileX + 0.5f) * size, 50.0f, (tileZ + 0.5f) * size };
+	return cache.Update(eye, 4.0f);
+}
+
+///----------------------------------------------------------------------------
+///Asks for a tile and waits for its background load, then links it in
+///----------------------------------------------------------------------------
+static void Stream(TerrainTileCache &cache, JobSystem &jobs, unsigned int tileX, unsigned int tileZ)
+{
+	UpdateOver(cache, tileX, tileZ);
+	jobs.Wait();
+	CHECK(UpdateOver(cache, tileX, tileZ) == 1);
+}
+
+TERRAIN_TEST(TileCachePinsBeforeDrain)
+{
+	//129 x 129 map in 4 x 4 tiles of 32
+	std::vector<unsigned char> samples(129 * 129);
+	for(size_t i = 0; i < samples.size(); i++)
+		samples[i] = (unsigned char)(i * 7);
+	CHECK(TerrainTest::WriteFile("test_tile_cache.raw", &samples[0], (unsigned int)samples.size()));
+
+	JobSystem jobs;
+	CHECK(jobs.Start(1));
+	TerrainTileCache cache;
+	CHECK(cache.Open("test_tile_cache.raw", 32, 16));
+	cache.SetJobSystem(&jobs);
+	CHECK(cache.GetTilesX() == 4 && cache.GetTilesZ() == 4);
+
+	//room for two tiles: A, then C, leave A least recently used
+	Stream(cache, jobs, 0, 0);
+	cache.SetBudget(cache.GetStats().residentBytes * 2);
+	Stream(cache, jobs, 3, 3);
+	CHECK(cache.GetStats().residentTiles == 2);
+
+	//X finishes loading while the camera is back over A: linking X in must
+	//evict C, not A
+	UpdateOver(cache, 0, 3);
+	jobs.Wait();
+	CHECK(UpdateOver(cache, 0, 0) == 1);
+	CHECK(cache.FindTile(0, 0) != NULL);
+	CHECK(cache.FindTile(0, 3) != NULL);
+	CHECK(cache.FindTile(3, 3) == NULL);
+	CHECK(cache.GetStats().evictions == 1);
+	CHECK(cache.GetStats().residentTiles == 2);
+
+	cache.Close();
+	jobs.Stop();
+	remove("test_tile_cache.raw");
+}
+
+TERRAIN_TEST(TileCacheFloatRange)
+{
+	//65 x 65 float ramp 0..640 along x, 2 x 2 tiles of 32 each holding a
+	//quarter of the range
+	std::vector<float> samples(65 * 65);
+	for(unsigned int z = 0; z < 65; z++)
+		for(unsigned int x = 0; x < 65; x++)
+			samples[z * 65 + x] = (float)x * 10.0f;
+	const char header[] = "width 65\nheight 65\nbits 32\n";
+	CHECK(TerrainTest::WriteFile("test_tile_float.raw", &samples[0], (unsigned int)samples.size() * sizeof(float)));
+	CHECK(TerrainTest::WriteFile("test_tile_float.raw.hdr", header, sizeof(header) - 1));
+
+	TerrainTileCache cache;
+	CHECK(cache.Open("test_tile_float.raw", 32, 16));
+	TerrainTile *left = cache.GetTile(0, 0), *right = cache.GetTile(1, 0);
+	CHECK(left != NULL && right != NULL);
+	if(left && right)
+	{
+		//the same range everywhere, so the shared column shades the same
+		const HeightField &a = left->terrain.GetHeightField(), &b = right->terrain.GetHeightField();
+		float low, high;
+		a.GetSampleRange(low, high);
+		CHECK(low == 0.0f && high == 640.0f);
+		b.GetSampleRange(low, high);
+		CHECK(low == 0.0f && high == 640.0f);
+		for(unsigned int z = 0; z < 33; z++)
+			CHECK(a.GetSample8(32, z) == b.GetSample8(0, z));
+		CHECK(a.GetSample8(32, 0) == 128);
+	}
+
+	//a float map shorter than its .hdr says does not open
+	const char large[] = "width 65\nheight 66\nbits 32\n";
+	CHECK(TerrainTest::WriteFile("test_tile_float.raw.hdr", large, sizeof(large) - 1));
+	CHECK(!cache.Open("test_tile_float.raw", 32, 16));
+
+	cache.Close();
+	remove("test_tile_float.raw");
+	remove("test_tile_float.raw.hdr");
+}
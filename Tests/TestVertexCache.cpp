@@ -0,0 +1,228 @@
+///============================================================================
+///@file	TestVertexCache.cpp
+///@brief	Vertex cache simulation on lists with known miss counts, and the
+///			two LOD index orders: the banded sets of TerrainMesh and the
+///			sets reordered by VertexCache::Optimize must hold the same
+///			triangles with the same winding.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "TerrainTest.h"
+#include "Terrain.h"
+#include "TerrainIndexTable.h"
+#include "VertexCache.h"
+
+#include <algorithm>
+#include <vector>
+
+//-------------------------------------------------------------------------
+//Triangle rotated so its smallest index comes first, which keeps winding
+//-------------------------------------------------------------------------
+struct Triangle
+{
+	unsigned int v[3];
+
+	bool operator<(const Triangle &other) const
+	{
+		return std::lexicographical_compare(v, v + 3, other.v, other.v + 3);
+	}
+
+	bool operator==(const Triangle &other) const
+	{
+		return v[0] == other.v[0] && v[1] == other.v[1] && v[2] == other.v[2];
+	}
+};
+
+///----------------------------------------------------------------------------
+///Returns the triangles of a list as a sorted multiset of rotated triangles
+///----------------------------------------------------------------------------
+template <typename IndexType>
+static std::vector<Triangle> GetTriangles(const IndexType *indices, unsigned int count)
+{
+	std::vector<Triangle> triangles(count / 3);
+	for(unsigned int t = 0; t < count / 3; t++)
+	{
+		const IndexType *in = indices + t * 3;
+		unsigned int first = (in[1] < in[0]) ? ((in[2] < in[1]) ? 2 : 1) : ((in[2] < in[0]) ? 2 : 0);
+		for(unsigned int i = 0; i < 3; i++)
+			triangles[t].v[i] = in[(first + i) % 3];
+	}
+
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+///----------------------------------------------------------------------------
+///Returns true if every triangle of a patch set winds the same way as the
+///full resolution grid (counterclockwise in x,z) and none is degenerate
+///----------------------------------------------------------------------------
+template <typename IndexType>
+static bool HasGridWinding(const IndexType *indices, unsigned int count, unsigned int patchSize)
+{
+	unsigned int pitch = patchSize + 1;
+	for(unsigned int t = 0; t + 2 < count; t += 3)
+	{
+		int x0 = indices[t] % pitch, z0 = indices[t] / pitch;
+		int x1 = indices[t + 1] % pitch, z1 = indices[t + 1] / pitch;
+		int x2 = indices[t + 2] % pitch, z2 = indices[t + 2] / pitch;
+		if((x1 - x0) * (z2 - z0) - (z1 - z0) * (x2 - x0) <= 0)
+			return false;
+	}
+
+	return true;
+}
+
+///----------------------------------------------------------------------------
+///Writes the triangle list of a strip of quads, two triangles per quad
+///between the vertex rows 0 2 4 ... and 1 3 5 ...
+///----------------------------------------------------------------------------
+static std::vector<unsigned short> BuildStrip(unsigned int triangles)
+{
+	std::vector<unsigned short> indices;
+	for(unsigned int t = 0; t < triangles; t++)
+	{
+		//strip triangle t is (t, t+1, t+2), every other one flipped
+		indices.push_back((unsigned short)t);
+		indices.push_back((unsigned short)((t & 1) ? t + 2 : t + 1));
+		indices.push_back((unsigned short)((t & 1) ? t + 1 : t + 2));
+	}
+	return indices;
+}
+
+TERRAIN_TEST(VertexCacheSimulateStrip)
+{
+	//each triangle after the first brings one new vertex: T + 2 misses
+	std::vector<unsigned short> strip = BuildStrip(10);
+	for(unsigned int policy = CACHE_FIFO; policy <= CACHE_LRU; policy++)
+	{
+		CacheStats stats = VertexCache::Simulate(&strip[0], (unsigned int)strip.size(), 16, (CachePolicy)policy);
+		CHECK(stats.triangles == 10);
+		CHECK(stats.vertices == 12);
+		CHECK(stats.misses == 12);
+		CHECK(stats.acmr == 1.2f);
+		CHECK(stats.atvr == 1.0f);
+	}
+
+	//the same strip twice: the second pass hits a cache that holds it all,
+	//misses again with one too small to
+	std::vector<unsigned short> twice(strip);
+	twice.insert(twice.end(), strip.begin(), strip.end());
+	CacheStats large = VertexCache::Simulate(&twice[0], (unsigned int)twice.size(), 16, CACHE_FIFO);
+	CHECK(large.triangles == 20 && large.misses == 12);
+	CHECK(large.acmr == 0.6f);
+	CacheStats small = VertexCache::Simulate(&twice[0], (unsigned int)twice.size(), 4, CACHE_FIFO);
+	CHECK(small.misses == 24);
+	CHECK(small.atvr == 2.0f);
+
+	//32-bit indices count the same
+	std::vector<unsigned int> wide(strip.begin(), strip.end());
+	CacheStats stats = VertexCache::Simulate(&wide[0], (unsigned int)wide.size(), 16, CACHE_FIFO);
+	CHECK(stats.misses == 12 && stats.acmr == 1.2f);
+}
+
+TERRAIN_TEST(VertexCacheSimulatePolicies)
+{
+	//0 1 2, then 0 is reused after 3 and 4 entered a cache of three: LRU
+	//kept it as the most recent, FIFO let it age out
+	const unsigned short indices[] = { 0, 1, 2,  0, 2, 3,  0, 3, 4,  0, 4, 5 };
+	CacheStats fifo = VertexCache::Simulate(indices, 12, 3, CACHE_FIFO);
+	CacheStats lru = VertexCache::Simulate(indices, 12, 3, CACHE_LRU);
+	CHECK(lru.misses == 6);
+	CHECK(fifo.misses > lru.misses);
+	CHECK(fifo.vertices == 6 && lru.vertices == 6);
+}
+
+TERRAIN_TEST(VertexCacheOptimizeKeepsTriangles)
+{
+	//a plain row by row grid, then the same grid reordered
+	const unsigned int patchSize = 16;
+	std::vector<unsigned short> grid((size_t)patchSize * patchSize * 6);
+	TerrainMesh::BuildPatchIndices(patchSize, &grid[0]);
+	std::vector<unsigned short> optimized(grid);
+	VertexCache::Optimize(&optimized[0], (unsigned int)optimized.size(), (patchSize + 1) * (patchSize + 1));
+
+	CHECK(GetTriangles(&optimized[0], (unsigned int)optimized.size()) == GetTriangles(&grid[0], (unsigned int)grid.size()));
+	CHECK(HasGridWinding(&optimized[0], (unsigned int)optimized.size(), patchSize));
+	CHECK(optimized != grid);
+
+	CacheStats before = VertexCache::Simulate(&grid[0], (unsigned int)grid.size(), 16, CACHE_FIFO);
+	CacheStats after = VertexCache::Simulate(&optimized[0], (unsigned int)optimized.size(), 16, CACHE_FIFO);
+	CHECK(after.acmr < before.acmr);
+
+	//the 32-bit path and a list of one triangle
+	std::vector<unsigned int> wide(grid.begin(), grid.end());
+	VertexCache::Optimize(&wide[0], (unsigned int)wide.size(), (patchSize + 1) * (patchSize + 1));
+	CHECK(GetTriangles(&wide[0], (unsigned int)wide.size()) == GetTriangles(&grid[0], (unsigned int)grid.size()));
+	const unsigned int triangle[3] = { 5, 2, 9 };
+	unsigned int single[3] = { 5, 2, 9 };
+	VertexCache::Optimize(single, 3, 10);
+	CHECK(GetTriangles(single, 3) == GetTriangles(triangle, 3));
+}
+
+TERRAIN_TEST(VertexCacheLODOrders)
+{
+	//every set of both orders: the banded sets from the compile time table
+	//and the sets reordered by VertexCache::Optimize
+	Terrain terrain;
+	CHECK(terrain.GetHeightField().Create(65, 65, HEIGHT_UINT8));
+	CHECK(terrain.Build(16));
+	const TerrainLOD &lod = terrain.GetLOD();
+	CHECK(lod.GetIndexTable() != NULL);
+
+	std::vector<unsigned short> banded(lod.GetIndexCount()), optimized(lod.GetIndexCount());
+	lod.BuildIndices(&banded[0]);
+	lod.BuildIndices(&optimized[0], true);
+
+	for(unsigned int level = 0; level < lod.GetLevelCount(); level++)
+	{
+		for(unsigned int mask = 0; mask < TerrainLOD::STITCH_VARIANTS; mask++)
+		{
+			const IndexRange &range = lod.GetIndexRange(level, mask);
+			const unsigned short *a = &banded[range.first], *b = &optimized[range.first];
+
+			//the table holds what TerrainMesh generates at runtime
+			std::vector<unsigned short> generated(range.count);
+			CHECK(TerrainMesh::BuildLODIndices(16, level, mask, &generated[0]) == range.count);
+			CHECK(std::equal(generated.begin(), generated.end(), a));
+
+			CHECK(GetTriangles(a, range.count) == GetTriangles(b, range.count));
+			CHECK(HasGridWinding(a, range.count, 16));
+			CHECK(HasGridWinding(b, range.count, 16));
+		}
+	}
+
+	//full resolution, no stitching: both orders beat the row by row grid
+	const IndexRange &full = lod.GetIndexRange(0, 0);
+	std::vector<unsigned short> grid(16 * 16 * 6);
+	TerrainMesh::BuildPatchIndices(16, &grid[0]);
+	CacheStats rows = VertexCache::Simulate(&grid[0], (unsigned int)grid.size(), 16, CACHE_FIFO);
+	CacheStats bands = VertexCache::Simulate(&banded[full.first], full.count, 16, CACHE_FIFO);
+	CacheStats reordered = VertexCache::Simulate(&optimized[full.first], full.count, 16, CACHE_FIFO);
+	CHECK(bands.acmr < rows.acmr);
+	CHECK(reordered.acmr < rows.acmr);
+}
+
+TERRAIN_TEST(VertexCacheBandedBeatsOptimize)
+{
+	//on the default patch size the banded order needs no reordering pass
+	//to stay ahead of the optimizer, on small caches and large ones
+	const LODIndexSets *sets = TerrainIndexTable::Find(TerrainQuadTree::DEFAULT_PATCH_SIZE);
+	CHECK(sets != NULL);
+	if(!sets) return;
+
+	unsigned int vertexCount = (sets->patchSize + 1) * (sets->patchSize + 1);
+	const IndexRange &full = sets->ranges[0];
+	std::vector<unsigned short> optimized(sets->indices + full.first, sets->indices + full.first + full.count);
+	VertexCache::Optimize(&optimized[0], full.count, vertexCount);
+	CHECK(GetTriangles(&optimized[0], full.count) == GetTriangles(sets->indices + full.first, full.count));
+
+	static const unsigned int cacheSizes[] = { 16, 24, 32 };
+	for(unsigned int i = 0; i < sizeof(cacheSizes) / sizeof(cacheSizes[0]); i++)
+	{
+		CacheStats bands = VertexCache::Simulate(sets->indices + full.first, full.count, cacheSizes[i], CACHE_FIFO);
+		CacheStats reordered = VertexCache::Simulate(&optimized[0], full.count, cacheSizes[i], CACHE_FIFO);
+		CHECK(bands.acmr <= reordered.acmr);
+		CHECK(bands.acmr < 0.7f);
+	}
+}
@@ -10,33 +10,27 @@
 
 #include "Timer.h"
 
+#include <stdio.h>
+
 //-----------------------------------------------------------------------------
 // Name : Timer () (Constructor)
 // Desc : Timer Class Constructor
 //-----------------------------------------------------------------------------
 Timer::Timer()
 {
-	// Query performance hardware and setup time scaling values
-	if (QueryPerformanceFrequency((LARGE_INTEGER *)&m_PerfFreq)) 
-    { 
-		m_PerfHardware		= TRUE;
-		QueryPerformanceCounter((LARGE_INTEGER *) &m_LastTime); 
-		m_TimeScale			= 1.0f / m_PerfFreq;
-	} 
-    else 
-    { 
-		// no performance counter, read in using timeGetTime 
-		m_PerfHardware		= FALSE;
-		m_LastTime			= timeGetTime(); 
-		m_TimeScale			= 0.001f;
-	
-    } // End If No Hardware
+	// The steady clock never jumps and counts in nanoseconds everywhere
+	m_LastTime			= FramePacer::Now();
+	m_CurrentTime		= m_LastTime;
 
 	// Clear any needed values
+    m_TimeElapsed       = 0.0f;
+    m_FrameTime         = 0;
     m_SampleCount       = 0;
+    m_SampleNext        = 0;
+    m_SampleSum         = 0.0;
 	m_FrameRate			= 0;
 	m_FPSFrameCount		= 0;
-	m_FPSTimeElapsed	= 0.0f;
+	m_FPSTimeElapsed	= 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -48,57 +42,22 @@ Timer::~Timer()
 }
 
 //-----------------------------------------------------------------------------
-// Name : Tick () 
+// Name : Tick ()
 // Desc : Function which signals that frame has advanced
 // Note : You can specify a number of frames per second to lock the frame rate
-//        to. This will simply soak up the remaining time to hit that target.
+//        to. The pacer sleeps through most of the remaining time and only
+//        spins for the last fraction of a millisecond to hit that target.
 //-----------------------------------------------------------------------------
 void Timer::Tick( float fLockFPS )
 {
-    float fTimeElapsed; 
-
-    // Is performance hardware available?
-	if ( m_PerfHardware ) 
-    {
-        // Query high-resolution performance hardware
-		QueryPerformanceCounter((LARGE_INTEGER *)&m_CurrentTime);
-	} 
-    else 
-    {
-        // Fall back to less accurate timer
-		m_CurrentTime = timeGetTime();
-
-	} // End If no hardware available
-
-	// Calculate elapsed time in seconds
-	fTimeElapsed = (m_CurrentTime - m_LastTime) * m_TimeScale;
-
-    // Smoothly ramp up frame rate to prevent jittering
-    //if ( fLockFPS == 0.0f ) fLockFPS = (1.0f / GetTimeElapsed()) + 20.0f;
-    
     // Should we lock the frame rate ?
-    if ( fLockFPS > 0.0f )
-    {
-        while ( fTimeElapsed < (1.0f / fLockFPS))
-        {
-            // Is performance hardware available?
-	        if ( m_PerfHardware ) 
-            {
-                // Query high-resolution performance hardware
-		        QueryPerformanceCounter((LARGE_INTEGER*)&m_CurrentTime);
-	        } 
-            else 
-            {
-                // Fall back to less accurate timer
-		        m_CurrentTime = timeGetTime();
-
-	        } // End If no hardware available
-
-	        // Calculate elapsed time in seconds
-	        fTimeElapsed = (m_CurrentTime - m_LastTime) * m_TimeScale;
-
-        } // End While
-    } // End If
+    m_Pacer.SetTargetRate( fLockFPS );
+    m_Pacer.Wait();
+
+	// Calculate elapsed time, integer nanoseconds until the very end
+	m_CurrentTime = FramePacer::Now();
+    m_FrameTime   = m_CurrentTime - m_LastTime;
+    float fTimeElapsed = (float)(m_FrameTime * 1e-9);
 
 	// Save current frame time
 	m_LastTime = m_CurrentTime;
@@ -106,46 +65,43 @@ void Timer::Tick( float fLockFPS )
     // Filter out values wildly different from current average
     if ( fabsf(fTimeElapsed - m_TimeElapsed) < 1.0f  )
     {
-        // Wrap FIFO frame time buffer.
-        memmove( &m_FrameTime[1], m_FrameTime, (MAX_SAMPLE_COUNT - 1) * sizeof(float) );
-        m_FrameTime[ 0 ] = fTimeElapsed;
+        // Overwrite the oldest sample of the ring, keeping the sum current
         if ( m_SampleCount < MAX_SAMPLE_COUNT ) m_SampleCount++;
+        else m_SampleSum -= m_FrameTimes[ m_SampleNext ];
+        m_FrameTimes[ m_SampleNext ] = fTimeElapsed;
+        m_SampleSum += fTimeElapsed;
+        m_SampleNext = (m_SampleNext + 1) % MAX_SAMPLE_COUNT;
 
     } // End if
-    
+
 
 	// Calculate Frame Rate
 	m_FPSFrameCount++;
-	m_FPSTimeElapsed += fTimeElapsed;
-	if ( m_FPSTimeElapsed > 1.0f) 
+	m_FPSTimeElapsed += m_FrameTime;
+	if ( m_FPSTimeElapsed > 1000000000LL )
     {
 		m_FrameRate			= m_FPSFrameCount;
 		m_FPSFrameCount		= 0;
-		m_FPSTimeElapsed	= 0.0f;
+		m_FPSTimeElapsed	= 0;
 	} // End If Second Elapsed
 
-    // Count up the new average elapsed time
-    m_TimeElapsed = 0.0f;
-    for ( ULONG i = 0; i < m_SampleCount; i++ ) m_TimeElapsed += m_FrameTime[ i ];
-    if ( m_SampleCount > 0 ) m_TimeElapsed /= m_SampleCount;
+    // New average elapsed time from the running sum
+    if ( m_SampleCount > 0 ) m_TimeElapsed = (float)(m_SampleSum / m_SampleCount);
 
 }
 
 //-----------------------------------------------------------------------------
-// Name : GetFrameRate () 
+// Name : GetFrameRate ()
 // Desc : Returns the frame rate, sampled over the last second or so.
 //-----------------------------------------------------------------------------
-unsigned long Timer::GetFrameRate( LPTSTR lpszString ) const
+unsigned long Timer::GetFrameRate( char * lpszString ) const
 {
     // Fill string buffer ?
     if ( lpszString )
     {
 
-        // Copy frame rate value into string
-        _itot( m_FrameRate, lpszString, 10 );
-
-        // Append with FPS
-        _tcscat( lpszString, _T(" FPS") );
+        // Copy frame rate value into string, appended with FPS
+        sprintf( lpszString, "%lu FPS", m_FrameRate );
 
     } // End if build FPS string
 
@@ -153,10 +109,28 @@ unsigned long Timer::GetFrameRate( LPTSTR lpszString ) const
 }
 
 //-----------------------------------------------------------------------------
-// Name : GetTimeElapsed () 
+// Name : GetTimeElapsed ()
 // Desc : Returns the amount of time elapsed since the last frame (Seconds)
 //-----------------------------------------------------------------------------
 float Timer::GetTimeElapsed() const
 {
     return m_TimeElapsed;
 }
+
+//-----------------------------------------------------------------------------
+// Name : GetFrameTime ()
+// Desc : Returns the unfiltered length of the last frame (Nanoseconds)
+//-----------------------------------------------------------------------------
+long long Timer::GetFrameTime() const
+{
+    return m_FrameTime;
+}
+
+//-----------------------------------------------------------------------------
+// Name : GetPacer ()
+// Desc : Returns the frame pacer, for its timing accuracy and cost
+//-----------------------------------------------------------------------------
+const FramePacer & Timer::GetPacer() const
+{
+    return m_Pacer;
+}
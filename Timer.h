@@ -11,15 +11,14 @@
 #ifndef TIMER_H
 #define TIMER_H
 
-#include <windows.h>
 #include <math.h>
-#include <tchar.h>
+#include "FramePacer.h"
 
-const ULONG MAX_SAMPLE_COUNT = 50; // Maximum frame time sample count
+const unsigned long MAX_SAMPLE_COUNT = 50; // Maximum frame time sample count
 
 //-----------------------------------------------------------------------------
 // Name : Timer (Class)
-// Desc : Game Timer class, queries performance hardware if available, and 
+// Desc : Game Timer class, reads the steady clock in integer nanoseconds, and
 //        calculates all the various values required for frame rate based
 //        vector / value scaling.
 //-----------------------------------------------------------------------------
@@ -36,26 +35,29 @@ public:
 	// Public Methods
 	//------------------------------------------------------------
 	void	        Tick( float fLockFPS = 0.0f );
-    unsigned long   GetFrameRate( LPTSTR lpszString = NULL ) const;
+    unsigned long   GetFrameRate( char * lpszString = NULL ) const;
     float           GetTimeElapsed() const;
+    long long       GetFrameTime() const;
+    const FramePacer & GetPacer() const;
 
 private:
 	//------------------------------------------------------------
 	// Private Members
 	//------------------------------------------------------------
-    bool            m_PerfHardware;             // Has Performance Counter
-	float           m_TimeScale;                // Amount to scale counter
 	float           m_TimeElapsed;              // Time elapsed since previous frame
-    __int64         m_CurrentTime;              // Current Performance Counter
-    __int64         m_LastTime;                 // Performance Counter last frame
-	__int64         m_PerfFreq;                 // Performance Frequency
+    long long       m_CurrentTime;              // Current clock, nanoseconds
+    long long       m_LastTime;                 // Clock last frame, nanoseconds
+    long long       m_FrameTime;                // Last frame, nanoseconds
+    FramePacer      m_Pacer;                    // Holds frames to the locked rate
 
-    float           m_FrameTime[MAX_SAMPLE_COUNT];
-    ULONG           m_SampleCount;
+    float           m_FrameTimes[MAX_SAMPLE_COUNT];  // Ring of recent frame times
+    unsigned long   m_SampleCount;              // Valid samples in the ring
+    unsigned long   m_SampleNext;               // Ring slot written next
+    double          m_SampleSum;                // Sum of the valid samples
 
     unsigned long   m_FrameRate;                // Stores current framerate
 	unsigned long   m_FPSFrameCount;            // Elapsed frames in any given second
-	float           m_FPSTimeElapsed;           // How much time has passed during FPS sample
+	long long       m_FPSTimeElapsed;           // How much time has passed during FPS sample
 };
 
-#endif
\ No newline at end of file
+#endif
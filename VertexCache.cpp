@@ -0,0 +1,265 @@
+///============================================================================
+///@file	VertexCache.cpp
+///@brief	Vertex cache simulator and optimizer implementation.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#include "VertexCache.h"
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+//Forsyth's scoring constants
+static const float CACHE_DECAY_POWER = 1.5f;
+static const float LAST_TRIANGLE_SCORE = 0.75f;
+static const float VALENCE_BOOST_SCALE = 2.0f;
+static const float VALENCE_BOOST_POWER = 0.5f;
+static const unsigned int VALENCE_TABLE_SIZE = 32;
+
+///----------------------------------------------------------------------------
+///Runs an index list through a simulated post-transform cache
+///----------------------------------------------------------------------------
+template <typename IndexType>
+static CacheStats SimulateCache(const IndexType *indices, unsigned int indexCount, unsigned int cacheSize, CachePolicy policy)
+{
+	CacheStats stats;
+	memset(&stats, 0, sizeof(stats));
+	if(cacheSize < 1) cacheSize = 1;
+
+	unsigned int maxIndex = 0;
+	for(unsigned int i = 0; i < indexCount; i++)
+		if(indices[i] > maxIndex) maxIndex = indices[i];
+
+	//entries[0] is the most recent one
+	std::vector<unsigned int> entries;
+	std::vector<unsigned char> seen(indexCount ? maxIndex + 1 : 0, 0);
+	entries.reserve(cacheSize + 1);
+
+	for(unsigned int i = 0; i < indexCount; i++)
+	{
+		unsigned int v = indices[i];
+		if(!seen[v])
+		{
+			seen[v] = 1;
+			stats.vertices++;
+		}
+
+		size_t slot = 0;
+		while(slot < entries.size() && entries[slot] != v)
+			slot++;
+
+		if(slot < entries.size())
+		{
+			if(policy == CACHE_LRU)
+			{
+				entries.erase(entries.begin() + slot);
+				entries.insert(entries.begin(), v);
+			}
+			continue;
+		}
+
+		stats.misses++;
+		entries.insert(entries.begin(), v);
+		if(entries.size() > cacheSize)
+			entries.pop_back();
+	}
+
+	stats.triangles = indexCount / 3;
+	stats.acmr = stats.triangles ? (float)stats.misses / (float)stats.triangles : 0.0f;
+	stats.atvr = stats.vertices ? (float)stats.misses / (float)stats.vertices : 0.0f;
+	return stats;
+}
+
+///----------------------------------------------------------------------------
+///Forsyth vertex score: recently used vertices score high (the last
+///triangle's three a bit less, so strips keep moving), and vertices with
+///few triangles left get a boost so they are finished off early
+///----------------------------------------------------------------------------
+static float VertexScore(int cachePosition, unsigned int remaining, unsigned int cacheSize)
+{
+	if(remaining == 0)
+		return -1.0f;
+
+	float score = 0.0f;
+	if(cachePosition >= 0)
+	{
+		if(cachePosition < 3)
+			score = LAST_TRIANGLE_SCORE;
+		else
+			score = powf(1.0f - (float)(cachePosition - 3) / (float)(cacheSize - 3), CACHE_DECAY_POWER);
+	}
+
+	return score + VALENCE_BOOST_SCALE * powf((float)remaining, -VALENCE_BOOST_POWER);
+}
+
+///----------------------------------------------------------------------------
+///Reorders the triangles of an index list for a post-transform cache
+///(Tom Forsyth, "Linear-Speed Vertex Cache Optimisation")
+///----------------------------------------------------------------------------
+template <typename IndexType>
+static void OptimizeCache(IndexType *indices, unsigned int indexCount, unsigned int vertexCount, unsigned int cacheSize)
+{
+	unsigned int triangleCount = indexCount / 3;
+	if(triangleCount < 2 || vertexCount < 3) return;
+	if(cacheSize < 4) cacheSize = 4;
+
+	//triangles of each vertex, the first remaining[v] are still to be emitted
+	std::vector<unsigned int> remaining(vertexCount, 0);
+	std::vector<unsigned int> first(vertexCount + 1, 0);
+	for(unsigned int i = 0; i < triangleCount * 3; i++)
+		remaining[indices[i]]++;
+	for(unsigned int v = 0; v < vertexCount; v++)
+		first[v + 1] = first[v] + remaining[v];
+
+	std::vector<unsigned int> adjacency(triangleCount * 3);
+	std::vector<unsigned int> fill(first.begin(), first.end() - 1);
+	for(unsigned int t = 0; t < triangleCount; t++)
+		for(unsigned int k = 0; k < 3; k++)
+			adjacency[fill[indices[t * 3 + k]]++] = t;
+
+	//scores only depend on small integers, tabulate them
+	std::vector<float> scoreTable((cacheSize + 1) * VALENCE_TABLE_SIZE);
+	for(unsigned int p = 0; p <= cacheSize; p++)
+		for(unsigned int n = 0; n < VALENCE_TABLE_SIZE; n++)
+			scoreTable[p * VALENCE_TABLE_SIZE + n] = VertexScore((p < cacheSize) ? (int)p : -1, n, cacheSize);
+
+	std::vector<float> vertexScore(vertexCount);
+	for(unsigned int v = 0; v < vertexCount; v++)
+		vertexScore[v] = VertexScore(-1, remaining[v], cacheSize);
+
+	std::vector<float> triangleScore(triangleCount);
+	std::vector<unsigned char> emitted(triangleCount, 0);
+	for(unsigned int t = 0; t < triangleCount; t++)
+		triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+
+	std::vector<IndexType> output(triangleCount * 3);
+	std::vector<unsigned int> cache, next;
+	cache.reserve(cacheSize + 3);
+	next.reserve(cacheSize + 3);
+
+	int best = 0;
+	for(unsigned int t = 1; t < triangleCount; t++)
+		if(triangleScore[t] > triangleScore[best]) best = (int)t;
+
+	unsigned int scan = 0;
+	for(unsigned int n = 0; n < triangleCount; n++)
+	{
+		//nothing adjacent to the cache left, take the best of the rest
+		if(best < 0)
+		{
+			while(scan < triangleCount && emitted[scan]) scan++;
+			best = (int)scan;
+			for(unsigned int t = scan + 1; t < triangleCount; t++)
+				if(!emitted[t] && triangleScore[t] > triangleScore[best]) best = (int)t;
+		}
+
+		unsigned int triangle = (unsigned int)best;
+		const IndexType *tri = &indices[triangle * 3];
+		output[n * 3] = tri[0];
+		output[n * 3 + 1] = tri[1];
+		output[n * 3 + 2] = tri[2];
+		emitted[triangle] = 1;
+
+		//drop the triangle from its vertices' remaining lists
+		for(unsigned int k = 0; k < 3; k++)
+		{
+			unsigned int v = tri[k];
+			unsigned int *list = &adjacency[first[v]];
+			for(unsigned int j = 0; j < remaining[v]; j++)
+			{
+				if(list[j] == triangle)
+				{
+					list[j] = list[remaining[v] - 1];
+					list[remaining[v] - 1] = triangle;
+					remaining[v]--;
+					break;
+				}
+			}
+		}
+
+		//the triangle's vertices go to the front of the cache
+		next.assign(tri, tri + 3);
+		for(size_t i = 0; i < cache.size(); i++)
+			if(cache[i] != tri[0] && cache[i] != tri[1] && cache[i] != tri[2])
+				next.push_back(cache[i]);
+		cache.swap(next);
+
+		for(size_t i = 0; i < cache.size(); i++)
+		{
+			unsigned int v = cache[i];
+			unsigned int p = (i < cacheSize) ? (unsigned int)i : cacheSize;
+			if(remaining[v] < VALENCE_TABLE_SIZE)
+				vertexScore[v] = scoreTable[p * VALENCE_TABLE_SIZE + remaining[v]];
+			else
+				vertexScore[v] = VertexScore((i < cacheSize) ? (int)i : -1, remaining[v], cacheSize);
+		}
+
+		//rescore the triangles touched by the cache, best one goes next
+		best = -1;
+		float bestScore = -1.0f;
+		for(size_t i = 0; i < cache.size(); i++)
+		{
+			unsigned int v = cache[i];
+			const unsigned int *list = &adjacency[first[v]];
+			for(unsigned int j = 0; j < remaining[v]; j++)
+			{
+				unsigned int t = list[j];
+				float score = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+				triangleScore[t] = score;
+				if(score > bestScore)
+				{
+					bestScore = score;
+					best = (int)t;
+				}
+			}
+		}
+
+		if(cache.size() > cacheSize)
+			cache.resize(cacheSize);
+	}
+
+	memcpy(indices, &output[0], triangleCount * 3 * sizeof(IndexType));
+}
+
+///----------------------------------------------------------------------------
+///Simulates a post-transform cache over an index list
+///@param	indices - triangle list
+///@param	indexCount - number of indices
+///@param	cacheSize - cache entries
+///@param	policy - CACHE_FIFO or CACHE_LRU
+///----------------------------------------------------------------------------
+CacheStats VertexCache::Simulate(const unsigned short *indices, unsigned int indexCount, unsigned int cacheSize, CachePolicy policy)
+{
+	return SimulateCache(indices, indexCount, cacheSize, policy);
+}
+
+///----------------------------------------------------------------------------
+///Simulates a post-transform cache over an index list
+///----------------------------------------------------------------------------
+CacheStats VertexCache::Simulate(const unsigned int *indices, unsigned int indexCount, unsigned int cacheSize, CachePolicy policy)
+{
+	return SimulateCache(indices, indexCount, cacheSize, policy);
+}
+
+///----------------------------------------------------------------------------
+///Reorders the triangles of a list in place for a vertex cache, triangles
+///keep their winding
+///@param	indices - triangle list
+///@param	indexCount - number of indices
+///@param	vertexCount - number of vertices the indices refer to
+///@param	cacheSize - cache size to optimize for
+///----------------------------------------------------------------------------
+void VertexCache::Optimize(unsigned short *indices, unsigned int indexCount, unsigned int vertexCount, unsigned int cacheSize)
+{
+	OptimizeCache(indices, indexCount, vertexCount, cacheSize);
+}
+
+///----------------------------------------------------------------------------
+///Reorders the triangles of a list in place for a vertex cache
+///----------------------------------------------------------------------------
+void VertexCache::Optimize(unsigned int *indices, unsigned int indexCount, unsigned int vertexCount, unsigned int cacheSize)
+{
+	OptimizeCache(indices, indexCount, vertexCount, cacheSize);
+}
@@ -0,0 +1,45 @@
+///============================================================================
+///@file	VertexCache.h
+///@brief	Post-transform vertex cache tools: a FIFO/LRU cache simulator
+///			reporting ACMR (misses per triangle) and ATVR (misses per unique
+///			vertex), and Forsyth's linear-speed triangle reordering that
+///			raises the hit rate of any indexed triangle list.
+///
+///@date	October 18, 2026
+///============================================================================
+
+#pragma once
+
+//-------------------------------------------------------------------------
+//Replacement policy of the simulated cache
+//-------------------------------------------------------------------------
+enum CachePolicy
+{
+	CACHE_FIFO,		///> Hits do not refresh entries (most GPUs)
+	CACHE_LRU		///> Hits move entries to the front
+};
+
+//-------------------------------------------------------------------------
+//Result of one simulation
+//-------------------------------------------------------------------------
+struct CacheStats
+{
+	unsigned int	triangles;	///> Triangles processed
+	unsigned int	vertices;	///> Unique vertices referenced
+	unsigned int	misses;		///> Vertices transformed
+	float			acmr;		///> Average cache miss ratio, misses / triangles (0.5 ideal on grids)
+	float			atvr;		///> Average transform to vertex ratio, misses / vertices (1.0 ideal)
+};
+
+namespace VertexCache
+{
+	static const unsigned int DEFAULT_CACHE_SIZE = 32;	///> Cache size the optimizer scores for
+
+	CacheStats Simulate(const unsigned short *indices, unsigned int indexCount, unsigned int cacheSize, CachePolicy policy);
+	CacheStats Simulate(const unsigned int *indices, unsigned int indexCount, unsigned int cacheSize, CachePolicy policy);
+
+	void Optimize(unsigned short *indices, unsigned int indexCount, unsigned int vertexCount,
+				  unsigned int cacheSize = DEFAULT_CACHE_SIZE);
+	void Optimize(unsigned int *indices, unsigned int indexCount, unsigned int vertexCount,
+				  unsigned int cacheSize = DEFAULT_CACHE_SIZE);
+}